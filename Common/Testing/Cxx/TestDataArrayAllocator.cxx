@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercise data arrays with the allocators: values must survive every
+// kind of reallocation, and memory must go back to the allocator that
+// provided it with the size it was allocated with.
+
+#include "vtkAlignedDataArrayAllocator.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPooledDataArrayAllocator.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <vtkstd/map>
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// An allocator that remembers the size of each block and reports blocks
+// that are released with another size or released twice.
+class vtkCheckingAllocator : public vtkDataArrayAllocator
+{
+public:
+  static vtkCheckingAllocator* New();
+  vtkTypeMacro(vtkCheckingAllocator,vtkDataArrayAllocator);
+
+  virtual void* Allocate(size_t size)
+    {
+    void* ptr = malloc(size);
+    this->Blocks[ptr] = size;
+    return ptr;
+    }
+  virtual void Free(void* ptr, size_t size)
+    {
+    vtkstd::map<void*, size_t>::iterator i = this->Blocks.find(ptr);
+    if (i == this->Blocks.end() || i->second != size)
+      {
+      this->Errors++;
+      return;
+      }
+    this->Blocks.erase(i);
+    free(ptr);
+    }
+
+  vtkstd::map<void*, size_t> Blocks;
+  int Errors;
+
+protected:
+  vtkCheckingAllocator() { this->Errors = 0; }
+};
+vtkStandardNewMacro(vtkCheckingAllocator);
+
+// Fill an array with InsertNextValue, then resize it, copy it and squeeze
+// it, checking the values after each step.
+static int TestArray(vtkDoubleArray* array, vtkIdType n)
+{
+  int errors = 0;
+  array->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < 3*n; i++)
+    {
+    array->InsertNextValue(0.5*i);
+    }
+  array->Resize(n + 7);
+  array->Squeeze();
+  VTK_CREATE(vtkDoubleArray, copy);
+  copy->SetAllocator(array->GetAllocator());
+  copy->DeepCopy(array);
+  for (vtkIdType i = 0; i < 3*n; i++)
+    {
+    if (array->GetValue(i) != 0.5*i || copy->GetValue(i) != 0.5*i)
+      {
+      cerr << "Value " << i << " of " << n << " tuples is wrong" << endl;
+      errors++;
+      break;
+      }
+    }
+  array->Resize(n/2);
+  for (vtkIdType i = 0; i < 3*(n/2); i++)
+    {
+    if (array->GetValue(i) != 0.5*i)
+      {
+      cerr << "Value " << i << " is wrong after shrinking" << endl;
+      errors++;
+      break;
+      }
+    }
+  return errors;
+}
+
+int TestDataArrayAllocator(int, char*[])
+{
+  int errors = 0;
+  vtkIdType sizes[5] = { 1, 5, 1000, 10000, 100000 };
+
+  // Arrays with an allocator of their own, which changes on the way.
+  VTK_CREATE(vtkCheckingAllocator, checking);
+  VTK_CREATE(vtkPooledDataArrayAllocator, pooled);
+  VTK_CREATE(vtkAlignedDataArrayAllocator, aligned);
+  aligned->UseHugePagesOn();
+  vtkDataArrayAllocator* allocators[3] = { checking, pooled, aligned };
+  for (int a = 0; a < 3; a++)
+    {
+    for (int s = 0; s < 5; s++)
+      {
+      VTK_CREATE(vtkDoubleArray, array);
+      array->SetAllocator(allocators[a]);
+      errors += TestArray(array, sizes[s]);
+      array->SetAllocator(allocators[(a + 1) % 3]);
+      array->SetAllocator(0);
+      if (array->GetNumberOfTuples() != sizes[s]/2 ||
+          (sizes[s] > 1 && array->GetValue(1) != 0.5))
+        {
+        cerr << "Values were lost when changing the allocator" << endl;
+        errors++;
+        }
+      }
+    }
+
+  // Aligned memory, including a huge page allocation.
+  VTK_CREATE(vtkUnsignedCharArray, bytes);
+  bytes->SetAllocator(aligned);
+  for (vtkIdType n = 1; n < (vtkIdType(1) << 23); n *= 7)
+    {
+    bytes->SetNumberOfValues(n);
+    if (reinterpret_cast<size_t>(bytes->GetPointer(0)) % 64 != 0)
+      {
+      cerr << "Memory of " << n << " bytes is not aligned" << endl;
+      errors++;
+      }
+    }
+  bytes->SetNumberOfValues(3 << 20);
+  if (reinterpret_cast<size_t>(bytes->GetPointer(0)) % (2 << 20) != 0)
+    {
+    cerr << "Huge page memory is not aligned to the page size" << endl;
+    errors++;
+    }
+
+  // The pool gives back freed blocks, and grows blocks within their class
+  // without moving them.
+  for (int i = 0; i < 10; i++)
+    {
+    VTK_CREATE(vtkIdTypeArray, ids);
+    ids->SetAllocator(pooled);
+    ids->SetNumberOfValues(100);
+    }
+  if (pooled->GetNumberOfReusedBlocks() < 9)
+    {
+    cerr << "The pool did not reuse blocks" << endl;
+    errors++;
+    }
+  VTK_CREATE(vtkUnsignedCharArray, growing);
+  growing->SetAllocator(pooled);
+  growing->SetNumberOfValues(600);
+  unsigned char* block = growing->GetPointer(0);
+  growing->Resize(1000);
+  if (growing->GetPointer(0) != block)
+    {
+    cerr << "The pooled block moved within its size class" << endl;
+    errors++;
+    }
+  pooled->ReleaseMemory();
+  if (pooled->GetCachedSize() != 0)
+    {
+    cerr << "The pool kept memory after ReleaseMemory" << endl;
+    errors++;
+    }
+
+  // The global allocator, with arrays given by the user that it must not
+  // release.
+  vtkDataArrayAllocator::SetGlobalAllocator(checking);
+  for (int s = 0; s < 5; s++)
+    {
+    VTK_CREATE(vtkDoubleArray, array);
+    errors += TestArray(array, sizes[s]);
+    }
+  double* user = new double[30];
+  {
+  VTK_CREATE(vtkDoubleArray, array);
+  array->SetArray(user, 30, 1);
+  array->InsertNextValue(1.0);
+  array->SetArray(user, 30, 1);
+  }
+  delete [] user;
+  vtkDataArrayAllocator::SetGlobalAllocator(0);
+
+  if (checking->Errors || !checking->Blocks.empty())
+    {
+    cerr << checking->Errors << " blocks were released with a wrong size and "
+         << checking->Blocks.size() << " were not released" << endl;
+    errors++;
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
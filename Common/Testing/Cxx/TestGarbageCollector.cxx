@@ -115,5 +115,76 @@ int TestGarbageCollector(int,char *[])
     return 1;
     }
 
+  // Enable batched collection and delete several objects.  None of
+  // them should be collected yet.
+  vtkGarbageCollector::SetBatchedCollection(1);
+  vtkGarbageCollector::ResetStatistics();
+  const int numberOfObjects = 10;
+  called = 0;
+  for(int i = 0; i < numberOfObjects; ++i)
+    {
+    obj = vtkTestReferenceLoop::New();
+    obj->AddObserver(vtkCommand::DeleteEvent, cc);
+    obj->Delete();
+    }
+  if(called || vtkGarbageCollector::GetNumberOfCollections() != 0)
+    {
+    cerr << "Object collection not batched." << endl;
+    return 1;
+    }
+  if(vtkGarbageCollector::GetNumberOfDeferredObjects() != numberOfObjects)
+    {
+    cerr << "Batched " << vtkGarbageCollector::GetNumberOfDeferredObjects()
+         << " objects instead of " << numberOfObjects << "." << endl;
+    return 1;
+    }
+
+  // Popping deferred collection does not collect batched objects.
+  vtkGarbageCollector::DeferredCollectionPush();
+  vtkGarbageCollector::DeferredCollectionPop();
+  if(called)
+    {
+    cerr << "Deferred collection collected batched objects." << endl;
+    return 1;
+    }
+
+  // Collect incrementally.  Each loop holds two objects, so visiting
+  // four objects collects two loops.
+  int remaining = vtkGarbageCollector::CollectIncrementally(4);
+  if(!called || remaining != numberOfObjects - 2)
+    {
+    cerr << "Incremental collection left " << remaining
+         << " objects instead of " << (numberOfObjects - 2) << "." << endl;
+    return 1;
+    }
+
+  // Collect the rest in a single walk.
+  vtkGarbageCollector::Collect();
+  if(vtkGarbageCollector::GetNumberOfDeferredObjects() != 0 ||
+     vtkGarbageCollector::GetNumberOfCollections() != 2 ||
+     vtkGarbageCollector::GetNumberOfVisitedObjects() != 2*numberOfObjects ||
+     vtkGarbageCollector::GetNumberOfCollectedObjects() != 2*numberOfObjects ||
+     vtkGarbageCollector::GetCollectionTime() < 0.0)
+    {
+    cerr << "Batched collection did not collect all objects: "
+         << vtkGarbageCollector::GetNumberOfCollections() << " collections, "
+         << vtkGarbageCollector::GetNumberOfVisitedObjects() << " visited, "
+         << vtkGarbageCollector::GetNumberOfCollectedObjects()
+         << " collected." << endl;
+    return 1;
+    }
+
+  // Disabling batched collection collects the remaining objects.
+  obj = vtkTestReferenceLoop::New();
+  obj->AddObserver(vtkCommand::DeleteEvent, cc);
+  called = 0;
+  obj->Delete();
+  vtkGarbageCollector::SetBatchedCollection(0);
+  if(!called || vtkGarbageCollector::GetNumberOfDeferredObjects() != 0)
+    {
+    cerr << "Disabling batched collection did not collect object." << endl;
+    return 1;
+    }
+
   return 0;
 }
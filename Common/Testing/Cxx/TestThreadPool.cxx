@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMultiThreader.h"
+#include "vtkThreadPool.h"
+
+// Per-slot partial sums of the indices visited by ParallelFor.
+struct vtkTestThreadPoolSum
+{
+  vtkThreadPool *Pool;
+  vtkIdType Sums[VTK_MAX_THREADS];
+  int BadRange;
+};
+
+static void vtkTestThreadPoolAdd(vtkIdType begin, vtkIdType end,
+                                 int threadIndex, void *data)
+{
+  vtkTestThreadPoolSum *sum = static_cast<vtkTestThreadPoolSum *>(data);
+  if (threadIndex < 0 || threadIndex >= sum->Pool->GetNumberOfThreads() ||
+      end <= begin)
+    {
+    sum->BadRange = 1;
+    return;
+    }
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    sum->Sums[threadIndex] += i;
+    }
+}
+
+static vtkIdType vtkTestThreadPoolTotal(vtkTestThreadPoolSum &sum)
+{
+  vtkIdType total = 0;
+  for (int i = 0; i < VTK_MAX_THREADS; ++i)
+    {
+    total += sum.Sums[i];
+    }
+  return total;
+}
+
+static void vtkTestThreadPoolReset(vtkTestThreadPoolSum &sum,
+                                   vtkThreadPool *pool)
+{
+  sum.Pool = pool;
+  sum.BadRange = 0;
+  for (int i = 0; i < VTK_MAX_THREADS; ++i)
+    {
+    sum.Sums[i] = 0;
+    }
+}
+
+// Each outer index runs a nested ParallelFor over [0, 100).
+struct vtkTestThreadPoolNested
+{
+  vtkThreadPool *Pool;
+  vtkIdType Totals[64];
+  int Failed;
+};
+
+static void vtkTestThreadPoolOuter(vtkIdType begin, vtkIdType end,
+                                   int, void *data)
+{
+  vtkTestThreadPoolNested *nested =
+    static_cast<vtkTestThreadPoolNested *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    vtkTestThreadPoolSum sum;
+    vtkTestThreadPoolReset(sum, nested->Pool);
+    nested->Pool->ParallelFor(0, 100, 7, vtkTestThreadPoolAdd, &sum);
+    nested->Totals[i] = vtkTestThreadPoolTotal(sum);
+    nested->Failed |= sum.BadRange;
+    }
+}
+
+// Single method for vtkMultiThreader: record that each id was run once.
+static VTK_THREAD_RETURN_TYPE vtkTestThreadPoolMethod(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  int *counts = static_cast<int *>(info->UserData);
+  counts[info->ThreadID]++;
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+int TestThreadPool(int, char *[])
+{
+  int rval = 0;
+
+  vtkThreadPool *pool = vtkThreadPool::New();
+  pool->SetNumberOfThreads(4);
+
+  // A flat range, with automatic and explicit grain.
+  const vtkIdType n = 100000;
+  const vtkIdType expected = n*(n - 1)/2;
+  vtkTestThreadPoolSum sum;
+  for (vtkIdType grain = 0; grain < 2000; grain += 999)
+    {
+    for (int repeat = 0; repeat < 50; ++repeat)
+      {
+      vtkTestThreadPoolReset(sum, pool);
+      pool->ParallelFor(0, n, grain, vtkTestThreadPoolAdd, &sum);
+      if (sum.BadRange || vtkTestThreadPoolTotal(sum) != expected)
+        {
+        cerr << "ParallelFor with grain " << grain << " computed "
+             << vtkTestThreadPoolTotal(sum) << " instead of " << expected
+             << endl;
+        rval = 1;
+        break;
+        }
+      }
+    }
+
+  // Empty and single-index ranges.
+  vtkTestThreadPoolReset(sum, pool);
+  pool->ParallelFor(5, 5, 0, vtkTestThreadPoolAdd, &sum);
+  pool->ParallelFor(5, 6, 0, vtkTestThreadPoolAdd, &sum);
+  if (sum.BadRange || vtkTestThreadPoolTotal(sum) != 5)
+    {
+    cerr << "Degenerate ranges were not handled." << endl;
+    rval = 1;
+    }
+
+  // Nested parallel regions.
+  vtkTestThreadPoolNested nested;
+  nested.Pool = pool;
+  nested.Failed = 0;
+  pool->ParallelFor(0, 64, 1, vtkTestThreadPoolOuter, &nested);
+  for (int i = 0; i < 64; ++i)
+    {
+    if (nested.Totals[i] != 4950)
+      {
+      nested.Failed = 1;
+      }
+    }
+  if (nested.Failed)
+    {
+    cerr << "Nested ParallelFor failed." << endl;
+    rval = 1;
+    }
+
+  // Resizing the pool restarts the workers.
+  pool->SetNumberOfThreads(2);
+  vtkTestThreadPoolReset(sum, pool);
+  pool->ParallelFor(0, n, 0, vtkTestThreadPoolAdd, &sum);
+  if (sum.BadRange || vtkTestThreadPoolTotal(sum) != expected)
+    {
+    cerr << "ParallelFor after resizing the pool failed." << endl;
+    rval = 1;
+    }
+  pool->Delete();
+
+  // vtkMultiThreader on top of the global pool.
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(3);
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->UseThreadPoolOn();
+  threader->SetNumberOfThreads(8);
+  int counts[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  threader->SetSingleMethod(vtkTestThreadPoolMethod, counts);
+  for (int repeat = 0; repeat < 100; ++repeat)
+    {
+    threader->SingleMethodExecute();
+    }
+  for (int i = 0; i < 8; ++i)
+    {
+    if (counts[i] != 100)
+      {
+      cerr << "Thread " << i << " ran " << counts[i] << " times." << endl;
+      rval = 1;
+      }
+    }
+  threader->Delete();
+
+  return rval;
+}
@@ -69,6 +69,15 @@ vtkAbstractArray::vtkAbstractArray(vtkIdType vtkNotUsed(numComp))
 
 //----------------------------------------------------------------------------
 vtkAbstractArray::~vtkAbstractArray()
+{
+  this->ClearComponentNames();
+
+  this->SetName(NULL);
+  this->SetInformation(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractArray::ClearComponentNames()
 {
   if ( this->ComponentNames )
     {
@@ -83,9 +92,6 @@ vtkAbstractArray::~vtkAbstractArray()
     delete this->ComponentNames;
     this->ComponentNames = NULL;
     }
-
-  this->SetName(NULL);
-  this->SetInformation(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -109,6 +109,10 @@ public:
   // Copies the component names from the inputed array to the current array
   // make sure that the current array has the same number of components as the input array
   int CopyComponentNames( vtkAbstractArray *da );
+
+  // Description:
+  // Remove the names of all the components.
+  void ClearComponentNames();
   
   // Description:
   // Set the number of tuples (a component group) in the array. Note that 
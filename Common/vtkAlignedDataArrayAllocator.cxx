@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAlignedDataArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAlignedDataArrayAllocator.h"
+#include "vtkObjectFactory.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <malloc.h> /* _aligned_malloc */
+#else
+# include <sys/mman.h> /* madvise */
+#endif
+
+vtkStandardNewMacro(vtkAlignedDataArrayAllocator);
+
+//----------------------------------------------------------------------------
+vtkAlignedDataArrayAllocator::vtkAlignedDataArrayAllocator()
+{
+  this->Alignment = 64;
+  this->UseHugePages = 0;
+  this->HugePageSize = 2*1024*1024;
+}
+
+//----------------------------------------------------------------------------
+vtkAlignedDataArrayAllocator::~vtkAlignedDataArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedDataArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Alignment: " << this->Alignment << endl;
+  os << indent << "UseHugePages: " << this->UseHugePages << endl;
+  os << indent << "HugePageSize: " << this->HugePageSize << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedDataArrayAllocator::SetAlignment(int alignment)
+{
+  int a = static_cast<int>(sizeof(void*));
+  while (a < alignment && a < (1 << 20))
+    {
+    a <<= 1;
+    }
+  if (this->Alignment != a)
+    {
+    this->Alignment = a;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void* vtkAlignedDataArrayAllocator::Allocate(size_t size)
+{
+  size_t alignment = static_cast<size_t>(this->Alignment);
+  size_t hugePageSize = static_cast<size_t>(this->HugePageSize);
+  int hugePages = (this->UseHugePages && size >= hugePageSize);
+  if (hugePages && alignment < hugePageSize)
+    {
+    alignment = hugePageSize;
+    }
+
+  void* ptr = 0;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  ptr = _aligned_malloc(size, alignment);
+#else
+  if (posix_memalign(&ptr, alignment, size) != 0)
+    {
+    ptr = 0;
+    }
+# if defined(MADV_HUGEPAGE)
+  // Only whole huge pages can be backed by one.
+  if (ptr && hugePages)
+    {
+    madvise(ptr, size - size % hugePageSize, MADV_HUGEPAGE);
+    }
+# endif
+#endif
+  return ptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedDataArrayAllocator::Free(void* ptr, size_t)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAlignedDataArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAlignedDataArrayAllocator - aligned memory for data arrays
+// .SECTION Description
+// vtkAlignedDataArrayAllocator returns memory aligned to a power of two,
+// 64 bytes by default, so that the values of the arrays can be loaded with
+// aligned vector instructions and do not share cache lines with other
+// data.
+//
+// With UseHugePages on, allocations of at least HugePageSize bytes are
+// aligned to that size and the system is asked to back them with huge
+// pages, which reduces TLB misses when large arrays are traversed.  This
+// uses transparent huge pages on Linux and is ignored elsewhere.
+//
+// .SECTION See Also
+// vtkDataArrayAllocator vtkPooledDataArrayAllocator
+
+#ifndef __vtkAlignedDataArrayAllocator_h
+#define __vtkAlignedDataArrayAllocator_h
+
+#include "vtkDataArrayAllocator.h"
+
+class VTK_COMMON_EXPORT vtkAlignedDataArrayAllocator :
+  public vtkDataArrayAllocator
+{
+public:
+  static vtkAlignedDataArrayAllocator* New();
+  vtkTypeMacro(vtkAlignedDataArrayAllocator,vtkDataArrayAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the alignment of the memory in bytes.  It is rounded up to a
+  // power of two of at least the size of a pointer.  The default is 64.
+  virtual void SetAlignment(int alignment);
+  vtkGetMacro(Alignment, int);
+
+  // Description:
+  // Set/Get whether large allocations ask for huge pages.  The default
+  // is off.
+  vtkSetMacro(UseHugePages, int);
+  vtkGetMacro(UseHugePages, int);
+  vtkBooleanMacro(UseHugePages, int);
+
+  // Description:
+  // Set/Get the size of a huge page in bytes, a power of two, which is
+  // also the smallest allocation that asks for huge pages.  The default
+  // is 2 MiB.
+  vtkSetClampMacro(HugePageSize, int, 4096, VTK_INT_MAX);
+  vtkGetMacro(HugePageSize, int);
+
+  //BTX
+  virtual void* Allocate(size_t size);
+  virtual void Free(void* ptr, size_t size);
+  //ETX
+
+protected:
+  vtkAlignedDataArrayAllocator();
+  ~vtkAlignedDataArrayAllocator();
+
+  int Alignment;
+  int UseHugePages;
+  int HugePageSize;
+
+private:
+  vtkAlignedDataArrayAllocator(const vtkAlignedDataArrayAllocator&);  // Not implemented.
+  void operator=(const vtkAlignedDataArrayAllocator&);  // Not implemented.
+};
+
+#endif
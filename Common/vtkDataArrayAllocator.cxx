@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataArrayAllocator.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <string.h>
+
+
+vtkDataArrayAllocator *vtkDataArrayAllocator::GlobalAllocator = 0;
+
+// The allocators that were global.  Arrays may still hold memory from
+// them, so they are only deleted when the program exits.
+static vtkstd::vector<vtkDataArrayAllocator*> *vtkDataArrayAllocatorRetired = 0;
+
+//----------------------------------------------------------------------------
+// Delete the global allocators when the program exits.
+class vtkDataArrayAllocatorCleanup
+{
+public:
+  ~vtkDataArrayAllocatorCleanup()
+    {
+    vtkDataArrayAllocator::SetGlobalAllocator(0);
+    if (vtkDataArrayAllocatorRetired)
+      {
+      for (size_t i = 0; i < vtkDataArrayAllocatorRetired->size(); i++)
+        {
+        (*vtkDataArrayAllocatorRetired)[i]->UnRegister(0);
+        }
+      delete vtkDataArrayAllocatorRetired;
+      vtkDataArrayAllocatorRetired = 0;
+      }
+    }
+};
+static vtkDataArrayAllocatorCleanup vtkDataArrayAllocatorCleanupInstance;
+
+//----------------------------------------------------------------------------
+vtkDataArrayAllocator::vtkDataArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayAllocator::~vtkDataArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+}
+
+//----------------------------------------------------------------------------
+void* vtkDataArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                        size_t newSize)
+{
+  void* newPtr = this->Allocate(newSize);
+  if (!newPtr)
+    {
+    return 0;
+    }
+  memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+  this->Free(ptr, oldSize);
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayAllocator::SetGlobalAllocator(
+  vtkDataArrayAllocator* allocator)
+{
+  if (vtkDataArrayAllocator::GlobalAllocator == allocator)
+    {
+    return;
+    }
+  if (allocator)
+    {
+    allocator->Register(0);
+    }
+  vtkDataArrayAllocator* previous = vtkDataArrayAllocator::GlobalAllocator;
+  if (previous)
+    {
+    if (!vtkDataArrayAllocatorRetired)
+      {
+      vtkDataArrayAllocatorRetired =
+        new vtkstd::vector<vtkDataArrayAllocator*>;
+      }
+    if (vtkstd::find(vtkDataArrayAllocatorRetired->begin(),
+                     vtkDataArrayAllocatorRetired->end(), previous) ==
+        vtkDataArrayAllocatorRetired->end())
+      {
+      vtkDataArrayAllocatorRetired->push_back(previous);
+      }
+    else
+      {
+      previous->UnRegister(0);
+      }
+    }
+  vtkDataArrayAllocator::GlobalAllocator = allocator;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayAllocator* vtkDataArrayAllocator::GetGlobalAllocator()
+{
+  return vtkDataArrayAllocator::GlobalAllocator;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDataArrayAllocator - abstract source of memory for data arrays
+// .SECTION Description
+// vtkDataArrayAllocator is the interface through which vtkDataArrayTemplate
+// obtains the memory holding its values.  An allocator can be given to a
+// single array with vtkDataArrayTemplate::SetAllocator(), or installed for
+// all arrays that have none with SetGlobalAllocator().  When neither is
+// set, arrays use malloc, realloc and free as before.
+//
+// Subclasses implement Allocate() and Free(), and may implement
+// Reallocate() to grow or shrink memory without copying.  The size of the
+// memory is passed back to Free() and Reallocate(), so allocators do not
+// need to store it.  The methods may be called from several threads at
+// once for different arrays.
+//
+// .SECTION See Also
+// vtkAlignedDataArrayAllocator vtkPooledDataArrayAllocator
+
+#ifndef __vtkDataArrayAllocator_h
+#define __vtkDataArrayAllocator_h
+
+#include "vtkObject.h"
+
+//BTX
+class vtkDataArrayAllocatorCleanup;
+//ETX
+
+class VTK_COMMON_EXPORT vtkDataArrayAllocator : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkDataArrayAllocator,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  // Description:
+  // Allocate size bytes.  Return 0 if the memory is not available.
+  virtual void* Allocate(size_t size) = 0;
+
+  // Description:
+  // Change the size of memory returned by this allocator from oldSize to
+  // newSize bytes, keeping the first bytes.  Return the new memory, after
+  // which ptr is no longer valid, or 0 if the memory is not available, in
+  // which case ptr is unchanged.  The default implementation allocates,
+  // copies and frees.
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+
+  // Description:
+  // Release memory of the given size returned by this allocator.
+  virtual void Free(void* ptr, size_t size) = 0;
+  //ETX
+
+  // Description:
+  // Set/Get the allocator of the arrays that have none of their own.  The
+  // default is NULL, meaning malloc.  A reference is kept to the global
+  // allocator.  Arrays may still hold memory from an allocator after it is
+  // replaced, so replaced allocators are kept until the program exits.
+  // This must not be called while arrays are allocated by other threads.
+  static void SetGlobalAllocator(vtkDataArrayAllocator* allocator);
+  static vtkDataArrayAllocator* GetGlobalAllocator();
+
+protected:
+  vtkDataArrayAllocator();
+  ~vtkDataArrayAllocator();
+
+private:
+  //BTX
+  static vtkDataArrayAllocator* GlobalAllocator;
+  friend class vtkDataArrayAllocatorCleanup;
+  //ETX
+
+  vtkDataArrayAllocator(const vtkDataArrayAllocator&);  // Not implemented.
+  void operator=(const vtkDataArrayAllocator&);  // Not implemented.
+};
+
+#endif
@@ -23,6 +23,8 @@
 
 #include "vtkDataArray.h"
 
+class vtkDataArrayAllocator;
+
 template <class T>
 class vtkDataArrayTemplateLookup;
 
@@ -199,7 +201,8 @@ public:
   enum DeleteMethod
   {
     VTK_DATA_ARRAY_FREE,
-    VTK_DATA_ARRAY_DELETE
+    VTK_DATA_ARRAY_DELETE,
+    VTK_DATA_ARRAY_USER_DEFINED
   };
 //ETX
 
@@ -212,7 +215,9 @@ public:
   // suppled array. If specified, the delete method determines how the data
   // array will be deallocated. If the delete method is
   // VTK_DATA_ARRAY_FREE, free() will be used. If the delete method is
-  // DELETE, delete[] will be used. The default is FREE.
+  // DELETE, delete[] will be used. If the delete method is
+  // VTK_DATA_ARRAY_USER_DEFINED, the function given to
+  // SetArrayFreeFunction will be used. The default is FREE.
   void SetArray(T* array, vtkIdType size, int save, int deleteMethod);
   void SetArray(T* array, vtkIdType size, int save)
     { this->SetArray(array, size, save, VTK_DATA_ARRAY_FREE); }
@@ -226,6 +231,22 @@ public:
       this->SetArray(static_cast<T*>(array), size, save, deleteMethod);
     }
 
+  // Description:
+  // Set the function that releases an array given to SetArray with the
+  // VTK_DATA_ARRAY_USER_DEFINED delete method, for example memory mapped
+  // from a file.  The function is called with clientData.  SetArray
+  // clears the function, so set it after each call to SetArray.
+  void SetArrayFreeFunction(void (*callback)(void*), void* clientData);
+
+  // Description:
+  // Set/Get the allocator that provides the memory of this array.  When
+  // none is set, the global allocator of vtkDataArrayAllocator is used,
+  // or malloc if there is none.  Values that the array already holds in
+  // memory from another allocator are moved to the new one.  Arrays given
+  // with SetArray are not affected.
+  void SetAllocator(vtkDataArrayAllocator* allocator);
+  vtkGetObjectMacro(Allocator, vtkDataArrayAllocator);
+
   // Description:
   // This method copies the array data to the void pointer specified
   // by the user.  It is up to the user to allocate enough memory for
@@ -278,6 +299,13 @@ protected:
 
   int SaveUserArray;
   int DeleteMethod;
+  void (*ArrayFreeFunction)(void*);
+  void* ArrayFreeClientData;
+
+  // The allocator set for this array, and the one that provided Array
+  // if any.
+  vtkDataArrayAllocator* Allocator;
+  vtkDataArrayAllocator* ArrayAllocator;
 
   virtual void ComputeScalarRange(int comp);
   virtual void ComputeVectorRange();
@@ -289,6 +317,9 @@ private:
   void UpdateLookup();
 
   void DeleteArray();
+
+  vtkDataArrayAllocator* GetStorageAllocator();
+  T* ReallocateValues(vtkIdType newSize);
 };
 
 #if !defined(VTK_NO_EXPLICIT_TEMPLATE_INSTANTIATION)
@@ -18,6 +18,7 @@
 #include "vtkDataArrayTemplate.h"
 
 #include "vtkArrayIteratorTemplate.h"
+#include "vtkDataArrayAllocator.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationDoubleVectorKey.h"
@@ -76,6 +77,10 @@ vtkDataArrayTemplate<T>::vtkDataArrayTemplate(vtkIdType numComp):
   this->TupleSize = 0;
   this->SaveUserArray = 0;
   this->DeleteMethod = VTK_DATA_ARRAY_FREE;
+  this->ArrayFreeFunction = 0;
+  this->ArrayFreeClientData = 0;
+  this->Allocator = 0;
+  this->ArrayAllocator = 0;
   this->Lookup = 0;
   this->ValueRange[0] = 0;
   this->ValueRange[1] = 1;
@@ -86,6 +91,10 @@ template <class T>
 vtkDataArrayTemplate<T>::~vtkDataArrayTemplate()
 {
   this->DeleteArray();
+  if(this->Allocator)
+    {
+    this->Allocator->UnRegister(this);
+    }
   if(this->Tuple)
     {
     free(this->Tuple);
@@ -121,6 +130,130 @@ void vtkDataArrayTemplate<T>::SetArray(T* array,
   this->DataChanged();
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::SetArrayFreeFunction(void (*callback)(void*),
+                                                   void* clientData)
+{
+  this->ArrayFreeFunction = callback;
+  this->ArrayFreeClientData = clientData;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::SetAllocator(vtkDataArrayAllocator* allocator)
+{
+  if(this->Allocator == allocator)
+    {
+    return;
+    }
+  vtkDataArrayAllocator* oldAllocator = this->Allocator;
+  this->Allocator = allocator;
+  if(allocator)
+    {
+    allocator->Register(this);
+    }
+
+  // Move the values away from the previous allocator while it is alive.
+  if(this->ArrayAllocator &&
+     this->ArrayAllocator != this->GetStorageAllocator() &&
+     !this->ReallocateValues(this->Size))
+    {
+    vtkErrorMacro("Unable to allocate " << this->Size
+                  << " elements of size " << sizeof(T)
+                  << " bytes. ");
+    this->Initialize();
+    }
+
+  if(oldAllocator)
+    {
+    oldAllocator->UnRegister(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+// Return the allocator that new storage comes from, or 0 for malloc.
+template <class T>
+vtkDataArrayAllocator* vtkDataArrayTemplate<T>::GetStorageAllocator()
+{
+  return (this->Allocator ? this->Allocator :
+          vtkDataArrayAllocator::GetGlobalAllocator());
+}
+
+//----------------------------------------------------------------------------
+// Move the values to storage of newSize values from the allocator of the
+// array, resizing the current storage in place when it comes from the
+// same allocator.  Return the new storage, or 0 if it cannot be
+// allocated, in which case the array is unchanged.  Size is not updated.
+template <class T>
+T* vtkDataArrayTemplate<T>::ReallocateValues(vtkIdType newSize)
+{
+  vtkDataArrayAllocator* allocator = this->GetStorageAllocator();
+  size_t newBytes = static_cast<size_t>(newSize)*sizeof(T);
+  T* newArray;
+
+  // OS X's realloc does not free memory if the new block is smaller.  This
+  // is a very serious problem and causes huge amount of memory to be
+  // wasted. Do not use realloc on the Mac.
+  bool dontUseRealloc=false;
+  #if defined __APPLE__
+  dontUseRealloc=true;
+  #endif
+
+  if(this->Array && allocator && this->ArrayAllocator == allocator)
+    {
+    // Let the allocator resize its own memory.
+    newArray = static_cast<T*>(
+      allocator->Reallocate(this->Array,
+                            static_cast<size_t>(this->Size)*sizeof(T),
+                            newBytes));
+    if(!newArray)
+      {
+      return 0;
+      }
+    }
+  else if (!this->Array
+           || allocator
+           || this->ArrayAllocator
+           || this->SaveUserArray
+           || this->DeleteMethod!=VTK_DATA_ARRAY_FREE
+           || dontUseRealloc)
+    {
+    newArray = static_cast<T*>(allocator ? allocator->Allocate(newBytes) :
+                               malloc(newBytes));
+    if(!newArray)
+      {
+      return 0;
+      }
+
+    // Copy the data from the old array.
+    if(this->Array)
+      {
+      memcpy(newArray, this->Array,
+             static_cast<size_t>(newSize < this->Size ? newSize : this->Size)
+             * sizeof(T));
+      }
+
+    // Realease old array if we own
+    this->DeleteArray();
+    this->ArrayAllocator = allocator;
+    }
+  else
+    {
+    // Try to reallocate with minimal memory usage and possibly avoid
+    // copying.
+    newArray = static_cast<T*>(realloc(this->Array, newBytes));
+    if(!newArray)
+      {
+      return 0;
+      }
+    }
+
+  this->Array = newArray;
+  return newArray;
+}
+
 //----------------------------------------------------------------------------
 // Allocate memory for this array. Delete old storage only if necessary.
 template <class T>
@@ -135,9 +268,7 @@ int vtkDataArrayTemplate<T>::Allocate(vtkIdType sz, vtkIdType)
     this->Size = 0;
 
     vtkIdType newSize = (sz > 0 ? sz : 1);
-    this->Array = static_cast<T*>(malloc(static_cast<size_t>(newSize)
-                                         * sizeof(T)));
-    if(this->Array==0)
+    if(!this->ReallocateValues(newSize))
       {
       vtkErrorMacro("Unable to allocate " << newSize
                     << " elements of size " << sizeof(T)
@@ -206,9 +337,7 @@ void vtkDataArrayTemplate<T>::DeepCopy(vtkDataArray* fa)
   this->Size = fa->GetSize();
 
   this->Size = (this->Size > 0 ? this->Size : 1);
-  this->Array = static_cast<T* >(
-    malloc(static_cast<size_t>(this->Size) * sizeof(T)));
-  if(this->Array==0)
+  if(!this->ReallocateValues(this->Size))
     {
     vtkErrorMacro("Unable to allocate " << this->Size
                   << " elements of size " << sizeof(T)
@@ -251,25 +380,48 @@ void vtkDataArrayTemplate<T>::PrintSelf(ostream& os, vtkIndent indent)
     {
     osw << indent << "Array: (null)\n";
     }
+  if(this->Allocator)
+    {
+    osw << indent << "Allocator: " << this->Allocator << "\n";
+    }
+  else
+    {
+    osw << indent << "Allocator: (none)\n";
+    }
 }
 
 //----------------------------------------------------------------------------
 template <class T>
 void vtkDataArrayTemplate<T>::DeleteArray()
 {
-  if ((this->Array) && (!this->SaveUserArray))
+  if (this->ArrayAllocator)
+    {
+    if (this->Array)
+      {
+      this->ArrayAllocator->Free(this->Array,
+                                 static_cast<size_t>(this->Size)*sizeof(T));
+      }
+    }
+  else if ((this->Array) && (!this->SaveUserArray))
     {
     if (this->DeleteMethod == VTK_DATA_ARRAY_FREE)
       {
       free(this->Array);
       }
-    else
+    else if (this->DeleteMethod == VTK_DATA_ARRAY_DELETE)
       {
       delete[] this->Array;
       }
+    else if (this->ArrayFreeFunction)
+      {
+      this->ArrayFreeFunction(this->ArrayFreeClientData);
+      }
     }
   this->SaveUserArray = 0;
   this->DeleteMethod = VTK_DATA_ARRAY_FREE;
+  this->ArrayFreeFunction = 0;
+  this->ArrayFreeClientData = 0;
+  this->ArrayAllocator = 0;
   this->Array = 0;
 }
 
@@ -307,69 +459,23 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz, bool useExactSize)
     return 0;
     }
 
-  // OS X's realloc does not free memory if the new block is smaller.  This
-  // is a very serious problem and causes huge amount of memory to be
-  // wasted. Do not use realloc on the Mac.
-  bool dontUseRealloc=false;
-  #if defined __APPLE__
-  dontUseRealloc=true;
-  #endif
-
   // Allocate the new array or reallocate the old.
-  if (this->Array
-      &&
-      (this->SaveUserArray
-       || this->DeleteMethod==VTK_DATA_ARRAY_DELETE
-       || dontUseRealloc ))
-    {
-    newArray = static_cast<T*>(malloc(static_cast<size_t>(newSize)*sizeof(T)));
-    if(!newArray)
-      {
-      vtkErrorMacro("Unable to allocate " << newSize
-                    << " elements of size " << sizeof(T)
-                    << " bytes. ");
-      #if !defined NDEBUG
-      // We're debugging, crash here preserving the stack
-      abort();
-      #elif !defined VTK_DONT_THROW_BAD_ALLOC
-      // We can throw something that has universal meaning
-      throw vtkstd::bad_alloc();
-      #else
-      // We indicate that malloc failed by return
-      return 0;
-      #endif
-      }
-
-    // Copy the data from the old array.
-    memcpy(newArray, this->Array,
-           static_cast<size_t>(newSize < this->Size ? newSize : this->Size)
-           * sizeof(T));
-
-    // Realease old array if we own
-    this->DeleteArray();
-    }
-  else
+  newArray = this->ReallocateValues(newSize);
+  if(!newArray)
     {
-    // Try to reallocate with minimal memory usage and possibly avoid
-    // copying.
-    newArray = static_cast<T*>(
-      realloc(this->Array,static_cast<size_t>(newSize)*sizeof(T)));
-    if(!newArray)
-      {
-      vtkErrorMacro("Unable to allocate " << newSize
-                    << " elements of size " << sizeof(T)
-                    << " bytes. ");
-      #if !defined NDEBUG
-      // We're debugging, crash here preserving the stack
-      abort();
-      #elif !defined VTK_DONT_THROW_BAD_ALLOC
-      // We can throw something that has universal meaning
-      throw vtkstd::bad_alloc();
-      #else
-      // We indicate that malloc failed by return
-      return 0;
-      #endif
-      }
+    vtkErrorMacro("Unable to allocate " << newSize
+                  << " elements of size " << sizeof(T)
+                  << " bytes. ");
+    #if !defined NDEBUG
+    // We're debugging, crash here preserving the stack
+    abort();
+    #elif !defined VTK_DONT_THROW_BAD_ALLOC
+    // We can throw something that has universal meaning
+    throw vtkstd::bad_alloc();
+    #else
+    // We indicate that malloc failed by return
+    return 0;
+    #endif
     }
 
   // Allocation was successful.  Save it.
@@ -14,9 +14,11 @@
 =========================================================================*/
 #include "vtkGarbageCollector.h"
 
+#include "vtkCriticalSection.h"
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointerBase.h"
+#include "vtkTimerLog.h"
 
 #include <vtksys/ios/sstream>
 #include <vtkstd/queue>
@@ -168,6 +170,9 @@ public:
   // Called by GiveReference to decide whether to accept a reference.
   int CheckAccept();
 
+  // Enable/disable batched collection.
+  void SetBatchedCollection(int flag);
+
   // Push/Pop deferred collection.
   void DeferredCollectionPush();
   void DeferredCollectionPop();
@@ -187,6 +192,56 @@ public:
   // The number of times DeferredCollectionPush has been called not
   // matched by a DeferredCollectionPop.
   int DeferredCollectionCount;
+
+  // Whether references are always accepted and collected only on
+  // demand.
+  int BatchedCollection;
+
+  // The number of nested collections in the main thread.  Only the
+  // outermost one is timed.
+  int CollectionDepth;
+
+  // Collection statistics.  Collections may happen in any thread so
+  // these are protected by a lock.
+  vtkSimpleCriticalSection StatisticsLock;
+  vtkIdType NumberOfCollections;
+  vtkIdType NumberOfVisitedObjects;
+  vtkIdType NumberOfCollectedObjects;
+  double CollectionTime;
+};
+
+//----------------------------------------------------------------------------
+// Time the outermost collection of the main thread.
+class vtkGarbageCollectorTimer
+{
+public:
+  vtkGarbageCollectorTimer()
+    {
+    this->Singleton = 0;
+    if(vtkGarbageCollectorIsMainThread())
+      {
+      this->Singleton = vtkGarbageCollectorSingletonInstance;
+      }
+    this->StartTime = 0.0;
+    if(this->Singleton && this->Singleton->CollectionDepth++ == 0)
+      {
+      this->StartTime = vtkTimerLog::GetUniversalTime();
+      }
+    }
+  ~vtkGarbageCollectorTimer()
+    {
+    if(this->Singleton && --this->Singleton->CollectionDepth == 0)
+      {
+      double elapsed = vtkTimerLog::GetUniversalTime() - this->StartTime;
+      this->Singleton->StatisticsLock.Lock();
+      this->Singleton->CollectionTime += elapsed;
+      this->Singleton->StatisticsLock.Unlock();
+      }
+    }
+
+private:
+  vtkGarbageCollectorSingleton* Singleton;
+  double StartTime;
 };
 
 //----------------------------------------------------------------------------
@@ -210,6 +265,10 @@ public:
   // Perform a collection check.
   void CollectInternal(vtkObjectBase* root);
 
+  // Perform a collection check starting from the objects whose
+  // collection was deferred until at least maximumNumberOfObjects
+  // objects have been visited, or from all of them if it is 0.
+  void CollectDeferred(int maximumNumberOfObjects);
 
 // Sun's compiler is broken and does not allow access to protected members from
 // nested class
@@ -340,6 +399,9 @@ public:
   // Count for visit order of Tarjan's algorithm.
   int VisitCount;
 
+  // The number of objects deleted by this collector.
+  int NumberOfCollectedObjects;
+
   // The singleton instance from which to take references when passing
   // references to the entries.
   vtkGarbageCollectorSingleton* Singleton;
@@ -351,6 +413,10 @@ public:
   // strongly connected components.
   void FindComponents(vtkObjectBase* root);
 
+  // Delete the leaked components found by the walk and release the
+  // references held on the others.
+  void CollectLeaked();
+
   // Get the entry for the given object.  This may visit the object.
   Entry* MaybeVisit(vtkObjectBase*);
 
@@ -410,6 +476,7 @@ vtkGarbageCollectorImpl::vtkGarbageCollectorImpl()
   this->VisitCount = 0;
   this->Current = 0;
   this->NumberOfComponents = 0;
+  this->NumberOfCollectedObjects = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -420,6 +487,17 @@ vtkGarbageCollectorImpl::~vtkGarbageCollectorImpl()
   assert(this->Stack.empty());
   assert(this->LeakedComponents.empty());
 
+  // Record statistics of this collection.
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    ++singleton->NumberOfCollections;
+    singleton->NumberOfVisitedObjects += this->Visited.size();
+    singleton->NumberOfCollectedObjects += this->NumberOfCollectedObjects;
+    singleton->StatisticsLock.Unlock();
+    }
+
   // Clear component list.
   for(ComponentsType::iterator c = this->ReferencedComponents.begin();
       c != this->ReferencedComponents.end(); ++c)
@@ -458,6 +536,46 @@ void vtkGarbageCollectorImpl::CollectInternal(vtkObjectBase* root)
   // Identify strong components.
   this->FindComponents(root);
 
+  // Delete the leaked ones.
+  this->CollectLeaked();
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollectorImpl::CollectDeferred(int maximumNumberOfObjects)
+{
+  if(this->Singleton)
+    {
+    // Save the deferred objects first because visiting an object takes
+    // its references from the singleton.
+    vtkstd::vector<vtkObjectBase*> roots;
+    roots.reserve(this->Singleton->References.size());
+    for(ReferencesType::iterator i = this->Singleton->References.begin();
+        i != this->Singleton->References.end(); ++i)
+      {
+      roots.push_back(i->first);
+      }
+
+    // Walk from the deferred objects in one pass.  Nothing is deleted
+    // until the walk is over, so all of the roots stay valid.
+    for(vtkstd::vector<vtkObjectBase*>::iterator r = roots.begin();
+        r != roots.end(); ++r)
+      {
+      if(maximumNumberOfObjects > 0 &&
+         this->Visited.size() >= static_cast<size_t>(maximumNumberOfObjects))
+        {
+        break;
+        }
+      this->FindComponents(*r);
+      }
+    }
+
+  // Delete the leaked ones.
+  this->CollectLeaked();
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollectorImpl::CollectLeaked()
+{
   // Delete all the leaked components.
   while(!this->LeakedComponents.empty())
     {
@@ -652,6 +770,7 @@ void vtkGarbageCollectorImpl::CollectComponent(ComponentType* c)
 
   // Print out the component for debugging.
   this->PrintComponent(c);
+  this->NumberOfCollectedObjects += static_cast<int>(c->size());
 
   // Get an extra reference to all objects in the component so that
   // they are not deleted until all references are removed.
@@ -854,6 +973,13 @@ void vtkGarbageCollector::ClassInitialize()
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::ClassFinalize()
 {
+  // Collect the checks that are still batched.
+  if(vtkGarbageCollectorSingletonInstance &&
+     vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
+    {
+    vtkGarbageCollector::Collect();
+    }
+
   // We are done with the singleton.  Delete it and reset the pointer.
   // Other singletons may still cause garbage collection of VTK
   // objects, they just will not have the option of deferred
@@ -876,22 +1002,49 @@ void vtkGarbageCollector::Collect()
   // This must be called only from the main thread.
   assert(vtkGarbageCollectorIsMainThread());
 
-  // Keep collecting until no deferred checks exist.
+  vtkGarbageCollectorTimer timer;
+
+  // Keep collecting until no deferred checks exist.  Deleting leaked
+  // objects may defer new checks.
   while(vtkGarbageCollectorSingletonInstance &&
         vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
     {
-    // Collect starting from one deferred object at a time.  Each
-    // check will remove at least the starting object and possibly
-    // other objects from the singleton's references.
-    vtkObjectBase* root =
-      vtkGarbageCollectorSingletonInstance->References.begin()->first;
-    vtkGarbageCollector::Collect(root);
+    // Collect starting from all deferred objects.  Each check removes
+    // all of them from the singleton's references.
+    vtkGarbageCollectorImpl collector;
+    vtkDebugWithObjectMacro((&collector), "Starting collection check.");
+    collector.CollectDeferred(0);
+    vtkDebugWithObjectMacro((&collector), "Finished collection check.");
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::CollectIncrementally(int maximumNumberOfObjects)
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
+
+  if(vtkGarbageCollectorSingletonInstance &&
+     vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
+    {
+    vtkGarbageCollectorTimer timer;
+
+    // Collect starting from some of the deferred objects.  At least
+    // one of them is always walked so repeated calls make progress.
+    vtkGarbageCollectorImpl collector;
+    vtkDebugWithObjectMacro((&collector), "Starting collection check.");
+    collector.CollectDeferred(maximumNumberOfObjects > 0 ?
+                              maximumNumberOfObjects : 1);
+    vtkDebugWithObjectMacro((&collector), "Finished collection check.");
+    }
+  return vtkGarbageCollector::GetNumberOfDeferredObjects();
+}
+
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::Collect(vtkObjectBase* root)
 {
+  vtkGarbageCollectorTimer timer;
+
   // Create a collector instance.
   vtkGarbageCollectorImpl collector;
 
@@ -903,6 +1056,108 @@ void vtkGarbageCollector::Collect(vtkObjectBase* root)
   vtkDebugWithObjectMacro((&collector), "Finished collection check.");
 }
 
+//----------------------------------------------------------------------------
+void vtkGarbageCollector::SetBatchedCollection(int flag)
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
+
+  // Forward the call to the singleton.
+  if(vtkGarbageCollectorSingletonInstance)
+    {
+    vtkGarbageCollectorSingletonInstance->SetBatchedCollection(flag);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::GetBatchedCollection()
+{
+  return (vtkGarbageCollectorSingletonInstance &&
+          vtkGarbageCollectorSingletonInstance->BatchedCollection);
+}
+
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::GetNumberOfDeferredObjects()
+{
+  if(vtkGarbageCollectorSingletonInstance)
+    {
+    return static_cast<int>(
+      vtkGarbageCollectorSingletonInstance->References.size());
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkGarbageCollector::GetNumberOfCollections()
+{
+  vtkIdType n = 0;
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    n = singleton->NumberOfCollections;
+    singleton->StatisticsLock.Unlock();
+    }
+  return n;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkGarbageCollector::GetNumberOfVisitedObjects()
+{
+  vtkIdType n = 0;
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    n = singleton->NumberOfVisitedObjects;
+    singleton->StatisticsLock.Unlock();
+    }
+  return n;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkGarbageCollector::GetNumberOfCollectedObjects()
+{
+  vtkIdType n = 0;
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    n = singleton->NumberOfCollectedObjects;
+    singleton->StatisticsLock.Unlock();
+    }
+  return n;
+}
+
+//----------------------------------------------------------------------------
+double vtkGarbageCollector::GetCollectionTime()
+{
+  double t = 0.0;
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    t = singleton->CollectionTime;
+    singleton->StatisticsLock.Unlock();
+    }
+  return t;
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollector::ResetStatistics()
+{
+  if(vtkGarbageCollectorSingleton* singleton =
+     vtkGarbageCollectorSingletonInstance)
+    {
+    singleton->StatisticsLock.Lock();
+    singleton->NumberOfCollections = 0;
+    singleton->NumberOfVisitedObjects = 0;
+    singleton->NumberOfCollectedObjects = 0;
+    singleton->CollectionTime = 0.0;
+    singleton->StatisticsLock.Unlock();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::DeferredCollectionPush()
 {
@@ -968,6 +1223,12 @@ vtkGarbageCollectorSingleton::vtkGarbageCollectorSingleton()
 {
   this->TotalNumberOfReferences = 0;
   this->DeferredCollectionCount = 0;
+  this->BatchedCollection = 0;
+  this->CollectionDepth = 0;
+  this->NumberOfCollections = 0;
+  this->NumberOfVisitedObjects = 0;
+  this->NumberOfCollectedObjects = 0;
+  this->CollectionTime = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -1034,13 +1295,26 @@ int vtkGarbageCollectorSingleton::CheckAccept()
   // construction.  We do not want to perform deferred collection
   // while an object is under construction because the reference walk
   // might call ReportReferences on a partially constructed object!
-  return this->DeferredCollectionCount > 0;
+  // Batched collection is safe for the same reason: it collects only
+  // when asked to.
+  return this->DeferredCollectionCount > 0 || this->BatchedCollection;
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollectorSingleton::SetBatchedCollection(int flag)
+{
+  this->BatchedCollection = flag? 1:0;
+  if(!this->BatchedCollection && this->DeferredCollectionCount <= 0)
+    {
+    // Batching is disabled.  Collect the batched checks now.
+    vtkGarbageCollector::Collect();
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 {
-  if(++this->DeferredCollectionCount <= 0)
+  if(++this->DeferredCollectionCount <= 0 && !this->BatchedCollection)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -1050,7 +1324,7 @@ void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPop()
 {
-  if(--this->DeferredCollectionCount <= 0)
+  if(--this->DeferredCollectionCount <= 0 && !this->BatchedCollection)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -106,7 +106,9 @@ public:
   // are held by objects in the original component.  These removed
   // references are handled as any other and their corresponding
   // checks may be deferred.  This method keeps collecting until no
-  // deferred collection checks remain.
+  // deferred collection checks remain.  All deferred objects are walked
+  // in a single pass so objects reachable from several of them are
+  // visited only once.
   static void Collect();
 
   // Description:
@@ -135,6 +137,46 @@ public:
   static void SetGlobalDebugFlag(int flag);
   static int GetGlobalDebugFlag();
 
+  // Description:
+  // Set/Get whether collection checks are batched.  When on, every
+  // release from the main thread of a reference to an object that
+  // participates in garbage collection is handed to the collector
+  // instead of walking the reference graph, whether or not the object
+  // is in a reference loop.  The check is done by the next call to
+  // Collect() or CollectIncrementally().  This makes tearing down large
+  // pipelines much cheaper, but the collector keeps the references it
+  // is handed, so such objects, and the data they hold, can stay alive
+  // until the application collects even after every other holder has
+  // released them.  Only releasing the very last reference deletes an
+  // object right away.  Turning batching off collects all batched
+  // checks.  Off by default.
+  static void SetBatchedCollection(int flag);
+  static int GetBatchedCollection();
+
+  // Description:
+  // Collect using some of the objects whose collection was deferred or
+  // batched as roots.  Reference graph walks are started from these
+  // objects until at least maximumNumberOfObjects objects have been
+  // visited.  The remaining checks are kept for later calls.  Returns
+  // the number of objects whose collection is still deferred.
+  static int CollectIncrementally(int maximumNumberOfObjects);
+
+  // Description:
+  // Get the number of objects whose collection is deferred or batched.
+  static int GetNumberOfDeferredObjects();
+
+  // Description:
+  // Get statistics of the collections done since the program started or
+  // the last call to ResetStatistics(): the number of reference graph
+  // walks, the number of objects they visited, the number of objects
+  // deleted, and the time in seconds spent by the collections of the
+  // main thread.
+  static vtkIdType GetNumberOfCollections();
+  static vtkIdType GetNumberOfVisitedObjects();
+  static vtkIdType GetNumberOfCollectedObjects();
+  static double GetCollectionTime();
+  static void ResetStatistics();
+
 protected:
   vtkGarbageCollector();
   ~vtkGarbageCollector();
@@ -16,6 +16,7 @@
 
 #include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkThreadPool.h"
 #include "vtkWindows.h"
 
 vtkStandardNewMacro(vtkMultiThreader);
@@ -143,6 +144,36 @@ int vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
   return vtkMultiThreaderGlobalDefaultNumberOfThreads;
 }
 
+// Initialize static member that controls whether new threaders use the pool
+static int vtkMultiThreaderGlobalDefaultUseThreadPool = 0;
+
+void vtkMultiThreader::SetGlobalDefaultUseThreadPool(int val)
+{
+  vtkMultiThreaderGlobalDefaultUseThreadPool = val;
+}
+
+int vtkMultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  return vtkMultiThreaderGlobalDefaultUseThreadPool;
+}
+
+// Data handed to the thread pool by SingleMethodExecute
+struct vtkMultiThreaderPoolData
+{
+  vtkThreadFunctionType Method;
+  vtkMultiThreader::ThreadInfo *ThreadInfoArray;
+};
+
+static void vtkMultiThreaderPoolExecute(vtkIdType begin, vtkIdType end,
+                                        int, void *data)
+{
+  vtkMultiThreaderPoolData *pd = static_cast<vtkMultiThreaderPoolData *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    pd->Method((void *)(&pd->ThreadInfoArray[i]));
+    }
+}
+
 // Constructor. Default all the methods to NULL. Since the
 // ThreadInfoArray is static, the ThreadIDs can be initialized here
 // and will not change.
@@ -164,6 +195,7 @@ vtkMultiThreader::vtkMultiThreader()
   this->SingleMethod = NULL;
   this->NumberOfThreads = 
     vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->UseThreadPool = vtkMultiThreaderGlobalDefaultUseThreadPool;
 
 }
 
@@ -258,7 +290,22 @@ void vtkMultiThreader::SingleMethodExecute()
     {
     this->NumberOfThreads = vtkMultiThreaderGlobalMaximumNumberOfThreads;
     }
-  
+
+  // Hand the invocations to the persistent pool threads
+  if ( this->UseThreadPool && this->NumberOfThreads > 1 )
+    {
+    for ( thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++ )
+      {
+      this->ThreadInfoArray[thread_loop].UserData        = this->SingleData;
+      this->ThreadInfoArray[thread_loop].NumberOfThreads = this->NumberOfThreads;
+      }
+    vtkMultiThreaderPoolData pd;
+    pd.Method = this->SingleMethod;
+    pd.ThreadInfoArray = this->ThreadInfoArray;
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, this->NumberOfThreads, 1, vtkMultiThreaderPoolExecute, &pd);
+    return;
+    }
     
   // We are using sproc (on SGIs), pthreads(on Suns), or a single thread
   // (the default)  
@@ -829,6 +876,7 @@ void vtkMultiThreader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Thread Count: " << this->NumberOfThreads << "\n";
   os << indent << "Global Maximum Number Of Threads: " << 
     vtkMultiThreaderGlobalMaximumNumberOfThreads << endl;
+  os << indent << "Use Thread Pool: " << this->UseThreadPool << endl;
   os << "Thread system used: " <<
 #ifdef VTK_USE_PTHREADS  
    "PTHREADS"
@@ -18,6 +18,10 @@
 // execution using sproc() on an SGI, or pthread_create on any platform
 // supporting POSIX threads.  This class can be used to execute a single
 // method on multiple threads, or to specify a method per thread. 
+//
+// When UseThreadPool is on, SingleMethodExecute() runs the method on the
+// persistent threads of vtkThreadPool::GetGlobalPool() instead of creating
+// and joining new threads on every call.
 
 #ifndef __vtkMultiThreader_h
 #define __vtkMultiThreader_h
@@ -138,6 +142,20 @@ public:
   static void SetGlobalDefaultNumberOfThreads(int val);
   static int  GetGlobalDefaultNumberOfThreads();
 
+  // Description:
+  // When on, SingleMethodExecute() hands the NumberOfThreads invocations
+  // of the single method to the global vtkThreadPool as tasks.  The pool
+  // threads are reused between calls and nested calls share them, but the
+  // invocations are no longer guaranteed to run at the same time, so the
+  // single method must not wait for its siblings.  MultipleMethodExecute()
+  // and SpawnThread() are not affected.  Initialized from
+  // GetGlobalDefaultUseThreadPool(), which is off by default.
+  vtkSetMacro(UseThreadPool, int);
+  vtkGetMacro(UseThreadPool, int);
+  vtkBooleanMacro(UseThreadPool, int);
+  static void SetGlobalDefaultUseThreadPool(int val);
+  static int  GetGlobalDefaultUseThreadPool();
+
   // These methods are excluded from Tcl wrapping 1) because the
   // wrapper gives up on them and 2) because they really shouldn't be
   // called from a script anyway.
@@ -197,6 +215,9 @@ protected:
   // The number of threads to use
   int                        NumberOfThreads;
 
+  // Run SingleMethodExecute on the global thread pool
+  int                        UseThreadPool;
+
   // An array of thread info containing a thread id
   // (0, 1, 2, .. VTK_MAX_THREADS-1), the thread count, and a pointer
   // to void so that user data can be passed to each thread
@@ -20,8 +20,53 @@
 
 #include <vtksys/ios/sstream>
 
+#if defined(_WIN32)
+# include "vtkWindows.h"
+#elif !defined(__GNUC__)
+# include "vtkCriticalSection.h"
+#endif
+
 #define vtkBaseDebugMacro(x)
 
+// Reference counts are changed atomically: the threaded pipeline executes
+// independent branches at the same time, and their filters register the
+// arrays of the inputs they share.
+#if defined(_WIN32)
+static inline int vtkObjectBaseIncrement(int* count)
+{
+  return InterlockedIncrement(reinterpret_cast<long*>(count));
+}
+static inline int vtkObjectBaseDecrement(int* count)
+{
+  return InterlockedDecrement(reinterpret_cast<long*>(count));
+}
+#elif defined(__GNUC__)
+static inline int vtkObjectBaseIncrement(int* count)
+{
+  return __sync_add_and_fetch(count, 1);
+}
+static inline int vtkObjectBaseDecrement(int* count)
+{
+  return __sync_sub_and_fetch(count, 1);
+}
+#else
+static vtkSimpleCriticalSection vtkObjectBaseReferenceCountLock;
+static inline int vtkObjectBaseIncrement(int* count)
+{
+  vtkObjectBaseReferenceCountLock.Lock();
+  int result = ++(*count);
+  vtkObjectBaseReferenceCountLock.Unlock();
+  return result;
+}
+static inline int vtkObjectBaseDecrement(int* count)
+{
+  vtkObjectBaseReferenceCountLock.Lock();
+  int result = --(*count);
+  vtkObjectBaseReferenceCountLock.Unlock();
+  return result;
+}
+#endif
+
 class vtkObjectBaseToGarbageCollectorFriendship
 {
 public:
@@ -245,7 +290,7 @@ void vtkObjectBase::RegisterInternal(vtkObjectBase*, int check)
   if(!(check &&
        vtkObjectBaseToGarbageCollectorFriendship::TakeReference(this)))
     {
-    ++this->ReferenceCount;
+    vtkObjectBaseIncrement(&this->ReferenceCount);
     }
 }
 
@@ -261,7 +306,7 @@ void vtkObjectBase::UnRegisterInternal(vtkObjectBase*, int check)
     }
 
   // Decrement the reference count, delete object if count goes to zero.
-  if(--this->ReferenceCount <= 0)
+  if(vtkObjectBaseDecrement(&this->ReferenceCount) <= 0)
     {
     // Clear all weak pointers to the object before deleting it.
     if (this->WeakPointers)
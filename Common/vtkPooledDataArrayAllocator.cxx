@@ -0,0 +1,194 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPooledDataArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPooledDataArrayAllocator.h"
+#include "vtkCriticalSection.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/vector>
+
+#include <stdlib.h>
+
+vtkStandardNewMacro(vtkPooledDataArrayAllocator);
+
+// The size classes are the powers of two from 2^VTK_POOL_MIN_CLASS to
+// 2^VTK_POOL_MAX_CLASS bytes.  The limits are fixed because the class of
+// a block is found again from its size when it is freed.
+#define VTK_POOL_MIN_CLASS 4
+#define VTK_POOL_MAX_CLASS 18
+#define VTK_POOL_NUMBER_OF_CLASSES (VTK_POOL_MAX_CLASS - VTK_POOL_MIN_CLASS + 1)
+
+//----------------------------------------------------------------------------
+class vtkPooledDataArrayAllocatorInternals
+{
+public:
+  vtkPooledDataArrayAllocatorInternals() :
+    FreeLists(VTK_POOL_NUMBER_OF_CLASSES), CachedSize(0), ReusedBlocks(0)
+    {
+    }
+
+  vtkstd::vector<vtkstd::vector<void*> > FreeLists;
+  vtkIdType CachedSize;
+  vtkIdType ReusedBlocks;
+  vtkSimpleCriticalSection Lock;
+};
+
+//----------------------------------------------------------------------------
+// Return the size class of a request, or -1 if it is not pooled.
+static inline int vtkPooledDataArrayAllocatorClass(size_t size)
+{
+  if (size > (static_cast<size_t>(1) << VTK_POOL_MAX_CLASS))
+    {
+    return -1;
+    }
+  int c = 0;
+  while ((static_cast<size_t>(1) << (c + VTK_POOL_MIN_CLASS)) < size)
+    {
+    c++;
+    }
+  return c;
+}
+
+//----------------------------------------------------------------------------
+vtkPooledDataArrayAllocator::vtkPooledDataArrayAllocator()
+{
+  this->MaximumCachedSize = 64*1024*1024;
+  this->Internals = new vtkPooledDataArrayAllocatorInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkPooledDataArrayAllocator::~vtkPooledDataArrayAllocator()
+{
+  this->ReleaseMemory();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPooledDataArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "MaximumCachedSize: " << this->MaximumCachedSize << endl;
+  os << indent << "CachedSize: " << this->GetCachedSize() << endl;
+  os << indent << "NumberOfReusedBlocks: "
+     << this->GetNumberOfReusedBlocks() << endl;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPooledDataArrayAllocator::GetMaximumPooledSize()
+{
+  return static_cast<size_t>(1) << VTK_POOL_MAX_CLASS;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPooledDataArrayAllocator::GetCachedSize()
+{
+  this->Internals->Lock.Lock();
+  vtkIdType size = this->Internals->CachedSize;
+  this->Internals->Lock.Unlock();
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPooledDataArrayAllocator::GetNumberOfReusedBlocks()
+{
+  this->Internals->Lock.Lock();
+  vtkIdType count = this->Internals->ReusedBlocks;
+  this->Internals->Lock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkPooledDataArrayAllocator::ReleaseMemory()
+{
+  this->Internals->Lock.Lock();
+  for (int c = 0; c < VTK_POOL_NUMBER_OF_CLASSES; c++)
+    {
+    vtkstd::vector<void*>& freeList = this->Internals->FreeLists[c];
+    for (size_t i = 0; i < freeList.size(); i++)
+      {
+      free(freeList[i]);
+      }
+    freeList.clear();
+    }
+  this->Internals->CachedSize = 0;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void* vtkPooledDataArrayAllocator::Allocate(size_t size)
+{
+  int c = vtkPooledDataArrayAllocatorClass(size);
+  if (c < 0)
+    {
+    return malloc(size);
+    }
+
+  // Take a block from the free list of the class if there is one.
+  size_t blockSize = static_cast<size_t>(1) << (c + VTK_POOL_MIN_CLASS);
+  this->Internals->Lock.Lock();
+  vtkstd::vector<void*>& freeList = this->Internals->FreeLists[c];
+  if (!freeList.empty())
+    {
+    void* ptr = freeList.back();
+    freeList.pop_back();
+    this->Internals->CachedSize -= static_cast<vtkIdType>(blockSize);
+    this->Internals->ReusedBlocks++;
+    this->Internals->Lock.Unlock();
+    return ptr;
+    }
+  this->Internals->Lock.Unlock();
+
+  return malloc(blockSize);
+}
+
+//----------------------------------------------------------------------------
+void* vtkPooledDataArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                              size_t newSize)
+{
+  int oldClass = vtkPooledDataArrayAllocatorClass(oldSize);
+  int newClass = vtkPooledDataArrayAllocatorClass(newSize);
+  if (oldClass < 0 && newClass < 0)
+    {
+    return realloc(ptr, newSize);
+    }
+  if (oldClass == newClass)
+    {
+    // The block already has the size of the class.
+    return ptr;
+    }
+  return this->Superclass::Reallocate(ptr, oldSize, newSize);
+}
+
+//----------------------------------------------------------------------------
+void vtkPooledDataArrayAllocator::Free(void* ptr, size_t size)
+{
+  int c = vtkPooledDataArrayAllocatorClass(size);
+  if (c >= 0)
+    {
+    // Keep the block if the cache has room for it.
+    vtkIdType blockSize =
+      static_cast<vtkIdType>(1) << (c + VTK_POOL_MIN_CLASS);
+    this->Internals->Lock.Lock();
+    if (this->Internals->CachedSize + blockSize <= this->MaximumCachedSize)
+      {
+      this->Internals->FreeLists[c].push_back(ptr);
+      this->Internals->CachedSize += blockSize;
+      this->Internals->Lock.Unlock();
+      return;
+      }
+    this->Internals->Lock.Unlock();
+    }
+  free(ptr);
+}
@@ -0,0 +1,96 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPooledDataArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPooledDataArrayAllocator - recycle the memory of small data arrays
+// .SECTION Description
+// vtkPooledDataArrayAllocator keeps the memory of freed arrays to give it
+// to the next arrays of similar size, which avoids going to the system
+// for the many small temporary arrays that filters create and delete.
+//
+// Requests of up to GetMaximumPooledSize() bytes are rounded up to a power
+// of two and served from a list of free blocks of that size.  A block
+// whose size class has room keeps growing or shrinking in place when the
+// array is resized within the class.  Larger requests go to malloc and
+// realloc.  Freed blocks are kept until MaximumCachedSize bytes are
+// cached; beyond that they are returned to the system.  ReleaseMemory()
+// returns all the cached blocks.  The allocator is safe to use from
+// several threads.
+//
+// .SECTION See Also
+// vtkDataArrayAllocator vtkAlignedDataArrayAllocator
+
+#ifndef __vtkPooledDataArrayAllocator_h
+#define __vtkPooledDataArrayAllocator_h
+
+#include "vtkDataArrayAllocator.h"
+
+//BTX
+class vtkPooledDataArrayAllocatorInternals;
+//ETX
+
+class VTK_COMMON_EXPORT vtkPooledDataArrayAllocator :
+  public vtkDataArrayAllocator
+{
+public:
+  static vtkPooledDataArrayAllocator* New();
+  vtkTypeMacro(vtkPooledDataArrayAllocator,vtkDataArrayAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the largest number of bytes kept in the free lists.  The
+  // default is 64 MiB.
+  vtkSetMacro(MaximumCachedSize, vtkIdType);
+  vtkGetMacro(MaximumCachedSize, vtkIdType);
+
+  // Description:
+  // Return the number of bytes currently kept in the free lists.
+  vtkIdType GetCachedSize();
+
+  // Description:
+  // Return the number of allocations that were served from the free
+  // lists since the allocator was created.
+  vtkIdType GetNumberOfReusedBlocks();
+
+  //BTX
+  // Description:
+  // Return the largest request in bytes that is served from the pool.
+  static size_t GetMaximumPooledSize();
+  //ETX
+
+  // Description:
+  // Return all the cached blocks to the system.
+  void ReleaseMemory();
+
+  //BTX
+  virtual void* Allocate(size_t size);
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+  virtual void Free(void* ptr, size_t size);
+  //ETX
+
+protected:
+  vtkPooledDataArrayAllocator();
+  ~vtkPooledDataArrayAllocator();
+
+  vtkIdType MaximumCachedSize;
+
+  //BTX
+  vtkPooledDataArrayAllocatorInternals* Internals;
+  //ETX
+
+private:
+  vtkPooledDataArrayAllocator(const vtkPooledDataArrayAllocator&);  // Not implemented.
+  void operator=(const vtkPooledDataArrayAllocator&);  // Not implemented.
+};
+
+#endif
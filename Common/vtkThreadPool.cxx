@@ -0,0 +1,468 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadPool.h"
+
+#include "vtkConditionVariable.h"
+#include "vtkCriticalSection.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/deque>
+
+vtkStandardNewMacro(vtkThreadPool);
+
+vtkThreadPool *vtkThreadPool::GlobalPool = 0;
+
+//----------------------------------------------------------------------------
+// Deletes the global pool, and therefore joins the worker threads, when the
+// program exits.
+class vtkThreadPoolCleanup
+{
+public:
+  ~vtkThreadPoolCleanup()
+    {
+    if (vtkThreadPool::GlobalPool)
+      {
+      vtkThreadPool::GlobalPool->Delete();
+      vtkThreadPool::GlobalPool = 0;
+      }
+    }
+};
+static vtkThreadPoolCleanup vtkThreadPoolCleanupInstance;
+
+// Serializes the creation of the global pool by the first callers.
+static vtkSimpleCriticalSection vtkThreadPoolGlobalPoolLock;
+
+//----------------------------------------------------------------------------
+// A group collects the chunks queued by one call to ParallelFor().
+struct vtkThreadPoolGroup
+{
+  int Pending;
+};
+
+struct vtkThreadPoolTask
+{
+  vtkThreadPoolRangeFunction Function;
+  void *Data;
+  vtkIdType Begin;
+  vtkIdType End;
+  vtkThreadPoolGroup *Group;
+};
+
+struct vtkThreadPoolSlot
+{
+  vtkSimpleMutexLock Lock;
+  vtkstd::deque<vtkThreadPoolTask> Queue;
+  vtkMultiThreaderIDType ThreadID;
+  int Running;
+};
+
+class vtkThreadPoolInternals;
+
+struct vtkThreadPoolWorkerArgs
+{
+  vtkThreadPoolInternals *Internals;
+  int Slot;
+};
+
+//----------------------------------------------------------------------------
+class vtkThreadPoolInternals
+{
+public:
+  vtkThreadPoolInternals()
+    {
+    this->Threader = 0;
+    this->NumberOfSlots = 1;
+    this->QueuedTasks = 0;
+    this->StolenTasks = 0;
+    this->Shutdown = 0;
+    this->WorkersRunning = 0;
+    for (int i = 0; i < VTK_MAX_THREADS; ++i)
+      {
+      this->Slots[i].Running = 0;
+      this->SpawnedThreadIDs[i] = -1;
+      this->WorkerArgs[i].Internals = this;
+      this->WorkerArgs[i].Slot = i;
+      }
+    }
+
+  // Take a chunk for the thread owning slot.  When group is not NULL only
+  // chunks of that group are considered, which keeps a waiting thread from
+  // re-entering the work of an enclosing parallel region.
+  int TakeTask(int slot, vtkThreadPoolGroup *group, vtkThreadPoolTask &task)
+    {
+    int found = 0;
+    int stolen = 0;
+
+    // Newest chunk of our own queue first: it is the most likely to still
+    // be in cache.
+    vtkThreadPoolSlot &own = this->Slots[slot];
+    own.Lock.Lock();
+    if (!own.Queue.empty() && (!group || own.Queue.back().Group == group))
+      {
+      task = own.Queue.back();
+      own.Queue.pop_back();
+      found = 1;
+      }
+    else if (group)
+      {
+      found = this->TakeGroupTask(own, group, task);
+      }
+    own.Lock.Unlock();
+
+    // Steal the oldest chunk from the other queues.
+    for (int i = 1; !found && i < this->NumberOfSlots; ++i)
+      {
+      vtkThreadPoolSlot &other = this->Slots[(slot + i) % this->NumberOfSlots];
+      other.Lock.Lock();
+      if (!group && !other.Queue.empty())
+        {
+        task = other.Queue.front();
+        other.Queue.pop_front();
+        found = 1;
+        }
+      else if (group)
+        {
+        found = this->TakeGroupTask(other, group, task);
+        }
+      other.Lock.Unlock();
+      stolen = found;
+      }
+
+    if (found)
+      {
+      this->StateLock.Lock();
+      --this->QueuedTasks;
+      this->StolenTasks += stolen;
+      this->StateLock.Unlock();
+      }
+    return found;
+    }
+
+  // Remove the oldest chunk of group from the queue of slot.  The slot lock
+  // must be held.
+  int TakeGroupTask(vtkThreadPoolSlot &slot, vtkThreadPoolGroup *group,
+                    vtkThreadPoolTask &task)
+    {
+    vtkstd::deque<vtkThreadPoolTask>::iterator it;
+    for (it = slot.Queue.begin(); it != slot.Queue.end(); ++it)
+      {
+      if (it->Group == group)
+        {
+        task = *it;
+        slot.Queue.erase(it);
+        return 1;
+        }
+      }
+    return 0;
+    }
+
+  void RunTask(int slot, vtkThreadPoolTask &task)
+    {
+    task.Function(task.Begin, task.End, slot, task.Data);
+
+    this->StateLock.Lock();
+    if (--task.Group->Pending == 0)
+      {
+      this->Condition.Broadcast();
+      }
+    this->StateLock.Unlock();
+    }
+
+  void WorkerLoop(int slot)
+    {
+    this->StateLock.Lock();
+    this->Slots[slot].ThreadID = vtkMultiThreader::GetCurrentThreadID();
+    this->Slots[slot].Running = 1;
+    this->StateLock.Unlock();
+
+    vtkThreadPoolTask task;
+    for (;;)
+      {
+      if (this->TakeTask(slot, 0, task))
+        {
+        this->RunTask(slot, task);
+        continue;
+        }
+      this->StateLock.Lock();
+      while (this->QueuedTasks == 0 && !this->Shutdown)
+        {
+        this->Condition.Wait(this->StateLock);
+        }
+      int shutdown = this->Shutdown;
+      this->StateLock.Unlock();
+      if (shutdown)
+        {
+        break;
+        }
+      }
+
+    this->StateLock.Lock();
+    this->Slots[slot].Running = 0;
+    this->StateLock.Unlock();
+    }
+
+  vtkMultiThreader *Threader;
+  int NumberOfSlots;
+  vtkThreadPoolSlot Slots[VTK_MAX_THREADS];
+  int SpawnedThreadIDs[VTK_MAX_THREADS];
+  vtkThreadPoolWorkerArgs WorkerArgs[VTK_MAX_THREADS];
+
+  // Protects the members below and is the mutex of Condition.
+  vtkSimpleMutexLock StateLock;
+  vtkSimpleConditionVariable Condition;
+  int QueuedTasks;
+  vtkIdType StolenTasks;
+  int Shutdown;
+  int WorkersRunning;
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkThreadPoolWorkerMain(void *arg)
+{
+  vtkThreadPoolWorkerArgs *args = static_cast<vtkThreadPoolWorkerArgs *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  args->Internals->WorkerLoop(args->Slot);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+vtkThreadPool::vtkThreadPool()
+{
+  this->Internals = new vtkThreadPoolInternals;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkThreadPool::~vtkThreadPool()
+{
+  this->StopWorkers();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+vtkThreadPool *vtkThreadPool::GetGlobalPool()
+{
+  vtkThreadPoolGlobalPoolLock.Lock();
+  if (!vtkThreadPool::GlobalPool)
+    {
+    vtkThreadPool::GlobalPool = vtkThreadPool::New();
+    }
+  vtkThreadPool *pool = vtkThreadPool::GlobalPool;
+  vtkThreadPoolGlobalPoolLock.Unlock();
+  return pool;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::SetNumberOfThreads(int num)
+{
+  num = (num < 1 ? 1 : (num > VTK_MAX_THREADS ? VTK_MAX_THREADS : num));
+  if (num == this->NumberOfThreads)
+    {
+    return;
+    }
+  this->StopWorkers();
+  this->NumberOfThreads = num;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadPool::GetNumberOfThreads()
+{
+  int num = this->NumberOfThreads;
+  int max = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (max > 0 && num > max)
+    {
+    num = max;
+    }
+  return num;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::StartWorkers()
+{
+  vtkThreadPoolInternals *internals = this->Internals;
+  int num = this->GetNumberOfThreads();
+
+  internals->StateLock.Lock();
+  if (internals->WorkersRunning)
+    {
+    internals->StateLock.Unlock();
+    return;
+    }
+  internals->WorkersRunning = 1;
+  internals->NumberOfSlots = num;
+  internals->StateLock.Unlock();
+
+  internals->Threader = vtkMultiThreader::New();
+  for (int i = 1; i < num; ++i)
+    {
+    internals->SpawnedThreadIDs[i] = internals->Threader->SpawnThread(
+      vtkThreadPoolWorkerMain, &internals->WorkerArgs[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::StopWorkers()
+{
+  vtkThreadPoolInternals *internals = this->Internals;
+
+  internals->StateLock.Lock();
+  if (!internals->WorkersRunning)
+    {
+    internals->StateLock.Unlock();
+    return;
+    }
+  internals->Shutdown = 1;
+  internals->Condition.Broadcast();
+  internals->StateLock.Unlock();
+
+  for (int i = 1; i < internals->NumberOfSlots; ++i)
+    {
+    if (internals->SpawnedThreadIDs[i] >= 0)
+      {
+      internals->Threader->TerminateThread(internals->SpawnedThreadIDs[i]);
+      internals->SpawnedThreadIDs[i] = -1;
+      }
+    }
+  internals->Threader->Delete();
+  internals->Threader = 0;
+
+  internals->StateLock.Lock();
+  internals->Shutdown = 0;
+  internals->WorkersRunning = 0;
+  internals->NumberOfSlots = 1;
+  internals->StateLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadPool::GetCurrentThreadIndex()
+{
+  vtkThreadPoolInternals *internals = this->Internals;
+  vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+  int index = 0;
+
+  internals->StateLock.Lock();
+  for (int i = 1; i < internals->NumberOfSlots; ++i)
+    {
+    if (internals->Slots[i].Running &&
+        vtkMultiThreader::ThreadsEqual(internals->Slots[i].ThreadID, self))
+      {
+      index = i;
+      break;
+      }
+    }
+  internals->StateLock.Unlock();
+
+  return index;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkThreadPool::GetNumberOfStolenTasks()
+{
+  this->Internals->StateLock.Lock();
+  vtkIdType stolen = this->Internals->StolenTasks;
+  this->Internals->StateLock.Unlock();
+  return stolen;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::ParallelFor(vtkIdType first, vtkIdType last,
+                                vtkIdType grain,
+                                vtkThreadPoolRangeFunction function,
+                                void *data)
+{
+  if (last <= first)
+    {
+    return;
+    }
+
+  vtkIdType num = last - first;
+  int numThreads = this->GetNumberOfThreads();
+  if (grain <= 0)
+    {
+    // A few chunks per thread leave room for stealing when chunks do not
+    // cost the same.
+    grain = (num + 4*numThreads - 1) / (4*numThreads);
+    }
+  vtkIdType numChunks = (num + grain - 1) / grain;
+
+  int slot = this->GetCurrentThreadIndex();
+  if (numThreads <= 1 || numChunks <= 1)
+    {
+    function(first, last, slot, data);
+    return;
+    }
+
+  this->StartWorkers();
+  vtkThreadPoolInternals *internals = this->Internals;
+
+  vtkThreadPoolGroup group;
+  group.Pending = static_cast<int>(numChunks);
+
+  vtkThreadPoolTask task;
+  task.Function = function;
+  task.Data = data;
+  task.Group = &group;
+
+  // Queue the chunks in reverse so that the owner, which pops from the
+  // back, walks the range in order while thieves take the far end.
+  vtkThreadPoolSlot &own = internals->Slots[slot];
+  own.Lock.Lock();
+  for (vtkIdType c = numChunks - 1; c >= 0; --c)
+    {
+    task.Begin = first + c*grain;
+    task.End = (task.Begin + grain < last ? task.Begin + grain : last);
+    own.Queue.push_back(task);
+    }
+  own.Lock.Unlock();
+
+  internals->StateLock.Lock();
+  internals->QueuedTasks += static_cast<int>(numChunks);
+  internals->Condition.Broadcast();
+  internals->StateLock.Unlock();
+
+  // Help with our own chunks until all of them have completed.
+  for (;;)
+    {
+    if (internals->TakeTask(slot, &group, task))
+      {
+      internals->RunTask(slot, task);
+      continue;
+      }
+    internals->StateLock.Lock();
+    int pending = group.Pending;
+    if (pending > 0)
+      {
+      internals->Condition.Wait(internals->StateLock);
+      }
+    internals->StateLock.Unlock();
+    if (pending == 0)
+      {
+      break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "NumberOfStolenTasks: "
+     << this->GetNumberOfStolenTasks() << "\n";
+}
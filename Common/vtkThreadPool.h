@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadPool - persistent, work-stealing pool of worker threads
+// .SECTION Description
+// vtkThreadPool keeps a fixed set of worker threads alive for the lifetime
+// of the process so that short parallel regions do not pay the cost of
+// creating and joining threads.  Work is submitted through ParallelFor(),
+// which splits an index range into chunks and runs the chunks on the pool.
+// Each thread of the pool owns a queue of chunks; idle threads steal chunks
+// from the queues of busy threads.
+//
+// The pool has GetNumberOfThreads() slots.  Slot 0 is used by threads
+// that call into the pool from outside, slots 1 to GetNumberOfThreads()-1
+// are the worker threads.  The slot index is passed to the range function
+// so that callers can keep per-thread scratch data in an array indexed by
+// slot without any locking.  Since a thread only executes chunks of its own
+// ParallelFor() and those of unrelated callers run on different data, two
+// outside threads may safely share slot 0.
+//
+// ParallelFor() may be called from inside a range function.  The nested
+// range is executed by the same pool, so nested parallelism never creates
+// more threads than the pool holds.  While a thread waits for its nested
+// range to complete it only executes chunks of that range, so per-slot
+// scratch data of the enclosing range is never re-entered.
+//
+// A process-wide instance is available through GetGlobalPool().  It is
+// created on first use and destroyed when the program exits.
+//
+// .SECTION See Also
+// vtkMultiThreader
+
+#ifndef __vtkThreadPool_h
+#define __vtkThreadPool_h
+
+#include "vtkObject.h"
+
+//BTX
+// Signature of the function executed by ParallelFor().  It is called with
+// a half-open sub-range [begin, end) of the requested range, the slot index
+// of the executing thread and the user data passed to ParallelFor().
+typedef void (*vtkThreadPoolRangeFunction)(vtkIdType begin, vtkIdType end,
+                                           int threadIndex, void *data);
+
+class vtkThreadPoolInternals;
+class vtkThreadPoolCleanup;
+//ETX
+
+class VTK_COMMON_EXPORT vtkThreadPool : public vtkObject
+{
+public:
+  static vtkThreadPool *New();
+  vtkTypeMacro(vtkThreadPool,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the process-wide pool.  The pool is created on first use, by
+  // one thread even when several ask for it at once, and is deleted when
+  // the program exits.  No reference is added.
+  static vtkThreadPool *GetGlobalPool();
+
+  // Description:
+  // Set/Get the number of slots of the pool, i.e. the calling thread plus
+  // the worker threads.  The default is
+  // vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), limited by
+  // vtkMultiThreader::GetGlobalMaximumNumberOfThreads().  Changing the
+  // value stops the current workers; new ones are started on the next
+  // parallel region.  This must not be called from inside a parallel
+  // region.
+  virtual void SetNumberOfThreads(int num);
+  virtual int GetNumberOfThreads();
+
+  //BTX
+  // Description:
+  // Execute function(begin, end, threadIndex, data) for sub-ranges
+  // covering [first, last).  Sub-ranges contain at most grain indices;
+  // a grain of 0 or less lets the pool pick one that gives a few chunks
+  // per thread.  The call returns after the whole range has been
+  // processed.  The calling thread takes part in the work.
+  void ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+                   vtkThreadPoolRangeFunction function, void *data);
+  //ETX
+
+  // Description:
+  // Return the slot index of the calling thread: its worker index when it
+  // is one of the pool threads, 0 otherwise.
+  int GetCurrentThreadIndex();
+
+  // Description:
+  // Return the number of chunks that were executed by a thread other than
+  // the one that queued them.  Useful to check load balancing.
+  vtkIdType GetNumberOfStolenTasks();
+
+protected:
+  vtkThreadPool();
+  ~vtkThreadPool();
+
+  // Description:
+  // Start and stop the worker threads.
+  void StartWorkers();
+  void StopWorkers();
+
+  int NumberOfThreads;
+
+  //BTX
+  vtkThreadPoolInternals *Internals;
+  friend class vtkThreadPoolInternals;
+  friend class vtkThreadPoolCleanup;
+  //ETX
+
+private:
+  static vtkThreadPool *GlobalPool;
+
+  vtkThreadPool(const vtkThreadPool&);  // Not implemented.
+  void operator=(const vtkThreadPool&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCachedStreamingPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Request time steps, pieces and filter settings again from an algorithm
+// driven by vtkCachedStreamingDemandDrivenPipeline and check that they
+// come from the cache, and that the cache respects its limits.
+
+#include "vtkCachedStreamingDemandDrivenPipeline.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A source of a few points whose z coordinate is the requested time plus
+// ten times the requested piece.
+class vtkTimePieceSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTimePieceSource *New();
+  vtkTypeMacro(vtkTimePieceSource,vtkPolyDataAlgorithm);
+
+  int Executions;
+
+protected:
+  vtkTimePieceSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Executions = 0;
+    }
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+                                 vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double steps[] = {0.0, 1.0, 2.0, 3.0};
+    double range[] = {0.0, 3.0};
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), steps, 4);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    outInfo->Set(
+      vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(), -1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+    {
+    this->Executions++;
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output =
+      vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    double time = 0.0;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+      {
+      time = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS())[0];
+      }
+    int piece = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEPS(),
+                                  &time, 1);
+
+    VTK_CREATE(vtkPoints, points);
+    VTK_CREATE(vtkCellArray, verts);
+    for (int i = 0; i < 100; i++)
+      {
+      vtkIdType id = points->InsertNextPoint(i, 0.0, time + 10*piece);
+      verts->InsertNextCell(1, &id);
+      }
+    output->SetPoints(points);
+    output->SetVerts(verts);
+    return 1;
+    }
+
+private:
+  vtkTimePieceSource(const vtkTimePieceSource&);  // Not implemented.
+  void operator=(const vtkTimePieceSource&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkTimePieceSource);
+
+// Check the z coordinate of the output.
+static int CheckOutput(vtkElevationFilter* filter, double z)
+{
+  vtkDataSet* output = filter->GetOutput();
+  if (output->GetNumberOfPoints() != 100 || output->GetPoint(0)[2] != z ||
+      !output->GetPointData()->GetScalars())
+    {
+    cerr << "Expected output at z = " << z << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Check the number of executions of the source and the filter.
+static int CheckCounts(vtkTimePieceSource* source,
+                       vtkCachedStreamingDemandDrivenPipeline* exec,
+                       int executions, int hits, int misses)
+{
+  if (source->Executions != executions ||
+      exec->GetNumberOfCacheHits() != hits ||
+      exec->GetNumberOfCacheMisses() != misses)
+    {
+    cerr << "The source executed " << source->Executions << " times, "
+         << "the cache had " << exec->GetNumberOfCacheHits() << " hits and "
+         << exec->GetNumberOfCacheMisses() << " misses instead of "
+         << executions << ", " << hits << " and " << misses << "." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestCachedStreamingPipeline(int, char*[])
+{
+  VTK_CREATE(vtkTimePieceSource, source);
+  VTK_CREATE(vtkElevationFilter, filter);
+  VTK_CREATE(vtkCachedStreamingDemandDrivenPipeline, exec);
+  filter->SetExecutive(exec);
+  filter->SetInputConnection(source->GetOutputPort());
+
+  // Scrub back and forth through time.  Each time step executes once.
+  double times[] = {0.0, 1.0, 2.0, 1.0, 0.0, 2.0};
+  for (int i = 0; i < 6; i++)
+    {
+    exec->UpdateInformation();
+    exec->SetUpdateTimeStep(0, times[i]);
+    exec->Update();
+    if (!CheckOutput(filter, times[i]))
+      {
+      return 1;
+      }
+    }
+  if (!CheckCounts(source, exec, 3, 3, 3))
+    {
+    return 1;
+    }
+
+  // Request pieces again.
+  for (int i = 0; i < 4; i++)
+    {
+    exec->UpdateInformation();
+    exec->SetUpdateExtent(0, i % 2, 2, 0);
+    exec->Update();
+    if (!CheckOutput(filter, 2.0 + 10*(i % 2)))
+      {
+      return 1;
+      }
+    }
+  if (!CheckCounts(source, exec, 5, 5, 5))
+    {
+    return 1;
+    }
+
+  // Toggle between filter settings identified by a cache key.  Only the
+  // filter executes, once for each setting.
+  exec->UpdateInformation();
+  exec->SetUpdateExtent(0, 0, 1, 0);
+  for (int i = 0; i < 4; i++)
+    {
+    exec->SetCacheKey(0, i % 2 ? "high" : "low");
+    double expected = i % 2 ? 7.0 : 5.0;
+    filter->SetScalarRange(0.0, expected);
+    filter->Update();
+    if (!CheckOutput(filter, 2.0) ||
+        filter->GetOutput()->GetPointData()->GetScalars()->GetComponent(0, 0)
+        != expected)
+      {
+      cerr << "Wrong cached result for setting " << i % 2 << endl;
+      return 1;
+      }
+    }
+  if (!CheckCounts(source, exec, 6, 7, 7))
+    {
+    return 1;
+    }
+
+  // Results without a key are discarded when the pipeline is modified.
+  exec->SetCacheKey(0, 0);
+  filter->SetLowPoint(0.0, 0.0, 0.5);
+  filter->Update();
+  filter->SetLowPoint(0.0, 0.0, 0.25);
+  filter->Update();
+  if (!CheckCounts(source, exec, 6, 7, 9) ||
+      exec->GetNumberOfCachedResults() != 3)
+    {
+    cerr << exec->GetNumberOfCachedResults() << " cached results." << endl;
+    return 1;
+    }
+
+  // The least recently used results are evicted first.
+  exec->SetCacheKey(0, "low");
+  filter->Update();
+  exec->SetCacheSize(1);
+  exec->SetCacheKey(0, 0);
+  exec->SetCacheKey(0, "low");
+  filter->Update();
+  if (exec->GetNumberOfCachedResults() != 1 ||
+      !CheckCounts(source, exec, 6, 9, 9))
+    {
+    cerr << "Evicted the most recently used result." << endl;
+    return 1;
+    }
+
+  // Results that do not fit in the memory limit are not cached.
+  exec->ClearCache();
+  exec->SetCacheSize(10);
+  exec->SetCacheMemoryLimit(1);
+  exec->SetCacheKey(0, "small");
+  filter->Update();
+  if (exec->GetNumberOfCachedResults() != 0 ||
+      exec->GetCacheMemorySize() != 0)
+    {
+    cerr << "Cached a result over the memory limit." << endl;
+    return 1;
+    }
+  exec->SetCacheMemoryLimit(0);
+  exec->SetCacheKey(0, "large");
+  filter->Update();
+  if (exec->GetNumberOfCachedResults() != 1 ||
+      exec->GetCacheMemorySize() == 0)
+    {
+    cerr << "Did not cache a result without a memory limit." << endl;
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCompactCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check random access, 32-bit storage and the legacy layout of
+// vtkCompactCellArray.
+
+#include "vtkCellArray.h"
+#include "vtkCompactCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkSmartPointer.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Cell i has i%5+1 points with ids 7*i+k.
+static void InsertCells(vtkCompactCellArray *cells, vtkCellArray *legacy,
+                        vtkIdType numCells)
+{
+  vtkIdType pts[5];
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    vtkIdType npts = i%5 + 1;
+    for (vtkIdType k = 0; k < npts; k++)
+      {
+      pts[k] = 7*i + k;
+      }
+    if (cells)
+      {
+      cells->InsertNextCell(npts, pts);
+      }
+    if (legacy)
+      {
+      legacy->InsertNextCell(npts, pts);
+      }
+    }
+}
+
+static int CheckCells(vtkCompactCellArray *cells, vtkIdType numCells,
+                      const char *label)
+{
+  if (cells->GetNumberOfCells() != numCells)
+    {
+    cerr << label << ": " << cells->GetNumberOfCells()
+         << " cells instead of " << numCells << endl;
+    return 1;
+    }
+  VTK_CREATE(vtkIdList, ids);
+  vtkIdType pts[5], npts;
+  // Visit the cells out of order to exercise random access.
+  for (vtkIdType j = 0; j < numCells; j++)
+    {
+    vtkIdType i = (j*37)%numCells;
+    cells->GetCellPoints(i, ids);
+    cells->GetCellPoints(i, npts, pts);
+    int ok = (cells->GetCellSize(i) == i%5 + 1 && npts == i%5 + 1 &&
+              ids->GetNumberOfIds() == npts);
+    for (vtkIdType k = 0; ok && k < npts; k++)
+      {
+      ok = (pts[k] == 7*i + k && ids->GetId(k) == 7*i + k);
+      }
+    if (!ok)
+      {
+      cerr << label << ": cell " << i << " is wrong" << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestCompactCellArray(int, char *[])
+{
+  const vtkIdType numCells = 1001;
+  int errors = 0;
+
+  VTK_CREATE(vtkCompactCellArray, cells);
+  cells->Allocate(numCells, 3*numCells);
+  InsertCells(cells, NULL, numCells);
+  errors += CheckCells(cells, numCells, "64-bit");
+  if (cells->GetNumberOfConnectivityEntries() != 3*(numCells - 1) + 1)
+    {
+    cerr << "Wrong number of connectivity entries" << endl;
+    errors++;
+    }
+
+  cells->Use32BitIdsOn();
+  errors += CheckCells(cells, numCells, "32-bit");
+  if (cells->GetConnectivityArray()->GetDataType() != VTK_INT)
+    {
+    cerr << "The connectivity was not converted to 32-bit" << endl;
+    errors++;
+    }
+  vtkIdType npts, *ptr;
+  if (cells->GetCellPointer(0, npts, ptr))
+    {
+    cerr << "GetCellPointer succeeded on 32-bit storage" << endl;
+    errors++;
+    }
+  InsertCells(cells, NULL, 10);
+  cells->Use32BitIdsOff();
+  if (cells->GetNumberOfCells() != numCells + 10)
+    {
+    cerr << "Inserting into 32-bit storage failed" << endl;
+    errors++;
+    }
+
+  // Ids beyond 32 bits must be refused.
+  if (sizeof(vtkIdType) > sizeof(int))
+    {
+    VTK_CREATE(vtkCompactCellArray, large);
+    vtkIdType big = static_cast<vtkIdType>(VTK_INT_MAX) + 1;
+    large->InsertNextCell(1, &big);
+    cout << "An error about 32-bit ids is expected:" << endl;
+    large->Use32BitIdsOn();
+    if (large->GetUse32BitIds())
+      {
+      cerr << "Ids that do not fit were converted to 32-bit" << endl;
+      errors++;
+      }
+    }
+
+  // Legacy import and export must share the legacy array.
+  VTK_CREATE(vtkCellArray, legacy);
+  InsertCells(NULL, legacy, numCells);
+  VTK_CREATE(vtkCompactCellArray, view);
+  view->ImportLegacyFormat(legacy);
+  if (!view->GetLegacyView() ||
+      view->GetConnectivityArray() != legacy->GetData())
+    {
+    cerr << "ImportLegacyFormat copied the connectivity" << endl;
+    errors++;
+    }
+  errors += CheckCells(view, numCells, "legacy view");
+  if (!view->GetCellPointer(3, npts, ptr) || npts != 4 || ptr[0] != 21)
+    {
+    cerr << "GetCellPointer failed on a legacy view" << endl;
+    errors++;
+    }
+  VTK_CREATE(vtkCellArray, exported);
+  view->ExportLegacyFormat(exported);
+  if (exported->GetData() != legacy->GetData() ||
+      exported->GetNumberOfCells() != numCells)
+    {
+    cerr << "ExportLegacyFormat copied the connectivity" << endl;
+    errors++;
+    }
+
+  view->Compact();
+  if (view->GetLegacyView() ||
+      view->GetConnectivityArray()->GetNumberOfTuples() !=
+      legacy->GetData()->GetNumberOfTuples() - numCells)
+    {
+    cerr << "Compact did not drop the point counts" << endl;
+    errors++;
+    }
+  errors += CheckCells(view, numCells, "compacted view");
+
+  // A compact array exports to the same legacy layout.
+  VTK_CREATE(vtkCellArray, rebuilt);
+  cells->ExportLegacyFormat(rebuilt);
+  vtkIdTypeArray *a = legacy->GetData();
+  vtkIdTypeArray *b = rebuilt->GetData();
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    if (a->GetValue(i) != b->GetValue(i))
+      {
+      cerr << "ExportLegacyFormat differs at " << i << endl;
+      errors++;
+      break;
+      }
+    }
+
+  VTK_CREATE(vtkCompactCellArray, copy);
+  copy->DeepCopy(view);
+  errors += CheckCells(copy, numCells, "deep copy");
+
+  return (errors == 0) ? 0 : 1;
+}
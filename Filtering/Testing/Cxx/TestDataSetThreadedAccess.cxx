@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetThreadedAccess.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Read cells and points of the main dataset types from several threads
+// after PrepareForThreadedAccess() and compare with a serial traversal.
+
+#include "vtkCellArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkThreadPool.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A signature of a cell built from its type, bounds, points and ids.
+static double CellSignature(vtkDataSet *ds, vtkIdType cellId,
+                            vtkGenericCell *cell, vtkIdList *ids)
+{
+  ds->GetCell(cellId, cell);
+  ds->GetCellPoints(cellId, ids);
+  double bounds[6], x[3];
+  ds->GetCellBounds(cellId, bounds);
+  double sum = ds->GetCellType(cellId) + cell->GetCellType() +
+    bounds[0] + 2*bounds[1] + 3*bounds[2] + 4*bounds[3] + 5*bounds[4] +
+    6*bounds[5];
+  for (vtkIdType i = 0; i < cell->GetNumberOfPoints(); i++)
+    {
+    vtkIdType ptId = cell->GetPointId(i);
+    ds->GetPoint(ptId, x);
+    sum += (i+1)*(ptId + x[0] + 3*x[1] + 7*x[2] + ids->GetId(i));
+    }
+  return sum;
+}
+
+struct ThreadedAccessData
+{
+  vtkDataSet *DataSet;
+  double *Signatures;
+};
+
+static void ComputeSignatures(vtkIdType begin, vtkIdType end, int,
+                              void *arg)
+{
+  ThreadedAccessData *data = static_cast<ThreadedAccessData *>(arg);
+  VTK_CREATE(vtkGenericCell, cell);
+  VTK_CREATE(vtkIdList, ids);
+  for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+    data->Signatures[cellId] =
+      CellSignature(data->DataSet, cellId, cell, ids);
+    }
+}
+
+static int TestDataSet(vtkDataSet *ds)
+{
+  vtkIdType numCells = ds->GetNumberOfCells();
+  double *signatures = new double[numCells];
+  ThreadedAccessData data;
+  data.DataSet = ds;
+  data.Signatures = signatures;
+
+  // No serial access happens before the threads start.
+  ds->PrepareForThreadedAccess();
+  vtkThreadPool::GetGlobalPool()->ParallelFor(
+    0, numCells, 16, ComputeSignatures, &data);
+
+  VTK_CREATE(vtkGenericCell, cell);
+  VTK_CREATE(vtkIdList, ids);
+  int errors = 0;
+  for (vtkIdType cellId = 0; cellId < numCells && !errors; cellId++)
+    {
+    if (signatures[cellId] != CellSignature(ds, cellId, cell, ids))
+      {
+      cerr << ds->GetClassName() << ": cell " << cellId
+           << " differs when read from several threads" << endl;
+      errors++;
+      }
+    }
+  delete [] signatures;
+  return errors;
+}
+
+int TestDataSetThreadedAccess(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+  const int dim = 24;
+
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(dim, dim, dim);
+  image->SetOrigin(-1.0, 0.5, 2.0);
+  image->SetSpacing(0.5, 0.25, 1.5);
+
+  VTK_CREATE(vtkStructuredGrid, grid);
+  VTK_CREATE(vtkPoints, points);
+  double x[3];
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ptId++)
+    {
+    image->GetPoint(ptId, x);
+    points->InsertNextPoint(x[0] + 0.1*x[1]*x[1], x[1], x[2] + 0.2*x[0]);
+    }
+  grid->SetDimensions(dim, dim, dim);
+  grid->SetPoints(points);
+
+  VTK_CREATE(vtkUnstructuredGrid, ugrid);
+  ugrid->SetPoints(points);
+  ugrid->Allocate(grid->GetNumberOfCells());
+  VTK_CREATE(vtkIdList, ids);
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); cellId++)
+    {
+    grid->GetCellPoints(cellId, ids);
+    ugrid->InsertNextCell(grid->GetCellType(cellId), ids);
+    }
+
+  // Mix vertices, lines and polygons so that the cell types of the
+  // polydata have to be built.
+  VTK_CREATE(vtkPolyData, poly);
+  VTK_CREATE(vtkCellArray, verts);
+  VTK_CREATE(vtkCellArray, lines);
+  VTK_CREATE(vtkCellArray, polys);
+  vtkIdType pts[4];
+  for (int j = 0; j < dim-1; j++)
+    {
+    for (int i = 0; i < dim-1; i++)
+      {
+      pts[0] = j*dim + i;
+      pts[1] = pts[0] + 1;
+      pts[2] = pts[1] + dim;
+      pts[3] = pts[0] + dim;
+      switch ((i + j) % 3)
+        {
+        case 0:
+          verts->InsertNextCell(1, pts);
+          break;
+        case 1:
+          lines->InsertNextCell(2, pts);
+          break;
+        default:
+          polys->InsertNextCell((i % 2) ? 3 : 4, pts);
+        }
+      }
+    }
+  poly->SetPoints(points);
+  poly->SetVerts(verts);
+  poly->SetLines(lines);
+  poly->SetPolys(polys);
+
+  int errors = 0;
+  errors += TestDataSet(image);
+  errors += TestDataSet(grid);
+  errors += TestDataSet(ugrid);
+  errors += TestDataSet(poly);
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestKdTreeThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Build k-d trees on several threads and check that the regions and the
+// results of the bulk queries match those of serial builds and of
+// queries of one point at a time.
+
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkKdNode.h"
+#include "vtkKdTree.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare the regions of two k-d trees.
+static int CompareRegions(vtkKdTree* a, vtkKdTree* b)
+{
+  if (a->GetNumberOfRegions() != b->GetNumberOfRegions())
+    {
+    cerr << "Trees have " << a->GetNumberOfRegions() << " and "
+         << b->GetNumberOfRegions() << " regions." << endl;
+    return 0;
+    }
+  double ba[6];
+  double bb[6];
+  for (int i = 0; i < a->GetNumberOfRegions(); i++)
+    {
+    a->GetRegionBounds(i, ba);
+    b->GetRegionBounds(i, bb);
+    for (int j = 0; j < 6; j++)
+      {
+      if (ba[j] != bb[j])
+        {
+        cerr << "Region " << i << " differs." << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+// Build trees from the cells of a sphere.
+static int TestCells()
+{
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(300);
+  sphere->Update();
+  vtkPolyData* input = sphere->GetOutput();
+
+  VTK_CREATE(vtkKdTree, serial);
+  serial->SetDataSet(input);
+  serial->BuildLocator();
+  VTK_CREATE(vtkKdTree, threaded);
+  threaded->SetNumberOfThreads(4);
+  threaded->SetDataSet(input);
+  threaded->BuildLocator();
+  if (!CompareRegions(serial, threaded))
+    {
+    return 0;
+    }
+
+  int* serialList = serial->AllGetRegionContainingCell();
+  int* threadedList = threaded->AllGetRegionContainingCell();
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); i++)
+    {
+    if (serialList[i] != threadedList[i] || threadedList[i] < 0)
+      {
+      cerr << "Cell " << i << " is in region " << threadedList[i]
+           << " instead of " << serialList[i] << endl;
+      return 0;
+      }
+    }
+
+  // Find the regions of the points, and of one point outside the tree.
+  VTK_CREATE(vtkPoints, points);
+  points->DeepCopy(input->GetPoints());
+  points->InsertNextPoint(10.0, 10.0, 10.0);
+  VTK_CREATE(vtkIntArray, regionIds);
+  threaded->GetRegionsContainingPoints(points, regionIds);
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); i++)
+    {
+    double* x = points->GetPoint(i);
+    if (regionIds->GetValue(i) !=
+        serial->GetRegionContainingPoint(x[0], x[1], x[2]))
+      {
+      cerr << "Wrong region for point " << i << endl;
+      return 0;
+      }
+    }
+  if (regionIds->GetValue(points->GetNumberOfPoints() - 1) != -1)
+    {
+    cerr << "Found a region for a point outside of the tree." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Build trees from points of which every third one is a copy of an
+// earlier point.
+static int TestPoints()
+{
+  vtkMath::RandomSeed(1234);
+  VTK_CREATE(vtkPoints, points);
+  for (int i = 0; i < 100000; i++)
+    {
+    if (i % 3 == 2)
+      {
+      points->InsertNextPoint(points->GetPoint(i / 2));
+      }
+    else
+      {
+      points->InsertNextPoint(vtkMath::Random(), vtkMath::Random(),
+                              vtkMath::Random());
+      }
+    }
+
+  VTK_CREATE(vtkKdTree, serial);
+  serial->BuildLocatorFromPoints(points);
+  VTK_CREATE(vtkKdTree, threaded);
+  threaded->SetNumberOfThreads(4);
+  threaded->BuildLocatorFromPoints(points);
+  if (!CompareRegions(serial, threaded))
+    {
+    return 0;
+    }
+
+  vtkIdTypeArray* serialMap = serial->BuildMapForDuplicatePoints(0.0);
+  vtkIdTypeArray* threadedMap = threaded->BuildMapForDuplicatePoints(0.0);
+  int ok = 1;
+  for (vtkIdType i = 0; ok && i < points->GetNumberOfPoints(); i++)
+    {
+    if (serialMap->GetValue(i) != threadedMap->GetValue(i))
+      {
+      cerr << "Point " << i << " maps to " << threadedMap->GetValue(i)
+           << " instead of " << serialMap->GetValue(i) << endl;
+      ok = 0;
+      }
+    }
+  serialMap->Delete();
+  threadedMap->Delete();
+  if (!ok)
+    {
+    return 0;
+    }
+
+  // Find every point, and one point that is not in the tree.
+  VTK_CREATE(vtkPoints, query);
+  query->DeepCopy(points);
+  query->InsertNextPoint(0.5, 0.5, 2.0);
+  VTK_CREATE(vtkIdTypeArray, ids);
+  threaded->FindPoints(query, ids);
+  for (vtkIdType i = 0; i < query->GetNumberOfPoints(); i++)
+    {
+    if (ids->GetValue(i) != serial->FindPoint(query->GetPoint(i)))
+      {
+      cerr << "Wrong id for point " << i << endl;
+      return 0;
+      }
+    }
+  if (ids->GetValue(query->GetNumberOfPoints() - 1) != -1)
+    {
+    cerr << "Found a point that is not in the tree." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestKdTreeThreads(int, char*[])
+{
+  if (!TestCells() || !TestPoints())
+    {
+    return 1;
+    }
+  return 0;
+}
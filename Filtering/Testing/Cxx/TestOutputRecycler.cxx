@@ -0,0 +1,320 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOutputRecycler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Re-execute filters whose outputs are recycled and check that they
+// reuse the memory of their previous outputs, that the outputs match
+// those of filters that do not recycle, that pieces shared with a
+// downstream data object are left alone, and that recycled arrays come
+// back without the names of their previous owner.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkContourFilter.h"
+#include "vtkDataArray.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkElevationFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdList.h"
+#include "vtkOutputRecycler.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare the arrays of two attributes.
+static int CompareAttributes(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << "Different number of arrays." << endl;
+    return 0;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* aa = a->GetArray(i);
+    vtkDataArray* ba = b->GetArray(aa->GetName());
+    if (!ba || aa->GetDataType() != ba->GetDataType() ||
+        aa->GetNumberOfTuples() != ba->GetNumberOfTuples() ||
+        aa->GetNumberOfComponents() != ba->GetNumberOfComponents())
+      {
+      cerr << "Array " << (aa->GetName() ? aa->GetName() : "(none)")
+           << " differs." << endl;
+      return 0;
+      }
+    for (vtkIdType j = 0; j < aa->GetNumberOfTuples(); j++)
+      {
+      for (int c = 0; c < aa->GetNumberOfComponents(); c++)
+        {
+        if (aa->GetComponent(j, c) != ba->GetComponent(j, c))
+          {
+          cerr << "Array " << (aa->GetName() ? aa->GetName() : "(none)")
+               << " differs at tuple " << j << "." << endl;
+          return 0;
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+// Compare the points, cells and attributes of two data sets.
+static int CompareOutputs(vtkPointSet* a, vtkPointSet* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    cerr << "Outputs have " << a->GetNumberOfPoints() << " and "
+         << b->GetNumberOfPoints() << " points, " << a->GetNumberOfCells()
+         << " and " << b->GetNumberOfCells() << " cells." << endl;
+    return 0;
+    }
+  double pa[3];
+  double pb[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, pa);
+    b->GetPoint(i, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2])
+      {
+      cerr << "Point " << i << " differs." << endl;
+      return 0;
+      }
+    }
+  VTK_CREATE(vtkIdList, ida);
+  VTK_CREATE(vtkIdList, idb);
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); i++)
+    {
+    a->GetCellPoints(i, ida);
+    b->GetCellPoints(i, idb);
+    if (a->GetCellType(i) != b->GetCellType(i) ||
+        ida->GetNumberOfIds() != idb->GetNumberOfIds())
+      {
+      cerr << "Cell " << i << " differs." << endl;
+      return 0;
+      }
+    for (vtkIdType j = 0; j < ida->GetNumberOfIds(); j++)
+      {
+      if (ida->GetId(j) != idb->GetId(j))
+        {
+        cerr << "Cell " << i << " differs." << endl;
+        return 0;
+        }
+      }
+    }
+  return CompareAttributes(a->GetPointData(), b->GetPointData()) &&
+    CompareAttributes(a->GetCellData(), b->GetCellData());
+}
+
+// Turn output recycling on for the first output of an algorithm.
+static vtkDemandDrivenPipeline* RecycleOutput(vtkAlgorithm* algorithm)
+{
+  vtkDemandDrivenPipeline* ddp =
+    vtkDemandDrivenPipeline::SafeDownCast(algorithm->GetExecutive());
+  ddp->SetRecycleOutputFlag(0, 1);
+  return ddp;
+}
+
+// Check the counters of the recycler of an output.
+static int CheckReused(vtkDemandDrivenPipeline* ddp, const char* name)
+{
+  vtkOutputRecycler* recycler = ddp->GetOutputRecycler(0);
+  if (!recycler || recycler->GetNumberOfReusedObjects() == 0 ||
+      recycler->GetReusedMemorySize() <= 0.0)
+    {
+    cerr << name << " did not reuse its output." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Test vtkContourFilter, which allocates its points and cells from the
+// recycler and interpolates its point data.  A downstream copy of its
+// output must be left alone when it is re-executed.
+static int TestContour(vtkAlgorithmOutput* input)
+{
+  VTK_CREATE(vtkContourFilter, reference);
+  reference->SetInputConnection(input);
+  VTK_CREATE(vtkContourFilter, recycled);
+  recycled->SetInputConnection(input);
+  vtkDemandDrivenPipeline* ddp = RecycleOutput(recycled);
+
+  // Keep a shallow copy of the first output, as a downstream filter
+  // would, and a deep copy to check that it does not change.
+  VTK_CREATE(vtkPolyData, shared);
+  VTK_CREATE(vtkPolyData, saved);
+  double values[] = {0.5, 0.45, 0.55, 0.5};
+  for (int i = 0; i < 4; i++)
+    {
+    reference->SetValue(0, values[i]);
+    reference->Update();
+    recycled->SetValue(0, values[i]);
+    recycled->Update();
+    if (!CompareOutputs(reference->GetOutput(), recycled->GetOutput()))
+      {
+      cerr << "Recycled contour differs at value " << values[i] << endl;
+      return 0;
+      }
+    if (i == 1)
+      {
+      shared->ShallowCopy(recycled->GetOutput());
+      saved->DeepCopy(recycled->GetOutput());
+      }
+    }
+  if (shared->GetPoints() == recycled->GetOutput()->GetPoints() ||
+      shared->GetLines() == recycled->GetOutput()->GetLines() ||
+      !CompareOutputs(shared, saved))
+    {
+    cerr << "Recycling changed a shared output." << endl;
+    return 0;
+    }
+  return CheckReused(ddp, "vtkContourFilter");
+}
+
+// Test vtkThreshold, which produces an unstructured grid and copies its
+// attributes.
+static int TestThreshold(vtkAlgorithmOutput* input)
+{
+  VTK_CREATE(vtkAppendFilter, grid);
+  grid->SetInputConnection(input);
+  VTK_CREATE(vtkThreshold, reference);
+  reference->SetInputConnection(grid->GetOutputPort());
+  VTK_CREATE(vtkThreshold, recycled);
+  recycled->SetInputConnection(grid->GetOutputPort());
+  vtkDemandDrivenPipeline* ddp = RecycleOutput(recycled);
+
+  double upper[] = {0.6, 0.5, 0.7, 0.6};
+  for (int i = 0; i < 4; i++)
+    {
+    reference->ThresholdBetween(0.2, upper[i]);
+    reference->Update();
+    recycled->ThresholdBetween(0.2, upper[i]);
+    recycled->Update();
+    if (!CompareOutputs(reference->GetOutput(), recycled->GetOutput()))
+      {
+      cerr << "Recycled threshold differs at " << upper[i] << endl;
+      return 0;
+      }
+    }
+  return CheckReused(ddp, "vtkThreshold");
+}
+
+// Test vtkGlyph3D, which creates its attribute arrays itself.
+static int TestGlyph(vtkAlgorithmOutput* input)
+{
+  VTK_CREATE(vtkConeSource, cone);
+  VTK_CREATE(vtkGlyph3D, reference);
+  reference->SetInputConnection(input);
+  reference->SetSourceConnection(cone->GetOutputPort());
+  reference->GeneratePointIdsOn();
+  VTK_CREATE(vtkGlyph3D, recycled);
+  recycled->SetInputConnection(input);
+  recycled->SetSourceConnection(cone->GetOutputPort());
+  recycled->GeneratePointIdsOn();
+  vtkDemandDrivenPipeline* ddp = RecycleOutput(recycled);
+
+  double factors[] = {0.1, 0.2, 0.1};
+  for (int i = 0; i < 3; i++)
+    {
+    reference->SetScaleFactor(factors[i]);
+    reference->Update();
+    recycled->SetScaleFactor(factors[i]);
+    recycled->Update();
+    if (!CompareOutputs(reference->GetOutput(), recycled->GetOutput()))
+      {
+      cerr << "Recycled glyphs differ at " << factors[i] << endl;
+      return 0;
+      }
+    }
+  return CheckReused(ddp, "vtkGlyph3D");
+}
+
+// Check that an array taken from the recycler has no name, component
+// names or lookup table left from the data object it came from.
+static int TestTakeArray()
+{
+  VTK_CREATE(vtkOutputRecycler, recycler);
+  vtkPolyData* data = vtkPolyData::New();
+  vtkFloatArray* array = vtkFloatArray::New();
+  array->SetNumberOfComponents(3);
+  array->SetNumberOfTuples(10);
+  array->SetName("Displacement");
+  array->SetComponentName(0, "DX");
+  array->SetComponentName(1, "DY");
+  array->SetComponentName(2, "DZ");
+  data->GetPointData()->AddArray(array);
+  array->Delete();
+  recycler->Recycle(data);
+  data->Delete();
+
+  vtkAbstractArray* taken = recycler->TakeArray("vtkFloatArray", 3);
+  if (!taken)
+    {
+    cerr << "The array was not recycled." << endl;
+    return 0;
+    }
+  int result = 1;
+  if (taken->GetName() || taken->HasAComponentName() ||
+      taken->GetComponentName(0) ||
+      vtkDataArray::SafeDownCast(taken)->GetLookupTable())
+    {
+    cerr << "The recycled array kept the names of its previous owner."
+         << endl;
+    result = 0;
+    }
+  taken->Delete();
+  return result;
+}
+
+int TestOutputRecycler(int, char*[])
+{
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(40);
+  VTK_CREATE(vtkElevationFilter, elevation);
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  elevation->SetLowPoint(0.0, 0.0, -0.5);
+  elevation->SetHighPoint(0.0, 0.0, 0.5);
+
+  if (!TestContour(elevation->GetOutputPort()) ||
+      !TestThreshold(elevation->GetOutputPort()) ||
+      !TestGlyph(elevation->GetOutputPort()) ||
+      !TestTakeArray())
+    {
+    return 1;
+    }
+
+  // Turning recycling off releases the recycler.
+  VTK_CREATE(vtkContourFilter, contour);
+  contour->SetInputConnection(elevation->GetOutputPort());
+  contour->SetValue(0, 0.5);
+  vtkDemandDrivenPipeline* ddp = RecycleOutput(contour);
+  contour->Update();
+  ddp->SetRecycleOutputFlag(0, 0);
+  if (ddp->GetRecycleOutputFlag(0) || ddp->GetOutputRecycler(0) ||
+      vtkOutputRecycler::GetRecycler(contour->GetOutput()))
+    {
+    cerr << "Recycling was not turned off." << endl;
+    return 1;
+    }
+  return 0;
+}
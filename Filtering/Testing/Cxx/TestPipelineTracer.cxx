@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineTracer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Trace the update of a small pipeline and check the recorded passes,
+// times, sizes and the Chrome trace output.
+
+#include "vtkClipPolyData.h"
+#include "vtkDataArrayAllocator.h"
+#include "vtkElevationFilter.h"
+#include "vtkPipelineTracer.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <vtkstd/string>
+#include <vtksys/ios/sstream>
+
+#include <string.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Return the index of the event of the given algorithm and pass, or -1.
+static int FindEvent(vtkPipelineTracer* tracer, const char* algorithm,
+                     const char* pass)
+{
+  for (int i = 0; i < tracer->GetNumberOfEvents(); i++)
+    {
+    if (strcmp(tracer->GetEventAlgorithm(i), algorithm) == 0 &&
+        strcmp(tracer->GetEventPass(i), pass) == 0)
+      {
+      return i;
+      }
+    }
+  cerr << "No " << pass << " event for " << algorithm << endl;
+  return -1;
+}
+
+int TestPipelineTracer(int, char*[])
+{
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  VTK_CREATE(vtkElevationFilter, elevation);
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  VTK_CREATE(vtkClipPolyData, clip);
+  clip->SetInputConnection(elevation->GetOutputPort());
+  clip->SetValue(0.25);
+
+  VTK_CREATE(vtkPipelineTracer, tracer);
+  tracer->Start();
+  if (vtkPipelineTracer::GetActiveTracer() != tracer.GetPointer())
+    {
+    cerr << "The tracer is not active" << endl;
+    return 1;
+    }
+  clip->Update();
+  tracer->Stop();
+  int numberOfEvents = tracer->GetNumberOfEvents();
+
+  int errors = 0;
+  if (vtkDataArrayAllocator::GetGlobalAllocator())
+    {
+    cerr << "The global allocator was not restored" << endl;
+    errors++;
+    }
+
+  // Every algorithm goes through the main passes.
+  const char* algorithms[3] =
+    { "vtkSphereSource", "vtkElevationFilter", "vtkClipPolyData" };
+  int data[3];
+  for (int a = 0; a < 3; a++)
+    {
+    if (FindEvent(tracer, algorithms[a], "REQUEST_INFORMATION") < 0 ||
+        FindEvent(tracer, algorithms[a], "REQUEST_UPDATE_EXTENT") < 0 ||
+        (data[a] = FindEvent(tracer, algorithms[a], "REQUEST_DATA")) < 0)
+      {
+      return 1;
+      }
+    }
+
+  for (int i = 0; i < numberOfEvents; i++)
+    {
+    if (tracer->GetEventStartTime(i) < 0.0 ||
+        tracer->GetEventEndTime(i) < tracer->GetEventStartTime(i) ||
+        tracer->GetEventThread(i) != 0)
+      {
+      cerr << "Event " << i << " has bad times or thread" << endl;
+      errors++;
+      }
+    }
+
+  // Data passes run upstream first, and report their outputs and the
+  // arrays they allocated.
+  for (int a = 0; a < 3; a++)
+    {
+    if (a > 0 && tracer->GetEventStartTime(data[a]) <
+        tracer->GetEventEndTime(data[a-1]))
+      {
+      cerr << algorithms[a] << " ran before its input" << endl;
+      errors++;
+      }
+    if (tracer->GetEventOutputSize(data[a]) <= 0.0 ||
+        tracer->GetEventAllocatedSize(data[a]) <= 0.0)
+      {
+      cerr << algorithms[a] << " reported no output or allocation" << endl;
+      errors++;
+      }
+    }
+  int info = FindEvent(tracer, "vtkSphereSource", "REQUEST_INFORMATION");
+  if (tracer->GetEventOutputSize(info) != -1.0)
+    {
+    cerr << "An output size was reported for REQUEST_INFORMATION" << endl;
+    errors++;
+    }
+
+  // Nothing is recorded once stopped.
+  sphere->SetThetaResolution(32);
+  clip->Update();
+  if (tracer->GetNumberOfEvents() != numberOfEvents)
+    {
+    cerr << "Events were recorded after Stop" << endl;
+    errors++;
+    }
+
+  // One complete event per record, and one name per thread.
+  vtksys_ios::ostringstream json;
+  tracer->WriteChromeTrace(json);
+  vtkstd::string text = json.str();
+  int complete = 0;
+  for (size_t pos = text.find("\"ph\":\"X\""); pos != vtkstd::string::npos;
+       pos = text.find("\"ph\":\"X\"", pos + 1))
+    {
+    complete++;
+    }
+  if (text.find("{\"traceEvents\":[") != 0 || complete != numberOfEvents ||
+      text.find("\"thread_name\"") == vtkstd::string::npos ||
+      text.find("\"cat\":\"REQUEST_DATA\"") == vtkstd::string::npos)
+    {
+    cerr << "Bad Chrome trace:\n" << text << endl;
+    errors++;
+    }
+
+  tracer->Clear();
+  if (tracer->GetNumberOfEvents() != 0)
+    {
+    cerr << "Events were not cleared" << endl;
+    errors++;
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedStreamingPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Update independent branches feeding a vtkAppendPolyData with the
+// threaded pipeline and check that they overlap, that each algorithm
+// executes once and after its inputs, that non-reentrant algorithms
+// never overlap, that consumers of a shared output that do not read it
+// concurrently never overlap, and that Pull() updates the inputs it is
+// given.
+
+#include "vtkAlgorithmOutput.h"
+#include "vtkAppendPolyData.h"
+#include "vtkCriticalSection.h"
+#include "vtkElevationFilter.h"
+#include "vtkExecutionScheduler.h"
+#include "vtkExecutiveCollection.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreadedStreamingPipeline.h"
+#include "vtkThreadPool.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Count the sources executing at the same time.
+static vtkSimpleCriticalSection CountLock;
+static int Running = 0;
+static int MaximumRunning = 0;
+static int RunningNonReentrant = 0;
+static int MaximumRunningNonReentrant = 0;
+static int Executions = 0;
+static int RunningReaders = 0;
+static int MaximumRunningReaders = 0;
+
+// A sphere source that takes some time to execute.
+class vtkSlowSphereSource : public vtkSphereSource
+{
+public:
+  static vtkSlowSphereSource *New();
+  vtkTypeMacro(vtkSlowSphereSource,vtkSphereSource);
+
+protected:
+  vtkSlowSphereSource() {}
+
+  virtual int RequestData(vtkInformation *request,
+                          vtkInformationVector **inputVector,
+                          vtkInformationVector *outputVector)
+    {
+    int nonReentrant = this->GetInformation()->
+      Get(vtkThreadedStreamingPipeline::NON_REENTRANT());
+    CountLock.Lock();
+    Executions++;
+    int &running = nonReentrant ? RunningNonReentrant : Running;
+    int &maximum =
+      nonReentrant ? MaximumRunningNonReentrant : MaximumRunning;
+    if (++running > maximum)
+      {
+      maximum = running;
+      }
+    CountLock.Unlock();
+
+    vtksys::SystemTools::Delay(50);
+    int result =
+      this->Superclass::RequestData(request, inputVector, outputVector);
+
+    CountLock.Lock();
+    running--;
+    CountLock.Unlock();
+    return result;
+    }
+
+private:
+  vtkSlowSphereSource(const vtkSlowSphereSource&);  // Not implemented.
+  void operator=(const vtkSlowSphereSource&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkSlowSphereSource);
+
+// A consumer that reads its input with vtkDataSet::GetPoint(id), which
+// returns a buffer of the input and is not thread safe.
+class vtkSlowPointReader : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSlowPointReader *New();
+  vtkTypeMacro(vtkSlowPointReader,vtkPolyDataAlgorithm);
+
+protected:
+  vtkSlowPointReader() {}
+
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **inputVector,
+                          vtkInformationVector *outputVector)
+    {
+    vtkPolyData *input = vtkPolyData::GetData(inputVector[0]);
+    vtkPolyData *output = vtkPolyData::GetData(outputVector);
+    CountLock.Lock();
+    if (++RunningReaders > MaximumRunningReaders)
+      {
+      MaximumRunningReaders = RunningReaders;
+      }
+    CountLock.Unlock();
+
+    int result = 1;
+    for (vtkIdType i = 0; i < input->GetNumberOfPoints(); i++)
+      {
+      double *x = input->GetPoint(i);
+      double y[3];
+      input->GetPoints()->GetPoint(i, y);
+      if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+        {
+        result = 0;
+        }
+      }
+    vtksys::SystemTools::Delay(50);
+    output->ShallowCopy(input);
+
+    CountLock.Lock();
+    RunningReaders--;
+    CountLock.Unlock();
+    return result;
+    }
+
+private:
+  vtkSlowPointReader(const vtkSlowPointReader&);  // Not implemented.
+  void operator=(const vtkSlowPointReader&);  // Not implemented.
+};
+
+vtkStandardNewMacro(vtkSlowPointReader);
+
+// Build four sphere branches, a shared one read twice by elevation
+// filters and a shared one read twice by point readers, all appended.
+static vtkAppendPolyData *BuildNetwork(int nonReentrant)
+{
+  vtkAppendPolyData *append = vtkAppendPolyData::New();
+  for (int i = 0; i < 4; i++)
+    {
+    VTK_CREATE(vtkSlowSphereSource, sphere);
+    sphere->SetCenter(i, 0.0, 0.0);
+    sphere->SetThetaResolution(8 + i);
+    if (nonReentrant)
+      {
+      sphere->GetInformation()->
+        Set(vtkThreadedStreamingPipeline::NON_REENTRANT(), 1);
+      }
+    VTK_CREATE(vtkElevationFilter, elevation);
+    elevation->SetInputConnection(sphere->GetOutputPort());
+    append->AddInputConnection(elevation->GetOutputPort());
+    }
+  VTK_CREATE(vtkSlowSphereSource, shared);
+  for (int i = 0; i < 2; i++)
+    {
+    VTK_CREATE(vtkElevationFilter, elevation);
+    elevation->SetInputConnection(shared->GetOutputPort());
+    elevation->SetHighPoint(0.0, 0.0, 1.0 + i);
+    append->AddInputConnection(elevation->GetOutputPort());
+    }
+  VTK_CREATE(vtkSlowSphereSource, sharedByReaders);
+  sharedByReaders->SetCenter(0.0, 2.0, 0.0);
+  for (int i = 0; i < 2; i++)
+    {
+    VTK_CREATE(vtkSlowPointReader, reader);
+    reader->SetInputConnection(sharedByReaders->GetOutputPort());
+    append->AddInputConnection(reader->GetOutputPort());
+    }
+  return append;
+}
+
+static void ResetCounts()
+{
+  Running = MaximumRunning = 0;
+  RunningNonReentrant = MaximumRunningNonReentrant = 0;
+  Executions = 0;
+  RunningReaders = MaximumRunningReaders = 0;
+}
+
+int TestThreadedStreamingPipeline(int, char*[])
+{
+  int errors = 0;
+
+  // The serial result.
+  vtkAppendPolyData *serial = BuildNetwork(0);
+  serial->Update();
+  vtkIdType numberOfPoints = serial->GetOutput()->GetNumberOfPoints();
+  serial->Delete();
+
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+  vtkExecutionScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+  vtkThreadedStreamingPipeline *prototype = vtkThreadedStreamingPipeline::New();
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype);
+  prototype->Delete();
+  vtkThreadedStreamingPipeline::SetMultiThreadedEnabled(true);
+
+  for (int nonReentrant = 0; nonReentrant < 2; nonReentrant++)
+    {
+    ResetCounts();
+    vtkAppendPolyData *append = BuildNetwork(nonReentrant);
+    append->Update();
+    if (append->GetOutput()->GetNumberOfPoints() != numberOfPoints)
+      {
+      cerr << "Got " << append->GetOutput()->GetNumberOfPoints()
+           << " points instead of " << numberOfPoints << endl;
+      errors++;
+      }
+    if (Executions != 6)
+      {
+      cerr << "The sources executed " << Executions << " times" << endl;
+      errors++;
+      }
+    if (!nonReentrant && MaximumRunning < 2)
+      {
+      cerr << "Independent branches did not execute concurrently" << endl;
+      errors++;
+      }
+    if (MaximumRunningNonReentrant > 1)
+      {
+      cerr << "Non-reentrant sources executed concurrently" << endl;
+      errors++;
+      }
+    if (MaximumRunningReaders > 1)
+      {
+      cerr << "The readers of a shared output executed concurrently"
+           << endl;
+      errors++;
+      }
+
+    // Nothing is executed again while the network is up to date.
+    ResetCounts();
+    append->Update();
+    if (Executions != 0)
+      {
+      cerr << "An up to date network executed again" << endl;
+      errors++;
+      }
+
+    // Pull() updates a set of executives and their inputs.
+    vtkExecutiveCollection *execs = vtkExecutiveCollection::New();
+    for (int i = 0; i < append->GetNumberOfInputConnections(0); i++)
+      {
+      vtkAlgorithm *elevation =
+        append->GetInputConnection(0, i)->GetProducer();
+      vtkAlgorithm *sphere = elevation->GetInputConnection(0, 0)->GetProducer();
+      static_cast<vtkSphereSource*>(sphere)->SetPhiResolution(12);
+      execs->AddItem(elevation->GetExecutive());
+      }
+    ResetCounts();
+    vtkThreadedStreamingPipeline::Pull(execs);
+    execs->Delete();
+    if (Executions != 6)
+      {
+      cerr << "Pull executed the sources " << Executions << " times" << endl;
+      errors++;
+      }
+
+    // Pull(info) on the appender updates its inputs and hands info to
+    // the algorithms that produce them.
+    for (int i = 0; i < append->GetNumberOfInputConnections(0); i++)
+      {
+      vtkAlgorithm *elevation =
+        append->GetInputConnection(0, i)->GetProducer();
+      vtkAlgorithm *sphere = elevation->GetInputConnection(0, 0)->GetProducer();
+      static_cast<vtkSphereSource*>(sphere)->SetPhiResolution(10);
+      }
+    VTK_CREATE(vtkInformation, info);
+    ResetCounts();
+    vtkThreadedStreamingPipeline::SafeDownCast(append->GetExecutive())->
+      Pull(info);
+    if (Executions != 6)
+      {
+      cerr << "Pull(info) executed the sources " << Executions << " times"
+           << endl;
+      errors++;
+      }
+    for (int i = 0; i < append->GetNumberOfInputConnections(0); i++)
+      {
+      vtkAlgorithm *elevation =
+        append->GetInputConnection(0, i)->GetProducer();
+      if (elevation->GetInformation()->
+          Get(vtkThreadedStreamingPipeline::EXTRA_INFORMATION()) != info)
+        {
+        cerr << "Pull(info) did not hand info to input " << i << endl;
+        errors++;
+        }
+      }
+    append->Delete();
+    }
+
+  vtkThreadedStreamingPipeline::SetMultiThreadedEnabled(false);
+  vtkAlgorithm::SetDefaultExecutivePrototype(0);
+
+  return (errors == 0) ? 0 : 1;
+}
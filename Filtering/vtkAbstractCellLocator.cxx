@@ -22,6 +22,30 @@
 #include "vtkPoints.h"
 #include "vtkDataSet.h"
 #include "vtkMath.h"
+#include "vtkThreadPool.h"
+
+// Number of cells whose bounds are computed by one task.
+#define VTK_CELL_BOUNDS_BLOCK_SIZE 4096
+
+//----------------------------------------------------------------------------
+struct vtkCellBoundsThreadStruct
+{
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6];
+};
+
+//----------------------------------------------------------------------------
+static void vtkAbstractCellLocatorComputeBounds(vtkIdType begin,
+                                                vtkIdType end, int,
+                                                void *arg)
+{
+  vtkCellBoundsThreadStruct *str =
+    static_cast<vtkCellBoundsThreadStruct *>(arg);
+  for (vtkIdType j=begin; j<end; j++)
+    {
+    str->DataSet->GetCellBounds(j, str->CellBounds[j]);
+    }
+}
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
@@ -34,6 +58,7 @@ vtkAbstractCellLocator::vtkAbstractCellLocator()
   this->NumberOfCellsPerNode       = 32;
   this->UseExistingSearchStructure = 0;
   this->LazyEvaluation             = 0;
+  this->NumberOfThreads            = 1;
   this->GenericCell                = vtkGenericCell::New();
 }
 //----------------------------------------------------------------------------
@@ -49,6 +74,17 @@ bool vtkAbstractCellLocator::StoreCellBounds()
   // Allocate space for cell bounds storage, then fill
   vtkIdType numCells = this->DataSet->GetNumberOfCells();
   this->CellBounds = new double [numCells][6];
+  if (this->NumberOfThreads > 1 && numCells > VTK_CELL_BOUNDS_BLOCK_SIZE)
+    {
+    vtkCellBoundsThreadStruct str;
+    str.DataSet = this->DataSet;
+    str.CellBounds = this->CellBounds;
+    this->DataSet->PrepareForThreadedAccess();
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, numCells, VTK_CELL_BOUNDS_BLOCK_SIZE,
+      vtkAbstractCellLocatorComputeBounds, &str);
+    return true;
+    }
   for (vtkIdType j=0; j<numCells; j++) 
     { 
     this->DataSet->GetCellBounds(j, CellBounds[j]);
@@ -229,5 +265,7 @@ void vtkAbstractCellLocator::PrintSelf(ostream& os, vtkIndent indent)
      << this->UseExistingSearchStructure << "\n";
   os << indent << "LazyEvaluation: " 
      << this->LazyEvaluation << "\n";
+  os << indent << "Number Of Threads: " 
+     << this->NumberOfThreads << "\n";
 }
 //----------------------------------------------------------------------------
@@ -94,6 +94,15 @@ public:
   vtkGetMacro(UseExistingSearchStructure,int);
   vtkBooleanMacro(UseExistingSearchStructure,int);
 
+  // Description:
+  // Set/get the number of threads used to build the search structure.
+  // Cell bounds are then computed concurrently on the vtkThreadPool, and
+  // locators that support it also partition the cells concurrently.  The
+  // resulting structure is the same whatever the number of threads.
+  // Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Return intersection point (if any) of finite line with cells contained
   // in cell locator.
@@ -248,7 +257,8 @@ protected:
   // all cell Bounds into the internal CellBounds array. Subsequent
   // calls to InsideCellBounds(...) can make use of the data
   // A valid dataset must be present for this to work. Returns true
-  // if bounds wre copied, false otherwise.
+  // if bounds wre copied, false otherwise.  The bounds are computed on
+  // NumberOfThreads threads.
   virtual bool StoreCellBounds();
   virtual void FreeCellBounds();
 
@@ -257,6 +267,7 @@ protected:
   int CacheCellBounds;
   int LazyEvaluation;
   int UseExistingSearchStructure;
+  int NumberOfThreads;
   vtkGenericCell *GenericCell;
 //BTX - begin tcl exclude
   double (*CellBounds)[6];
@@ -16,81 +16,314 @@
 
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
+#include "vtkInformationStringKey.h"
 #include "vtkObjectFactory.h"
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
-#include "vtkImageData.h"
+#include "vtkDataObject.h"
 #include "vtkInformation.h"
+#include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationInformationVectorKey.h"
 #include "vtkInformationVector.h"
-#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <vtksys/ios/sstream>
 
 vtkStandardNewMacro(vtkCachedStreamingDemandDrivenPipeline);
 
+vtkInformationKeyMacro(vtkCachedStreamingDemandDrivenPipeline, CACHE_KEY, String);
+
+//----------------------------------------------------------------------------
+// A cached result, or the description of a request.
+class vtkCachedStreamingDemandDrivenPipelineResult
+{
+public:
+  vtkSmartPointer<vtkDataObject> Data;
+
+  // What identifies the result.
+  unsigned long PipelineMTime;
+  int HasKey;
+  vtkstd::string Key;
+  vtkstd::string Arrays;
+  vtkstd::vector<double> TimeSteps;
+  int Piece;
+  int NumberOfPieces;
+  int GhostLevel;
+  int Extent[6];
+
+  // When the result was last used, and its memory size in kilobytes.
+  unsigned long LastUsed;
+  unsigned long Size;
+};
+
+//----------------------------------------------------------------------------
+class vtkCachedStreamingDemandDrivenPipelineInternals
+{
+public:
+  typedef vtkCachedStreamingDemandDrivenPipelineResult Result;
+  vtkstd::vector<Result> Results;
+  unsigned long UseCount;
+
+  vtkCachedStreamingDemandDrivenPipelineInternals() : UseCount(0) {}
+
+  // Describe the request made to an output port.
+  void GetRequest(vtkAlgorithm* algorithm, unsigned long pipelineMTime,
+                  vtkInformation* outInfo, Result& request);
+
+  // Return whether the data of a result satisfy a request.  Results with
+  // a 3D extent satisfy requests for an extent they contain.
+  int Matches(const Result& result, const Result& request);
+
+  // Discard the results identified by a pipeline modification time older
+  // than the given one.
+  void DiscardStaleResults(unsigned long pipelineMTime);
+};
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipelineInternals
+::GetRequest(vtkAlgorithm* algorithm, unsigned long pipelineMTime,
+             vtkInformation* outInfo, Result& request)
+{
+  typedef vtkStreamingDemandDrivenPipeline SDDP;
+  request.PipelineMTime = pipelineMTime;
+  request.HasKey = outInfo->Has(
+    vtkCachedStreamingDemandDrivenPipeline::CACHE_KEY());
+  request.Key = request.HasKey ?
+    outInfo->Get(vtkCachedStreamingDemandDrivenPipeline::CACHE_KEY()) : "";
+
+  // The arrays the algorithm was asked to process.
+  vtksys_ios::ostringstream arrays;
+  vtkInformationVector* inArrays = algorithm->GetInformation()->Get(
+    vtkAlgorithm::INPUT_ARRAYS_TO_PROCESS());
+  for (int i = 0; inArrays && i < inArrays->GetNumberOfInformationObjects();
+       ++i)
+    {
+    vtkInformation* info = inArrays->GetInformationObject(i);
+    arrays << i << ":" << info->Get(vtkDataObject::FIELD_ASSOCIATION());
+    if (info->Has(vtkDataObject::FIELD_NAME()))
+      {
+      arrays << ":n" << info->Get(vtkDataObject::FIELD_NAME());
+      }
+    else
+      {
+      arrays << ":a" << info->Get(vtkDataObject::FIELD_ATTRIBUTE_TYPE());
+      }
+    arrays << ";";
+    }
+  request.Arrays = arrays.str();
+
+  // The time steps matter only when someone upstream provides time.
+  request.TimeSteps.clear();
+  if (outInfo->Has(SDDP::TIME_RANGE()) &&
+      outInfo->Has(SDDP::UPDATE_TIME_STEPS()))
+    {
+    double* steps = outInfo->Get(SDDP::UPDATE_TIME_STEPS());
+    int length = outInfo->Length(SDDP::UPDATE_TIME_STEPS());
+    request.TimeSteps.assign(steps, steps + length);
+    }
+
+  request.Piece = outInfo->Get(SDDP::UPDATE_PIECE_NUMBER());
+  request.NumberOfPieces = outInfo->Get(SDDP::UPDATE_NUMBER_OF_PIECES());
+  request.GhostLevel = outInfo->Get(SDDP::UPDATE_NUMBER_OF_GHOST_LEVELS());
+  for (int j = 0; j < 6; ++j)
+    {
+    request.Extent[j] = 0;
+    }
+  if (outInfo->Has(SDDP::UPDATE_EXTENT()))
+    {
+    outInfo->Get(SDDP::UPDATE_EXTENT(), request.Extent);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipelineInternals
+::Matches(const Result& result, const Result& request)
+{
+  if (result.HasKey != request.HasKey ||
+      (request.HasKey ? result.Key != request.Key :
+       result.PipelineMTime != request.PipelineMTime) ||
+      result.Arrays != request.Arrays ||
+      result.TimeSteps != request.TimeSteps)
+    {
+    return 0;
+    }
+
+  vtkInformation* dataInfo = result.Data->GetInformation();
+  int extentType = dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE());
+  if (extentType == VTK_3D_EXTENT)
+    {
+    // The update extent must be empty or inside the extent of the data.
+    const int* ue = request.Extent;
+    const int* de = result.Extent;
+    return (ue[0] > ue[1] || ue[2] > ue[3] || ue[4] > ue[5]) ||
+      (ue[0] >= de[0] && ue[1] <= de[1] &&
+       ue[2] >= de[2] && ue[3] <= de[3] &&
+       ue[4] >= de[4] && ue[5] <= de[5]);
+    }
+
+  // Check the unstructured extent as the streaming pipeline does.
+  return result.NumberOfPieces == request.NumberOfPieces &&
+    result.GhostLevel >= request.GhostLevel &&
+    (request.NumberOfPieces == 1 || result.Piece == request.Piece);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipelineInternals
+::DiscardStaleResults(unsigned long pipelineMTime)
+{
+  for (size_t i = this->Results.size(); i > 0; --i)
+    {
+    Result& result = this->Results[i-1];
+    if (!result.HasKey && result.PipelineMTime < pipelineMTime)
+      {
+      this->Results.erase(this->Results.begin() + (i-1));
+      }
+    }
+}
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
 ::vtkCachedStreamingDemandDrivenPipeline()
 {
-  this->CacheSize = 0;
-  this->Data = NULL;
-  this->Times = NULL;
-  
-  this->SetCacheSize(10);
+  this->CachedStreamingDemandDrivenInternal =
+    new vtkCachedStreamingDemandDrivenPipelineInternals;
+  this->CacheSize = 10;
+  this->CacheMemoryLimit = 0;
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
 ::~vtkCachedStreamingDemandDrivenPipeline()
 {
-  this->SetCacheSize(0);
+  delete this->CachedStreamingDemandDrivenInternal;
 }
 
 //----------------------------------------------------------------------------
 void vtkCachedStreamingDemandDrivenPipeline::SetCacheSize(int size)
 {
-  int idx;
-  
+  if (size < 0)
+    {
+    size = 0;
+    }
   if (size == this->CacheSize)
     {
     return;
     }
-  
+
   this->Modified();
-  
-  // free the old data
-  for (idx = 0; idx < this->CacheSize; ++idx)
+  this->CacheSize = size;
+  this->EvictResults();
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::SetCacheMemoryLimit(unsigned long limit)
+{
+  if (limit == this->CacheMemoryLimit)
     {
-    if (this->Data[idx])
-      {
-      this->Data[idx]->Delete();
-      this->Data[idx] = NULL;
-      }
+    return;
     }
-  if (this->Data)
+
+  this->Modified();
+  this->CacheMemoryLimit = limit;
+  this->EvictResults();
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipeline::GetNumberOfCachedResults()
+{
+  return static_cast<int>(this->CachedStreamingDemandDrivenInternal->
+                          Results.size());
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCachedStreamingDemandDrivenPipeline::GetCacheMemorySize()
+{
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+  unsigned long size = 0;
+  for (size_t i = 0; i < internal->Results.size(); ++i)
     {
-    delete [] this->Data;
-    this->Data = NULL;
+    size += internal->Results[i].Size;
     }
-  if (this->Times)
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::ClearCache()
+{
+  this->CachedStreamingDemandDrivenInternal->Results.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::ResetCacheStatistics()
+{
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipeline::SetCacheKey(int port,
+                                                        const char* key)
+{
+  if(!this->OutputPortIndexInRange(port, "set cache key on"))
     {
-    delete [] this->Times;
-    this->Times = NULL;
+    return 0;
     }
-  
-  this->CacheSize = size;
-  if (size == 0)
+  vtkInformation* info = this->GetOutputInformation(port);
+  const char* oldKey = this->GetCacheKey(port);
+  if((!key && !oldKey) || (key && oldKey && strcmp(key, oldKey) == 0))
     {
-    return;
+    return 0;
+    }
+  if(key)
+    {
+    info->Set(CACHE_KEY(), key);
+    }
+  else
+    {
+    info->Remove(CACHE_KEY());
+    }
+  this->Algorithm->Modified();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCachedStreamingDemandDrivenPipeline::GetCacheKey(int port)
+{
+  if(!this->OutputPortIndexInRange(port, "get cache key from"))
+    {
+    return 0;
     }
-  
-  this->Data = new vtkDataObject* [size];
-  this->Times = new unsigned long [size];
+  return this->GetOutputInformation(port)->Get(CACHE_KEY());
+}
 
-  for (idx = 0; idx < size; ++idx)
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::EvictResults()
+{
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+  unsigned long size = this->GetCacheMemorySize();
+  while (!internal->Results.empty() &&
+         (static_cast<int>(internal->Results.size()) > this->CacheSize ||
+          (this->CacheMemoryLimit > 0 && size > this->CacheMemoryLimit)))
     {
-    this->Data[idx] = NULL;
-    this->Times[idx] = 0;
+    size_t lru = 0;
+    for (size_t i = 1; i < internal->Results.size(); ++i)
+      {
+      if (internal->Results[i].LastUsed < internal->Results[lru].LastUsed)
+        {
+        lru = i;
+        }
+      }
+    size -= internal->Results[lru].Size;
+    internal->Results.erase(internal->Results.begin() + lru);
     }
 }
 
@@ -100,6 +333,10 @@ void vtkCachedStreamingDemandDrivenPipeline
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << "\n";
+  os << indent << "NumberOfCacheHits: " << this->NumberOfCacheHits << "\n";
+  os << indent << "NumberOfCacheMisses: " << this->NumberOfCacheMisses
+     << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -120,9 +357,9 @@ int vtkCachedStreamingDemandDrivenPipeline::Update(int port)
     int retval = 1;
     // some streaming filters can request that the pipeline execute multiple
     // times for a single update
-    do 
+    do
       {
-      retval =  
+      retval =
         this->PropagateUpdateExtent(port) && this->UpdateData(port) && retval;
       }
     while (this->ContinueExecuting);
@@ -148,116 +385,67 @@ int vtkCachedStreamingDemandDrivenPipeline
                                                inInfoVec, outInfoVec);
     }
 
-  // Does the superclass want to execute? We must skip our direct superclass
-  // because it looks at update extents but does not know about the cache
-  if(this->vtkDemandDrivenPipeline::NeedToExecuteData(outputPort,
-                                                      inInfoVec, outInfoVec))
+  // Has the algorithm asked to be executed again?
+  if(this->ContinueExecuting)
     {
     return 1;
     }
 
-  // Has the algorithm asked to be executed again?
-  if(this->ContinueExecuting)
+  // Is the output already up to date?
+  if(!this->Superclass::NeedToExecuteData(outputPort, inInfoVec, outInfoVec))
     {
-    return 1;
+    return 0;
     }
 
-  // First look through the cached data to see if it is still valid.
-  int i;
-  unsigned long pmt = this->GetPipelineMTime();
-  for (i = 0; i < this->CacheSize; ++i)
+  // Only the first output is cached.
+  if(outputPort != 0)
     {
-    if (this->Data[i] && this->Times[i] < pmt)
-      {
-      this->Data[i]->Delete();
-      this->Data[i] = NULL;
-      this->Times[i] = 0;
-      }
+    return 1;
     }
 
-  // We need to check the requested update extent.  Get the output
-  // port information and data information.  We do not need to check
-  // existence of values because it has already been verified by
-  // VerifyOutputInformation.
+  // Results of an older pipeline can never be used again.
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+  internal->DiscardStaleResults(this->PipelineMTime);
+
+  // Look for a cached result that satisfies the request.
   vtkInformation* outInfo = outInfoVec->GetInformationObject(outputPort);
   vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
-  vtkInformation* dataInfo = dataObject->GetInformation();
-  if(dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == VTK_PIECES_EXTENT)
+  vtkCachedStreamingDemandDrivenPipelineResult request;
+  internal->GetRequest(this->Algorithm, this->PipelineMTime, outInfo,
+                       request);
+  for (size_t i = 0; i < internal->Results.size(); ++i)
     {
-    int updatePiece = outInfo->Get(UPDATE_PIECE_NUMBER());
-    int updateNumberOfPieces = outInfo->Get(UPDATE_NUMBER_OF_PIECES());
-    int updateGhostLevel = outInfo->Get(UPDATE_NUMBER_OF_GHOST_LEVELS());
-
-    // check to see if any data in the cache fits this request
-    for (i = 0; i < this->CacheSize; ++i)
+    vtkCachedStreamingDemandDrivenPipelineResult& result =
+      internal->Results[i];
+    if (!internal->Matches(result, request) ||
+        strcmp(result.Data->GetClassName(), dataObject->GetClassName()))
       {
-      if (this->Data[i])
-        {
-        dataInfo = this->Data[i]->GetInformation();
-        
-        // Check the unstructured extent.  If we do not have the requested
-        // piece, we need to execute.
-        int dataPiece = dataInfo->Get(vtkDataObject::DATA_PIECE_NUMBER());
-        int dataNumberOfPieces = 
-          dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_PIECES());
-        int dataGhostLevel = 
-          dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
-        if (dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == 
-            VTK_PIECES_EXTENT && dataPiece == updatePiece &&
-            dataNumberOfPieces == updateNumberOfPieces &&
-            dataGhostLevel == updateGhostLevel)
-          {
-          // we have a matching data we must copy it to our output, but for
-          // now we don't support polydata
-          return 1;
-          }
-        }
+      continue;
       }
-    }
-  else if (dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == VTK_3D_EXTENT)
-    {
-    // Check the structured extent.  If the update extent is outside
-    // of the extent and not empty, we need to execute.
-    int dataExtent[6];
-    int updateExtent[6];
-    outInfo->Get(UPDATE_EXTENT(), updateExtent);
-
-    // check to see if any data in the cache fits this request
-    for (i = 0; i < this->CacheSize; ++i)
+
+    // Pass the cached result to the output.
+    dataObject->ShallowCopy(result.Data);
+    vtkInformation* dataInfo = dataObject->GetInformation();
+    dataInfo->Set(vtkDataObject::DATA_PIECE_NUMBER(), result.Piece);
+    dataInfo->Set(vtkDataObject::DATA_NUMBER_OF_PIECES(),
+                  result.NumberOfPieces);
+    dataInfo->Set(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS(),
+                  result.GhostLevel);
+    if (outInfo->Has(UPDATE_TIME_STEPS()))
       {
-      if (this->Data[i])
-        {
-        dataInfo = this->Data[i]->GetInformation();
-        dataInfo->Get(vtkDataObject::DATA_EXTENT(), dataExtent);
-        if(dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == 
-           VTK_3D_EXTENT &&
-           !(updateExtent[0] < dataExtent[0] ||
-             updateExtent[1] > dataExtent[1] ||
-             updateExtent[2] < dataExtent[2] ||
-             updateExtent[3] > dataExtent[3] ||
-             updateExtent[4] < dataExtent[4] ||
-             updateExtent[5] > dataExtent[5]) &&
-           (updateExtent[0] <= updateExtent[1] &&
-            updateExtent[2] <= updateExtent[3] &&
-            updateExtent[4] <= updateExtent[5]))
-          {
-          // we have a match
-          // Pass this data to output.
-          vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
-          vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[i]);
-          if (id && id2)
-            {
-            id->SetExtent(dataExtent);
-            id->GetPointData()->PassData(id2->GetPointData());
-            // not sure if we need this
-            dataObject->DataHasBeenGenerated();
-            return 0;
-            }
-          }
-        }
+      outInfo->Set(PREVIOUS_UPDATE_TIME_STEPS(),
+                   outInfo->Get(UPDATE_TIME_STEPS()),
+                   outInfo->Length(UPDATE_TIME_STEPS()));
       }
+    dataObject->DataHasBeenGenerated();
+    this->DataTime.Modified();
+
+    result.LastUsed = ++internal->UseCount;
+    this->NumberOfCacheHits++;
+    return 0;
     }
-  
+
   // We do need to execute
   return 1;
 }
@@ -269,68 +457,63 @@ int vtkCachedStreamingDemandDrivenPipeline
               vtkInformationVector** inInfoVec,
               vtkInformationVector* outInfoVec)
 {
-  // only works for one in one out algorithms
-  if (request->Get(FROM_OUTPUT_PORT()) != 0)
+  // only works for algorithms requesting their first output
+  if (request->Get(FROM_OUTPUT_PORT()) > 0)
     {
     vtkErrorMacro("vtkCachedStreamingDemandDrivenPipeline can only be used for algorithms with one output and one input");
     return 0;
     }
-  
+
   // first do the ususal thing
   int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
-  
-  // then save the newly generated data
-  unsigned long bestTime = VTK_LARGE_INTEGER;
-  int bestIdx = 0;
-  
-  // Save the image in cache.
-  // Find a spot to put the data.
-  for (int i = 0; i < this->CacheSize; ++i)
+  this->NumberOfCacheMisses++;
+  if (!result || this->ContinueExecuting || this->CacheSize == 0)
     {
-    if (this->Data[i] == NULL)
-      {
-      bestIdx = i;
-      bestTime = 0;
-      break;
-      }
-    if (this->Times[i] < bestTime)
-      {
-      bestIdx = i;
-      bestTime = this->Times[i];
-      }
+    return result;
     }
 
   vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
   vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
-  if (this->Data[bestIdx] == NULL)
+  if (!dataObject)
     {
-    this->Data[bestIdx] = dataObject->NewInstance();
+    return result;
     }
-  this->Data[bestIdx]->ReleaseData();
 
-  vtkImageData *id = vtkImageData::SafeDownCast(dataObject);  
-  if (id)
+  // then save the newly generated data, replacing a result for the same
+  // request
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+  internal->DiscardStaleResults(this->PipelineMTime);
+  vtkCachedStreamingDemandDrivenPipelineResult entry;
+  internal->GetRequest(this->Algorithm, this->PipelineMTime, outInfo, entry);
+  for (size_t i = internal->Results.size(); i > 0; --i)
     {
-    vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
-    vtkImageData *input = 
-      vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-    id->SetExtent(input->GetExtent());
-    id->GetPointData()->PassData(input->GetPointData());
-    id->DataHasBeenGenerated();
+    if (internal->Matches(internal->Results[i-1], entry))
+      {
+      internal->Results.erase(internal->Results.begin() + (i-1));
+      }
     }
-  
-  vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[bestIdx]);
-  if (id && id2)
+
+  entry.Data.TakeReference(dataObject->NewInstance());
+  entry.Data->ShallowCopy(dataObject);
+  vtkInformation* dataInfo = dataObject->GetInformation();
+  entry.Piece = dataInfo->Get(vtkDataObject::DATA_PIECE_NUMBER());
+  entry.NumberOfPieces = dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_PIECES());
+  entry.GhostLevel =
+    dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
+  if (dataInfo->Has(vtkDataObject::DATA_EXTENT()))
     {
-    id2->SetExtent(id->GetExtent());
-    id2->SetScalarType(id->GetScalarType());
-    id2->SetNumberOfScalarComponents(
-      id->GetNumberOfScalarComponents());
-    id2->GetPointData()->SetScalars(
-      id->GetPointData()->GetScalars());
+    dataInfo->Get(vtkDataObject::DATA_EXTENT(), entry.Extent);
     }
-  
-  this->Times[bestIdx] = dataObject->GetUpdateTime();
-  
+  entry.LastUsed = ++internal->UseCount;
+  entry.Size = entry.Data->GetActualMemorySize();
+
+  // A result that does not fit in the memory limit is not cached.
+  if (this->CacheMemoryLimit == 0 || entry.Size <= this->CacheMemoryLimit)
+    {
+    internal->Results.push_back(entry);
+    this->EvictResults();
+    }
+
   return result;
 }
@@ -12,9 +12,40 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
-// .NAME vtkCachedStreamingDemandDrivenPipeline -
+// .NAME vtkCachedStreamingDemandDrivenPipeline - executive that caches results
 // .SECTION Description
-// vtkCachedStreamingDemandDrivenPipeline
+// vtkCachedStreamingDemandDrivenPipeline keeps several results of its
+// algorithm in memory and gives a cached result to the output instead of
+// executing the algorithm when one matches the request.  A result is
+// identified by:
+//
+// \li the pipeline modification time when it was generated, or the cache
+// key of the output port if one is set (see SetCacheKey()),
+// \li the update piece, number of pieces and ghost levels, or the update
+// extent, which may be contained in the extent of the result,
+// \li the requested time steps,
+// \li the input arrays the algorithm was asked to process.
+//
+// Requesting the pieces, extents or time steps of a result again, for
+// example while scrubbing back and forth through time, does not execute
+// the pipeline.  Results are shallow copies of the output, so they share
+// the memory of the arrays the algorithm produced.
+//
+// Results identified by the pipeline modification time become useless
+// as soon as the pipeline is modified and are discarded.  To cache
+// results across parameter changes, for example while toggling between
+// a few filter settings, the application sets a cache key describing
+// everything the result depends on along with the parameters.  Results
+// with a cache key are not invalidated by modifications; the
+// application is responsible for changing the key when the result would
+// change.
+//
+// The number of results and the memory they use are limited by
+// SetCacheSize() and SetCacheMemoryLimit().  The least recently used
+// results are evicted first.  Only the first output port is cached.
+//
+// .SECTION See Also
+// vtkImageCacheFilter
 
 #ifndef __vtkCachedStreamingDemandDrivenPipeline_h
 #define __vtkCachedStreamingDemandDrivenPipeline_h
@@ -23,6 +54,7 @@
 
 class vtkInformationIntegerKey;
 class vtkInformationIntegerVectorKey;
+class vtkInformationStringKey;
 class vtkCachedStreamingDemandDrivenPipelineInternals;
 
 class VTK_FILTERING_EXPORT vtkCachedStreamingDemandDrivenPipeline : 
@@ -40,11 +72,48 @@ public:
   virtual int Update(int port);
 
   // Description:
-  // This is the maximum number of images that can be retained in memory.
-  // it defaults to 10.
+  // This is the maximum number of results that can be retained in
+  // memory.  It defaults to 10.
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize, int);
 
+  // Description:
+  // The maximum memory in kilobytes (1024 bytes) used by the cached
+  // results, as reported by their GetActualMemorySize().  A result that
+  // does not fit is not cached.  0, the default, means no limit.
+  void SetCacheMemoryLimit(unsigned long limit);
+  vtkGetMacro(CacheMemoryLimit, unsigned long);
+
+  // Description:
+  // Get the number of cached results and the memory in kilobytes they
+  // use.
+  int GetNumberOfCachedResults();
+  unsigned long GetCacheMemorySize();
+
+  // Description:
+  // Discard all the cached results.
+  void ClearCache();
+
+  // Description:
+  // The number of requests satisfied by a cached result, and the number
+  // of requests that executed the algorithm.  Counted since the
+  // executive was created or ResetCacheStatistics() was last called.
+  vtkGetMacro(NumberOfCacheHits, vtkIdType);
+  vtkGetMacro(NumberOfCacheMisses, vtkIdType);
+  void ResetCacheStatistics();
+
+  // Description:
+  // Set/Get the cache key of an output port.  When a key is set, the
+  // results are identified by the key instead of the pipeline
+  // modification time.  Setting NULL removes the key.  Changing the key
+  // modifies the algorithm so that the next update looks it up.
+  int SetCacheKey(int port, const char* key);
+  const char* GetCacheKey(int port);
+
+  // Description:
+  // Key to store the cache key in the output port information.
+  static vtkInformationStringKey* CACHE_KEY();
+
 protected:
   vtkCachedStreamingDemandDrivenPipeline();
   ~vtkCachedStreamingDemandDrivenPipeline();
@@ -55,11 +124,15 @@ protected:
   virtual int ExecuteData(vtkInformation* request,
                           vtkInformationVector** inInfoVec,
                           vtkInformationVector* outInfoVec);
-  
+
+  // Evict the least recently used results until the cache fits in its
+  // limits.
+  void EvictResults();
+
   int CacheSize;
-  
-  vtkDataObject **Data;
-  unsigned long *Times;
+  unsigned long CacheMemoryLimit;
+  vtkIdType NumberOfCacheHits;
+  vtkIdType NumberOfCacheMisses;
 
 private:
   vtkCachedStreamingDemandDrivenPipelineInternals* CachedStreamingDemandDrivenInternal;
@@ -20,6 +20,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkBox.h"
+#include "vtkThreadPool.h"
+
+#include <vtkstd/vector>
 
 #include <math.h>
 
@@ -28,6 +31,9 @@ vtkStandardNewMacro(vtkCellLocator);
 #define VTK_CELL_OUTSIDE 0
 #define VTK_CELL_INSIDE 1
 
+// Minimum number of cells for a concurrent build.
+#define VTK_CELL_LOCATOR_BLOCK_SIZE 4096
+
 typedef vtkIdList *vtkIdListPtr;
 
 //----------------------------------------------------------------------------
@@ -56,6 +62,148 @@ inline int vtkNeighborCells::InsertNextPoint(int *x)
   return id/3;
 }
 
+//----------------------------------------------------------------------------
+// Compute the range of leaf octants overlapped by the given cell bounds.
+static inline void vtkCellLocatorLeafRange(const double *cellBounds,
+                                           const double bounds[6],
+                                           const double h[3],
+                                           const double hTol[3], int ndivs,
+                                           int ijkMin[3], int ijkMax[3])
+{
+  for (int i=0; i<3; i++)
+    {
+    ijkMin[i] = static_cast<int>(
+      (cellBounds[2*i] - bounds[2*i] - hTol[i])/ h[i]);
+    ijkMax[i] = static_cast<int>(
+      (cellBounds[2*i+1] - bounds[2*i] + hTol[i]) / h[i]);
+
+    if (ijkMin[i] < 0)
+      {
+      ijkMin[i] = 0;
+      }
+    if (ijkMax[i] >= ndivs)
+      {
+      ijkMax[i] = ndivs-1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The concurrent build sorts the cells into slabs of leaf octants along z.
+// Each chunk of cells first computes the leaf range of its cells and lists
+// them per slab; each slab then fills its own octants, visiting the chunks
+// in order so that the octant lists are sorted by cell id as in the serial
+// build.
+typedef vtkstd::vector<vtkIdType> vtkCellLocatorSlabList;
+
+struct vtkCellLocatorThreadStruct
+{
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6];
+  double *Bounds;
+  double *H;
+  double *HTol;
+  int NumberOfDivisions;
+  int NumberOfCellsPerBucket;
+  vtkIdType ParentOffset;
+  vtkIdList **Tree;
+
+  vtkIdType ChunkSize;
+  int NumberOfSlabs;
+  int *LeafRanges;
+  vtkstd::vector<vtkCellLocatorSlabList> SlabLists; // chunk-major
+
+  int SlabStart(int slab)
+    {
+    return static_cast<int>(
+      static_cast<vtkIdType>(slab)*this->NumberOfDivisions /
+      this->NumberOfSlabs);
+    }
+};
+
+//----------------------------------------------------------------------------
+static void vtkCellLocatorSortCells(vtkIdType begin, vtkIdType end, int,
+                                    void *arg)
+{
+  vtkCellLocatorThreadStruct *str =
+    static_cast<vtkCellLocatorThreadStruct *>(arg);
+  vtkCellLocatorSlabList *lists =
+    &str->SlabLists[(begin/str->ChunkSize)*str->NumberOfSlabs];
+  double cellBounds[6], *boundsPtr = cellBounds;
+  for (vtkIdType cellId=begin; cellId<end; cellId++)
+    {
+    if (str->CellBounds)
+      {
+      boundsPtr = str->CellBounds[cellId];
+      }
+    else
+      {
+      str->DataSet->GetCellBounds(cellId, cellBounds);
+      }
+    int *range = str->LeafRanges + 6*cellId;
+    vtkCellLocatorLeafRange(boundsPtr, str->Bounds, str->H, str->HTol,
+                            str->NumberOfDivisions, range, range+3);
+    for (int slab=0; slab<str->NumberOfSlabs; slab++)
+      {
+      if (range[2] < str->SlabStart(slab+1) &&
+          range[5] >= str->SlabStart(slab))
+        {
+        lists[slab].push_back(cellId);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static void vtkCellLocatorFillSlabs(vtkIdType begin, vtkIdType end, int,
+                                    void *arg)
+{
+  vtkCellLocatorThreadStruct *str =
+    static_cast<vtkCellLocatorThreadStruct *>(arg);
+  int ndivs = str->NumberOfDivisions;
+  vtkIdType product = static_cast<vtkIdType>(ndivs)*ndivs;
+  vtkIdType numChunks =
+    static_cast<vtkIdType>(str->SlabLists.size())/str->NumberOfSlabs;
+  for (int slab=static_cast<int>(begin); slab<end; slab++)
+    {
+    int kStart = str->SlabStart(slab);
+    int kEnd = str->SlabStart(slab+1);
+    for (vtkIdType chunk=0; chunk<numChunks; chunk++)
+      {
+      vtkCellLocatorSlabList &list =
+        str->SlabLists[chunk*str->NumberOfSlabs + slab];
+      for (size_t n=0; n<list.size(); n++)
+        {
+        vtkIdType cellId = list[n];
+        int *range = str->LeafRanges + 6*cellId;
+        int kMin = (range[2] > kStart ? range[2] : kStart);
+        int kMax = (range[5] < kEnd-1 ? range[5] : kEnd-1);
+        for (int k = kMin; k <= kMax; k++)
+          {
+          for (int j = range[1]; j <= range[4]; j++)
+            {
+            for (int i = range[0]; i <= range[3]; i++)
+              {
+              vtkIdType idx = str->ParentOffset + i + j*ndivs + k*product;
+              vtkIdList *octant = str->Tree[idx];
+              if ( ! octant )
+                {
+                octant = vtkIdList::New();
+                octant->Allocate(str->NumberOfCellsPerBucket,
+                                 str->NumberOfCellsPerBucket/2);
+                str->Tree[idx] = octant;
+                }
+              octant->InsertNextId(cellId);
+              }
+            }
+          }
+        }
+      // The lists of this slab are no longer needed.
+      vtkCellLocatorSlabList().swap(list);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 // Construct with automatic computation of divisions, averaging
 // 25 cells per bucket.
@@ -1292,6 +1440,54 @@ void vtkCellLocator::BuildLocatorInternal()
   parentOffset = numOctants - (ndivs * ndivs * ndivs);
   product = ndivs * ndivs;
   boundsPtr = cellBounds;
+  if ( this->NumberOfThreads > 1 && ndivs > 1 &&
+       numCells > VTK_CELL_LOCATOR_BLOCK_SIZE )
+    {
+    vtkCellLocatorThreadStruct str;
+    str.DataSet = this->DataSet;
+    str.CellBounds = this->CellBounds;
+    str.Bounds = this->Bounds;
+    str.H = this->H;
+    str.HTol = hTol;
+    str.NumberOfDivisions = ndivs;
+    str.NumberOfCellsPerBucket = numCellsPerBucket;
+    str.ParentOffset = parentOffset;
+    str.Tree = this->Tree;
+    vtkIdType numChunks = 4*this->NumberOfThreads;
+    str.ChunkSize = (numCells + numChunks - 1) / numChunks;
+    numChunks = (numCells + str.ChunkSize - 1) / str.ChunkSize;
+    str.NumberOfSlabs = (ndivs < 4*this->NumberOfThreads ?
+                         ndivs : 4*this->NumberOfThreads);
+    str.LeafRanges = new int [6*numCells];
+    str.SlabLists.resize(numChunks*str.NumberOfSlabs);
+
+    this->DataSet->PrepareForThreadedAccess();
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    pool->ParallelFor(0, numCells, str.ChunkSize,
+                      vtkCellLocatorSortCells, &str);
+    pool->ParallelFor(0, str.NumberOfSlabs, 1,
+                      vtkCellLocatorFillSlabs, &str);
+    delete [] str.LeafRanges;
+
+    // Mark the parents of the non-empty leaves.
+    for ( k = 0; k < ndivs; k++ )
+      {
+      for ( j = 0; j < ndivs; j++ )
+        {
+        for ( i = 0; i < ndivs; i++ )
+          {
+          if ( this->Tree[parentOffset + i + j*ndivs + k*product] )
+            {
+            this->MarkParents(reinterpret_cast<void*>(VTK_CELL_INSIDE),
+                              i,j,k,ndivs,this->Level);
+            }
+          }
+        }
+      }
+    this->BuildTime.Modified();
+    return;
+    }
+
   for (cellId=0; cellId<numCells; cellId++) 
     {
     if (this->CellBounds)
@@ -1304,22 +1500,8 @@ void vtkCellLocator::BuildLocatorInternal()
       }
     
     // find min/max locations of bounding box
-    for (i=0; i<3; i++)
-      {
-      ijkMin[i] = static_cast<int>(
-        (boundsPtr[2*i] - this->Bounds[2*i] - hTol[i])/ this->H[i]);
-      ijkMax[i] = static_cast<int>(
-        (boundsPtr[2*i+1] - this->Bounds[2*i] + hTol[i]) / this->H[i]);
-      
-      if (ijkMin[i] < 0)
-        {
-        ijkMin[i] = 0;
-        }
-      if (ijkMax[i] >= ndivs)
-        {
-        ijkMax[i] = ndivs-1;
-        }
-      }
+    vtkCellLocatorLeafRange(boundsPtr, this->Bounds, this->H, hTol, ndivs,
+                            ijkMin, ijkMax);
     
     // each octant inbetween min/max point may have cell in it
     for ( k = ijkMin[2]; k <= ijkMax[2]; k++ )
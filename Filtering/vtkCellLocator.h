@@ -22,6 +22,11 @@
 // inside of it.)  Typical operations are intersection with a line to return
 // candidate cells, or intersection with another vtkCellLocator to return
 // candidate cells.
+//
+// With NumberOfThreads above one, large datasets are inserted into the
+// octree concurrently: the leaf octants are split into slabs along z and
+// each slab is filled by one task.  The resulting octree is identical to
+// the one built serially.
 
 // .SECTION Caveats
 // Many other types of spatial locators have been developed, such as 
@@ -0,0 +1,488 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompactCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCompactCellArray.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkCompactCellArray);
+
+// In both layouts Offsets has NumberOfCells+1 entries and the ids of cell
+// i start at Offsets[i].  In the separate layout a cell ends where the
+// next one starts.  In a legacy view the next cell starts after its
+// point count, so Offsets[i+1] - Offsets[i] - 1 ids belong to cell i.
+
+//----------------------------------------------------------------------------
+// Copy cells from one storage to another, dropping legacy point counts.
+template <class TIn, class TOut>
+void vtkCompactCellArrayConvert(const TIn *inOffsets, const TIn *inConn,
+                                vtkIdType numCells, int legacy,
+                                TOut *outOffsets, TOut *outConn)
+{
+  vtkIdType pos = 0;
+  outOffsets[0] = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    vtkIdType end = static_cast<vtkIdType>(inOffsets[cellId+1]) - legacy;
+    for (vtkIdType i = static_cast<vtkIdType>(inOffsets[cellId]); i < end;
+         i++)
+      {
+      outConn[pos++] = static_cast<TOut>(inConn[i]);
+      }
+    outOffsets[cellId+1] = static_cast<TOut>(pos);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TIn>
+void vtkCompactCellArrayConvert(const TIn *inOffsets, const TIn *inConn,
+                                vtkIdType numCells, int legacy,
+                                vtkDataArray *outOffsets,
+                                vtkDataArray *outConn)
+{
+  if (outOffsets->GetDataType() == VTK_INT)
+    {
+    vtkCompactCellArrayConvert(
+      inOffsets, inConn, numCells, legacy,
+      static_cast<vtkIntArray *>(outOffsets)->GetPointer(0),
+      static_cast<vtkIntArray *>(outConn)->GetPointer(0));
+    }
+  else
+    {
+    vtkCompactCellArrayConvert(
+      inOffsets, inConn, numCells, legacy,
+      static_cast<vtkIdTypeArray *>(outOffsets)->GetPointer(0),
+      static_cast<vtkIdTypeArray *>(outConn)->GetPointer(0));
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TArray, class T>
+vtkIdType vtkCompactCellArrayInsert(TArray *offsets, TArray *conn,
+                                    vtkIdType npts, const vtkIdType *pts, T)
+{
+  vtkIdType loc = conn->GetMaxId() + 1;
+  T *ptr = conn->WritePointer(loc, npts);
+  for (vtkIdType i = 0; i < npts; i++)
+    {
+    ptr[i] = static_cast<T>(pts[i]);
+    }
+  offsets->InsertNextValue(static_cast<T>(loc + npts));
+  return offsets->GetMaxId() - 1;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkCompactCellArrayGetPoints(const T *offsets, const T *conn,
+                                  vtkIdType cellId, int legacy,
+                                  vtkIdType &npts, vtkIdType *pts)
+{
+  const T *ptr = conn + offsets[cellId];
+  npts = static_cast<vtkIdType>(offsets[cellId+1] - offsets[cellId]) - legacy;
+  for (vtkIdType i = 0; i < npts; i++)
+    {
+    pts[i] = static_cast<vtkIdType>(ptr[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkCompactCellArray::vtkCompactCellArray()
+{
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->Use32BitIds = 0;
+  this->LegacyView = 0;
+  this->CreateArrays();
+}
+
+//----------------------------------------------------------------------------
+vtkCompactCellArray::~vtkCompactCellArray()
+{
+  this->SetArrays(NULL, NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::SetArrays(vtkDataArray *offsets,
+                                    vtkDataArray *connectivity)
+{
+  if (offsets)
+    {
+    offsets->Register(this);
+    }
+  if (connectivity)
+    {
+    connectivity->Register(this);
+    }
+  if (this->Offsets)
+    {
+    this->Offsets->UnRegister(this);
+    }
+  if (this->Connectivity)
+    {
+    this->Connectivity->UnRegister(this);
+    }
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::CreateArrays()
+{
+  vtkDataArray *offsets, *connectivity;
+  if (this->Use32BitIds)
+    {
+    vtkIntArray *intOffsets = vtkIntArray::New();
+    intOffsets->InsertNextValue(0);
+    offsets = intOffsets;
+    connectivity = vtkIntArray::New();
+    }
+  else
+    {
+    vtkIdTypeArray *idOffsets = vtkIdTypeArray::New();
+    idOffsets->InsertNextValue(0);
+    offsets = idOffsets;
+    connectivity = vtkIdTypeArray::New();
+    }
+  this->SetArrays(offsets, connectivity);
+  offsets->Delete();
+  connectivity->Delete();
+  this->LegacyView = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Allocate(vtkIdType numCells,
+                                   vtkIdType connectivitySize)
+{
+  this->CreateArrays();
+  this->Offsets->Allocate(numCells + 1);
+  if (this->Use32BitIds)
+    {
+    static_cast<vtkIntArray *>(this->Offsets)->InsertNextValue(0);
+    }
+  else
+    {
+    static_cast<vtkIdTypeArray *>(this->Offsets)->InsertNextValue(0);
+    }
+  this->Connectivity->Allocate(connectivitySize);
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Initialize()
+{
+  this->CreateArrays();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::GetNumberOfCells()
+{
+  return this->Offsets->GetNumberOfTuples() - 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::GetNumberOfConnectivityEntries()
+{
+  return this->Connectivity->GetNumberOfTuples() -
+    (this->LegacyView ? this->GetNumberOfCells() : 0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::InsertNextCell(vtkIdType npts,
+                                              const vtkIdType *pts)
+{
+  if (this->LegacyView)
+    {
+    this->Compact();
+    }
+  if (this->Use32BitIds)
+    {
+    return vtkCompactCellArrayInsert(
+      static_cast<vtkIntArray *>(this->Offsets),
+      static_cast<vtkIntArray *>(this->Connectivity), npts, pts, int());
+    }
+  return vtkCompactCellArrayInsert(
+    static_cast<vtkIdTypeArray *>(this->Offsets),
+    static_cast<vtkIdTypeArray *>(this->Connectivity), npts, pts,
+    vtkIdType());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::InsertNextCell(vtkIdList *pts)
+{
+  return this->InsertNextCell(pts->GetNumberOfIds(), pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::GetCellSize(vtkIdType cellId)
+{
+  if (this->Use32BitIds)
+    {
+    int *offsets = static_cast<vtkIntArray *>(this->Offsets)->GetPointer(0);
+    return offsets[cellId+1] - offsets[cellId];
+    }
+  vtkIdType *offsets =
+    static_cast<vtkIdTypeArray *>(this->Offsets)->GetPointer(0);
+  return offsets[cellId+1] - offsets[cellId] - this->LegacyView;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::GetCellPoints(vtkIdType cellId, vtkIdType &npts,
+                                        vtkIdType *pts)
+{
+  if (this->Use32BitIds)
+    {
+    vtkCompactCellArrayGetPoints(
+      static_cast<vtkIntArray *>(this->Offsets)->GetPointer(0),
+      static_cast<vtkIntArray *>(this->Connectivity)->GetPointer(0),
+      cellId, 0, npts, pts);
+    }
+  else
+    {
+    vtkCompactCellArrayGetPoints(
+      static_cast<vtkIdTypeArray *>(this->Offsets)->GetPointer(0),
+      static_cast<vtkIdTypeArray *>(this->Connectivity)->GetPointer(0),
+      cellId, this->LegacyView, npts, pts);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::GetCellPoints(vtkIdType cellId, vtkIdList *pts)
+{
+  vtkIdType npts;
+  pts->SetNumberOfIds(this->GetCellSize(cellId));
+  this->GetCellPoints(cellId, npts, pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+int vtkCompactCellArray::GetCellPointer(vtkIdType cellId, vtkIdType &npts,
+                                        vtkIdType* &pts)
+{
+  if (this->Use32BitIds)
+    {
+    npts = 0;
+    pts = NULL;
+    return 0;
+    }
+  vtkIdType *offsets =
+    static_cast<vtkIdTypeArray *>(this->Offsets)->GetPointer(0);
+  npts = offsets[cellId+1] - offsets[cellId] - this->LegacyView;
+  pts = static_cast<vtkIdTypeArray *>(this->Connectivity)->GetPointer(0) +
+    offsets[cellId];
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCompactCellArray::CanUse32BitIds(vtkIdType numPoints,
+                                        vtkIdType connectivitySize)
+{
+  return numPoints <= static_cast<vtkIdType>(VTK_INT_MAX) &&
+    connectivitySize <= static_cast<vtkIdType>(VTK_INT_MAX);
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::SetUse32BitIds(int use32)
+{
+  use32 = (use32 ? 1 : 0);
+  if (use32 != this->Use32BitIds)
+    {
+    this->ConvertStorage(use32);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCompactCellArray::ConvertStorage(int use32)
+{
+  vtkIdType numCells = this->GetNumberOfCells();
+  vtkIdType numEntries = this->GetNumberOfConnectivityEntries();
+  if (use32 && numEntries > 0)
+    {
+    // Legacy point counts are small, so the range can be taken over the
+    // whole connectivity array.
+    double range[2];
+    this->Connectivity->GetRange(range, 0);
+    if (range[0] < 0 ||
+        !vtkCompactCellArray::CanUse32BitIds(
+          static_cast<vtkIdType>(range[1]) + 1, numEntries))
+      {
+      vtkErrorMacro("The point ids of the cells do not fit in 32 bits.");
+      return 0;
+      }
+    }
+
+  vtkDataArray *offsets = this->Offsets;
+  vtkDataArray *connectivity = this->Connectivity;
+  offsets->Register(this);
+  connectivity->Register(this);
+  int legacy = this->LegacyView;
+
+  this->Use32BitIds = use32;
+  this->CreateArrays();
+  this->Offsets->SetNumberOfTuples(numCells + 1);
+  this->Connectivity->SetNumberOfTuples(numEntries);
+  if (offsets->GetDataType() == VTK_INT)
+    {
+    vtkCompactCellArrayConvert(
+      static_cast<vtkIntArray *>(offsets)->GetPointer(0),
+      static_cast<vtkIntArray *>(connectivity)->GetPointer(0),
+      numCells, legacy, this->Offsets, this->Connectivity);
+    }
+  else
+    {
+    vtkCompactCellArrayConvert(
+      static_cast<vtkIdTypeArray *>(offsets)->GetPointer(0),
+      static_cast<vtkIdTypeArray *>(connectivity)->GetPointer(0),
+      numCells, legacy, this->Offsets, this->Connectivity);
+    }
+  offsets->UnRegister(this);
+  connectivity->UnRegister(this);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ImportLegacyFormat(vtkCellArray *cells)
+{
+  if (!cells)
+    {
+    return;
+    }
+
+  vtkIdTypeArray *legacy = cells->GetData();
+  vtkIdType numCells = cells->GetNumberOfCells();
+  vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+  offsets->SetNumberOfTuples(numCells + 1);
+  vtkIdType *offsetPtr = offsets->GetPointer(0);
+  vtkIdType *ptr = legacy->GetPointer(0);
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    offsetPtr[cellId] = loc + 1;
+    loc += ptr[loc] + 1;
+    }
+  offsetPtr[numCells] = loc + 1;
+
+  this->Use32BitIds = 0;
+  this->SetArrays(offsets, legacy);
+  offsets->Delete();
+  this->LegacyView = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ExportLegacyFormat(vtkCellArray *cells)
+{
+  if (!cells)
+    {
+    return;
+    }
+
+  vtkIdType numCells = this->GetNumberOfCells();
+  if (this->LegacyView)
+    {
+    cells->SetCells(numCells,
+                    static_cast<vtkIdTypeArray *>(this->Connectivity));
+    return;
+    }
+
+  vtkIdTypeArray *legacy = vtkIdTypeArray::New();
+  vtkIdType *ptr = legacy->WritePointer(
+    0, numCells + this->GetNumberOfConnectivityEntries());
+  vtkIdType npts;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    this->GetCellPoints(cellId, npts, ptr + 1);
+    *ptr = npts;
+    ptr += npts + 1;
+    }
+  cells->SetCells(numCells, legacy);
+  legacy->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Compact()
+{
+  if (!this->LegacyView)
+    {
+    return;
+    }
+  this->ConvertStorage(this->Use32BitIds);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray *vtkCompactCellArray::GetOffsetsArray()
+{
+  return this->Offsets;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray *vtkCompactCellArray::GetConnectivityArray()
+{
+  return this->Connectivity;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::DeepCopy(vtkCompactCellArray *ca)
+{
+  if (!ca || ca == this)
+    {
+    return;
+    }
+  this->Use32BitIds = ca->Use32BitIds;
+  this->CreateArrays();
+  this->Offsets->DeepCopy(ca->Offsets);
+  this->Connectivity->DeepCopy(ca->Connectivity);
+  this->LegacyView = ca->LegacyView;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ShallowCopy(vtkCompactCellArray *ca)
+{
+  if (!ca || ca == this)
+    {
+    return;
+    }
+  this->SetArrays(ca->Offsets, ca->Connectivity);
+  this->Use32BitIds = ca->Use32BitIds;
+  this->LegacyView = ca->LegacyView;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Squeeze()
+{
+  this->Offsets->Squeeze();
+  this->Connectivity->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCompactCellArray::GetActualMemorySize()
+{
+  return this->Offsets->GetActualMemorySize() +
+    this->Connectivity->GetActualMemorySize();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Cells: " << this->GetNumberOfCells() << endl;
+  os << indent << "Number Of Connectivity Entries: "
+     << this->GetNumberOfConnectivityEntries() << endl;
+  os << indent << "Use32BitIds: "
+     << (this->Use32BitIds ? "On" : "Off") << endl;
+  os << indent << "Legacy View: "
+     << (this->LegacyView ? "On" : "Off") << endl;
+}
@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompactCellArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCompactCellArray - cell connectivity as offsets and point ids
+// .SECTION Description
+// vtkCompactCellArray represents cell connectivity with two arrays: a
+// connectivity array holding the point ids of all cells one after the
+// other, and an offsets array of NumberOfCells+1 entries where cell i
+// uses the ids from Offsets[i] up to, but not including, Offsets[i+1].
+// Unlike vtkCellArray, the number of points is not stored with each cell,
+// so the point ids of any cell are found in constant time without an
+// additional location array, and ranges of cells can be processed
+// independently, e.g. on several threads.
+//
+// When the number of points and the connectivity size allow it, both
+// arrays can be stored as 32-bit integers (see SetUse32BitIds()), which
+// halves the memory used by cells on platforms with 64-bit vtkIdType.
+//
+// The legacy vtkCellArray layout (n,id1,...,idn, n,id1,...) can be used
+// without copying: ImportLegacyFormat() only builds the offsets, which
+// then point into the shared legacy array, and ExportLegacyFormat() hands
+// that array back.  Compact() turns such a shared view into the separate
+// layout.
+//
+// The data sets of the toolkit still store their cells in vtkCellArray;
+// this class is a standalone container for code that wants the new
+// layout.
+//
+// .SECTION See Also
+// vtkCellArray vtkCellTypes
+
+#ifndef __vtkCompactCellArray_h
+#define __vtkCompactCellArray_h
+
+#include "vtkObject.h"
+
+class vtkCellArray;
+class vtkDataArray;
+class vtkIdList;
+class vtkIdTypeArray;
+
+class VTK_FILTERING_EXPORT vtkCompactCellArray : public vtkObject
+{
+public:
+  static vtkCompactCellArray *New();
+  vtkTypeMacro(vtkCompactCellArray,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Allocate memory for numCells cells using connectivitySize point ids
+  // in total.
+  void Allocate(vtkIdType numCells, vtkIdType connectivitySize);
+
+  // Description:
+  // Free any memory and reset to an empty state.  The storage type chosen
+  // with SetUse32BitIds() is kept.
+  void Initialize();
+
+  // Description:
+  // Get the number of cells in the array.
+  vtkIdType GetNumberOfCells();
+
+  // Description:
+  // Get the total number of point ids used by the cells.
+  vtkIdType GetNumberOfConnectivityEntries();
+
+  // Description:
+  // Insert a cell given its number of points and its point ids.  Return
+  // the id of the new cell.  A shared legacy view is compacted first.
+  vtkIdType InsertNextCell(vtkIdType npts, const vtkIdType *pts);
+  vtkIdType InsertNextCell(vtkIdList *pts);
+
+  // Description:
+  // Return the number of points of a cell.
+  vtkIdType GetCellSize(vtkIdType cellId);
+
+  // Description:
+  // Copy the point ids of a cell into pts.  With the second signature pts
+  // must be large enough to hold GetCellSize(cellId) ids.  These methods
+  // do not modify the object and can be called from several threads.
+  void GetCellPoints(vtkIdType cellId, vtkIdList *pts);
+  void GetCellPoints(vtkIdType cellId, vtkIdType &npts, vtkIdType *pts);
+
+  // Description:
+  // Set pts to the point ids of a cell stored in the array, without
+  // copying.  This is only possible when ids are stored as vtkIdType; 0
+  // is returned otherwise.
+  int GetCellPointer(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+
+  // Description:
+  // Store offsets and point ids as 32-bit integers instead of vtkIdType.
+  // Existing cells are converted.  A value that does not fit is reported
+  // as an error and the storage is left unchanged.
+  void SetUse32BitIds(int use32);
+  vtkGetMacro(Use32BitIds, int);
+  vtkBooleanMacro(Use32BitIds, int);
+
+  // Description:
+  // Return whether cells referring to numPoints points and using
+  // connectivitySize ids in total can be stored with 32-bit ids.
+  static int CanUse32BitIds(vtkIdType numPoints, vtkIdType connectivitySize);
+
+  // Description:
+  // Share the connectivity of a legacy cell array.  Only the offsets are
+  // computed; the point ids stay in the legacy array, which must not be
+  // modified while it is shared.  The storage becomes 64-bit.
+  void ImportLegacyFormat(vtkCellArray *cells);
+
+  // Description:
+  // Set cells to the legacy layout of this array.  When the array is a
+  // shared legacy view the legacy array is handed back without copying,
+  // otherwise a new legacy array is built.
+  void ExportLegacyFormat(vtkCellArray *cells);
+
+  // Description:
+  // Return whether the point ids are stored in a shared legacy array.
+  vtkGetMacro(LegacyView, int);
+
+  // Description:
+  // Copy the point ids of a shared legacy view into a separate
+  // connectivity array, using 32-bit ids if Use32BitIds is set.  Does
+  // nothing if the array is not a legacy view.
+  void Compact();
+
+  // Description:
+  // Return the offsets and connectivity arrays.  They are vtkIdTypeArray
+  // or, with 32-bit ids, vtkIntArray instances.  For a legacy view the
+  // connectivity is the legacy array and the offsets give the location of
+  // the first point id of each cell.
+  vtkDataArray *GetOffsetsArray();
+  vtkDataArray *GetConnectivityArray();
+
+  // Description:
+  // Copy another array, deep or by reference.
+  void DeepCopy(vtkCompactCellArray *ca);
+  void ShallowCopy(vtkCompactCellArray *ca);
+
+  // Description:
+  // Reclaim any extra memory.
+  void Squeeze();
+
+  // Description:
+  // Return the memory in kilobytes consumed by this cell array.
+  unsigned long GetActualMemorySize();
+
+protected:
+  vtkCompactCellArray();
+  ~vtkCompactCellArray();
+
+  // Description:
+  // Replace the storage arrays, taking a reference to them.
+  void SetArrays(vtkDataArray *offsets, vtkDataArray *connectivity);
+
+  // Description:
+  // Create empty storage arrays of the current type.
+  void CreateArrays();
+
+  // Description:
+  // Copy the cells into new arrays of the requested type, dropping the
+  // point counts of a legacy view.  Return 0 if the ids do not fit.
+  int ConvertStorage(int use32);
+
+  vtkDataArray *Offsets;
+  vtkDataArray *Connectivity;
+  int Use32BitIds;
+  int LegacyView;
+
+private:
+  vtkCompactCellArray(const vtkCompactCellArray&);  // Not implemented.
+  void operator=(const vtkCompactCellArray&);  // Not implemented.
+};
+
+#endif
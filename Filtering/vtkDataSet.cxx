@@ -143,6 +143,14 @@ void vtkDataSet::ComputeScalarRange()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkDataSet::PrepareForThreadedAccess()
+{
+  double range[2];
+  this->ComputeBounds();
+  this->GetScalarRange(range);
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSet::GetScalarRange(double range[2])
 {
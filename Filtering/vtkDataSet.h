@@ -28,6 +28,14 @@
 // Attribute data in vtk is either point data (data at points) or cell data
 // (data at cells). Typically filters operate on point data, but some may
 // operate on cell data, both cell and point data, either one, or none.
+//
+// Methods marked below as thread safe if first called from a single thread
+// may build internal structures on their first call, e.g. the bounds or
+// the cell types of vtkPolyData. PrepareForThreadedAccess() builds all of
+// them, after which GetCell(cellId, vtkGenericCell*), GetPoint(ptId, x),
+// GetCellPoints(), GetCellType(), GetCellBounds() and GetBounds(bounds)
+// can be called concurrently, without copying the dataset, as long as it
+// is not modified. Each thread must use its own vtkGenericCell and lists.
 
 // .SECTION See Also
 // vtkPointSet vtkStructuredPoints vtkStructuredGrid vtkUnstructuredGrid
@@ -93,6 +101,14 @@ public:
   // THIS METHOD IS NOT THREAD SAFE.
   virtual vtkCell *GetCell(vtkIdType cellId) = 0;
 
+  // Description:
+  // Build the structures that the thread safe read methods would otherwise
+  // build on their first call, so that they can be used from several
+  // threads right away. Structures only needed for topological queries,
+  // such as the point to cell links, are not built.
+  // THIS METHOD IS NOT THREAD SAFE.
+  virtual void PrepareForThreadedAccess();
+
   // Description:
   // Get cell with cellId such that: 0 <= cellId < NumberOfCells. 
   // This is a thread-safe alternative to the previous GetCell()
@@ -30,6 +30,7 @@
 #include "vtkIdTypeArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include "vtkOutputRecycler.h"
 
 #include <vtkstd/vector>
 
@@ -90,7 +91,7 @@ vtkDataSetAttributes::vtkDataSetAttributes()
   this->CopyAttributeFlags[INTERPOLATE][PEDIGREEIDS] = 0;
 
   this->TargetIndices=0;
-
+  this->Recycler = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -100,8 +101,12 @@ vtkDataSetAttributes::~vtkDataSetAttributes()
   this->Initialize();
   delete[] this->TargetIndices;
   this->TargetIndices = 0;
+  this->SetRecycler(0);
 }
 
+//--------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkDataSetAttributes, Recycler, vtkOutputRecycler);
+
 //--------------------------------------------------------------------------
 // Turn on copying of all data.
 void vtkDataSetAttributes::CopyAllOn(int ctype)
@@ -626,7 +631,16 @@ void vtkDataSetAttributes::InternalCopyAllocate(vtkDataSetAttributes* pd,
         }
       else
         {
-        newAA = aa->NewInstance();
+        newAA = 0;
+        if (this->Recycler)
+          {
+          newAA = this->Recycler->TakeArray(aa->GetClassName(),
+                                            aa->GetNumberOfComponents());
+          }
+        if (!newAA)
+          {
+          newAA = aa->NewInstance();
+          }
         newAA->SetNumberOfComponents(aa->GetNumberOfComponents());
         newAA->CopyComponentNames( aa );        
         newAA->SetName(aa->GetName());
@@ -1233,6 +1247,7 @@ void vtkDataSetAttributes::PrintSelf(ostream& os, vtkIndent indent)
     os << this->CopyAttributeFlags[PASSDATA][i] << " ";
     }
   os << ")" << endl;
+  os << indent << "Recycler: " << this->Recycler << endl;
   
   // Now print the various attributes
   vtkAbstractArray* aa;
@@ -1498,6 +1513,16 @@ void vtkDataSetAttributes::InternalCopyAllocate(
     if ( list.FieldIndices[i] >= 0 )
       {
       newAA = vtkAbstractArray::CreateArray(list.FieldTypes[i]);
+      if (this->Recycler)
+        {
+        vtkAbstractArray* recycled = this->Recycler->TakeArray(
+          newAA->GetClassName(), list.FieldComponents[i]);
+        if (recycled)
+          {
+          newAA->Delete();
+          newAA = recycled;
+          }
+        }
       newAA->SetName(list.Fields[i]);
       newAA->SetNumberOfComponents(list.FieldComponents[i]);
       
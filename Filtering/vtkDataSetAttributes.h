@@ -44,6 +44,7 @@
 #include "vtkFieldData.h"
 
 class vtkLookupTable;
+class vtkOutputRecycler;
 
 class VTK_FILTERING_EXPORT vtkDataSetAttributes : public vtkFieldData
 {
@@ -512,6 +513,15 @@ public:
                        vtkDataSetAttributes *from2,
                        vtkIdType id, double t);
 
+  // Description:
+  // Set/Get the recycler from which CopyAllocate() and
+  // InterpolateAllocate() take the arrays they create, when it has
+  // arrays of the same class and number of components.  The pipeline
+  // sets it while an algorithm generates a recycled output (see
+  // vtkOutputRecycler).
+  virtual void SetRecycler(vtkOutputRecycler*);
+  vtkGetObjectMacro(Recycler, vtkOutputRecycler);
+
 //BTX
   class FieldList;
 
@@ -581,6 +591,8 @@ protected:
 
   int* TargetIndices;
 
+  vtkOutputRecycler* Recycler;
+
   static const int NumberOfAttributeComponents[NUM_ATTRIBUTES];
   static const int AttributeLimits[NUM_ATTRIBUTES];
   static const char AttributeNames[NUM_ATTRIBUTES][12];
@@ -33,6 +33,7 @@
 #include "vtkInformationVector.h"
 #include "vtkInstantiator.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPointData.h"
 
 #include <vtkstd/vector>
@@ -41,6 +42,7 @@ vtkStandardNewMacro(vtkDemandDrivenPipeline);
 
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, DATA_NOT_GENERATED, Integer);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, RELEASE_DATA, Integer);
+vtkInformationKeyMacro(vtkDemandDrivenPipeline, RECYCLE_OUTPUT, Integer);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_DATA, Request);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_DATA_NOT_GENERATED, Request);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_DATA_OBJECT, Request);
@@ -539,8 +541,27 @@ void vtkDemandDrivenPipeline::ExecuteDataStart(vtkInformation* request,
     vtkDataObject* data = outInfo->Get(vtkDataObject::DATA_OBJECT());
     if(data && !outInfo->Get(DATA_NOT_GENERATED()))
       {
+      // Keep the old data for reuse if requested.
+      vtkOutputRecycler* recycler = 0;
+      if(outInfo->Get(RECYCLE_OUTPUT()))
+        {
+        recycler =
+          static_cast<vtkOutputRecycler*>(outInfo->Get(
+                                            vtkOutputRecycler::RECYCLER()));
+        if(!recycler)
+          {
+          recycler = vtkOutputRecycler::New();
+          outInfo->Set(vtkOutputRecycler::RECYCLER(), recycler);
+          recycler->Delete();
+          }
+        recycler->Recycle(data);
+        }
       data->PrepareForNewData();
       data->CopyInformationFromPipeline(request);
+      if(recycler)
+        {
+        recycler->Attach(data);
+        }
       }
     }
 
@@ -594,6 +615,17 @@ void vtkDemandDrivenPipeline::ExecuteDataEnd(vtkInformation* request,
     {
     vtkInformation* outInfo = outputs->GetInformationObject(i);
     outInfo->Remove(DATA_NOT_GENERATED());
+
+    // Release the recycled data that were not reused.
+    if(vtkOutputRecycler* recycler = static_cast<vtkOutputRecycler*>(
+         outInfo->Get(vtkOutputRecycler::RECYCLER())))
+      {
+      if(vtkDataObject* data = outInfo->Get(vtkDataObject::DATA_OBJECT()))
+        {
+        recycler->Detach(data);
+        }
+      recycler->Release();
+      }
     }
 
   // Release input data if requested.
@@ -1105,6 +1137,47 @@ int vtkDemandDrivenPipeline::SetReleaseDataFlag(int port, int n)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int vtkDemandDrivenPipeline::SetRecycleOutputFlag(int port, int n)
+{
+  if(!this->OutputPortIndexInRange(port, "set recycle output flag on"))
+    {
+    return 0;
+    }
+  vtkInformation* info = this->GetOutputInformation(port);
+  if(this->GetRecycleOutputFlag(port) != n)
+    {
+    info->Set(RECYCLE_OUTPUT(), n);
+    if(!n)
+      {
+      info->Remove(vtkOutputRecycler::RECYCLER());
+      }
+    return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDemandDrivenPipeline::GetRecycleOutputFlag(int port)
+{
+  if(!this->OutputPortIndexInRange(port, "get recycle output flag from"))
+    {
+    return 0;
+    }
+  return this->GetOutputInformation(port)->Get(RECYCLE_OUTPUT());
+}
+
+//----------------------------------------------------------------------------
+vtkOutputRecycler* vtkDemandDrivenPipeline::GetOutputRecycler(int port)
+{
+  if(!this->OutputPortIndexInRange(port, "get output recycler from"))
+    {
+    return 0;
+    }
+  return static_cast<vtkOutputRecycler*>(
+    this->GetOutputInformation(port)->Get(vtkOutputRecycler::RECYCLER()));
+}
+
 //----------------------------------------------------------------------------
 int vtkDemandDrivenPipeline::GetReleaseDataFlag(int port)
 {
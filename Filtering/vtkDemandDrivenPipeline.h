@@ -33,6 +33,7 @@ class vtkInformationIntegerKey;
 class vtkInformationVector;
 class vtkInformationKeyVectorKey;
 class vtkInformationUnsignedLongKey;
+class vtkOutputRecycler;
 
 class VTK_FILTERING_EXPORT vtkDemandDrivenPipeline : public vtkExecutive
 {
@@ -76,6 +77,22 @@ public:
   // Get whether the given output port releases data when it is consumed.
   virtual int GetReleaseDataFlag(int port);
 
+  // Description:
+  // Set whether the given output port recycles the memory of its previous
+  // output when the algorithm executes again.  See vtkOutputRecycler.
+  // Returns 1 if the value changes and 0 otherwise.
+  virtual int SetRecycleOutputFlag(int port, int n);
+
+  // Description:
+  // Get whether the given output port recycles its previous output.
+  virtual int GetRecycleOutputFlag(int port);
+
+  // Description:
+  // Get the recycler of the given output port, or NULL if the port has
+  // not recycled an output yet.  Its counters tell how many allocations
+  // were avoided.
+  vtkOutputRecycler* GetOutputRecycler(int port);
+
   // Description:
   // Bring the PipelineMTime up to date.
   virtual int UpdatePipelineMTime();
@@ -118,6 +135,11 @@ public:
   // released after it is used.
   static vtkInformationIntegerKey* RELEASE_DATA();
 
+  // Description:
+  // Key to specify in pipeline information the request that the memory
+  // of the previous output be reused when new data are generated.
+  static vtkInformationIntegerKey* RECYCLE_OUTPUT();
+
   // Description:
   // Key to store a mark for an output that will not be generated.
   // Algorithms use this to tell the executive that they will not
@@ -31,18 +31,23 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkCommand.h"
+#include "vtkCompositeDataPipeline.h"
 #include "vtkComputingResources.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataSet.h"
 #include "vtkExecutiveCollection.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkInformationExecutivePortKey.h"
 #include "vtkInformationExecutivePortVectorKey.h"
 #include "vtkInformationIntegerKey.h"
+#include "vtkInformationStringKey.h"
 #include "vtkMultiThreader.h"
 #include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkThreadedStreamingPipeline.h"
 #include "vtkThreadMessager.h"
+#include "vtkThreadPool.h"
 
 #include <vtkstd/set>
 #include <vtksys/hash_map.hxx>
@@ -53,6 +58,7 @@
 vtkStandardNewMacro(vtkExecutionScheduler);
 
 vtkInformationKeyMacro(vtkExecutionScheduler, TASK_PRIORITY, Integer);
+vtkInformationKeyMacro(vtkExecutionScheduler, UPSTREAM_UPDATED, Integer);
 
 //----------------------------------------------------------------------------
 class Task 
@@ -93,6 +99,433 @@ public:
 };
 typedef vtksys::hash_set<vtkExecutive*, vtkExecutiveHasher> vtkExecutiveSet;
 typedef vtkstd::vector<vtkExecutive*>                       vtkExecutiveVector;
+// An output port of a node of the graph: the node id and the port
+typedef vtkstd::pair<int, int>                              vtkExecutionSchedulerPort;
+
+//----------------------------------------------------------------------------
+// The dependency graph executed by Update() and UpdateUpstream().  Each
+// node is an executive; it becomes ready when all of its producers are
+// done.  The workers take ready nodes until the whole graph is executed.
+class vtkExecutionSchedulerGraph
+{
+public:
+  struct Node
+  {
+    vtkExecutive        *Executive;
+    vtkInformation      *Request;
+    vtkstd::vector<int>  Consumers;
+    // The output ports to update and how many nodes of the graph read them
+    vtkstd::vector<int>  OutputPorts;
+    vtkstd::vector<int>  NumberOfReaders;
+    int                  NumberOfProducers;
+    int                  Failed;
+    // Nodes of the same group never execute at the same time
+    const char          *Group;
+    // The output ports read by the node
+    vtkstd::vector<vtkExecutionSchedulerPort> Inputs;
+    // The inputs also read by other nodes that the node does not read
+    // at the same time as them
+    vtkstd::vector<vtkExecutionSchedulerPort> SharedInputs;
+  };
+
+  vtkExecutionSchedulerGraph()
+  {
+    this->NumberOfRunning = 0;
+    this->NumberOfRemaining = 0;
+    this->Result = 1;
+    this->Serial = 0;
+  }
+
+  ~vtkExecutionSchedulerGraph()
+  {
+    for (size_t i = 0; i < this->Nodes.size(); i++)
+      {
+      if (this->Nodes[i].Request)
+        {
+        this->Nodes[i].Request->Delete();
+        }
+      }
+  }
+
+  // Description:
+  // Add exec and all the executives upstream of it, return its node id
+  int AddNode(vtkExecutive *exec);
+
+  // Description:
+  // Ask the node to update an output port
+  void AddOutputPort(int node, int port, int reader);
+
+  // Description:
+  // Return 1 if the network must be updated serially: temporal pipelines,
+  // or outputs read by several consumers that release their input data
+  int NeedsSerialUpdate();
+
+  // Description:
+  // Give each node its copy of the request, find the ready nodes and the
+  // shared inputs that the nodes must not read concurrently
+  void Prepare(vtkInformation *request);
+
+  // Description:
+  // Execute the graph on the given number of workers
+  int Execute(int numberOfWorkers);
+
+  // Description:
+  // The loop of a worker
+  void Work();
+
+  vtkstd::vector<Node>        Nodes;
+  vtksys::hash_map<vtkExecutive*, int, vtkExecutiveHasher> Ids;
+  vtkstd::vector<int>         Ready;
+  vtkstd::vector<const char*> RunningGroups;
+  vtkstd::vector<vtkExecutionSchedulerPort> RunningSharedInputs;
+  int                         NumberOfRunning;
+  int                         NumberOfRemaining;
+  int                         Result;
+  int                         Serial;
+  vtkSimpleMutexLock          Lock;
+  vtkSimpleConditionVariable  Condition;
+
+protected:
+  int PopReady();
+  int ExecuteNode(int node);
+};
+
+// The group of executives that are not vtkThreadedStreamingPipeline.
+// They forward the requests upstream themselves, which touches the
+// information of their producers, so they are executed one at a time.
+static const char vtkExecutionSchedulerSerialGroup[] = "vtkExecutive";
+
+//----------------------------------------------------------------------------
+int vtkExecutionSchedulerGraph::AddNode(vtkExecutive *exec)
+{
+  vtksys::hash_map<vtkExecutive*, int, vtkExecutiveHasher>::iterator hit =
+    this->Ids.find(exec);
+  if (hit != this->Ids.end())
+    {
+    return (*hit).second;
+    }
+  int id = static_cast<int>(this->Nodes.size());
+  this->Ids[exec] = id;
+  Node node;
+  node.Executive = exec;
+  node.Request = NULL;
+  node.NumberOfProducers = 0;
+  node.Failed = 0;
+  node.Group = NULL;
+  this->Nodes.push_back(node);
+
+  vtkAlgorithm *algorithm = exec->GetAlgorithm();
+  if (!vtkThreadedStreamingPipeline::SafeDownCast(exec))
+    {
+    this->Nodes[id].Group = vtkExecutionSchedulerSerialGroup;
+    }
+  else if (algorithm->GetInformation()->
+           Get(vtkThreadedStreamingPipeline::NON_REENTRANT()))
+    {
+    this->Nodes[id].Group = algorithm->GetClassName();
+    }
+
+  // Temporal pipelines mark the inputs that need time while forwarding
+  // the requests, see vtkCompositeDataPipeline::ForwardUpstream().
+  for (int i = 0; i < exec->GetNumberOfOutputPorts(); ++i)
+    {
+    if (exec->GetOutputInformation(i)->
+        Has(vtkCompositeDataPipeline::REQUIRES_TIME_DOWNSTREAM()))
+      {
+      this->Serial = 1;
+      }
+    }
+
+  for (int i = 0; i < exec->GetNumberOfInputPorts(); ++i)
+    {
+    const char *type = algorithm->GetInputPortInformation(i)->
+      Get(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE());
+    if (type && !strcmp(type, "vtkTemporalDataSet"))
+      {
+      this->Serial = 1;
+      }
+    int nic = algorithm->GetNumberOfInputConnections(i);
+    vtkInformationVector* inVector = exec->GetInputInformation()[i];
+    for (int j = 0; j < nic; ++j)
+      {
+      vtkInformation* inInfo = inVector->GetInformationObject(j);
+      vtkExecutive* e;
+      int producerPort;
+      vtkExecutive::PRODUCER()->Get(inInfo, e, producerPort);
+      if (e)
+        {
+        int producer = this->AddNode(e);
+        this->Nodes[producer].Consumers.push_back(id);
+        this->Nodes[id].NumberOfProducers++;
+        this->AddOutputPort(producer, producerPort, 1);
+        this->Nodes[id].Inputs.push_back(
+          vtkExecutionSchedulerPort(producer, producerPort));
+        }
+      }
+    }
+  return id;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionSchedulerGraph::AddOutputPort(int node, int port, int reader)
+{
+  Node &n = this->Nodes[node];
+  for (size_t i = 0; i < n.OutputPorts.size(); i++)
+    {
+    if (n.OutputPorts[i] == port)
+      {
+      n.NumberOfReaders[i] += reader;
+      return;
+      }
+    }
+  n.OutputPorts.push_back(port);
+  n.NumberOfReaders.push_back(reader);
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionSchedulerGraph::Prepare(vtkInformation *request)
+{
+  for (size_t i = 0; i < this->Nodes.size(); i++)
+    {
+    Node &n = this->Nodes[i];
+    n.Request = vtkInformation::New();
+    n.Request->Copy(request);
+    // The request key is not copied with the entries.
+    n.Request->Set(vtkDemandDrivenPipeline::REQUEST_DATA());
+    if (n.Group == vtkExecutionSchedulerSerialGroup)
+      {
+      n.Request->Remove(vtkExecutionScheduler::UPSTREAM_UPDATED());
+      }
+    else
+      {
+      n.Request->Set(vtkExecutionScheduler::UPSTREAM_UPDATED(), 1);
+      }
+    if (n.NumberOfProducers == 0)
+      {
+      this->Ready.push_back(static_cast<int>(i));
+      }
+
+    // Most algorithms read their input through methods that return
+    // buffers of the data set, e.g. GetPoint(id) or GetCell(id), so the
+    // consumers of a shared output execute one at a time unless they
+    // declare that they read it concurrently.
+    if (n.Executive->GetAlgorithm()->GetInformation()->
+        Get(vtkThreadedStreamingPipeline::CONCURRENT_INPUT_READS()))
+      {
+      continue;
+      }
+    for (size_t j = 0; j < n.Inputs.size(); j++)
+      {
+      Node &producer = this->Nodes[n.Inputs[j].first];
+      for (size_t p = 0; p < producer.OutputPorts.size(); p++)
+        {
+        if (producer.OutputPorts[p] == n.Inputs[j].second &&
+            producer.NumberOfReaders[p] > 1)
+          {
+          n.SharedInputs.push_back(n.Inputs[j]);
+          }
+        }
+      }
+    }
+  this->NumberOfRemaining = static_cast<int>(this->Nodes.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionSchedulerGraph::NeedsSerialUpdate()
+{
+  // A consumer that finishes would release data still read by the other
+  // consumers.
+  for (size_t i = 0; i < this->Nodes.size() && !this->Serial; i++)
+    {
+    Node &n = this->Nodes[i];
+    for (size_t p = 0; p < n.OutputPorts.size(); p++)
+      {
+      if (n.NumberOfReaders[p] > 1 && n.OutputPorts[p] >= 0 &&
+          (vtkDataObject::GetGlobalReleaseDataFlag() ||
+           n.Executive->GetOutputInformation(n.OutputPorts[p])->
+           Get(vtkDemandDrivenPipeline::RELEASE_DATA())))
+        {
+        this->Serial = 1;
+        }
+      }
+    }
+  return this->Serial;
+}
+
+//----------------------------------------------------------------------------
+static void vtkExecutionSchedulerWork(vtkIdType, vtkIdType, int, void *data)
+{
+  static_cast<vtkExecutionSchedulerGraph*>(data)->Work();
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionSchedulerGraph::Execute(int numberOfWorkers)
+{
+  if (numberOfWorkers > static_cast<int>(this->Nodes.size()))
+    {
+    numberOfWorkers = static_cast<int>(this->Nodes.size());
+    }
+  if (numberOfWorkers <= 1)
+    {
+    this->Work();
+    }
+  else
+    {
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, numberOfWorkers, 1, vtkExecutionSchedulerWork, this);
+    }
+  return this->Result;
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionSchedulerGraph::PopReady()
+{
+  for (size_t i = 0; i < this->Ready.size(); i++)
+    {
+    const char *group = this->Nodes[this->Ready[i]].Group;
+    bool blocked = false;
+    for (size_t g = 0; group && g < this->RunningGroups.size(); g++)
+      {
+      if (!strcmp(this->RunningGroups[g], group))
+        {
+        blocked = true;
+        break;
+        }
+      }
+    const vtkstd::vector<vtkExecutionSchedulerPort> &shared =
+      this->Nodes[this->Ready[i]].SharedInputs;
+    for (size_t s = 0; !blocked && s < shared.size(); s++)
+      {
+      for (size_t r = 0; r < this->RunningSharedInputs.size(); r++)
+        {
+        if (this->RunningSharedInputs[r] == shared[s])
+          {
+          blocked = true;
+          break;
+          }
+        }
+      }
+    if (!blocked)
+      {
+      int node = this->Ready[i];
+      this->Ready.erase(this->Ready.begin() + i);
+      if (group)
+        {
+        this->RunningGroups.push_back(group);
+        }
+      this->RunningSharedInputs.insert(this->RunningSharedInputs.end(),
+                                       shared.begin(), shared.end());
+      return node;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionSchedulerGraph::Work()
+{
+  this->Lock.Lock();
+  while (this->NumberOfRemaining > 0)
+    {
+    int node = this->PopReady();
+    if (node < 0)
+      {
+      if (this->NumberOfRunning == 0)
+        {
+        // Nothing can make progress; this only happens for a cycle.
+        this->Result = 0;
+        break;
+        }
+      this->Condition.Wait(this->Lock);
+      continue;
+      }
+    Node &n = this->Nodes[node];
+    this->NumberOfRunning++;
+    this->Lock.Unlock();
+
+    // The consumers of a failed executive are not executed, as in the
+    // serial update.
+    int result = n.Failed ? 0 : this->ExecuteNode(node);
+
+    this->Lock.Lock();
+    this->NumberOfRunning--;
+    this->NumberOfRemaining--;
+    if (!result)
+      {
+      this->Result = 0;
+      }
+    if (n.Group)
+      {
+      for (size_t g = 0; g < this->RunningGroups.size(); g++)
+        {
+        if (this->RunningGroups[g] == n.Group)
+          {
+          this->RunningGroups.erase(this->RunningGroups.begin() + g);
+          break;
+          }
+        }
+      }
+    for (size_t s = 0; s < n.SharedInputs.size(); s++)
+      {
+      for (size_t r = 0; r < this->RunningSharedInputs.size(); r++)
+        {
+        if (this->RunningSharedInputs[r] == n.SharedInputs[s])
+          {
+          this->RunningSharedInputs.erase(
+            this->RunningSharedInputs.begin() + r);
+          break;
+          }
+        }
+      }
+    for (size_t c = 0; c < n.Consumers.size(); c++)
+      {
+      Node &consumer = this->Nodes[n.Consumers[c]];
+      if (!result)
+        {
+        consumer.Failed = 1;
+        }
+      if (--consumer.NumberOfProducers == 0)
+        {
+        this->Ready.push_back(n.Consumers[c]);
+        }
+      }
+    this->Condition.Broadcast();
+    }
+  this->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionSchedulerGraph::ExecuteNode(int node)
+{
+  Node &n = this->Nodes[node];
+  vtkExecutive *exec = n.Executive;
+  for (size_t p = 0; p < n.OutputPorts.size(); p++)
+    {
+    n.Request->Set(vtkExecutive::FROM_OUTPUT_PORT(), n.OutputPorts[p]);
+    if (!exec->ProcessRequest(n.Request, exec->GetInputInformation(),
+                              exec->GetOutputInformation()))
+      {
+      return 0;
+      }
+    }
+
+  // Consumers that declare CONCURRENT_INPUT_READS() may read the outputs
+  // they share at the same time.
+  for (size_t p = 0; p < n.OutputPorts.size(); p++)
+    {
+    if (n.NumberOfReaders[p] > 1 && n.OutputPorts[p] >= 0)
+      {
+      vtkDataSet *output = vtkDataSet::SafeDownCast(
+        exec->GetOutputInformation(n.OutputPorts[p])->
+        Get(vtkDataObject::DATA_OBJECT()));
+      if (output)
+        {
+        output->PrepareForThreadedAccess();
+        }
+      }
+    }
+  return 1;
+}
 
 //----------------------------------------------------------------------------
 class vtkExecutionScheduler::implementation
@@ -208,6 +641,7 @@ vtkExecutionScheduler::vtkExecutionScheduler()
   this->ScheduleThreader = vtkMultiThreader::New();
   this->ScheduleThreader->SetNumberOfThreads(1);
   this->ScheduleThreadId = -1;
+  this->NumberOfThreads = vtkThreadPool::GetGlobalPool()->GetNumberOfThreads();
   this->Implementation->Scheduler = this;
   this->Implementation->CurrentPriority = 0;
 }
@@ -227,6 +661,130 @@ vtkExecutionScheduler::~vtkExecutionScheduler()
 void vtkExecutionScheduler::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+}
+
+//----------------------------------------------------------------------------
+// Fill request with a plain REQUEST_DATA request, as sent by Update().
+static void vtkExecutionSchedulerDataRequest(vtkInformation *request)
+{
+  request->Set(vtkDemandDrivenPipeline::REQUEST_DATA());
+  request->Set(vtkExecutive::FORWARD_DIRECTION(), vtkExecutive::RequestUpstream);
+  request->Set(vtkExecutive::ALGORITHM_AFTER_FORWARD(), 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionScheduler::UpdateUpstream(vtkExecutive *exec,
+                                          vtkInformation *request)
+{
+  vtkExecutionSchedulerGraph graph;
+  for (int i = 0; i < exec->GetNumberOfInputPorts(); ++i)
+    {
+    int nic = exec->GetAlgorithm()->GetNumberOfInputConnections(i);
+    vtkInformationVector* inVector = exec->GetInputInformation()[i];
+    for (int j = 0; j < nic; ++j)
+      {
+      vtkInformation* inInfo = inVector->GetInformationObject(j);
+      vtkExecutive* e;
+      int producerPort;
+      vtkExecutive::PRODUCER()->Get(inInfo, e, producerPort);
+      if (e)
+        {
+        graph.AddOutputPort(graph.AddNode(e), producerPort, 0);
+        }
+      }
+    }
+
+  if (graph.NeedsSerialUpdate())
+    {
+    return -1;
+    }
+
+  if (!exec->GetAlgorithm()->ModifyRequest(request, vtkExecutive::BeforeForward))
+    {
+    return 0;
+    }
+  graph.Prepare(request);
+  int result = graph.Execute(this->NumberOfThreads);
+  if (!exec->GetAlgorithm()->ModifyRequest(request, vtkExecutive::AfterForward))
+    {
+    return 0;
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutionScheduler::Update(vtkExecutiveCollection *execs)
+{
+  // The information and update extent passes are cheap, they are run
+  // serially before the data pass.
+  vtkExecutionSchedulerGraph graph;
+  execs->InitTraversal();
+  for (vtkExecutive *e = execs->GetNextItem(); e != 0; e = execs->GetNextItem())
+    {
+    vtkStreamingDemandDrivenPipeline *sddp =
+      vtkStreamingDemandDrivenPipeline::SafeDownCast(e);
+    if (!sddp)
+      {
+      if (!e->Update())
+        {
+        return 0;
+        }
+      continue;
+      }
+    if (!sddp->UpdateInformation())
+      {
+      return 0;
+      }
+    int node = graph.AddNode(e);
+    int numPorts = e->GetNumberOfOutputPorts();
+    for (int port = 0; port < numPorts; ++port)
+      {
+      if (!sddp->PropagateUpdateExtent(port))
+        {
+        return 0;
+        }
+      graph.AddOutputPort(node, port, 0);
+      }
+    if (numPorts == 0)
+      {
+      graph.AddOutputPort(node, -1, 0);
+      }
+    }
+
+  if (graph.NeedsSerialUpdate())
+    {
+    int result = 1;
+    execs->InitTraversal();
+    for (vtkExecutive *e = execs->GetNextItem(); e != 0;
+         e = execs->GetNextItem())
+      {
+      vtkStreamingDemandDrivenPipeline *sddp =
+        vtkStreamingDemandDrivenPipeline::SafeDownCast(e);
+      if (!sddp)
+        {
+        continue;
+        }
+      int numPorts = e->GetNumberOfOutputPorts();
+      if (numPorts == 0 && !sddp->Update(-1))
+        {
+        result = 0;
+        }
+      for (int port = 0; port < numPorts; ++port)
+        {
+        if (!sddp->Update(port))
+          {
+          result = 0;
+          }
+        }
+      }
+    return result;
+    }
+  vtkInformation *request = vtkInformation::New();
+  vtkExecutionSchedulerDataRequest(request);
+  graph.Prepare(request);
+  request->Delete();
+  return graph.Execute(this->NumberOfThreads);
 }
 
 //----------------------------------------------------------------------------
@@ -267,6 +825,7 @@ void vtkExecutionScheduler::Schedule(vtkExecutiveCollection *execs, vtkInformati
     {
     if (this->Implementation->ExecutingTasks.find(e) != this->Implementation->ExecutingTasks.end())
       {
+      this->ScheduleLock->Unlock();
       return;
       }
     if (this->Implementation->DependencyNodes.find(e) == this->Implementation->DependencyNodes.end()) 
@@ -838,7 +1397,6 @@ void * vtkExecutionScheduler_ExecuteThread(void *data)
   self->ScheduleMessager->SendWakeMessage();
   if (task.info && task.info->Has(vtkThreadedStreamingPipeline::AUTO_PROPAGATE()))
     {
-      fprintf(stderr, "Push DOWN from %s\n", exec->GetAlgorithm()->GetClassName());
     exec->Push(task.info);
     }
   if (messager)
@@ -846,7 +1404,6 @@ void * vtkExecutionScheduler_ExecuteThread(void *data)
     messager->SendWakeMessage();
     }
   delete eData;
-  fprintf(stderr, "Release now\n");
   lock->Unlock();
   return NULL;
 }
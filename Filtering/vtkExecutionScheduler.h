@@ -32,6 +32,17 @@
 // .SECTION Description
 // This is a class for balancing the computing resources throughout
 // the network
+//
+// Update() and UpdateUpstream() execute a network on the global
+// vtkThreadPool.  They build the dependency graph of the executives, then
+// execute each executive as soon as all of its producers are done, so
+// that independent branches, such as the readers feeding a
+// vtkAppendPolyData, run at the same time.  An algorithm that must not
+// execute at the same time as another instance of its class declares it
+// by setting vtkThreadedStreamingPipeline::NON_REENTRANT() in its
+// information.  The consumers of an output read by several algorithms
+// execute one at a time, unless they set
+// vtkThreadedStreamingPipeline::CONCURRENT_INPUT_READS().
 
 // .SECTION See Also
 // vtkComputingResources vtkThreadedStreamingPipeline
@@ -62,6 +73,37 @@ public:
   // Return the global instance of the scheduler 
   static vtkExecutionScheduler *GetGlobalScheduler();
 
+  // Description:
+  // Set/Get the maximum number of executives that Update() and
+  // UpdateUpstream() execute at the same time.  It is also limited by the
+  // number of threads of the global vtkThreadPool.  The default is the
+  // number of threads of that pool.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // Key set on the REQUEST_DATA requests sent by Update() and
+  // UpdateUpstream() to executives whose inputs are already up to date.
+  // vtkThreadedStreamingPipeline does not forward such requests upstream.
+  static vtkInformationIntegerKey* UPSTREAM_UPDATED();
+
+  // Description:
+  // Bring the data of all the executives upstream of exec up to date,
+  // running independent branches concurrently.  exec itself is not
+  // executed.  request is the REQUEST_DATA request being processed by
+  // exec, which its algorithm may modify before and after the inputs are
+  // updated (see vtkAlgorithm::ModifyRequest()).  Return 1 on success, 0
+  // if an executive failed, and -1 when nothing was executed because the
+  // network needs the serial update: temporal pipelines, or shared
+  // outputs whose data is released after use.
+  int UpdateUpstream(vtkExecutive *exec, vtkInformation *request);
+
+  // Description:
+  // Update all the output ports of the given executives and all the
+  // executives upstream of them, running independent branches
+  // concurrently.  Return 1 on success.
+  int Update(vtkExecutiveCollection *execs);
+
  // Description:
   // Key to store the priority of a task
   static vtkInformationIntegerKey* TASK_PRIORITY();
@@ -145,6 +187,7 @@ protected:
   vtkMutexLock                *ScheduleLock;
   vtkMultiThreader            *ScheduleThreader;
   int                          ScheduleThreadId;
+  int                          NumberOfThreads;
 
 //BTX
   class implementation;
@@ -25,6 +25,7 @@
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineTracer.h"
 #include "vtkSmartPointer.h"
 
 #include <vtkstd/vector>
@@ -742,10 +743,21 @@ int vtkExecutive::CallAlgorithm(vtkInformation* request, int direction,
   // Copy default information in the direction of information flow.
   this->CopyDefaultInformation(request, direction, inInfo, outInfo);
 
-  // Invoke the request on the algorithm.
+  // Invoke the request on the algorithm, recording it if the pipeline is
+  // traced.
+  vtkPipelineTracer* tracer = vtkPipelineTracer::GetActiveTracer();
+  vtkPipelineTracer::ExecutionMark mark;
+  if(tracer)
+    {
+    tracer->BeginExecution(mark);
+    }
   this->InAlgorithm = 1;
   int result = this->Algorithm->ProcessRequest(request, inInfo, outInfo);
   this->InAlgorithm = 0;
+  if(tracer)
+    {
+    tracer->EndExecution(mark, this->Algorithm, request, outInfo);
+    }
 
   // If the algorithm failed report it now.
   if(!result)
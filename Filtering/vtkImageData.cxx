@@ -632,6 +632,15 @@ void vtkImageData::GetCellBounds(vtkIdType cellId, double bounds[6])
 double *vtkImageData::GetPoint(vtkIdType ptId)
 {
   static double x[3];
+  this->GetPoint(ptId, x);
+  return x;
+}
+
+//----------------------------------------------------------------------------
+// Computes the point from the structure only, so that it can be called
+// from several threads.
+void vtkImageData::GetPoint(vtkIdType ptId, double x[3])
+{
   int i, loc[3];
   const double *origin = this->Origin;
   const double *spacing = this->Spacing;
@@ -646,7 +655,7 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
   if (dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
     {
     vtkErrorMacro("Requesting a point from an empty image.");
-    return x;
+    return;
     }
 
   // "loc" holds the point x,y,z indices
@@ -655,7 +664,7 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
   switch (this->DataDescription)
     {
     case VTK_EMPTY:
-      return x;
+      return;
 
     case VTK_SINGLE_POINT:
       break;
@@ -698,8 +707,6 @@ double *vtkImageData::GetPoint(vtkIdType ptId)
     {
     x[i] = origin[i] + (loc[i]+extent[i*2]) * spacing[i];
     }
-
-  return x;
 }
 
 //----------------------------------------------------------------------------
@@ -1945,10 +1952,10 @@ int *vtkImageData::GetDimensions()
 //----------------------------------------------------------------------------
 void vtkImageData::GetDimensions(int *dOut)
 {
-  int *dims = this->GetDimensions();
-  dOut[0] = dims[0];
-  dOut[1] = dims[1];
-  dOut[2] = dims[2];
+  const int* extent = this->Extent;
+  dOut[0] = extent[1] - extent[0] + 1;
+  dOut[1] = extent[3] - extent[2] + 1;
+  dOut[2] = extent[5] - extent[4] + 1;
 }
 
 //----------------------------------------------------------------------------
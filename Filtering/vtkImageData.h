@@ -75,10 +75,11 @@ public:
                                   double *weights);
   virtual int GetCellType(vtkIdType cellId);
   virtual void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
-    {vtkStructuredData::GetCellPoints(cellId,ptIds,this->DataDescription,
-                                      this->GetDimensions());}
+    {int dims[3]; this->GetDimensions(dims);
+     vtkStructuredData::GetCellPoints(cellId,ptIds,this->DataDescription,dims);}
   virtual void GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
-    {vtkStructuredData::GetPointCells(ptId,cellIds,this->GetDimensions());}
+    {int dims[3]; this->GetDimensions(dims);
+     vtkStructuredData::GetPointCells(ptId,cellIds,dims);}
   virtual void ComputeBounds();
   virtual int GetMaxCellSize() {return 8;}; //voxel is the largest
 
@@ -412,13 +413,6 @@ inline void vtkImageData::ComputeIncrements()
   this->ComputeIncrements(this->Increments);
 }
 
-//----------------------------------------------------------------------------
-inline void vtkImageData::GetPoint(vtkIdType id, double x[3])
-{
-  const double *p = this->GetPoint(id);
-  x[0] = p[0]; x[1] = p[1]; x[2] = p[2];
-}
-
 //----------------------------------------------------------------------------
 inline vtkIdType vtkImageData::GetNumberOfPoints()
 {
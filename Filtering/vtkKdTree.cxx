@@ -31,6 +31,7 @@
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkGarbageCollector.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkPolyData.h"
 #include "vtkPoints.h"
@@ -41,6 +42,7 @@
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkCallbackCommand.h"
+#include "vtkThreadPool.h"
 
 #ifdef _MSC_VER
 #pragma warning ( disable : 4100 )
@@ -50,6 +52,7 @@
 #include <vtkstd/map>
 #include <vtkstd/queue>
 #include <vtkstd/set>
+#include <vtkstd/vector>
 
 
 // Timing data ---------------------------------------------
@@ -174,6 +177,189 @@ namespace
   };
 }
 
+// Number of cells or points handled by one task of the concurrent
+// build and queries.
+#define VTK_KD_TREE_BLOCK_SIZE 4096
+
+// Regions with more points than this have their two halves divided
+// concurrently.
+#define VTK_KD_TREE_DIVIDE_SIZE 32768
+
+//----------------------------------------------------------------------------
+// Arguments of the range functions run on the vtkThreadPool by the
+// concurrent build and queries.
+struct vtkKdTreeThreadStruct
+{
+  vtkKdTree *Tree;
+  vtkDataSet *DataSet;
+  int MaxCellSize;
+  float *Centers;
+  vtkPoints *Points;
+  int *RegionIds;
+  vtkIdType *PointIds;
+
+  // DivideChildren
+  vtkKdNode *Node;
+  int *Ids;
+  int Level;
+
+  // MapDuplicatePoints
+  vtkIdType *UniqueIds;
+  char *CorruptRegions;
+};
+
+// The range functions, in a friend class of vtkKdTree.
+class vtkKdTreeThreads
+{
+public:
+  static void ComputeCellCenters(vtkIdType begin, vtkIdType end, int,
+                                 void *arg);
+  static void DivideChildren(vtkIdType begin, vtkIdType end, int,
+                             void *arg);
+  static void FindRegions(vtkIdType begin, vtkIdType end, int, void *arg);
+  static void FindPoints(vtkIdType begin, vtkIdType end, int, void *arg);
+  static void MapDuplicatePoints(vtkIdType begin, vtkIdType end, int,
+                                 void *arg);
+};
+
+//----------------------------------------------------------------------------
+void vtkKdTreeThreads::ComputeCellCenters(vtkIdType begin, vtkIdType end,
+                                          int, void *arg)
+{
+  vtkKdTreeThreadStruct *str = static_cast<vtkKdTreeThreadStruct *>(arg);
+  vtkGenericCell *cell = vtkGenericCell::New();
+  double *weights = new double [str->MaxCellSize];
+  double dcenter[3];
+  float *cptr = str->Centers + 3*begin;
+
+  for (vtkIdType j=begin; j<end; j++)
+    {
+    str->DataSet->GetCell(j, cell);
+    str->Tree->ComputeCellCenter(cell, dcenter, weights);
+    cptr[0] = static_cast<float>(dcenter[0]);
+    cptr[1] = static_cast<float>(dcenter[1]);
+    cptr[2] = static_cast<float>(dcenter[2]);
+    cptr += 3;
+    }
+
+  delete [] weights;
+  cell->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Divide the left (0) and right (1) children of a node.  Each works on
+// its own part of the point and id arrays.
+void vtkKdTreeThreads::DivideChildren(vtkIdType begin, vtkIdType end,
+                                      int, void *arg)
+{
+  vtkKdTreeThreadStruct *str = static_cast<vtkKdTreeThreadStruct *>(arg);
+  int nleft = str->Node->GetLeft()->GetNumberOfPoints();
+
+  for (vtkIdType i=begin; i<end; i++)
+    {
+    if (i == 0)
+      {
+      str->Tree->DivideRegion(str->Node->GetLeft(), str->Centers,
+                              str->Ids, str->Level);
+      }
+    else
+      {
+      str->Tree->DivideRegion(str->Node->GetRight(),
+                              str->Centers + nleft*3,
+                              str->Ids ? str->Ids + nleft : NULL,
+                              str->Level);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the regions of the cell centers, or of the points if there are no
+// centers.
+void vtkKdTreeThreads::FindRegions(vtkIdType begin, vtkIdType end,
+                                   int, void *arg)
+{
+  vtkKdTreeThreadStruct *str = static_cast<vtkKdTreeThreadStruct *>(arg);
+  vtkKdNode *top = str->Tree->Top;
+  double pt[3];
+
+  for (vtkIdType i=begin; i<end; i++)
+    {
+    if (str->Centers)
+      {
+      float *center = str->Centers + 3*i;
+      str->RegionIds[i] =
+        vtkKdTree::findRegion(top, center[0], center[1], center[2]);
+      }
+    else
+      {
+      str->Points->GetPoint(i, pt);
+      str->RegionIds[i] = vtkKdTree::findRegion(top, pt[0], pt[1], pt[2]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTreeThreads::FindPoints(vtkIdType begin, vtkIdType end,
+                                  int, void *arg)
+{
+  vtkKdTreeThreadStruct *str = static_cast<vtkKdTreeThreadStruct *>(arg);
+  double pt[3];
+
+  for (vtkIdType i=begin; i<end; i++)
+    {
+    str->Points->GetPoint(i, pt);
+    str->PointIds[i] = str->Tree->FindPoint(pt);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Map the points of whole regions to the first identical point of their
+// region, as BuildMapForDuplicatePoints() does for a zero tolerance.
+void vtkKdTreeThreads::MapDuplicatePoints(vtkIdType begin, vtkIdType end,
+                                          int, void *arg)
+{
+  vtkKdTreeThreadStruct *str = static_cast<vtkKdTreeThreadStruct *>(arg);
+  vtkKdTree *self = str->Tree;
+  vtkstd::vector<int> uniqueFound;
+
+  for (vtkIdType regionId=begin; regionId<end; regionId++)
+    {
+    int idx = self->LocatorRegionLocation[regionId];
+    int numRegionPoints = self->RegionList[regionId]->GetNumberOfPoints();
+    float *point = self->LocatorPoints + 3*idx;
+
+    if ((numRegionPoints == 0) ||
+        (self->GetRegionContainingPoint(point[0],point[1],point[2]) !=
+         regionId))
+      {
+      str->CorruptRegions[regionId] = 1;
+      continue;
+      }
+
+    uniqueFound.resize(numRegionPoints);
+    int count = 0;
+
+    for (int idx2 = idx; idx2 < idx + numRegionPoints; idx2++)
+      {
+      int currentId = self->LocatorIds[idx2];
+
+      int duplicateFound =
+        self->SearchRegionForDuplicate(point, &uniqueFound[0], count, 0.0);
+
+      if (duplicateFound >= 0)
+        {
+        str->UniqueIds[currentId] = self->LocatorIds[duplicateFound];
+        }
+      else
+        {
+        uniqueFound[count++] = idx2;
+        str->UniqueIds[currentId] = currentId;
+        }
+      point += 3;
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkKdTree);
 
 //----------------------------------------------------------------------------
@@ -200,6 +386,7 @@ vtkKdTree::vtkKdTree()
 
   this->Timing = 0;
   this->TimerLog = NULL;
+  this->NumberOfThreads = 1;
 
   this->IncludeRegionBoundaryCells = 0;
   this->GenerateRepresentationUsingDataBounds = 0;
@@ -624,6 +811,34 @@ float *vtkKdTree::ComputeCellCenters(vtkDataSet *set)
     return NULL;
     }
 
+  if ((this->NumberOfThreads > 1) && (totalCells > VTK_KD_TREE_BLOCK_SIZE))
+    {
+    // Progress is only reported before and after the concurrent
+    // computation.
+
+    vtkKdTreeThreadStruct str;
+    str.Tree = this;
+    str.Centers = center;
+
+    int numSets = set ? 1 : this->GetNumberOfDataSets();
+
+    for (int i=0; i<numSets; i++)
+      {
+      str.DataSet = set ? set : this->GetDataSet(i);
+      str.MaxCellSize = str.DataSet->GetMaxCellSize();
+      vtkIdType nCells = str.DataSet->GetNumberOfCells();
+
+      str.DataSet->PrepareForThreadedAccess();
+      vtkThreadPool::GetGlobalPool()->ParallelFor(0, nCells,
+        VTK_KD_TREE_BLOCK_SIZE, vtkKdTreeThreads::ComputeCellCenters, &str);
+
+      str.Centers += 3*nCells;
+      }
+
+    this->UpdateSubOperationProgress(1.0);
+    return center;
+    }
+
   int maxCellSize = 0;
 
   if (set)
@@ -1303,6 +1518,23 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
     return 0;   // unable to divide region further
     }
 
+  if ((this->NumberOfThreads > 1) &&
+      (kd->GetNumberOfPoints() > VTK_KD_TREE_DIVIDE_SIZE))
+    {
+    // The two halves are disjoint parts of the point and id arrays.
+
+    vtkKdTreeThreadStruct str;
+    str.Tree = this;
+    str.Node = kd;
+    str.Centers = c1;
+    str.Ids = ids;
+    str.Level = level + 1;
+    vtkThreadPool::GetGlobalPool()->ParallelFor(0, 2, 1,
+      vtkKdTreeThreads::DivideChildren, &str);
+
+    return 0;
+    }
+
   int nleft = kd->GetLeft()->GetNumberOfPoints();
 
   int *leftIds  = ids;
@@ -1918,6 +2150,38 @@ vtkIdTypeArray *vtkKdTree::BuildMapForDuplicatePoints(float tolerance = 0.0)
 
   TIMER("Find duplicate points");
 
+  if ((tolerance == 0.0) && (this->NumberOfThreads > 1))
+    {
+    // Identical points are in the same region, so the regions are
+    // independent.
+
+    vtkIdTypeArray *uniqueIds = vtkIdTypeArray::New();
+    uniqueIds->SetNumberOfValues(this->NumberOfLocatorPoints);
+
+    vtkstd::vector<char> corruptRegions(this->NumberOfRegions, 0);
+
+    vtkKdTreeThreadStruct str;
+    str.Tree = this;
+    str.UniqueIds = uniqueIds->GetPointer(0);
+    str.CorruptRegions = &corruptRegions[0];
+    vtkThreadPool::GetGlobalPool()->ParallelFor(0, this->NumberOfRegions, 1,
+      vtkKdTreeThreads::MapDuplicatePoints, &str);
+
+    for (i=0; i<this->NumberOfRegions; i++)
+      {
+      if (corruptRegions[i])
+        {
+        uniqueIds->Delete();
+        vtkErrorMacro(<< "vtkKdTree::BuildMapForDuplicatePoints corrupt k-d tree");
+        return NULL; 
+        }
+      }
+
+    TIMERDONE("Find duplicate points");
+
+    return uniqueIds;
+    }
+
   int *idCount = new int [this->NumberOfRegions];
   int **uniqueFound = new int * [this->NumberOfRegions];
 
@@ -2188,6 +2452,35 @@ vtkIdType vtkKdTree::FindPoint(double x, double y, double z)
   return ptId;
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTree::FindPoints(vtkPoints *points, vtkIdTypeArray *ids)
+{
+  if (!this->LocatorPoints)
+    {
+    vtkErrorMacro(<< "vtkKdTree::FindPoints - must build locator first");
+    return;
+    }
+
+  vtkIdType npoints = points->GetNumberOfPoints();
+  ids->SetNumberOfComponents(1);
+  ids->SetNumberOfTuples(npoints);
+
+  vtkKdTreeThreadStruct str;
+  str.Tree = this;
+  str.Points = points;
+  str.PointIds = ids->GetPointer(0);
+
+  if (this->NumberOfThreads > 1)
+    {
+    vtkThreadPool::GetGlobalPool()->ParallelFor(0, npoints,
+      VTK_KD_TREE_BLOCK_SIZE, vtkKdTreeThreads::FindPoints, &str);
+    }
+  else
+    {
+    vtkKdTreeThreads::FindPoints(0, npoints, 0, &str);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkKdTree::FindClosestPoint(double x[3], double &dist2)
 {
@@ -4152,14 +4445,19 @@ int *vtkKdTree::AllGetRegionContainingCell()
     
     float *centers = this->ComputeCellCenters(iset);
     
-    float *pt = centers;
+    vtkKdTreeThreadStruct str;
+    str.Tree = this;
+    str.Centers = centers;
+    str.RegionIds = listPtr;
 
-    for (int cellId = 0; cellId < setCells; cellId++)
+    if (this->NumberOfThreads > 1)
       {
-      listPtr[cellId] =
-        this->GetRegionContainingPoint(pt[0], pt[1], pt[2]);
-
-      pt += 3;
+      vtkThreadPool::GetGlobalPool()->ParallelFor(0, setCells,
+        VTK_KD_TREE_BLOCK_SIZE, vtkKdTreeThreads::FindRegions, &str);
+      }
+    else
+      {
+      vtkKdTreeThreads::FindRegions(0, setCells, 0, &str);
       }
 
     listPtr += setCells;
@@ -4175,6 +4473,37 @@ int vtkKdTree::GetRegionContainingPoint(double x, double y, double z)
 {
   return vtkKdTree::findRegion(this->Top, x, y, z);
 }
+
+//----------------------------------------------------------------------------
+void vtkKdTree::GetRegionsContainingPoints(vtkPoints *points,
+                                           vtkIntArray *regionIds)
+{
+  if (!this->Top)
+    {
+    vtkErrorMacro(<< "vtkKdTree::GetRegionsContainingPoints - must build locator first");
+    return;
+    }
+
+  vtkIdType npoints = points->GetNumberOfPoints();
+  regionIds->SetNumberOfComponents(1);
+  regionIds->SetNumberOfTuples(npoints);
+
+  vtkKdTreeThreadStruct str;
+  str.Tree = this;
+  str.Centers = NULL;
+  str.Points = points;
+  str.RegionIds = regionIds->GetPointer(0);
+
+  if (this->NumberOfThreads > 1)
+    {
+    vtkThreadPool::GetGlobalPool()->ParallelFor(0, npoints,
+      VTK_KD_TREE_BLOCK_SIZE, vtkKdTreeThreads::FindRegions, &str);
+    }
+  else
+    {
+    vtkKdTreeThreads::FindRegions(0, npoints, 0, &str);
+    }
+}
 //----------------------------------------------------------------------------
 int vtkKdTree::MinimalNumberOfConvexSubRegions(vtkIntArray *regionIdList,
                                                double **convexSubRegions)
@@ -4790,6 +5119,7 @@ void vtkKdTree::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Timing: " << this->Timing << endl;
   os << indent << "TimerLog: " << this->TimerLog << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 
   os << indent << "IncludeRegionBoundaryCells: ";
         os << this->IncludeRegionBoundaryCells << endl;
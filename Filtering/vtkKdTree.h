@@ -47,6 +47,13 @@
 //     tolerance, or you can use FindPoint and FindClosestPoint to
 //     locate points in the original set that the tree was built from.
 //
+//     With NumberOfThreads above one, the cell centers are computed and
+//     the two halves of large regions are divided concurrently on the
+//     vtkThreadPool.  The resulting tree is the same as the serial one.
+//     AllGetRegionContainingCell, GetRegionsContainingPoints, FindPoints
+//     and BuildMapForDuplicatePoints with a zero tolerance also use
+//     NumberOfThreads threads.
+//
 // .SECTION See Also
 //      vtkLocator vtkCellLocator vtkPKdTree
 
@@ -87,6 +94,12 @@ public:
   vtkSetMacro(MinCells, int);
   vtkGetMacro(MinCells, int);
 
+  // Description:
+  //  Set/Get the number of threads used to build the k-d tree and to
+  //  answer the bulk queries.  Default is 1.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   //   Set/Get the number of spatial regions you want to get close
   //   to without going over.  (The number of spatial regions is normally
@@ -337,6 +350,11 @@ public:
   // Description:
   //    Get the id of the region containing the specified location.
   int GetRegionContainingPoint(double x, double y, double z);
+
+  // Description:
+  //    Get the id of the region containing each of the points.  The
+  //    id is -1 for points outside of the k-d tree.
+  void GetRegionsContainingPoints(vtkPoints *points, vtkIntArray *regionIds);
   
   // Description:
   // Create the k-d tree decomposition of the cells of the data set
@@ -438,6 +456,9 @@ public:
   //
   // You must have called BuildLocatorFromPoints() before calling this.
   // You are responsible for deleting the returned array.
+  //
+  // With a zero tolerance, duplicates can only be in the same region and
+  // the regions are searched on NumberOfThreads threads.
   vtkIdTypeArray *BuildMapForDuplicatePoints(float tolerance);
 
   // Description:
@@ -447,6 +468,11 @@ public:
   vtkIdType FindPoint(double *x);
   vtkIdType FindPoint(double x, double y, double z);
 
+  // Description:
+  // Find the Ids of a list of points, as FindPoint() does for each
+  // of them.
+  void FindPoints(vtkPoints *points, vtkIdTypeArray *ids);
+
   // Description:
   // Find the Id of the point that was previously supplied
   // to BuildLocatorFromPoints() which is closest to the given point.
@@ -808,6 +834,7 @@ protected:
   int NumberOfRegions;              // number of leaf nodes
 
   int Timing;
+  int NumberOfThreads;
   double FudgeFactor;   // a very small distance, relative to the dataset's size
 
   // These instance variables are used by the special locator created
@@ -836,6 +863,10 @@ protected:
   vtkBSPCuts *Cuts;
   double Progress;
 
+//BTX
+  friend class vtkKdTreeThreads;
+//ETX
+
   vtkKdTree(const vtkKdTree&); // Not implemented
   void operator=(const vtkKdTree&); // Not implemented
 };
@@ -0,0 +1,322 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkOutputRecycler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkOutputRecycler.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/vector>
+
+#include <string.h>
+
+vtkStandardNewMacro(vtkOutputRecycler);
+
+vtkInformationKeyMacro(vtkOutputRecycler, RECYCLER, ObjectBase);
+
+//----------------------------------------------------------------------------
+class vtkOutputRecyclerInternals
+{
+public:
+  vtkstd::vector<vtkSmartPointer<vtkPoints> > Points;
+  vtkSmartPointer<vtkCellArray>
+    CellArrays[vtkOutputRecycler::NUMBER_OF_CELL_ARRAY_TYPES];
+  vtkstd::vector<vtkSmartPointer<vtkAbstractArray> > Arrays;
+
+  // Keep the arrays of the given attributes.
+  void AddArrays(vtkFieldData* fd)
+    {
+    for (int i = 0; i < fd->GetNumberOfArrays(); i++)
+      {
+      if (vtkAbstractArray* array = fd->GetAbstractArray(i))
+        {
+        this->Arrays.push_back(array);
+        }
+      }
+    }
+
+  // Keep the given cell array if it holds cells.  Empty cell arrays may
+  // be the dummy one that vtkPolyData returns when it has none.
+  void AddCellArray(int type, vtkCellArray* cells)
+    {
+    if (cells && cells->GetNumberOfCells() > 0)
+      {
+      this->CellArrays[type] = cells;
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkOutputRecycler::vtkOutputRecycler()
+{
+  this->Internal = new vtkOutputRecyclerInternals;
+  this->NumberOfReusedObjects = 0;
+  this->NumberOfNewObjects = 0;
+  this->ReusedMemorySize = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkOutputRecycler::~vtkOutputRecycler()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::Recycle(vtkDataObject* data)
+{
+  this->Release();
+
+  if (vtkPointSet* ps = vtkPointSet::SafeDownCast(data))
+    {
+    if (ps->GetPoints())
+      {
+      this->Internal->Points.push_back(ps->GetPoints());
+      }
+    }
+  if (vtkPolyData* pd = vtkPolyData::SafeDownCast(data))
+    {
+    this->Internal->AddCellArray(VERTS, pd->GetVerts());
+    this->Internal->AddCellArray(LINES, pd->GetLines());
+    this->Internal->AddCellArray(POLYS, pd->GetPolys());
+    this->Internal->AddCellArray(STRIPS, pd->GetStrips());
+    }
+  if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data))
+    {
+    this->Internal->AddCellArray(CELLS, ug->GetCells());
+    if (ug->GetCellTypesArray())
+      {
+      this->Internal->Arrays.push_back(ug->GetCellTypesArray());
+      }
+    if (ug->GetCellLocationsArray())
+      {
+      this->Internal->Arrays.push_back(ug->GetCellLocationsArray());
+      }
+    }
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+    {
+    this->Internal->AddArrays(ds->GetPointData());
+    this->Internal->AddArrays(ds->GetCellData());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::Release()
+{
+  this->Internal->Points.clear();
+  for (int i = 0; i < NUMBER_OF_CELL_ARRAY_TYPES; i++)
+    {
+    this->Internal->CellArrays[i] = 0;
+    }
+  this->Internal->Arrays.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::Attach(vtkDataObject* data)
+{
+  data->GetInformation()->Set(RECYCLER(), this);
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+    {
+    ds->GetPointData()->SetRecycler(this);
+    ds->GetCellData()->SetRecycler(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::Detach(vtkDataObject* data)
+{
+  data->GetInformation()->Remove(RECYCLER());
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+    {
+    ds->GetPointData()->SetRecycler(0);
+    ds->GetCellData()->SetRecycler(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPoints* vtkOutputRecycler::TakePoints(int dataType)
+{
+  vtkstd::vector<vtkSmartPointer<vtkPoints> >& points = this->Internal->Points;
+  for (size_t i = 0; i < points.size(); i++)
+    {
+    vtkPoints* p = points[i];
+    if (p->GetDataType() == dataType && p->GetReferenceCount() == 1 &&
+        p->GetData()->GetReferenceCount() == 1)
+      {
+      p->Register(0);
+      points.erase(points.begin() + i);
+      p->Reset();
+      p->Modified();
+      this->CountReused(p->GetActualMemorySize());
+      return p;
+      }
+    }
+  this->CountNew();
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkCellArray* vtkOutputRecycler::TakeCellArray(int type)
+{
+  vtkCellArray* c = 0;
+  if (type >= 0 && type < NUMBER_OF_CELL_ARRAY_TYPES)
+    {
+    c = this->Internal->CellArrays[type];
+    }
+  if (c && c->GetReferenceCount() == 1 &&
+      c->GetData()->GetReferenceCount() == 1)
+    {
+    c->Register(0);
+    this->Internal->CellArrays[type] = 0;
+    c->Reset();
+    c->Modified();
+    this->CountReused(c->GetActualMemorySize());
+    return c;
+    }
+  this->CountNew();
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractArray* vtkOutputRecycler::TakeArray(const char* className,
+                                               int numComponents)
+{
+  vtkstd::vector<vtkSmartPointer<vtkAbstractArray> >& arrays =
+    this->Internal->Arrays;
+  for (size_t i = 0; i < arrays.size(); i++)
+    {
+    vtkAbstractArray* a = arrays[i];
+    if (a->GetNumberOfComponents() == numComponents &&
+        a->GetReferenceCount() == 1 &&
+        strcmp(a->GetClassName(), className) == 0)
+      {
+      a->Register(0);
+      arrays.erase(arrays.begin() + i);
+
+      // Return the array as if it were new, with its memory.
+      a->Reset();
+      a->SetName(0);
+      a->ClearComponentNames();
+      if (a->HasInformation())
+        {
+        a->GetInformation()->Clear();
+        }
+      if (vtkDataArray* da = vtkDataArray::SafeDownCast(a))
+        {
+        da->SetLookupTable(0);
+        }
+      a->DataChanged();
+      this->CountReused(a->GetActualMemorySize());
+      return a;
+      }
+    }
+  this->CountNew();
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkOutputRecycler* vtkOutputRecycler::GetRecycler(vtkDataObject* data)
+{
+  if (!data || !data->GetInformation())
+    {
+    return 0;
+    }
+  return static_cast<vtkOutputRecycler*>(
+    data->GetInformation()->Get(RECYCLER()));
+}
+
+//----------------------------------------------------------------------------
+vtkPoints* vtkOutputRecycler::NewPoints(vtkDataObject* output, int dataType)
+{
+  vtkOutputRecycler* self = vtkOutputRecycler::GetRecycler(output);
+  vtkPoints* points = self ? self->TakePoints(dataType) : 0;
+  if (!points)
+    {
+    points = vtkPoints::New();
+    points->SetDataType(dataType);
+    }
+  return points;
+}
+
+//----------------------------------------------------------------------------
+vtkCellArray* vtkOutputRecycler::NewCellArray(vtkDataObject* output,
+                                              int type)
+{
+  vtkOutputRecycler* self = vtkOutputRecycler::GetRecycler(output);
+  vtkCellArray* cells = self ? self->TakeCellArray(type) : 0;
+  if (!cells)
+    {
+    cells = vtkCellArray::New();
+    }
+  return cells;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkOutputRecycler::NewArray(vtkDataObject* output,
+                                          int dataType, int numComponents)
+{
+  vtkDataArray* array = vtkDataArray::CreateDataArray(dataType);
+  if (vtkOutputRecycler* self = vtkOutputRecycler::GetRecycler(output))
+    {
+    vtkDataArray* recycled = vtkDataArray::SafeDownCast(
+      self->TakeArray(array->GetClassName(), numComponents));
+    if (recycled)
+      {
+      array->Delete();
+      return recycled;
+      }
+    }
+  array->SetNumberOfComponents(numComponents);
+  return array;
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::CountReused(unsigned long size)
+{
+  this->NumberOfReusedObjects++;
+  this->ReusedMemorySize += size;
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::CountNew()
+{
+  this->NumberOfNewObjects++;
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::ResetCounters()
+{
+  this->NumberOfReusedObjects = 0;
+  this->NumberOfNewObjects = 0;
+  this->ReusedMemorySize = 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkOutputRecycler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "Number Of Reused Objects: "
+     << this->NumberOfReusedObjects << "\n";
+  os << indent << "Number Of New Objects: " << this->NumberOfNewObjects << "\n";
+  os << indent << "Reused Memory Size: " << this->ReusedMemorySize << "\n";
+}
@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkOutputRecycler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkOutputRecycler - reuse the memory of an algorithm's previous output
+// .SECTION Description
+// vtkOutputRecycler keeps the points, cell arrays and attribute arrays
+// of the previous output of an algorithm so that the next execution can
+// reuse their memory instead of allocating new objects.  This avoids
+// most of the allocation and page fault cost of re-executing a filter
+// whose output keeps about the same size, for example while a contour
+// value is changed interactively.
+//
+// vtkDemandDrivenPipeline creates one recycler for each output port whose
+// RECYCLE_OUTPUT flag is set (see SetRecycleOutputFlag()).  Before the
+// algorithm executes, the pieces of the old output are given to the
+// recycler with Recycle(), and the recycler is attached to the new
+// output.  While it is attached, vtkPolyData::Allocate(),
+// vtkUnstructuredGrid::Allocate() and the CopyAllocate() and
+// InterpolateAllocate() methods of the output attributes take their
+// objects from it.  Algorithms get their points and cell arrays with
+// NewPoints(), NewCellArray() and NewArray(), which behave like the New()
+// method of the class when no recycler is attached.  Recycled objects
+// are Reset, so their capacity is kept and an Allocate() that fits in it
+// does not allocate memory.  Pieces still referenced elsewhere, for
+// example by a downstream filter that shallow copied them, are never
+// reused.  The pieces that were not reused are released after the
+// algorithm has executed.
+//
+// A recycler must be used by one thread at a time.
+//
+// .SECTION See Also
+// vtkDemandDrivenPipeline
+
+#ifndef __vtkOutputRecycler_h
+#define __vtkOutputRecycler_h
+
+#include "vtkObject.h"
+
+class vtkAbstractArray;
+class vtkCellArray;
+class vtkDataArray;
+class vtkDataObject;
+class vtkInformationObjectBaseKey;
+class vtkPoints;
+//BTX
+class vtkOutputRecyclerInternals;
+//ETX
+
+class VTK_FILTERING_EXPORT vtkOutputRecycler : public vtkObject
+{
+public:
+  static vtkOutputRecycler* New();
+  vtkTypeMacro(vtkOutputRecycler,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Keep the points, cell arrays and point and cell attribute arrays of
+  // the given data object for reuse.  Call this before the data object
+  // is initialized.
+  void Recycle(vtkDataObject* data);
+
+  // Description:
+  // Release all the kept objects.
+  void Release();
+
+  // Description:
+  // Attach the recycler to a data object, or detach it.  While attached,
+  // the data object and its attributes allocate from the recycler.
+  void Attach(vtkDataObject* data);
+  void Detach(vtkDataObject* data);
+
+  //BTX
+  // Description:
+  // The role of a cell array in its data set: the vertices, lines,
+  // polygons or strips of a vtkPolyData, or the cells of a
+  // vtkUnstructuredGrid.
+  enum CellArrayTypes
+  {
+    VERTS = 0,
+    LINES,
+    POLYS,
+    STRIPS,
+    CELLS,
+    NUMBER_OF_CELL_ARRAY_TYPES
+  };
+  //ETX
+
+  // Description:
+  // Return a kept object of the given kind, reset, or NULL if there is
+  // none that can be reused.  The caller receives a reference, as from
+  // New().  Arrays are matched by class and number of components.
+  vtkPoints* TakePoints(int dataType);
+  vtkCellArray* TakeCellArray(int type);
+  vtkAbstractArray* TakeArray(const char* className, int numComponents);
+
+  // Description:
+  // Return the recycler attached to the given data object, or NULL.
+  static vtkOutputRecycler* GetRecycler(vtkDataObject* data);
+
+  // Description:
+  // Create objects for the given output, reusing kept ones when a
+  // recycler is attached to it.  NewArray() returns an array of the
+  // given data type, with the given number of components.  The type of
+  // a cell array is one of CellArrayTypes.
+  static vtkPoints* NewPoints(vtkDataObject* output, int dataType=VTK_FLOAT);
+  static vtkCellArray* NewCellArray(vtkDataObject* output, int type);
+  static vtkDataArray* NewArray(vtkDataObject* output, int dataType,
+                                int numComponents=1);
+
+  // Description:
+  // The number of objects taken from the recycler, each of which saved
+  // an allocation, and the number of requests that found nothing to
+  // reuse.  Counted since the recycler was created or ResetCounters()
+  // was last called.
+  vtkGetMacro(NumberOfReusedObjects, vtkIdType);
+  vtkGetMacro(NumberOfNewObjects, vtkIdType);
+
+  // Description:
+  // The capacity of the reused objects in kilobytes (1024 bytes).
+  vtkGetMacro(ReusedMemorySize, double);
+
+  // Description:
+  // Reset the counters.
+  void ResetCounters();
+
+  // Description:
+  // Key to store the recycler in the information of an output port and
+  // of a data object it is attached to.
+  static vtkInformationObjectBaseKey* RECYCLER();
+
+protected:
+  vtkOutputRecycler();
+  ~vtkOutputRecycler();
+
+  vtkIdType NumberOfReusedObjects;
+  vtkIdType NumberOfNewObjects;
+  double ReusedMemorySize;
+
+  // Count an object taken from the recycler, or a request that found
+  // nothing.
+  void CountReused(unsigned long size);
+  void CountNew();
+
+private:
+  vtkOutputRecyclerInternals* Internal;
+
+  vtkOutputRecycler(const vtkOutputRecycler&);  // Not implemented.
+  void operator=(const vtkOutputRecycler&);  // Not implemented.
+};
+
+#endif
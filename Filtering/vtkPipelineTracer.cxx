@@ -0,0 +1,452 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineTracer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPipelineTracer.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkCriticalSection.h"
+#include "vtkDataArrayAllocator.h"
+#include "vtkDataObject.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationRequestKey.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+#include <vtksys/ios/fstream>
+
+#include <stdlib.h>
+
+vtkStandardNewMacro(vtkPipelineTracer);
+
+vtkPipelineTracer* vtkPipelineTracer::ActiveTracer = 0;
+
+//----------------------------------------------------------------------------
+// A data array allocator that counts the bytes it allocates, separately
+// for each thread, and forwards to the allocator that was global before,
+// or malloc.
+class vtkPipelineTracerAllocator : public vtkDataArrayAllocator
+{
+public:
+  static vtkPipelineTracerAllocator* New();
+  vtkTypeMacro(vtkPipelineTracerAllocator,vtkDataArrayAllocator);
+
+  virtual void* Allocate(size_t size)
+    {
+    void* ptr = (this->Delegate ? this->Delegate->Allocate(size) :
+                 malloc(size));
+    if (ptr)
+      {
+      this->Count(size);
+      }
+    return ptr;
+    }
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize)
+    {
+    void* newPtr = (this->Delegate ?
+                    this->Delegate->Reallocate(ptr, oldSize, newSize) :
+                    realloc(ptr, newSize));
+    if (newPtr && newSize > oldSize)
+      {
+      this->Count(newSize - oldSize);
+      }
+    return newPtr;
+    }
+  virtual void Free(void* ptr, size_t size)
+    {
+    if (this->Delegate)
+      {
+      this->Delegate->Free(ptr, size);
+      }
+    else
+      {
+      free(ptr);
+      }
+    }
+
+  void Count(size_t size)
+    {
+    this->Lock.Lock();
+    this->GetThreadCount() += static_cast<vtkTypeInt64>(size);
+    this->Lock.Unlock();
+    }
+
+  // Return the bytes allocated so far by the calling thread.
+  vtkTypeInt64 GetAllocated()
+    {
+    this->Lock.Lock();
+    vtkTypeInt64 allocated = this->GetThreadCount();
+    this->Lock.Unlock();
+    return allocated;
+    }
+
+  vtkSmartPointer<vtkDataArrayAllocator> Delegate;
+  vtkstd::vector<vtkMultiThreaderIDType> Threads;
+  vtkstd::vector<vtkTypeInt64> Allocated;
+  vtkSimpleCriticalSection Lock;
+
+protected:
+  vtkPipelineTracerAllocator() {}
+  ~vtkPipelineTracerAllocator() {}
+
+  // Return the count of the calling thread.  Must be called with the lock
+  // held.
+  vtkTypeInt64& GetThreadCount()
+    {
+    vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+    for (size_t i = 0; i < this->Threads.size(); i++)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Threads[i], id))
+        {
+        return this->Allocated[i];
+        }
+      }
+    this->Threads.push_back(id);
+    this->Allocated.push_back(0);
+    return this->Allocated.back();
+    }
+};
+vtkStandardNewMacro(vtkPipelineTracerAllocator);
+
+//----------------------------------------------------------------------------
+struct vtkPipelineTracerEvent
+{
+  vtkstd::string Algorithm;
+  vtkstd::string Pass;
+  void* Address;
+  double Start;
+  double End;
+  int Thread;
+  double OutputSize;
+  double AllocatedSize;
+};
+
+//----------------------------------------------------------------------------
+class vtkPipelineTracerInternals
+{
+public:
+  vtkPipelineTracerInternals() : HaveOrigin(false), Origin(0.0) {}
+
+  vtkstd::vector<vtkPipelineTracerEvent> Events;
+  vtkstd::vector<vtkMultiThreaderIDType> Threads;
+  vtkSimpleCriticalSection Lock;
+  vtkSmartPointer<vtkPipelineTracerAllocator> Allocator;
+  bool HaveOrigin;
+  double Origin;
+
+  // Return the number of the calling thread.  Must be called with the
+  // lock held.
+  int GetThreadNumber()
+    {
+    vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+    for (size_t i = 0; i < this->Threads.size(); i++)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Threads[i], id))
+        {
+        return static_cast<int>(i);
+        }
+      }
+    this->Threads.push_back(id);
+    return static_cast<int>(this->Threads.size() - 1);
+    }
+};
+
+//----------------------------------------------------------------------------
+// Write a string as a JSON string.
+static void vtkPipelineTracerWriteString(ostream& os, const vtkstd::string& s)
+{
+  os << '"';
+  for (size_t i = 0; i < s.size(); i++)
+    {
+    if (s[i] == '"' || s[i] == '\\')
+      {
+      os << '\\';
+      }
+    os << s[i];
+    }
+  os << '"';
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineTracer::vtkPipelineTracer()
+{
+  this->TraceAllocations = 1;
+  this->Internals = new vtkPipelineTracerInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineTracer::~vtkPipelineTracer()
+{
+  this->Stop();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "TraceAllocations: " << this->TraceAllocations << endl;
+  os << indent << "NumberOfEvents: " << this->GetNumberOfEvents() << endl;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineTracer* vtkPipelineTracer::GetActiveTracer()
+{
+  return vtkPipelineTracer::ActiveTracer;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::Start()
+{
+  if (vtkPipelineTracer::ActiveTracer == this)
+    {
+    return;
+    }
+  if (vtkPipelineTracer::ActiveTracer)
+    {
+    vtkPipelineTracer::ActiveTracer->Stop();
+    }
+  if (!this->Internals->HaveOrigin)
+    {
+    this->Internals->Origin = vtkTimerLog::GetUniversalTime();
+    this->Internals->HaveOrigin = true;
+    }
+  if (this->TraceAllocations)
+    {
+    // Arrays return their memory to the allocator that provided it, so an
+    // allocator keeps its delegate for its whole life.
+    vtkDataArrayAllocator* global =
+      vtkDataArrayAllocator::GetGlobalAllocator();
+    if (!this->Internals->Allocator ||
+        this->Internals->Allocator->Delegate != global)
+      {
+      this->Internals->Allocator =
+        vtkSmartPointer<vtkPipelineTracerAllocator>::New();
+      this->Internals->Allocator->Delegate = global;
+      }
+    vtkDataArrayAllocator::SetGlobalAllocator(this->Internals->Allocator);
+    }
+  vtkPipelineTracer::ActiveTracer = this;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::Stop()
+{
+  if (vtkPipelineTracer::ActiveTracer != this)
+    {
+    return;
+    }
+  vtkPipelineTracerAllocator* allocator = this->Internals->Allocator;
+  if (allocator &&
+      vtkDataArrayAllocator::GetGlobalAllocator() == allocator)
+    {
+    vtkDataArrayAllocator::SetGlobalAllocator(allocator->Delegate);
+    }
+  vtkPipelineTracer::ActiveTracer = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::Clear()
+{
+  this->Internals->Events.clear();
+  this->Internals->Threads.clear();
+  this->Internals->HaveOrigin = false;
+  if (vtkPipelineTracer::ActiveTracer == this)
+    {
+    this->Internals->Origin = vtkTimerLog::GetUniversalTime();
+    this->Internals->HaveOrigin = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::BeginExecution(ExecutionMark& mark)
+{
+  mark.Allocated = -1;
+  if (this->Internals->Allocator &&
+      vtkDataArrayAllocator::GetGlobalAllocator() ==
+      this->Internals->Allocator.GetPointer())
+    {
+    mark.Allocated = this->Internals->Allocator->GetAllocated();
+    }
+  mark.Time = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::EndExecution(const ExecutionMark& mark,
+                                     vtkAlgorithm* algorithm,
+                                     vtkInformation* request,
+                                     vtkInformationVector* outInfo)
+{
+  vtkPipelineTracerEvent event;
+  event.End = vtkTimerLog::GetUniversalTime();
+  event.AllocatedSize = -1.0;
+  if (mark.Allocated >= 0)
+    {
+    event.AllocatedSize = static_cast<double>(
+      this->Internals->Allocator->GetAllocated() - mark.Allocated);
+    }
+  event.Algorithm = algorithm->GetClassName();
+  event.Address = algorithm;
+
+  // The pass is the request key of the request.
+  vtkInformationRequestKey* pass = request->GetRequest();
+  if (pass)
+    {
+    event.Pass = pass->GetName();
+    }
+
+  // The memory held by the outputs that were generated.
+  event.OutputSize = -1.0;
+  if (pass == vtkDemandDrivenPipeline::REQUEST_DATA() && outInfo)
+    {
+    event.OutputSize = 0.0;
+    for (int i = 0; i < outInfo->GetNumberOfInformationObjects(); i++)
+      {
+      vtkDataObject* output =
+        outInfo->GetInformationObject(i)->Get(vtkDataObject::DATA_OBJECT());
+      if (output)
+        {
+        event.OutputSize += 1024.0*output->GetActualMemorySize();
+        }
+      }
+    }
+
+  this->Internals->Lock.Lock();
+  event.Start = mark.Time - this->Internals->Origin;
+  event.End -= this->Internals->Origin;
+  event.Thread = this->Internals->GetThreadNumber();
+  this->Internals->Events.push_back(event);
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineTracer::GetNumberOfEvents()
+{
+  return static_cast<int>(this->Internals->Events.size());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPipelineTracer::GetEventAlgorithm(int i)
+{
+  return this->Internals->Events[i].Algorithm.c_str();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPipelineTracer::GetEventPass(int i)
+{
+  return this->Internals->Events[i].Pass.c_str();
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineTracer::GetEventStartTime(int i)
+{
+  return this->Internals->Events[i].Start;
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineTracer::GetEventEndTime(int i)
+{
+  return this->Internals->Events[i].End;
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineTracer::GetEventThread(int i)
+{
+  return this->Internals->Events[i].Thread;
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineTracer::GetEventOutputSize(int i)
+{
+  return this->Internals->Events[i].OutputSize;
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineTracer::GetEventAllocatedSize(int i)
+{
+  return this->Internals->Events[i].AllocatedSize;
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineTracer::WriteChromeTrace(const char* fileName)
+{
+  vtksys_ios::ofstream os(fileName);
+  if (!os)
+    {
+    vtkErrorMacro("Cannot open " << fileName << " for writing.");
+    return 0;
+    }
+  this->WriteChromeTrace(os);
+  os.close();
+  if (os.fail())
+    {
+    vtkErrorMacro("Error writing " << fileName << ".");
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineTracer::WriteChromeTrace(ostream& os)
+{
+  // Complete events with times in microseconds, preceded by the names of
+  // the threads.
+  vtksys_ios::ios::fmtflags flags = os.flags();
+  vtksys_ios::streamsize precision = os.precision();
+  os.setf(vtksys_ios::ios::fixed, vtksys_ios::ios::floatfield);
+  os.precision(3);
+  os << "{\"traceEvents\":[\n";
+  const char* separator = "";
+  for (size_t t = 0; t < this->Internals->Threads.size(); t++)
+    {
+    os << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+       << "\"tid\":" << t << ",\"args\":{\"name\":\"Thread " << t << "\"}}";
+    separator = ",\n";
+    }
+  for (size_t i = 0; i < this->Internals->Events.size(); i++)
+    {
+    const vtkPipelineTracerEvent& event = this->Internals->Events[i];
+    os << separator << "{\"name\":";
+    vtkPipelineTracerWriteString(os, event.Algorithm);
+    os << ",\"cat\":";
+    vtkPipelineTracerWriteString(os, event.Pass);
+    os << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.Thread
+       << ",\"ts\":" << 1e6*event.Start
+       << ",\"dur\":" << 1e6*(event.End - event.Start)
+       << ",\"args\":{\"pass\":";
+    vtkPipelineTracerWriteString(os, event.Pass);
+    os << ",\"algorithm\":\"" << event.Address << "\"";
+    if (event.OutputSize >= 0)
+      {
+      os << ",\"output_bytes\":"
+         << static_cast<vtkTypeInt64>(event.OutputSize);
+      }
+    if (event.AllocatedSize >= 0)
+      {
+      os << ",\"allocated_bytes\":"
+         << static_cast<vtkTypeInt64>(event.AllocatedSize);
+      }
+    os << "}}";
+    separator = ",\n";
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
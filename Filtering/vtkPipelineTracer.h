@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineTracer.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPipelineTracer - record a timeline of algorithm executions
+// .SECTION Description
+// vtkPipelineTracer records every call that an executive makes to an
+// algorithm while it is started: the algorithm, the pipeline pass (the
+// request key, such as REQUEST_INFORMATION, REQUEST_UPDATE_EXTENT or
+// REQUEST_DATA), the begin and end times, and the thread that made the
+// call.  For REQUEST_DATA it also records the memory held by the outputs
+// afterwards.  With TraceAllocations on, it counts the bytes allocated
+// for data arrays by the thread of each call during that call.  Arrays
+// allocated at the same time by calls on other threads are not counted,
+// nor are those that a call allocates on the threads of vtkThreadPool.
+//
+// The timeline can be written in the Chrome trace event format and
+// loaded in chrome://tracing or any viewer of that format:
+// \code
+// vtkPipelineTracer* tracer = vtkPipelineTracer::New();
+// tracer->Start();
+// writer->Write();
+// tracer->Stop();
+// tracer->WriteChromeTrace("pipeline.json");
+// \endcode
+//
+// Only one tracer is active at a time.  Tracing costs nothing when no
+// tracer is started.  Start() and Stop() must not be called while
+// pipelines execute.
+//
+// .SECTION See Also
+// vtkExecutive vtkTimerLog
+
+#ifndef __vtkPipelineTracer_h
+#define __vtkPipelineTracer_h
+
+#include "vtkObject.h"
+
+class vtkAlgorithm;
+class vtkInformation;
+class vtkInformationVector;
+//BTX
+class vtkPipelineTracerInternals;
+//ETX
+
+class VTK_FILTERING_EXPORT vtkPipelineTracer : public vtkObject
+{
+public:
+  static vtkPipelineTracer* New();
+  vtkTypeMacro(vtkPipelineTracer,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Make this tracer the active one and record the executions from now
+  // on.  Recorded events are kept; call Clear() to remove them.
+  void Start();
+
+  // Description:
+  // Stop recording.
+  void Stop();
+
+  // Description:
+  // Return the tracer that records the executions, or NULL.
+  static vtkPipelineTracer* GetActiveTracer();
+
+  // Description:
+  // Set/Get whether the bytes allocated for data arrays are counted.
+  // This installs a global vtkDataArrayAllocator while the tracer is
+  // started, which forwards to the one that was global before.  The
+  // default is on.
+  vtkSetMacro(TraceAllocations, int);
+  vtkGetMacro(TraceAllocations, int);
+  vtkBooleanMacro(TraceAllocations, int);
+
+  // Description:
+  // Remove all the recorded events.
+  void Clear();
+
+  // Description:
+  // Get the recorded events.  Times are in seconds since the first call
+  // to Start() after the tracer was created or cleared.  Threads are
+  // numbered in the order they were first seen.  Sizes are in bytes; the
+  // output size is -1 for passes other than REQUEST_DATA, and the
+  // allocated size is -1 when allocations are not traced.
+  int GetNumberOfEvents();
+  const char* GetEventAlgorithm(int i);
+  const char* GetEventPass(int i);
+  double GetEventStartTime(int i);
+  double GetEventEndTime(int i);
+  int GetEventThread(int i);
+  double GetEventOutputSize(int i);
+  double GetEventAllocatedSize(int i);
+
+  // Description:
+  // Write the events in the Chrome trace event JSON format.  Return 1 on
+  // success, 0 if the file cannot be written.
+  int WriteChromeTrace(const char* fileName);
+  void WriteChromeTrace(ostream& os);
+
+  //BTX
+  // Description:
+  // Called by vtkExecutive around each call to an algorithm.  Begin
+  // fills the mark that is given back to End.
+  struct ExecutionMark
+  {
+    double Time;
+    vtkTypeInt64 Allocated;
+  };
+  void BeginExecution(ExecutionMark& mark);
+  void EndExecution(const ExecutionMark& mark, vtkAlgorithm* algorithm,
+                    vtkInformation* request, vtkInformationVector* outInfo);
+  //ETX
+
+protected:
+  vtkPipelineTracer();
+  ~vtkPipelineTracer();
+
+  int TraceAllocations;
+
+  //BTX
+  vtkPipelineTracerInternals* Internals;
+  //ETX
+
+private:
+  static vtkPipelineTracer* ActiveTracer;
+
+  vtkPipelineTracer(const vtkPipelineTracer&);  // Not implemented.
+  void operator=(const vtkPipelineTracer&);  // Not implemented.
+};
+
+#endif
@@ -92,7 +92,9 @@ void vtkPointSet::ComputeBounds()
 {
   double *bounds;
 
-  if ( this->Points )
+  // Only recompute when the points changed, so that GetBounds() does not
+  // write to the dataset once PrepareForThreadedAccess() computed them.
+  if ( this->Points && this->GetMTime() > this->ComputeTime )
     {
     bounds = this->Points->GetBounds();
     for (int i=0; i<6; i++)
@@ -23,6 +23,7 @@
 #include "vtkInformationVector.h"
 #include "vtkLine.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPointData.h"
 #include "vtkPointLocator.h"
 #include "vtkPolyLine.h"
@@ -950,6 +951,16 @@ void vtkPolyData::DeleteCells()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyData::PrepareForThreadedAccess()
+{
+  this->Superclass::PrepareForThreadedAccess();
+  if ( !this->Cells )
+    {
+    this->BuildCells();
+    }
+}
+
 //----------------------------------------------------------------------------
 // Create data structure that allows random access of cells.
 void vtkPolyData::BuildCells()
@@ -1167,22 +1178,22 @@ void vtkPolyData::Allocate(vtkIdType numCells, int extSize)
     this->Cells->Delete();
     }
 
-  cells = vtkCellArray::New();
+  cells = vtkOutputRecycler::NewCellArray(this, vtkOutputRecycler::VERTS);
   cells->Allocate(numCells,extSize);
   this->SetVerts(cells);
   cells->Delete();
 
-  cells = vtkCellArray::New();
+  cells = vtkOutputRecycler::NewCellArray(this, vtkOutputRecycler::LINES);
   cells->Allocate(numCells,extSize);
   this->SetLines(cells);
   cells->Delete();
 
-  cells = vtkCellArray::New();
+  cells = vtkOutputRecycler::NewCellArray(this, vtkOutputRecycler::POLYS);
   cells->Allocate(numCells,extSize);
   this->SetPolys(cells);
   cells->Delete();
 
-  cells = vtkCellArray::New();
+  cells = vtkOutputRecycler::NewCellArray(this, vtkOutputRecycler::STRIPS);
   cells->Allocate(numCells,extSize);
   this->SetStrips(cells);
   cells->Delete();
@@ -1214,7 +1225,8 @@ void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
 
   if ( numVerts > 0 )
     {
-    cells = vtkCellArray::New();
+    cells = vtkOutputRecycler::NewCellArray(
+      this, vtkOutputRecycler::VERTS);
     cells->Allocate(
       static_cast<int>(static_cast<double>(numVerts)/total*numCells),extSize);
     this->SetVerts(cells);
@@ -1222,7 +1234,8 @@ void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
     }
   if ( numLines > 0 )
     {
-    cells = vtkCellArray::New();
+    cells = vtkOutputRecycler::NewCellArray(
+      this, vtkOutputRecycler::LINES);
     cells->Allocate(
       static_cast<int>(static_cast<double>(numLines)/total*numCells),extSize);
     this->SetLines(cells);
@@ -1230,7 +1243,8 @@ void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
     }
   if ( numPolys > 0 )
     {
-    cells = vtkCellArray::New();
+    cells = vtkOutputRecycler::NewCellArray(
+      this, vtkOutputRecycler::POLYS);
     cells->Allocate(
       static_cast<int>(static_cast<double>(numPolys)/total*numCells),extSize);
     this->SetPolys(cells);
@@ -1238,7 +1252,8 @@ void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
     }
   if ( numStrips > 0 )
     {
-    cells = vtkCellArray::New();
+    cells = vtkOutputRecycler::NewCellArray(
+      this, vtkOutputRecycler::STRIPS);
     cells->Allocate(
       static_cast<int>(static_cast<double>(numStrips)/total*numCells),extSize);
     this->SetStrips(cells);
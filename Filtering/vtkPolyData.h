@@ -115,6 +115,13 @@ public:
   // Description:
   // Compute the (X, Y, Z)  bounds of the data.
   void ComputeBounds();
+
+  // Description:
+  // Build the bounds and the cell types (see BuildCells()) so that
+  // GetCell(cellId, vtkGenericCell*) and the other thread safe read
+  // methods can be called from several threads. Call BuildLinks() as
+  // well for topological queries.
+  virtual void PrepareForThreadedAccess();
   
   // Description:
   // Recover extra allocated memory when creating data whose initial size
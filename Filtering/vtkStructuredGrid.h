@@ -81,7 +81,9 @@ public:
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds);
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
     {
-      vtkStructuredData::GetPointCells(ptId,cellIds,this->GetDimensions());
+      int dims[3];
+      this->GetDimensions(dims);
+      vtkStructuredData::GetPointCells(ptId,cellIds,dims);
     }
   void Initialize();
   int GetMaxCellSize() {return 8;}; //hexahedron is the largest
@@ -31,6 +31,9 @@
 vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 {
   this->Threader = vtkMultiThreader::New();
+  // The pieces of ThreadedRequestData are independent, so they can run on
+  // the persistent pool threads instead of fresh ones.
+  this->Threader->UseThreadPoolOn();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
 }
 
@@ -19,6 +19,11 @@
 // into smaller extents so that the vtkImageData limits are observed. It 
 // also provides support for multithreading. If you don't need any of this
 // functionality, consider using vtkSimpleImageToImageAlgorithm instead.
+//
+// The pieces of ThreadedRequestData() run on the threads of the global
+// vtkThreadPool (see vtkMultiThreader::SetUseThreadPool()), whatever the
+// global default of vtkMultiThreader.  A subclass whose pieces wait for
+// each other must turn UseThreadPool off on its Threader.
 // .SECTION See also
 // vtkSimpleImageToImageAlgorithm
 
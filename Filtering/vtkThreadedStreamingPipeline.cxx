@@ -56,6 +56,9 @@ vtkInformationKeyMacro(vtkThreadedStreamingPipeline, AUTO_PROPAGATE, Integer);
 vtkInformationKeyRestrictedMacro(vtkThreadedStreamingPipeline,
                                  EXTRA_INFORMATION, ObjectBase,
                                  "vtkInformation");
+vtkInformationKeyMacro(vtkThreadedStreamingPipeline, NON_REENTRANT, Integer);
+vtkInformationKeyMacro(vtkThreadedStreamingPipeline, CONCURRENT_INPUT_READS,
+                       Integer);
 
 //----------------------------------------------------------------------------
 // Convinient definitions of vector/set of vtkExecutive
@@ -118,30 +121,6 @@ void vtkThreadedStreamingPipeline::SetAutoPropagatePush(bool enabled)
   AutoPropagatePush = enabled;
 }
 
-//----------------------------------------------------------------------------
-static void
-CollectUpstreamModules(vtkExecutive *exec, vtkExecutiveSet &eSet) 
-{
-  for(int i = 0; i < exec->GetNumberOfInputPorts(); ++i) 
-    {
-    int nic = exec->GetAlgorithm()->GetNumberOfInputConnections(i);
-    vtkInformationVector* inVector = exec->GetInputInformation()[i];
-    for(int j = 0; j < nic; ++j) 
-      {
-      vtkInformation* inInfo = inVector->GetInformationObject(j);
-      vtkExecutive* e;
-      int producerPort;
-      vtkExecutive::PRODUCER()->Get(inInfo, e, producerPort);
-      if (eSet.find(e)!=eSet.end())
-        {
-        continue;
-        }
-      eSet.insert(e);
-      CollectUpstreamModules(e, eSet);
-      }
-    }
-}
-
 //----------------------------------------------------------------------------
 void vtkThreadedStreamingPipeline::Pull(vtkExecutive *exec) 
 {
@@ -164,23 +143,15 @@ void vtkThreadedStreamingPipeline::Pull(vtkExecutiveCollection *execs)
 }
 
 //----------------------------------------------------------------------------
-void vtkThreadedStreamingPipeline::Pull(vtkExecutiveCollection *execs, vtkInformation *info) 
+void vtkThreadedStreamingPipeline::Pull(vtkExecutiveCollection *execs,
+                                        vtkInformation *info)
 {
-  vtkExecutiveSet eSet;
   execs->InitTraversal();
   for (vtkExecutive *e = execs->GetNextItem(); e != 0; e = execs->GetNextItem()) 
     {
-    eSet.insert(e);
-    CollectUpstreamModules(e, eSet);
-    }
-  vtkExecutiveCollection *collectedExecs = vtkExecutiveCollection::New();
-  for (vtkExecutiveSet::iterator ti = eSet.begin(); ti != eSet.end(); ti++)
-    {
-    collectedExecs->AddItem(*ti);
+    e->GetAlgorithm()->GetInformation()->Set(EXTRA_INFORMATION(), info);
     }
-  vtkExecutionScheduler::GetGlobalScheduler()->Schedule(collectedExecs, info);
-  vtkExecutionScheduler::GetGlobalScheduler()->WaitUntilDone(collectedExecs);
-  collectedExecs->Delete();
+  vtkExecutionScheduler::GetGlobalScheduler()->Update(execs);
 }
 
 //----------------------------------------------------------------------------
@@ -223,9 +194,7 @@ void vtkThreadedStreamingPipeline::Push(vtkExecutiveCollection *execs, vtkInform
     info->Set(vtkThreadedStreamingPipeline::AUTO_PROPAGATE(), 1);
     }
   vtkExecutionScheduler::GetGlobalScheduler()->Schedule(execs, info);
-  fprintf(stderr, "OK 2 %d\n", execs->GetNumberOfItems());
   vtkExecutionScheduler::GetGlobalScheduler()->WaitUntilReleased(execs);
-  fprintf(stderr, "OK 3\n");
 }
 
 //----------------------------------------------------------------------------
@@ -235,19 +204,31 @@ void vtkThreadedStreamingPipeline::Pull()
 }
 
 //----------------------------------------------------------------------------
-void vtkThreadedStreamingPipeline::Pull(vtkInformation *info) 
+void vtkThreadedStreamingPipeline::Pull(vtkInformation *info)
 {
   vtkExecutiveSet eSet;
-  CollectUpstreamModules(this, eSet);
+  for(int i = 0; i < this->GetNumberOfInputPorts(); ++i) 
+    {
+    int nic = this->GetAlgorithm()->GetNumberOfInputConnections(i);
+    vtkInformationVector* inVector = this->GetInputInformation()[i];
+    for(int j = 0; j < nic; ++j) 
+      {
+      vtkInformation* inInfo = inVector->GetInformationObject(j);
+      vtkExecutive* e;
+      int producerPort;
+      vtkExecutive::PRODUCER()->Get(inInfo, e, producerPort);
+      if (e)
+        {
+        eSet.insert(e);
+        }
+      }
+    }
   vtkExecutiveCollection *execs = vtkExecutiveCollection::New();
-  for (vtkExecutiveSet::iterator ti = eSet.begin(); ti != eSet.end(); ti++)
+  for (vtkExecutiveSet::iterator ti=eSet.begin(); ti!=eSet.end(); ti++)
     {
     execs->AddItem(*ti);
     }
-  vtkExecutionScheduler::GetGlobalScheduler()->Schedule(execs, info);
-  vtkExecutionScheduler::GetGlobalScheduler()->ReleaseResources(this);
-  vtkExecutionScheduler::GetGlobalScheduler()->WaitUntilDone(execs);
-  vtkExecutionScheduler::GetGlobalScheduler()->ReacquireResources(this);
+  vtkThreadedStreamingPipeline::Pull(execs, info);
   execs->Delete();
 }
   
@@ -388,15 +369,23 @@ vtkComputingResources *vtkThreadedStreamingPipeline::GetResources() {
 //----------------------------------------------------------------------------
 int vtkThreadedStreamingPipeline::ForwardUpstream(vtkInformation* request)
 {
-  if (MultiThreadedEnabled && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())) 
+  if (MultiThreadedEnabled && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())
+      && !this->SharedInputInformation)
     {
-    this->Pull();
-    return 1;
-    }
-  else
-    {
-    return this->Superclass::ForwardUpstream(request);
+    // The scheduler already brought the inputs up to date.
+    if (request->Get(vtkExecutionScheduler::UPSTREAM_UPDATED()))
+      {
+      return 1;
+      }
+    int result = vtkExecutionScheduler::GetGlobalScheduler()->
+      UpdateUpstream(this, request);
+    if (result >= 0)
+      {
+      return result;
+      }
+    // The network needs the serial update.
     }
+  return this->Superclass::ForwardUpstream(request);
 }
 
 //----------------------------------------------------------------------------
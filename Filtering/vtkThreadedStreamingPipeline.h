@@ -31,6 +31,14 @@
 // .SECTION Description
 // vtkThreadeStreamingDemandDrivenPipeline is an executive that supports
 // updating input ports based on the number of threads available.
+//
+// When multi-threading is enabled with SetMultiThreadedEnabled(), a
+// REQUEST_DATA request is not forwarded to the inputs one after the
+// other: vtkExecutionScheduler executes the whole network upstream on
+// the global vtkThreadPool, running independent branches at the same
+// time.  All the executives of the network should be of this type, e.g.
+// by setting it with vtkAlgorithm::SetDefaultExecutivePrototype(); the
+// others are executed one at a time.
 
 // .SECTION See Also
 // vtkExecutionScheduler
@@ -60,6 +68,21 @@ public:
   // Key to store the additional information for an update request
   static vtkInformationObjectBaseKey* EXTRA_INFORMATION();
 
+  // Description:
+  // Key set to 1 in the information of an algorithm (see
+  // vtkAlgorithm::GetInformation()) that must not execute at the same
+  // time as another instance of its class, e.g. a reader using a library
+  // that is not thread safe.
+  static vtkInformationIntegerKey* NON_REENTRANT();
+
+  // Description:
+  // Key set to 1 in the information of an algorithm that may read an
+  // input at the same time as the other consumers of that input, i.e.
+  // that only uses the thread safe access methods of vtkDataSet (see
+  // vtkDataSet::PrepareForThreadedAccess()).  The consumers of a shared
+  // output that do not set it execute one at a time.
+  static vtkInformationIntegerKey* CONCURRENT_INPUT_READS();
+
 //BTX
   // Description:
   // Definition of different types of processing units an algorithm
@@ -87,7 +110,9 @@ public:
 
   // Description:
   // Trigger the updates on certain execs and asking all of its
-  // upstream modules to be updated as well (propagate up)
+  // upstream modules to be updated as well (propagate up).  info is
+  // stored with EXTRA_INFORMATION() in the information of the algorithms
+  // of execs, as Push() does, before they are updated.
   static void Pull(vtkExecutiveCollection *execs, vtkInformation *info);
   
   // Description:
@@ -105,7 +130,9 @@ public:
   static void Pull(vtkExecutive *exec);
 
   // Description:
-  // A simplified version of Pull() which only acts upon a single executive
+  // A simplified version of Pull() which only acts upon a single executive.
+  // info is stored with EXTRA_INFORMATION() in the information of its
+  // algorithm.
   static void Pull(vtkExecutive *exec, vtkInformation *info);
 
   // Description:
@@ -121,7 +148,9 @@ public:
   void Pull();
 
   // Description:  
-  // Triggers upstream modules to update but not including itself
+  // Triggers upstream modules to update but not including itself.  info
+  // is stored with EXTRA_INFORMATION() in the information of the
+  // algorithms that produce the inputs.
   void Pull(vtkInformation *info);
 
   // Description:  
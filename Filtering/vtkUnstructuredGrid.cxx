@@ -27,6 +27,7 @@
 #include "vtkInformationVector.h"
 #include "vtkLine.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPixel.h"
 #include "vtkPointData.h"
 #include "vtkPolyLine.h"
@@ -135,7 +136,8 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
     {
     this->Connectivity->UnRegister(this);
     }
-  this->Connectivity = vtkCellArray::New();
+  this->Connectivity =
+    vtkOutputRecycler::NewCellArray(this, vtkOutputRecycler::CELLS);
   this->Connectivity->Allocate(numCells,4*extSize);
   this->Connectivity->Register(this);
   this->Connectivity->Delete();
@@ -144,7 +146,8 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
     {
     this->Types->UnRegister(this);
     }
-  this->Types = vtkUnsignedCharArray::New();
+  this->Types = static_cast<vtkUnsignedCharArray*>(
+    vtkOutputRecycler::NewArray(this, VTK_UNSIGNED_CHAR));
   this->Types->Allocate(numCells,extSize);
   this->Types->Register(this);
   this->Types->Delete();
@@ -153,7 +156,8 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
     {
     this->Locations->UnRegister(this);
     }
-  this->Locations = vtkIdTypeArray::New();
+  this->Locations = static_cast<vtkIdTypeArray*>(
+    vtkOutputRecycler::NewArray(this, VTK_ID_TYPE));
   this->Locations->Allocate(numCells,extSize);
   this->Locations->Register(this);
   this->Locations->Delete();
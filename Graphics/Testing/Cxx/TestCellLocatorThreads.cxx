@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Build vtkCellLocator and vtkModifiedBSPTree on several threads and check
+// that the queries give the same answers as with a serial build.
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkCellLocator.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreadPool.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Run the same queries on both locators and count the differences.
+// vtkModifiedBSPTree does not support the closest point and bounds
+// queries.
+static int CompareLocators(vtkAbstractCellLocator *serial,
+                           vtkAbstractCellLocator *threaded,
+                           int fullInterface)
+{
+  VTK_CREATE(vtkGenericCell, cell);
+  VTK_CREATE(vtkIdList, ids1);
+  VTK_CREATE(vtkIdList, ids2);
+  double pcoords[3], weights[8], closest[3], x1[3], x2[3], t1, t2, d1, d2;
+  int subId, errors = 0;
+  vtkIdType c1, c2;
+
+  for (int n = 0; n < 200 && errors < 10; n++)
+    {
+    // Rays through the sphere and points around its surface.
+    double a = 0.0377*n, b = 0.0191*n;
+    double p1[3] = { 2.0*cos(a)*sin(b+0.2), 2.0*sin(a)*sin(b+0.2),
+                     2.0*cos(b+0.2) };
+    double p2[3] = { -p1[0] + 0.1, -p1[1] - 0.05, -p1[2] + 0.02 };
+    int hit1 = serial->IntersectWithLine(p1, p2, 0.0, t1, x1, pcoords,
+                                         subId, c1, cell);
+    int hit2 = threaded->IntersectWithLine(p1, p2, 0.0, t2, x2, pcoords,
+                                           subId, c2, cell);
+    if (hit1 != hit2 || c1 != c2 || t1 != t2)
+      {
+      cerr << threaded->GetClassName() << ": ray " << n << " differs"
+           << endl;
+      errors++;
+      }
+
+    double x[3] = { 0.26*p1[0], 0.26*p1[1], 0.26*p1[2] };
+    if (serial->FindCell(x, 1e-3, cell, pcoords, weights) !=
+        threaded->FindCell(x, 1e-3, cell, pcoords, weights))
+      {
+      cerr << threaded->GetClassName() << ": cell of point " << n
+           << " differs" << endl;
+      errors++;
+      }
+
+    if (fullInterface)
+      {
+      serial->FindClosestPoint(x, closest, cell, c1, subId, d1);
+      threaded->FindClosestPoint(x, closest, cell, c2, subId, d2);
+      if (c1 != c2 || d1 != d2)
+        {
+        cerr << threaded->GetClassName() << ": closest cell " << n
+             << " differs" << endl;
+        errors++;
+        }
+
+      double bbox[6] = { x[0]-0.1, x[0]+0.1, x[1]-0.1, x[1]+0.1,
+                         x[2]-0.1, x[2]+0.1 };
+      serial->FindCellsWithinBounds(bbox, ids1);
+      threaded->FindCellsWithinBounds(bbox, ids2);
+      int same = (ids1->GetNumberOfIds() == ids2->GetNumberOfIds());
+      for (vtkIdType i = 0; same && i < ids1->GetNumberOfIds(); i++)
+        {
+        same = (ids1->GetId(i) == ids2->GetId(i));
+        }
+      if (!same)
+        {
+        cerr << threaded->GetClassName() << ": cells within bounds " << n
+             << " differ" << endl;
+        errors++;
+        }
+      }
+    }
+  return errors;
+}
+
+int TestCellLocatorThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(160);
+  sphere->SetPhiResolution(120);
+  sphere->Update();
+  vtkPolyData *input = sphere->GetOutput();
+
+  int errors = 0;
+  for (int threads = 2; threads <= 8; threads *= 2)
+    {
+    for (int cache = 0; cache < 2; cache++)
+      {
+      VTK_CREATE(vtkCellLocator, serial);
+      serial->SetDataSet(input);
+      serial->SetCacheCellBounds(cache);
+      serial->BuildLocator();
+      VTK_CREATE(vtkCellLocator, threaded);
+      threaded->SetDataSet(input);
+      threaded->SetCacheCellBounds(cache);
+      threaded->SetNumberOfThreads(threads);
+      threaded->BuildLocator();
+      errors += CompareLocators(serial, threaded, 1);
+
+      VTK_CREATE(vtkPolyData, rep1);
+      VTK_CREATE(vtkPolyData, rep2);
+      serial->GenerateRepresentation(-1, rep1);
+      threaded->GenerateRepresentation(-1, rep2);
+      if (rep1->GetNumberOfCells() != rep2->GetNumberOfCells())
+        {
+        cerr << threads << " threads: the octrees differ" << endl;
+        errors++;
+        }
+      }
+
+    // The split axes are drawn with rand().
+    VTK_CREATE(vtkModifiedBSPTree, serialBSP);
+    serialBSP->SetDataSet(input);
+    serialBSP->LazyEvaluationOff();
+    srand(1);
+    serialBSP->BuildLocator();
+    VTK_CREATE(vtkModifiedBSPTree, threadedBSP);
+    threadedBSP->SetDataSet(input);
+    threadedBSP->LazyEvaluationOff();
+    threadedBSP->SetNumberOfThreads(threads);
+    srand(1);
+    threadedBSP->BuildLocator();
+    errors += CompareLocators(serialBSP, threadedBSP, 0);
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterClipThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that cutting and clipping an unstructured grid on several threads
+// gives the same output as the serial algorithms, and that the threaded
+// algorithms stop when they are aborted.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkClipDataSet.h"
+#include "vtkCommand.h"
+#include "vtkCutter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkThreadPool.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A grid of dim^3 points made of hexahedra, or of tetrahedra when tets is
+// set, with a point scalar and the cell ids as cell data.
+static void BuildGrid(vtkUnstructuredGrid *grid, int dim, int tets)
+{
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("Distance");
+  int i, j, k;
+  for (k = 0; k < dim; k++)
+    {
+    for (j = 0; j < dim; j++)
+      {
+      for (i = 0; i < dim; i++)
+        {
+        double x = i + 0.1*j, y = j + 0.05*k*k/dim, z = k;
+        points->InsertNextPoint(x, y, z);
+        scalars->InsertNextValue(static_cast<float>(x*x + y*y + z*z));
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+
+  VTK_CREATE(vtkIdTypeArray, cellIds);
+  cellIds->SetName("CellIds");
+  grid->Allocate((dim-1)*(dim-1)*(dim-1)*(tets ? 6 : 1));
+  static const int kuhn[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6},
+                                  {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+  vtkIdType pts[8], tetPts[4];
+  for (k = 0; k < dim-1; k++)
+    {
+    for (j = 0; j < dim-1; j++)
+      {
+      for (i = 0; i < dim-1; i++)
+        {
+        pts[0] = (k*dim + j)*dim + i;
+        pts[1] = pts[0] + 1;
+        pts[2] = pts[0] + dim + 1;
+        pts[3] = pts[0] + dim;
+        pts[4] = pts[0] + dim*dim;
+        pts[5] = pts[1] + dim*dim;
+        pts[6] = pts[2] + dim*dim;
+        pts[7] = pts[3] + dim*dim;
+        if (!tets)
+          {
+          cellIds->InsertNextValue(
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, pts));
+          continue;
+          }
+        for (int t = 0; t < 6; t++)
+          {
+          for (int v = 0; v < 4; v++)
+            {
+            tetPts[v] = pts[kuhn[t][v]];
+            }
+          cellIds->InsertNextValue(
+            grid->InsertNextCell(VTK_TETRA, 4, tetPts));
+          }
+        }
+      }
+    }
+  grid->GetCellData()->AddArray(cellIds);
+}
+
+// Abort the filter as soon as it reports some progress.
+class vtkAbortOnProgress : public vtkCommand
+{
+public:
+  static vtkAbortOnProgress *New() { return new vtkAbortOnProgress; }
+  virtual void Execute(vtkObject *caller, unsigned long, void *callData)
+    {
+    if (*static_cast<double *>(callData) > 0.0)
+      {
+      static_cast<vtkAlgorithm *>(caller)->SetAbortExecute(1);
+      }
+    }
+};
+
+// Check that an aborted filter kept part of the cells, but not all.
+static int CheckAborted(vtkPointSet *serial, vtkPointSet *aborted,
+                        const char *label)
+{
+  if (aborted->GetNumberOfCells() == 0 ||
+      aborted->GetNumberOfCells() >= serial->GetNumberOfCells())
+    {
+    cerr << label << ": " << aborted->GetNumberOfCells()
+         << " cells after an abort, out of " << serial->GetNumberOfCells()
+         << endl;
+    return 1;
+    }
+  return 0;
+}
+
+// The threaded filters merge points in cell order, so the outputs must be
+// identical, not only equivalent.
+static int CompareDataSets(vtkPointSet *serial, vtkPointSet *threaded,
+                           const char *label)
+{
+  vtkIdType numPts = serial->GetNumberOfPoints();
+  vtkIdType numCells = serial->GetNumberOfCells();
+  if (numCells == 0)
+    {
+    cerr << label << ": the serial output is empty" << endl;
+    return 1;
+    }
+  if (threaded->GetNumberOfPoints() != numPts ||
+      threaded->GetNumberOfCells() != numCells)
+    {
+    cerr << label << ": " << threaded->GetNumberOfPoints() << " points and "
+         << threaded->GetNumberOfCells() << " cells instead of " << numPts
+         << " and " << numCells << endl;
+    return 1;
+    }
+  double x1[3], x2[3];
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+    serial->GetPoint(ptId, x1);
+    threaded->GetPoint(ptId, x2);
+    if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+      {
+      cerr << label << ": point " << ptId << " differs" << endl;
+      return 1;
+      }
+    }
+  vtkDataArray *ids1 = serial->GetCellData()->GetArray("CellIds");
+  vtkDataArray *ids2 = threaded->GetCellData()->GetArray("CellIds");
+  if (!ids1 || !ids2 || threaded->GetPointData()->GetNumberOfArrays() !=
+      serial->GetPointData()->GetNumberOfArrays())
+    {
+    cerr << label << ": attributes are missing" << endl;
+    return 1;
+    }
+  VTK_CREATE(vtkIdList, cell1);
+  VTK_CREATE(vtkIdList, cell2);
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    serial->GetCellPoints(cellId, cell1);
+    threaded->GetCellPoints(cellId, cell2);
+    int same = (serial->GetCellType(cellId) == threaded->GetCellType(cellId) &&
+                cell1->GetNumberOfIds() == cell2->GetNumberOfIds() &&
+                ids1->GetTuple1(cellId) == ids2->GetTuple1(cellId));
+    for (vtkIdType i = 0; same && i < cell1->GetNumberOfIds(); i++)
+      {
+      same = (cell1->GetId(i) == cell2->GetId(i));
+      }
+    if (!same)
+      {
+      cerr << label << ": cell " << cellId << " differs" << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestCutterClipThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  VTK_CREATE(vtkUnstructuredGrid, hexes);
+  BuildGrid(hexes, 33, 0);
+  VTK_CREATE(vtkUnstructuredGrid, tets);
+  BuildGrid(tets, 21, 1);
+
+  VTK_CREATE(vtkPlane, plane);
+  plane->SetOrigin(16.0, 16.0, 16.0);
+  plane->SetNormal(0.3, 0.5, 1.0);
+
+  VTK_CREATE(vtkSphere, sphere);
+  sphere->SetCenter(8.0, 10.0, 12.0);
+  sphere->SetRadius(14.0);
+
+  int errors = 0;
+  VTK_CREATE(vtkCutter, serialCutter);
+  serialCutter->SetInput(hexes);
+  serialCutter->SetCutFunction(plane);
+  serialCutter->GenerateValues(3, -8.0, 8.0);
+  serialCutter->GenerateCutScalarsOn();
+  serialCutter->Update();
+
+  VTK_CREATE(vtkClipDataSet, serialClip);
+  serialClip->SetInput(tets);
+  serialClip->SetClipFunction(sphere);
+  serialClip->GenerateClippedOutputOn();
+  serialClip->Update();
+
+  VTK_CREATE(vtkClipDataSet, serialScalarClip);
+  serialScalarClip->SetInput(tets);
+  serialScalarClip->SetValue(500.0);
+  serialScalarClip->Update();
+
+  // Hexahedra are tetrahedralized differently by the threaded clip, but
+  // the result must not depend on the number of threads.
+  VTK_CREATE(vtkClipDataSet, serialHexClip);
+  serialHexClip->SetInput(hexes);
+  serialHexClip->SetClipFunction(sphere);
+  serialHexClip->Update();
+  vtkIdType hexClipPoints = -1, hexClipCells = -1;
+
+  for (int threads = 2; threads <= 8; threads *= 2)
+    {
+    VTK_CREATE(vtkCutter, cutter);
+    cutter->SetInput(hexes);
+    cutter->SetCutFunction(plane);
+    cutter->GenerateValues(3, -8.0, 8.0);
+    cutter->GenerateCutScalarsOn();
+    cutter->SetNumberOfThreads(threads);
+    cutter->Update();
+    errors += CompareDataSets(serialCutter->GetOutput(), cutter->GetOutput(),
+                              "vtkCutter");
+
+    VTK_CREATE(vtkClipDataSet, clip);
+    clip->SetInput(tets);
+    clip->SetClipFunction(sphere);
+    clip->GenerateClippedOutputOn();
+    clip->SetNumberOfThreads(threads);
+    clip->Update();
+    errors += CompareDataSets(serialClip->GetOutput(), clip->GetOutput(),
+                              "vtkClipDataSet");
+    errors += CompareDataSets(serialClip->GetClippedOutput(),
+                              clip->GetClippedOutput(),
+                              "vtkClipDataSet clipped output");
+
+    VTK_CREATE(vtkClipDataSet, scalarClip);
+    scalarClip->SetInput(tets);
+    scalarClip->SetValue(500.0);
+    scalarClip->SetNumberOfThreads(threads);
+    scalarClip->Update();
+    errors += CompareDataSets(serialScalarClip->GetOutput(),
+                              scalarClip->GetOutput(),
+                              "vtkClipDataSet with scalars");
+
+    VTK_CREATE(vtkClipDataSet, hexClip);
+    hexClip->SetInput(hexes);
+    hexClip->SetClipFunction(sphere);
+    hexClip->SetNumberOfThreads(threads);
+    hexClip->Update();
+    vtkUnstructuredGrid *hexOutput = hexClip->GetOutput();
+    if (hexClipPoints < 0)
+      {
+      hexClipPoints = hexOutput->GetNumberOfPoints();
+      hexClipCells = hexOutput->GetNumberOfCells();
+      }
+    double b1[6], b2[6];
+    serialHexClip->GetOutput()->GetBounds(b1);
+    hexOutput->GetBounds(b2);
+    if (hexOutput->GetNumberOfPoints() != hexClipPoints ||
+        hexOutput->GetNumberOfCells() != hexClipCells ||
+        b1[0] != b2[0] || b1[1] != b2[1] || b1[2] != b2[2] ||
+        b1[3] != b2[3] || b1[4] != b2[4] || b1[5] != b2[5])
+      {
+      cerr << "vtkClipDataSet with hexahedra on " << threads
+           << " threads: " << hexOutput->GetNumberOfPoints()
+           << " points and " << hexOutput->GetNumberOfCells()
+           << " cells" << endl;
+      errors++;
+      }
+    }
+
+  // The chunks are processed in groups, and the filters stop between
+  // groups when they are aborted.
+  VTK_CREATE(vtkAbortOnProgress, abort);
+  VTK_CREATE(vtkCutter, abortedCutter);
+  abortedCutter->SetInput(hexes);
+  abortedCutter->SetCutFunction(plane);
+  abortedCutter->GenerateValues(3, -8.0, 8.0);
+  abortedCutter->SetNumberOfThreads(4);
+  abortedCutter->AddObserver(vtkCommand::ProgressEvent, abort);
+  abortedCutter->Update();
+  errors += CheckAborted(serialCutter->GetOutput(),
+                         abortedCutter->GetOutput(), "vtkCutter");
+
+  VTK_CREATE(vtkClipDataSet, abortedClip);
+  abortedClip->SetInput(tets);
+  abortedClip->SetClipFunction(sphere);
+  abortedClip->SetNumberOfThreads(4);
+  abortedClip->AddObserver(vtkCommand::ProgressEvent, abort);
+  abortedClip->Update();
+  errors += CheckAborted(serialClip->GetOutput(), abortedClip->GetOutput(),
+                         "vtkClipDataSet");
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that generating glyphs on several threads gives the same output as
+// the serial algorithm, that the glyph instances transform the source into
+// the glyphs, and that the instances copy non-numeric arrays.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStringArray.h"
+#include "vtkThreadPool.h"
+#include "vtkTransform.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare two arrays tuple by tuple.
+static int CompareArrays(vtkDataArray *serial, vtkDataArray *threaded)
+{
+  if (!threaded ||
+      serial->GetNumberOfTuples() != threaded->GetNumberOfTuples() ||
+      serial->GetNumberOfComponents() != threaded->GetNumberOfComponents())
+    {
+    cerr << "Array " << serial->GetName() << " is missing." << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < serial->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < serial->GetNumberOfComponents(); j++)
+      {
+      if (serial->GetComponent(i, j) != threaded->GetComponent(i, j))
+        {
+        cerr << "Array " << serial->GetName() << " differs at " << i << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+// Compare the outputs of the serial and threaded filters.
+static int CompareOutputs(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  vtkIdType numCells = serial->GetNumberOfCells();
+  if (numCells == 0 || threaded->GetNumberOfCells() != numCells)
+    {
+    cerr << threaded->GetNumberOfCells() << " cells instead of "
+         << numCells << endl;
+    return 0;
+    }
+  if (!CompareArrays(serial->GetPoints()->GetData(),
+                     threaded->GetPoints()->GetData()))
+    {
+    return 0;
+    }
+  VTK_CREATE(vtkIdList, cell1);
+  VTK_CREATE(vtkIdList, cell2);
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    serial->GetCellPoints(cellId, cell1);
+    threaded->GetCellPoints(cellId, cell2);
+    int same = (serial->GetCellType(cellId) == threaded->GetCellType(cellId) &&
+                cell1->GetNumberOfIds() == cell2->GetNumberOfIds());
+    for (vtkIdType i = 0; same && i < cell1->GetNumberOfIds(); i++)
+      {
+      same = (cell1->GetId(i) == cell2->GetId(i));
+      }
+    if (!same)
+      {
+      cerr << "Cell " << cellId << " differs." << endl;
+      return 0;
+      }
+    }
+  int i;
+  vtkPointData *pd = serial->GetPointData();
+  for (i = 0; i < pd->GetNumberOfArrays(); i++)
+    {
+    if (pd->GetArray(i) &&
+        !CompareArrays(pd->GetArray(i), threaded->GetPointData()->GetArray(
+                         pd->GetArrayName(i))))
+      {
+      return 0;
+      }
+    }
+  vtkCellData *cd = serial->GetCellData();
+  for (i = 0; i < cd->GetNumberOfArrays(); i++)
+    {
+    if (cd->GetArray(i) &&
+        !CompareArrays(cd->GetArray(i), threaded->GetCellData()->GetArray(
+                         cd->GetArrayName(i))))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Check that the transformations of the instances, which include the
+// source transform, map the source points to the points of the glyphs.
+static int CheckInstances(vtkPolyData *instances, vtkPolyData *glyphs,
+                          vtkPolyData *source)
+{
+  vtkIdType numSourcePts = source->GetNumberOfPoints();
+  vtkIdType numInstances = instances->GetNumberOfPoints();
+  vtkDataArray *transforms =
+    instances->GetPointData()->GetArray("GlyphTransform");
+  if (!transforms || instances->GetNumberOfCells() != 0 ||
+      numInstances*numSourcePts != glyphs->GetNumberOfPoints() ||
+      !instances->GetPointData()->GetArray("GlyphScaleFactors") ||
+      !instances->GetPointData()->GetVectors())
+    {
+    cerr << "Wrong instances." << endl;
+    return 0;
+    }
+  double m[16], x[3], y[3], z[3];
+  for (vtkIdType i = 0; i < numInstances; i++)
+    {
+    transforms->GetTuple(i, m);
+    for (vtkIdType j = 0; j < numSourcePts; j++)
+      {
+      source->GetPoint(j, x);
+      for (int k = 0; k < 3; k++)
+        {
+        y[k] = m[4*k]*x[0] + m[4*k+1]*x[1] + m[4*k+2]*x[2] + m[4*k+3];
+        }
+      glyphs->GetPoint(i*numSourcePts + j, z);
+      if (sqrt(vtkMath::Distance2BetweenPoints(y, z)) > 1.0e-4)
+        {
+        cerr << "Instance " << i << " does not transform point " << j
+             << " into its glyph." << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+int TestGlyph3DThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  // Random points with scalars, vectors, an array of ids, and an array of
+  // labels for the instances.
+  vtkMath::RandomSeed(4321);
+  VTK_CREATE(vtkPolyData, input);
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("Speed");
+  VTK_CREATE(vtkFloatArray, vectors);
+  vectors->SetNumberOfComponents(3);
+  vectors->SetName("Velocity");
+  VTK_CREATE(vtkIntArray, ids);
+  ids->SetName("Ids");
+  VTK_CREATE(vtkStringArray, labels);
+  labels->SetName("Labels");
+  for (int i = 0; i < 5000; i++)
+    {
+    points->InsertNextPoint(vtkMath::Random(0.0, 10.0),
+                            vtkMath::Random(0.0, 10.0),
+                            vtkMath::Random(0.0, 10.0));
+    scalars->InsertNextValue(static_cast<float>(vtkMath::Random()));
+    vectors->InsertNextTuple3(vtkMath::Random(-1.0, 1.0),
+                              vtkMath::Random(-1.0, 1.0),
+                              i % 10 ? vtkMath::Random(-1.0, 1.0) : 0.0);
+    ids->InsertNextValue(i);
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->AddArray(ids);
+
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(8);
+  sphere->SetPhiResolution(6);
+  sphere->Update();
+  VTK_CREATE(vtkTransform, sourceTransform);
+  sourceTransform->Translate(0.5, 0.0, 0.0);
+  sourceTransform->Scale(2.0, 0.5, 0.5);
+
+  for (int mode = 0; mode < 3; mode++)
+    {
+    VTK_CREATE(vtkGlyph3D, serial);
+    VTK_CREATE(vtkGlyph3D, threaded);
+    vtkGlyph3D *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; f++)
+      {
+      filters[f]->SetInput(input);
+      filters[f]->SetSource(sphere->GetOutput());
+      filters[f]->SetScaleFactor(0.1);
+      if (mode == 0)
+        {
+        filters[f]->SetScaleModeToScaleByVector();
+        filters[f]->SetColorModeToColorByScale();
+        }
+      else if (mode == 1)
+        {
+        filters[f]->SetScaleModeToScaleByScalar();
+        filters[f]->SetColorModeToColorByScalar();
+        filters[f]->ClampingOn();
+        filters[f]->SetRange(0.2, 0.8);
+        filters[f]->FillCellDataOn();
+        filters[f]->GeneratePointIdsOn();
+        }
+      else
+        {
+        filters[f]->SetScaleModeToScaleByVectorComponents();
+        filters[f]->SetColorModeToColorByVector();
+        filters[f]->SetSourceTransform(sourceTransform);
+        }
+      }
+    threaded->SetNumberOfThreads(4);
+    serial->Update();
+    threaded->Update();
+    if (!CompareOutputs(serial->GetOutput(), threaded->GetOutput()))
+      {
+      cerr << "In mode " << mode << "." << endl;
+      return 1;
+      }
+
+    if (mode == 2)
+      {
+      threaded->GenerateInstancesOn();
+      threaded->Update();
+      if (!CheckInstances(threaded->GetOutput(), serial->GetOutput(),
+                          sphere->GetOutput()))
+        {
+        return 1;
+        }
+      }
+    }
+
+  // Index the glyphs by scalar into a table of two sources.  The instances
+  // are the glyphed points, with their labels.
+  input->GetPointData()->AddArray(labels);
+  VTK_CREATE(vtkSphereSource, sphere2);
+  sphere2->SetThetaResolution(4);
+  sphere2->SetPhiResolution(4);
+  sphere2->Update();
+  VTK_CREATE(vtkGlyph3D, instances);
+  instances->SetInput(input);
+  instances->SetSource(0, sphere->GetOutput());
+  instances->SetSource(1, sphere2->GetOutput());
+  instances->SetIndexModeToScalar();
+  instances->SetScaleFactor(0.1);
+  instances->SetNumberOfThreads(4);
+  instances->GenerateInstancesOn();
+  instances->Update();
+  vtkPointData *instancePD = instances->GetOutput()->GetPointData();
+  vtkStringArray *instanceLabels =
+    vtkStringArray::SafeDownCast(instancePD->GetAbstractArray("Labels"));
+  vtkDataArray *sourceIndices = instancePD->GetArray("GlyphSourceIndex");
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if (instances->GetOutput()->GetNumberOfPoints() != numPts ||
+      !instanceLabels || instanceLabels->GetNumberOfTuples() != numPts ||
+      !sourceIndices)
+    {
+    cerr << "Wrong instances of an indexed table." << endl;
+    return 1;
+    }
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+    {
+    if (sourceIndices->GetComponent(inPtId, 0) !=
+        (scalars->GetValue(inPtId) < 0.5 ? 0 : 1) ||
+        instanceLabels->GetValue(inPtId) != labels->GetValue(inPtId))
+      {
+      cerr << "Wrong instance " << inPtId << endl;
+      return 1;
+      }
+    }
+
+  return 0;
+}
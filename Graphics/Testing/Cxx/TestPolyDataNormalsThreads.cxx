@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that computing normals on several threads gives the same points,
+// polygons and normals as the serial algorithm, with and without
+// splitting of the feature edges, including for points that no polygon
+// uses.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkCylinderSource.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+#include "vtkThreadPool.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare two arrays of normals.
+static int CompareNormals(vtkDataArray *serial, vtkDataArray *threaded,
+                          const char *label)
+{
+  if (!serial || !threaded ||
+      serial->GetNumberOfTuples() != threaded->GetNumberOfTuples())
+    {
+    cerr << label << " are missing." << endl;
+    return 0;
+    }
+  double n1[3], n2[3];
+  for (vtkIdType i = 0; i < serial->GetNumberOfTuples(); i++)
+    {
+    serial->GetTuple(i, n1);
+    threaded->GetTuple(i, n2);
+    if (n1[0] != n2[0] || n1[1] != n2[1] || n1[2] != n2[2])
+      {
+      cerr << label << " " << i << " differs." << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Compare the outputs of the serial and threaded filters.
+static int CompareOutputs(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  vtkIdType numPts = serial->GetNumberOfPoints();
+  vtkIdType numCells = serial->GetNumberOfCells();
+  if (threaded->GetNumberOfPoints() != numPts ||
+      threaded->GetNumberOfCells() != numCells)
+    {
+    cerr << threaded->GetNumberOfPoints() << " points and "
+         << threaded->GetNumberOfCells() << " cells instead of " << numPts
+         << " and " << numCells << endl;
+    return 0;
+    }
+  double x1[3], x2[3];
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+    serial->GetPoint(ptId, x1);
+    threaded->GetPoint(ptId, x2);
+    if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+      {
+      cerr << "Point " << ptId << " differs." << endl;
+      return 0;
+      }
+    }
+  VTK_CREATE(vtkIdList, cell1);
+  VTK_CREATE(vtkIdList, cell2);
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    serial->GetCellPoints(cellId, cell1);
+    threaded->GetCellPoints(cellId, cell2);
+    int same = (cell1->GetNumberOfIds() == cell2->GetNumberOfIds());
+    for (vtkIdType i = 0; same && i < cell1->GetNumberOfIds(); i++)
+      {
+      same = (cell1->GetId(i) == cell2->GetId(i));
+      }
+    if (!same)
+      {
+      cerr << "Cell " << cellId << " differs." << endl;
+      return 0;
+      }
+    }
+  return CompareNormals(serial->GetPointData()->GetNormals(),
+                        threaded->GetPointData()->GetNormals(),
+                        "Point normals") &&
+    CompareNormals(serial->GetCellData()->GetNormals(),
+                   threaded->GetCellData()->GetNormals(), "Cell normals");
+}
+
+int TestPolyDataNormalsThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  // A smooth sphere made of triangle strips, and a cylinder whose caps
+  // share their points with its side on sharp edges.
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(100);
+  VTK_CREATE(vtkStripper, stripper);
+  stripper->SetInputConnection(sphere->GetOutputPort());
+  VTK_CREATE(vtkCylinderSource, cylinder);
+  cylinder->SetResolution(5000);
+  cylinder->SetCenter(2.0, 0.0, 0.0);
+  VTK_CREATE(vtkCleanPolyData, clean);
+  clean->SetInputConnection(cylinder->GetOutputPort());
+  VTK_CREATE(vtkAppendPolyData, append);
+  append->AddInputConnection(stripper->GetOutputPort());
+  append->AddInputConnection(clean->GetOutputPort());
+  append->Update();
+
+  // Points that no polygon uses get a zero normal.
+  VTK_CREATE(vtkPolyData, input);
+  input->DeepCopy(append->GetOutput());
+  input->GetPointData()->Initialize();
+  for (int i = 0; i < 3; i++)
+    {
+    input->GetPoints()->InsertNextPoint(-2.0, i, 0.0);
+    }
+
+  for (int i = 0; i < 4; i++)
+    {
+    int splitting = i % 2;
+    int flip = i / 2;
+
+    VTK_CREATE(vtkPolyDataNormals, serial);
+    serial->SetInput(input);
+    serial->ConsistencyOff();
+    serial->SetSplitting(splitting);
+    serial->SetFlipNormals(flip);
+    serial->ComputeCellNormalsOn();
+    serial->Update();
+
+    VTK_CREATE(vtkPolyDataNormals, threaded);
+    threaded->SetNumberOfThreads(4);
+    threaded->SetInput(input);
+    threaded->ConsistencyOff();
+    threaded->SetSplitting(splitting);
+    threaded->SetFlipNormals(flip);
+    threaded->ComputeCellNormalsOn();
+    threaded->Update();
+
+    if (splitting && serial->GetOutput()->GetNumberOfPoints() <=
+        input->GetNumberOfPoints())
+      {
+      cerr << "No point was split." << endl;
+      return 1;
+      }
+    if (!CompareOutputs(serial->GetOutput(), threaded->GetOutput()))
+      {
+      cerr << "With splitting " << splitting << " and flipping " << flip
+           << "." << endl;
+      return 1;
+      }
+    }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestProbeFilterThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check probing an unstructured grid on several threads.  The threaded
+// search starts from the cell of the previous point, so a point within the
+// tolerance of two cells may take its values from the other cell than in
+// the serial probe: values are compared with a tolerance, and must not
+// depend on the number of threads.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkCharArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkProbeFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadPool.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// A slightly distorted grid of dim^3 points split into tetrahedra, with a
+// point scalar and the cell ids as cell data.
+static void BuildSource(vtkUnstructuredGrid *grid, int dim)
+{
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("Field");
+  int i, j, k;
+  for (k = 0; k < dim; k++)
+    {
+    for (j = 0; j < dim; j++)
+      {
+      for (i = 0; i < dim; i++)
+        {
+        double x = i + 0.1*j, y = j + 0.05*k*k/dim, z = k;
+        points->InsertNextPoint(x, y, z);
+        scalars->InsertNextValue(static_cast<float>(sin(0.3*x)*y + z*z));
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+
+  VTK_CREATE(vtkIdTypeArray, cellIds);
+  cellIds->SetName("CellIds");
+  grid->Allocate((dim-1)*(dim-1)*(dim-1)*6);
+  static const int kuhn[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6},
+                                  {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+  vtkIdType pts[8], tetPts[4];
+  for (k = 0; k < dim-1; k++)
+    {
+    for (j = 0; j < dim-1; j++)
+      {
+      for (i = 0; i < dim-1; i++)
+        {
+        pts[0] = (k*dim + j)*dim + i;
+        pts[1] = pts[0] + 1;
+        pts[2] = pts[0] + dim + 1;
+        pts[3] = pts[0] + dim;
+        pts[4] = pts[0] + dim*dim;
+        pts[5] = pts[1] + dim*dim;
+        pts[6] = pts[2] + dim*dim;
+        pts[7] = pts[3] + dim*dim;
+        for (int t = 0; t < 6; t++)
+          {
+          for (int v = 0; v < 4; v++)
+            {
+            tetPts[v] = pts[kuhn[t][v]];
+            }
+          cellIds->InsertNextValue(
+            grid->InsertNextCell(VTK_TETRA, 4, tetPts));
+          }
+        }
+      }
+    }
+  grid->GetCellData()->AddArray(cellIds);
+}
+
+int TestProbeFilterThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  VTK_CREATE(vtkUnstructuredGrid, source);
+  BuildSource(source, 16);
+
+  // The probe grid sticks out of the source so that some points miss.
+  VTK_CREATE(vtkImageData, input);
+  input->SetDimensions(41, 37, 33);
+  input->SetOrigin(-0.713, -0.519, -0.377);
+  input->SetSpacing(0.4217, 0.4431, 0.4789);
+
+  VTK_CREATE(vtkProbeFilter, serial);
+  serial->SetInput(input);
+  serial->SetSource(source);
+  serial->Update();
+  vtkDataSet *expected = serial->GetOutput();
+  vtkIdType numValid = serial->GetValidPoints()->GetNumberOfTuples();
+  if (numValid == 0 || numValid == input->GetNumberOfPoints())
+    {
+    cerr << "The serial probe found " << numValid << " points" << endl;
+    return 1;
+    }
+
+  int errors = 0;
+  vtkSmartPointer<vtkDataSet> first;
+  for (int threads = 2; threads <= 8; threads *= 2)
+    {
+    VTK_CREATE(vtkProbeFilter, probe);
+    probe->SetInput(input);
+    probe->SetSource(source);
+    probe->SetNumberOfThreads(threads);
+    probe->Update();
+    vtkDataSet *output = probe->GetOutput();
+
+    vtkIdTypeArray *valid = probe->GetValidPoints();
+    if (valid->GetNumberOfTuples() != numValid)
+      {
+      cerr << threads << " threads: " << valid->GetNumberOfTuples()
+           << " valid points instead of " << numValid << endl;
+      errors++;
+      continue;
+      }
+    for (vtkIdType i = 0; i < numValid; i++)
+      {
+      if (valid->GetValue(i) != serial->GetValidPoints()->GetValue(i))
+        {
+        cerr << threads << " threads: valid point " << i << " differs"
+             << endl;
+        errors++;
+        break;
+        }
+      }
+    if (!first)
+      {
+      first.TakeReference(output->NewInstance());
+      first->DeepCopy(output);
+      }
+
+    // Name, reference and tolerance of the compared arrays.
+    const char *names[4] = { "Field", "vtkValidPointMask", "Field",
+                             "CellIds" };
+    vtkDataSet *references[4] = { expected, expected, first, first };
+    double tolerances[4] = { 1e-3, 0.0, 0.0, 0.0 };
+    for (int a = 0; a < 4; a++)
+      {
+      vtkDataArray *a1 = references[a]->GetPointData()->GetArray(names[a]);
+      vtkDataArray *a2 = output->GetPointData()->GetArray(names[a]);
+      if (!a1 || !a2 || a1->GetNumberOfTuples() != a2->GetNumberOfTuples())
+        {
+        cerr << threads << " threads: array " << names[a]
+             << " is missing or has the wrong size" << endl;
+        errors++;
+        continue;
+        }
+      for (vtkIdType ptId = 0; ptId < a1->GetNumberOfTuples(); ptId++)
+        {
+        double v1 = a1->GetTuple1(ptId);
+        double v2 = a2->GetTuple1(ptId);
+        if (fabs(v1 - v2) > tolerances[a]*(1.0 + fabs(v1)))
+          {
+          cerr << threads << " threads: " << names[a] << " differs at point "
+               << ptId << ": " << v2 << " instead of " << v1 << endl;
+          errors++;
+          break;
+          }
+        }
+      }
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
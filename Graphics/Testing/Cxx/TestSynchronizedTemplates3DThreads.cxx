@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSynchronizedTemplates3DThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that contouring a volume in z-slabs on several threads gives the
+// same surface as the serial algorithm, also for integer data where many
+// samples equal the contour value.
+
+#include "vtkContourFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkMath.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkSynchronizedTemplates3D.h"
+#include "vtkThreadPool.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int CompareOutputs(vtkPolyData *serial, vtkPolyData *threaded,
+                          const char *label)
+{
+  int errors = 0;
+  if (serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+    {
+    cerr << label << ": " << threaded->GetNumberOfPoints()
+         << " points instead of " << serial->GetNumberOfPoints() << endl;
+    errors++;
+    }
+  if (serial->GetNumberOfCells() != threaded->GetNumberOfCells())
+    {
+    cerr << label << ": " << threaded->GetNumberOfCells()
+         << " cells instead of " << serial->GetNumberOfCells() << endl;
+    errors++;
+    }
+  double b1[6], b2[6];
+  serial->GetBounds(b1);
+  threaded->GetBounds(b2);
+  for (int i = 0; i < 6; i++)
+    {
+    if (fabs(b1[i] - b2[i]) > 1e-6)
+      {
+      cerr << label << ": bounds differ" << endl;
+      errors++;
+      break;
+      }
+    }
+  if (!threaded->GetPointData()->GetNormals() ||
+      !threaded->GetPointData()->GetScalars())
+    {
+    cerr << label << ": normals or scalars are missing" << endl;
+    errors++;
+    }
+  return errors;
+}
+
+int TestSynchronizedTemplates3DThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+
+  // Two overlapping blobs, so that the surface crosses many slabs.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(41, 37, 53);
+  image->SetSpacing(0.5, 0.5, 0.5);
+  VTK_CREATE(vtkFloatArray, scalars);
+  scalars->SetName("Blobs");
+  scalars->SetNumberOfTuples(41*37*53);
+  vtkIdType id = 0;
+  for (int k = 0; k < 53; k++)
+    {
+    for (int j = 0; j < 37; j++)
+      {
+      for (int i = 0; i < 41; i++)
+        {
+        double d1 = (i-15)*(i-15) + (j-18)*(j-18) + (k-20)*(k-20);
+        double d2 = (i-25)*(i-25) + (j-18)*(j-18) + (k-32)*(k-32);
+        scalars->SetValue(id++, 1.0/(1.0 + d1) + 1.0/(1.0 + d2));
+        }
+      }
+    }
+  image->GetPointData()->SetScalars(scalars);
+
+  int errors = 0;
+  VTK_CREATE(vtkSynchronizedTemplates3D, serial);
+  serial->SetInput(image);
+  serial->SetValue(0, 0.01);
+  serial->SetValue(1, 0.05);
+  serial->Update();
+
+  for (int threads = 2; threads <= 8; threads *= 2)
+    {
+    VTK_CREATE(vtkSynchronizedTemplates3D, threaded);
+    threaded->SetInput(image);
+    threaded->SetValue(0, 0.01);
+    threaded->SetValue(1, 0.05);
+    threaded->SetNumberOfThreads(threads);
+    threaded->Update();
+    errors += CompareOutputs(serial->GetOutput(), threaded->GetOutput(),
+                             "vtkSynchronizedTemplates3D");
+    }
+
+  // Random integers in [0,2] contoured at 1: the samples on the planes
+  // shared by the slabs are often on the surface.
+  VTK_CREATE(vtkImageData, levels);
+  levels->SetDimensions(23, 19, 31);
+  VTK_CREATE(vtkShortArray, levelScalars);
+  levelScalars->SetName("Levels");
+  levelScalars->SetNumberOfTuples(23*19*31);
+  vtkMath::RandomSeed(8765);
+  for (id = 0; id < 23*19*31; id++)
+    {
+    levelScalars->SetValue(
+      id, static_cast<short>(floor(vtkMath::Random(0.0, 2.999))));
+    }
+  levels->GetPointData()->SetScalars(levelScalars);
+
+  VTK_CREATE(vtkSynchronizedTemplates3D, serialLevels);
+  serialLevels->SetInput(levels);
+  serialLevels->SetValue(0, 1.0);
+  serialLevels->Update();
+  for (int threads = 2; threads <= 8; threads *= 2)
+    {
+    VTK_CREATE(vtkSynchronizedTemplates3D, threaded);
+    threaded->SetInput(levels);
+    threaded->SetValue(0, 1.0);
+    threaded->SetNumberOfThreads(threads);
+    threaded->Update();
+    errors += CompareOutputs(serialLevels->GetOutput(), threaded->GetOutput(),
+                             "integer levels");
+    }
+
+  // The contour filter forwards its thread count.
+  VTK_CREATE(vtkContourFilter, contour);
+  contour->SetInput(image);
+  contour->SetValue(0, 0.01);
+  contour->SetValue(1, 0.05);
+  contour->SetNumberOfThreads(3);
+  contour->Update();
+  errors += CompareOutputs(serial->GetOutput(), contour->GetOutput(),
+                           "vtkContourFilter");
+
+  return (errors == 0) ? 0 : 1;
+}
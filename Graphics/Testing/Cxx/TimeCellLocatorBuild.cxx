@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeCellLocatorBuild.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Time the build of cell locators on a large sphere with an increasing
+// number of threads.  Usage: TimeCellLocatorBuild [resolution]
+
+#include "vtkCellLocator.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkOBBTree.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreadPool.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+
+// Return the best of a few build times of the locator, in seconds.
+static double TimeBuild(vtkAbstractCellLocator *locator, vtkPolyData *input)
+{
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  double best = VTK_DOUBLE_MAX;
+  for (int run = 0; run < 3; run++)
+    {
+    locator->SetDataSet(input);
+    locator->Modified();
+    timer->StartTimer();
+    locator->BuildLocator();
+    timer->StopTimer();
+    if (timer->GetElapsedTime() < best)
+      {
+      best = timer->GetElapsedTime();
+      }
+    }
+  return best;
+}
+
+int main( int argc, char *argv[] )
+{
+  int res = (argc > 1 ? atoi(argv[1]) : 1000);
+  if (res < 8)
+    {
+    cerr << "Usage: " << argv[0] << " [resolution]\n";
+    return 1;
+    }
+
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(res);
+  sphere->SetPhiResolution(res);
+  sphere->Update();
+  vtkPolyData *input = sphere->GetOutput();
+  cout << input->GetNumberOfCells() << " cells\n";
+
+  int maxThreads = vtkThreadPool::GetGlobalPool()->GetNumberOfThreads();
+  double serial[3] = { 0.0, 0.0, 0.0 };
+  for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+    vtkSmartPointer<vtkCellLocator> cellLocator =
+      vtkSmartPointer<vtkCellLocator>::New();
+    cellLocator->CacheCellBoundsOn();
+    vtkSmartPointer<vtkModifiedBSPTree> bspTree =
+      vtkSmartPointer<vtkModifiedBSPTree>::New();
+    bspTree->LazyEvaluationOff();
+    vtkSmartPointer<vtkOBBTree> obbTree =
+      vtkSmartPointer<vtkOBBTree>::New();
+    vtkAbstractCellLocator *locators[3] = { cellLocator, bspTree, obbTree };
+
+    cout << threads << " threads:";
+    for (int i = 0; i < 3; i++)
+      {
+      locators[i]->SetNumberOfThreads(threads);
+      double t = TimeBuild(locators[i], input);
+      if (threads == 1)
+        {
+        serial[i] = t;
+        }
+      cout << "  " << locators[i]->GetClassName() << " " << t << " s";
+      if (threads > 1 && t > 0.0)
+        {
+        cout << " (x" << serial[i]/t << ")";
+        }
+      }
+    cout << "\n";
+    }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeDataArrayAllocators.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Time a pipeline that creates many small arrays with each global data
+// array allocator.  The pipeline is run repeatedly on small spheres, then
+// a few times on a large one.  Usage: TimeDataArrayAllocators [runs]
+
+#include "vtkAlignedDataArrayAllocator.h"
+#include "vtkClipPolyData.h"
+#include "vtkElevationFilter.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkPooledDataArrayAllocator.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+#include "vtkTriangleFilter.h"
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Run the pipeline the given number of times on a sphere of the given
+// resolution and return the elapsed time in seconds.
+static double TimePipeline(int resolution, int runs)
+{
+  VTK_CREATE(vtkTimerLog, timer);
+  timer->StartTimer();
+  for (int run = 0; run < runs; run++)
+    {
+    VTK_CREATE(vtkSphereSource, sphere);
+    sphere->SetThetaResolution(resolution);
+    sphere->SetPhiResolution(resolution);
+    VTK_CREATE(vtkElevationFilter, elevation);
+    elevation->SetInputConnection(sphere->GetOutputPort());
+    elevation->SetLowPoint(0.0, 0.0, -0.5);
+    elevation->SetHighPoint(0.0, 0.0, 0.5);
+    VTK_CREATE(vtkClipPolyData, clip);
+    clip->SetInputConnection(elevation->GetOutputPort());
+    clip->SetValue(0.3 + 0.4*run/runs);
+    VTK_CREATE(vtkTriangleFilter, triangles);
+    triangles->SetInputConnection(clip->GetOutputPort());
+    VTK_CREATE(vtkPolyDataNormals, normals);
+    normals->SetInputConnection(triangles->GetOutputPort());
+    normals->Update();
+    }
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+
+int main(int argc, char *argv[])
+{
+  int runs = (argc > 1 ? atoi(argv[1]) : 2000);
+  if (runs < 1)
+    {
+    cerr << "Usage: " << argv[0] << " [runs]\n";
+    return 1;
+    }
+
+  VTK_CREATE(vtkPooledDataArrayAllocator, pooled);
+  VTK_CREATE(vtkAlignedDataArrayAllocator, aligned);
+  VTK_CREATE(vtkAlignedDataArrayAllocator, hugePages);
+  hugePages->UseHugePagesOn();
+  vtkDataArrayAllocator *allocators[4] = { 0, pooled, aligned, hugePages };
+  const char *names[4] = { "malloc", "pooled", "aligned", "huge pages" };
+
+  double reference[2] = { 0.0, 0.0 };
+  for (int a = 0; a < 4; a++)
+    {
+    vtkDataArrayAllocator::SetGlobalAllocator(allocators[a]);
+    double small = TimePipeline(16, runs);
+    double large = TimePipeline(1000, 3);
+    if (a == 0)
+      {
+      reference[0] = small;
+      reference[1] = large;
+      }
+    cout << names[a] << ": " << runs << " small pipelines " << small
+         << " s (x" << reference[0]/small << "), 3 large pipelines "
+         << large << " s (x" << reference[1]/large << ")\n";
+    }
+  vtkDataArrayAllocator::SetGlobalAllocator(0);
+  cout << "Pool reused " << pooled->GetNumberOfReusedBlocks()
+       << " blocks\n";
+
+  return 0;
+}
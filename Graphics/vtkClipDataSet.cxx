@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkClipVolume.h"
+#include "vtkCutter.h"
 #include "vtkExecutive.h"
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
@@ -32,6 +33,7 @@
 #include "vtkPointData.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -39,6 +41,8 @@
 #include "vtkPolyhedron.h"
 
 #include <math.h>
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkClipDataSet);
 vtkCxxSetObjectMacro(vtkClipDataSet,ClipFunction,vtkImplicitFunction);
@@ -57,6 +61,7 @@ vtkClipDataSet::vtkClipDataSet(vtkImplicitFunction *cf)
 
   this->GenerateClippedOutput = 0;
   this->MergeTolerance = 0.01;
+  this->NumberOfThreads = 1;
 
   this->SetNumberOfOutputPorts(2);
   vtkUnstructuredGrid *output2 = vtkUnstructuredGrid::New();
@@ -143,6 +148,283 @@ vtkUnstructuredGrid *vtkClipDataSet::GetClippedOutput()
     this->GetExecutive()->GetOutputData(1));
 }
 
+//----------------------------------------------------------------------------
+// Type of a cell generated by clipping a cell of the given dimension.
+static int vtkClipDataSetOutputCellType(int dimension, vtkIdType npts)
+{
+  switch ( dimension )
+    {
+    case 0: //points are generated--------------------------------
+      return (npts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX);
+
+    case 1: //lines are generated---------------------------------
+      return (npts > 2 ? VTK_POLY_LINE : VTK_LINE);
+
+    case 2: //polygons are generated------------------------------
+      return (npts == 3 ? VTK_TRIANGLE :
+              (npts == 4 ? VTK_QUAD : VTK_POLYGON));
+
+    case 3: //tetrahedra or wedges are generated------------------
+      return (npts == 4 ? VTK_TETRA : VTK_WEDGE);
+    } //switch
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// A contiguous range of cells that is clipped on its own, with its own
+// locator and output arrays.  Index 1 of the arrays holds the clipped
+// away part when it is requested.
+struct vtkClipDataSetChunk
+{
+  vtkIdType BeginCell;
+  vtkIdType EndCell;
+  vtkIncrementalPointLocator *Locator;
+  vtkPoints *Points;
+  vtkPointData *PointData;
+  vtkCellArray *Connectivity[2];
+  vtkUnsignedCharArray *Types[2];
+  vtkCellData *CellData[2];
+};
+
+struct vtkClipDataSetThreadStruct
+{
+  vtkUnstructuredGrid *Grid;
+  vtkDataArray *ClipScalars;
+  double Value;
+  int InsideOut;
+  int NumberOfOutputs;
+  double Bounds[6];
+  vtkPointData *InPD;
+  vtkCellData *InCD;
+  unsigned char *CellTypeDimensions;
+  vtkClipDataSetChunk *Chunks;
+};
+
+//----------------------------------------------------------------------------
+// vtkCell3D::Clip() tetrahedralizes a cell in the order of the output ids
+// of its points, so that neighbor cells agree on the faces they share.
+// Output ids are local to a chunk, and two chunks may order the same points
+// differently.  To keep the triangulation consistent across chunks, the
+// points of the cells that are clipped that way are inserted in the chunk
+// locator first, in input id order.  Only the points used by output cells
+// are kept when the chunks are merged.
+static void vtkClipDataSetSeedChunk(vtkClipDataSetThreadStruct *str,
+                                    vtkClipDataSetChunk *chunk,
+                                    double *tuple)
+{
+  vtkUnstructuredGrid *grid = str->Grid;
+  vtkstd::vector<vtkIdType> seeds;
+  vtkIdType npts, *pts, i;
+  for (vtkIdType cellId = chunk->BeginCell; cellId < chunk->EndCell;
+       cellId++)
+    {
+    int cellType = grid->GetCellType(cellId);
+    if (cellType == VTK_TETRA || cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+        str->CellTypeDimensions[cellType] != 3)
+      {
+      continue;
+      }
+    // A cell that lies completely outside of all requested outputs does
+    // not insert its points.
+    grid->GetCellPoints(cellId, npts, pts);
+    int inside = 0, outside = 0;
+    for (i = 0; i < npts; i++)
+      {
+      str->ClipScalars->GetTuple(pts[i], tuple);
+      if (static_cast<float>(tuple[0]) >= str->Value)
+        {
+        inside = 1;
+        }
+      else
+        {
+        outside = 1;
+        }
+      }
+    if ((str->InsideOut ? outside : inside) ||
+        (str->NumberOfOutputs > 1 && (str->InsideOut ? inside : outside)))
+      {
+      seeds.insert(seeds.end(), pts, pts + npts);
+      }
+    }
+
+  vtkstd::sort(seeds.begin(), seeds.end());
+  seeds.erase(vtkstd::unique(seeds.begin(), seeds.end()), seeds.end());
+  double x[3];
+  vtkIdType newId;
+  for (size_t k = 0; k < seeds.size(); k++)
+    {
+    grid->GetPoint(seeds[k], x);
+    if (chunk->Locator->InsertUniquePoint(x, newId))
+      {
+      chunk->PointData->CopyData(str->InPD, seeds[k], newId);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static void vtkClipDataSetClipChunks(vtkIdType begin, vtkIdType end, int,
+                                     void *arg)
+{
+  vtkClipDataSetThreadStruct *str =
+    static_cast<vtkClipDataSetThreadStruct *>(arg);
+  vtkGenericCell *cell = vtkGenericCell::New();
+  vtkFloatArray *cellScalars = vtkFloatArray::New();
+  cellScalars->Allocate(VTK_CELL_SIZE);
+  // GetComponent() goes through the array's tuple buffer, which is not
+  // safe to share between threads, so whole tuples are copied instead.
+  double *tuple = new double[str->ClipScalars->GetNumberOfComponents()];
+  vtkIdType npts, *pts, i, j, numNew;
+  int o;
+
+  for (vtkIdType c = begin; c < end; c++)
+    {
+    vtkClipDataSetChunk *chunk = str->Chunks + c;
+    chunk->Locator->InitPointInsertion(chunk->Points, str->Bounds);
+    vtkClipDataSetSeedChunk(str, chunk, tuple);
+    vtkIdType num[2] = { 0, 0 };
+    for (o = 0; o < str->NumberOfOutputs; o++)
+      {
+      chunk->Connectivity[o]->InitTraversal();
+      }
+
+    for (vtkIdType cellId = chunk->BeginCell; cellId < chunk->EndCell;
+         cellId++)
+      {
+      str->Grid->GetCell(cellId, cell);
+      vtkIdList *cellIds = cell->GetPointIds();
+      npts = cellIds->GetNumberOfIds();
+      for (i = 0; i < npts; i++)
+        {
+        str->ClipScalars->GetTuple(cellIds->GetId(i), tuple);
+        cellScalars->InsertTuple(i, tuple);
+        }
+
+      for (o = 0; o < str->NumberOfOutputs; o++)
+        {
+        cell->Clip(str->Value, cellScalars, chunk->Locator,
+                   chunk->Connectivity[o], str->InPD, chunk->PointData,
+                   str->InCD, cellId, chunk->CellData[o],
+                   (o == 0 ? str->InsideOut : !str->InsideOut));
+        numNew = chunk->Connectivity[o]->GetNumberOfCells() - num[o];
+        num[o] += numNew;
+        for (j = 0; j < numNew; j++)
+          {
+          chunk->Connectivity[o]->GetNextCell(npts, pts);
+          chunk->Types[o]->InsertNextValue(
+            vtkClipDataSetOutputCellType(cell->GetCellDimension(), npts));
+          }
+        }
+      }
+    chunk->Locator->Initialize();
+    }
+
+  delete [] tuple;
+  cell->Delete();
+  cellScalars->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Append the chunk outputs in chunk order.  Points go through locator so
+// that points generated by several chunks are merged as in the serial
+// algorithm.  Points that no output cell uses are dropped.
+static void vtkClipDataSetMergeChunks(vtkClipDataSetChunk *chunks,
+                                      int numChunks, int numOutputs,
+                                      vtkIncrementalPointLocator *locator,
+                                      vtkCellArray **conn,
+                                      vtkUnsignedCharArray **types,
+                                      vtkIdTypeArray **locs,
+                                      vtkPointData *outPD,
+                                      vtkCellData **outCD)
+{
+  vtkIdType numPts = 0;
+  int c, o;
+  for (c = 0; c < numChunks; c++)
+    {
+    numPts += chunks[c].Points->GetNumberOfPoints();
+    }
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(chunks[0].PointData, numPts > 0 ? numPts : 1);
+  for (o = 0; o < numOutputs; o++)
+    {
+    vtkIdType numCells = 0;
+    for (c = 0; c < numChunks; c++)
+      {
+      numCells += chunks[c].Connectivity[o]->GetNumberOfCells();
+      }
+    outCD[o]->CopyAllOn();
+    outCD[o]->CopyAllocate(chunks[0].CellData[o],
+                           numCells > 0 ? numCells : 1);
+    }
+
+  vtkIdType **maps = new vtkIdType *[numChunks];
+  vtkIdType ptId, newId, npts, *pts, i;
+  double x[3];
+  for (c = 0; c < numChunks; c++)
+    {
+    vtkIdType numChunkPts = chunks[c].Points->GetNumberOfPoints();
+    vtkIdType *map = new vtkIdType[numChunkPts > 0 ? numChunkPts : 1];
+    maps[c] = map;
+    for (ptId = 0; ptId < numChunkPts; ptId++)
+      {
+      map[ptId] = -1;
+      }
+    for (o = 0; o < numOutputs; o++)
+      {
+      vtkCellArray *cells = chunks[c].Connectivity[o];
+      for (cells->InitTraversal(); cells->GetNextCell(npts, pts); )
+        {
+        for (i = 0; i < npts; i++)
+          {
+          map[pts[i]] = 0;
+          }
+        }
+      }
+    for (ptId = 0; ptId < numChunkPts; ptId++)
+      {
+      if (map[ptId] < 0)
+        {
+        continue;
+        }
+      chunks[c].Points->GetPoint(ptId, x);
+      if (locator->InsertUniquePoint(x, newId))
+        {
+        outPD->CopyData(chunks[c].PointData, ptId, newId);
+        }
+      map[ptId] = newId;
+      }
+    }
+
+  vtkIdList *cellPts = vtkIdList::New();
+  vtkIdType cellId, newCellId;
+  for (o = 0; o < numOutputs; o++)
+    {
+    for (c = 0; c < numChunks; c++)
+      {
+      vtkCellArray *cells = chunks[c].Connectivity[o];
+      for (cellId = 0, cells->InitTraversal();
+           cells->GetNextCell(npts, pts); cellId++)
+        {
+        cellPts->SetNumberOfIds(npts);
+        for (i = 0; i < npts; i++)
+          {
+          cellPts->SetId(i, maps[c][pts[i]]);
+          }
+        newCellId = conn[o]->InsertNextCell(cellPts);
+        locs[o]->InsertNextValue(conn[o]->GetInsertLocation(npts));
+        types[o]->InsertNextValue(chunks[c].Types[o]->GetValue(cellId));
+        outCD[o]->CopyData(chunks[c].CellData[o], cellId, newCellId);
+        }
+      }
+    }
+  cellPts->Delete();
+
+  for (c = 0; c < numChunks; c++)
+    {
+    delete [] maps[c];
+    }
+  delete [] maps;
+}
+
 //----------------------------------------------------------------------------
 //
 // Clip through data generating surface.
@@ -351,110 +633,191 @@ int vtkClipDataSet::RequestData(
   //  {
   //  outPD->CopyScalarsOn();
   //  }
-  vtkDataSetAttributes* tempDSA = vtkDataSetAttributes::New();
-  tempDSA->InterpolateAllocate(inPD, 1, 2);
-  outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
-  tempDSA->Delete();
-  outCD[0] = output->GetCellData();
-  outCD[0]->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
-  if ( this->GenerateClippedOutput )
+
+  // Unstructured grids without polyhedra can be clipped in chunks of
+  // cells on several threads.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  int numChunks = 1;
+  if ( this->NumberOfThreads > 1 && grid && grid->GetFaces() == NULL )
     {
-    outCD[1] = clippedOutput->GetCellData();
-    outCD[1]->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+    numChunks = 4*this->NumberOfThreads;
+    if ( numChunks > numCells/1024 )
+      {
+      numChunks = static_cast<int>(numCells/1024);
+      }
     }
 
-  //Process all cells and clip each in turn
-  //
-  int abort=0;
-  vtkIdType updateTime = numCells/20 + 1;  // update roughly every 5%
-  vtkGenericCell *cell = vtkGenericCell::New();
-  int num[2]; num[0]=num[1]=0;
-  int numNew[2]; numNew[0]=numNew[1]=0;
-  for (vtkIdType cellId=0; cellId < numCells && !abort; cellId++)
+  if ( numChunks > 1 )
     {
-    if ( !(cellId % updateTime) )
+    vtkClipDataSetChunk *chunks = new vtkClipDataSetChunk[numChunks];
+    vtkIdType chunkSize = estimatedSize/numChunks + 1;
+    int c;
+    for (c = 0; c < numChunks; c++)
       {
-      this->UpdateProgress(static_cast<double>(cellId) / numCells);
-      abort = this->GetAbortExecute();
+      vtkClipDataSetChunk *chunk = chunks + c;
+      chunk->BeginCell = c*numCells/numChunks;
+      chunk->EndCell = (c+1)*numCells/numChunks;
+      chunk->Locator = this->Locator->NewInstance();
+      chunk->Locator->SetTolerance(this->Locator->GetTolerance());
+      chunk->Points = vtkPoints::New();
+      chunk->Points->Allocate(chunkSize,chunkSize/2);
+      chunk->PointData = vtkPointData::New();
+      chunk->PointData->InterpolateAllocate(inPD,chunkSize,chunkSize/2);
+      for ( j=0; j < numOutputs; j++ )
+        {
+        chunk->Connectivity[j] = vtkCellArray::New();
+        chunk->Connectivity[j]->Allocate(chunkSize,chunkSize/2);
+        chunk->Types[j] = vtkUnsignedCharArray::New();
+        chunk->Types[j]->Allocate(chunkSize,chunkSize/2);
+        chunk->CellData[j] = vtkCellData::New();
+        chunk->CellData[j]->CopyAllocate(inCD,chunkSize,chunkSize/2);
+        }
       }
 
-    input->GetCell(cellId,cell);
-    cellPts = cell->GetPoints();
-    cellIds = cell->GetPointIds();
-    npts = cellPts->GetNumberOfPoints();
-
-    // evaluate implicit cutting function
-    for ( i=0; i < npts; i++ )
+    vtkClipDataSetThreadStruct str;
+    str.Grid = grid;
+    str.ClipScalars = clipScalars;
+    str.Value = 0.0;
+    if (this->UseValueAsOffset || !this->ClipFunction)
+      {
+      str.Value = this->Value;
+      }
+    str.InsideOut = this->InsideOut;
+    str.NumberOfOutputs = numOutputs;
+    input->GetBounds(str.Bounds);
+    str.InPD = inPD;
+    str.InCD = inCD;
+    unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+    str.CellTypeDimensions = cellTypeDimensions;
+    str.Chunks = chunks;
+    // Chunks are processed in groups of one per thread to report progress
+    // and check for abort.  After an abort the output holds the chunks
+    // that were done, as the serial loop keeps the cells done so far.
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    int groupSize = pool->GetNumberOfThreads();
+    int numDone = 0;
+    while ( numDone < numChunks && !this->GetAbortExecute() )
       {
-      s = clipScalars->GetComponent(cellIds->GetId(i), 0);
-      cellScalars->InsertTuple(i, &s);
+      this->UpdateProgress(0.9*numDone/numChunks);
+      int lastChunk = numDone + groupSize;
+      lastChunk = (lastChunk < numChunks ? lastChunk : numChunks);
+      pool->ParallelFor(numDone, lastChunk, 1, vtkClipDataSetClipChunks, &str);
+      numDone = lastChunk;
       }
+    this->UpdateProgress(0.9);
 
-    double value = 0.0;
-    if (this->UseValueAsOffset || !this->ClipFunction)
+    outCD[0] = output->GetCellData();
+    if ( this->GenerateClippedOutput )
       {
-      value = this->Value;
+      outCD[1] = clippedOutput->GetCellData();
       }
+    vtkClipDataSetMergeChunks(chunks, numDone, numOutputs, this->Locator,
+                              conn, types, locs, outPD, outCD);
 
-    // perform the clipping
-    cell->Clip(value, cellScalars, this->Locator, conn[0],
-               inPD, outPD, inCD, cellId, outCD[0], this->InsideOut);
-    numNew[0] = conn[0]->GetNumberOfCells() - num[0];
-    num[0] = conn[0]->GetNumberOfCells();
- 
+    for (c = 0; c < numChunks; c++)
+      {
+      chunks[c].Locator->Delete();
+      chunks[c].Points->Delete();
+      chunks[c].PointData->Delete();
+      for ( j=0; j < numOutputs; j++ )
+        {
+        chunks[c].Connectivity[j]->Delete();
+        chunks[c].Types[j]->Delete();
+        chunks[c].CellData[j]->Delete();
+        }
+      }
+    delete [] chunks;
+    }
+  else
+    {
+    vtkDataSetAttributes* tempDSA = vtkDataSetAttributes::New();
+    tempDSA->InterpolateAllocate(inPD, 1, 2);
+    outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
+    tempDSA->Delete();
+    outCD[0] = output->GetCellData();
+    outCD[0]->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
     if ( this->GenerateClippedOutput )
       {
-      cell->Clip(value, cellScalars, this->Locator, conn[1],
-                 inPD, outPD, inCD, cellId, outCD[1], !this->InsideOut);
-      numNew[1] = conn[1]->GetNumberOfCells() - num[1];
-      num[1] = conn[1]->GetNumberOfCells();
+      outCD[1] = clippedOutput->GetCellData();
+      outCD[1]->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
       }
 
-    for (i=0; i<numOutputs; i++) //for both outputs
+    //Process all cells and clip each in turn
+    //
+    int abort=0;
+    vtkIdType updateTime = numCells/20 + 1;  // update roughly every 5%
+    vtkGenericCell *cell = vtkGenericCell::New();
+    int num[2]; num[0]=num[1]=0;
+    int numNew[2]; numNew[0]=numNew[1]=0;
+    for (vtkIdType cellId=0; cellId < numCells && !abort; cellId++)
       {
-      for (j=0; j < numNew[i]; j++) 
+      if ( !(cellId % updateTime) )
         {
-        if (cell->GetCellType() == VTK_POLYHEDRON)
-          {
-          //Polyhedron cells have a special cell connectivity format
-          //(nCell0Faces, nFace0Pts, i, j, k, nFace1Pts, i, j, k, ...).
-          //But we don't need to deal with it here. The special case is handled 
-          //by vtkUnstructuredGrid::SetCells(), which will be called next.
-          types[i]->InsertNextValue(VTK_POLYHEDRON);
-          }
-        else
-          {
-          locs[i]->InsertNextValue(conn[i]->GetTraversalLocation());
-          conn[i]->GetNextCell(npts,pts);
-          
-          //For each new cell added, got to set the type of the cell
-          switch ( cell->GetCellDimension() )
-            {
-            case 0: //points are generated--------------------------------
-              cellType = (npts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX);
-              break;
+        this->UpdateProgress(static_cast<double>(cellId) / numCells);
+        abort = this->GetAbortExecute();
+        }
+
+      input->GetCell(cellId,cell);
+      cellPts = cell->GetPoints();
+      cellIds = cell->GetPointIds();
+      npts = cellPts->GetNumberOfPoints();
 
-            case 1: //lines are generated---------------------------------
-              cellType = (npts > 2 ? VTK_POLY_LINE : VTK_LINE);
-              break;
+      // evaluate implicit cutting function
+      for ( i=0; i < npts; i++ )
+        {
+        s = clipScalars->GetComponent(cellIds->GetId(i), 0);
+        cellScalars->InsertTuple(i, &s);
+        }
 
-            case 2: //polygons are generated------------------------------
-              cellType = (npts == 3 ? VTK_TRIANGLE : 
-                          (npts == 4 ? VTK_QUAD : VTK_POLYGON));
-              break;
+      double value = 0.0;
+      if (this->UseValueAsOffset || !this->ClipFunction)
+        {
+        value = this->Value;
+        }
 
-            case 3: //tetrahedra or wedges are generated------------------
-              cellType = (npts == 4 ? VTK_TETRA : VTK_WEDGE);
-              break;
-            } //switch
+      // perform the clipping
+      cell->Clip(value, cellScalars, this->Locator, conn[0],
+                 inPD, outPD, inCD, cellId, outCD[0], this->InsideOut);
+      numNew[0] = conn[0]->GetNumberOfCells() - num[0];
+      num[0] = conn[0]->GetNumberOfCells();
+ 
+      if ( this->GenerateClippedOutput )
+        {
+        cell->Clip(value, cellScalars, this->Locator, conn[1],
+                   inPD, outPD, inCD, cellId, outCD[1], !this->InsideOut);
+        numNew[1] = conn[1]->GetNumberOfCells() - num[1];
+        num[1] = conn[1]->GetNumberOfCells();
+        }
 
-          types[i]->InsertNextValue(cellType);
-          }
-        } //for each new cell
-      } //for both outputs
-    } //for each cell
+      for (i=0; i<numOutputs; i++) //for both outputs
+        {
+        for (j=0; j < numNew[i]; j++) 
+          {
+          if (cell->GetCellType() == VTK_POLYHEDRON)
+            {
+            //Polyhedron cells have a special cell connectivity format
+            //(nCell0Faces, nFace0Pts, i, j, k, nFace1Pts, i, j, k, ...).
+            //But we don't need to deal with it here. The special case is handled 
+            //by vtkUnstructuredGrid::SetCells(), which will be called next.
+            types[i]->InsertNextValue(VTK_POLYHEDRON);
+            }
+          else
+            {
+            locs[i]->InsertNextValue(conn[i]->GetTraversalLocation());
+            conn[i]->GetNextCell(npts,pts);
+          
+            //For each new cell added, got to set the type of the cell
+            cellType = vtkClipDataSetOutputCellType(cell->GetCellDimension(),
+                                                    npts);
+            types[i]->InsertNextValue(cellType);
+            }
+          } //for each new cell
+        } //for both outputs
+      } //for each cell
 
-  cell->Delete();
+    cell->Delete();
+    }
   cellScalars->Delete();
 
   if ( this->ClipFunction ) 
@@ -686,6 +1049,8 @@ void vtkClipDataSet::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "UseValueAsOffset: " 
      << (this->UseValueAsOffset ? "On\n" : "Off\n");
+
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
 //-----------------------------------------------------------------------
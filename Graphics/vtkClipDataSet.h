@@ -44,6 +44,14 @@
 // This filter can be configured to compute a second output. The
 // second output is the part of the cell that is clipped away. Set the
 // GenerateClippedData boolean on if you wish to access this output data.
+//
+// Unstructured grids can be clipped on several threads (see
+// SetNumberOfThreads()).  The cells are then split into contiguous ranges
+// that are clipped concurrently on the vtkThreadPool, each with its own
+// point locator and output arrays, and the pieces are merged through the
+// locator of the filter.  3D cells other than tetrahedra are then
+// tetrahedralized following input point ids rather than output point ids,
+// so their pieces may be split differently than by the serial algorithm.
 
 // .SECTION Caveats
 // vtkClipDataSet will triangulate all types of 3D cells (i.e., create
@@ -131,6 +139,13 @@ public:
   // instance variable.
   vtkSetClampMacro(MergeTolerance,double,0.0001,0.25);
   vtkGetMacro(MergeTolerance,double);
+
+  // Description:
+  // Set/get the number of threads used to clip unstructured grids without
+  // polyhedral cells.  The clip function is still evaluated serially.
+  // Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
   
   // Description:
   // Return the Clipped output.
@@ -172,6 +187,7 @@ protected:
 
   int GenerateClippedOutput;
   double MergeTolerance;
+  int NumberOfThreads;
 
   // Callback registered with the InternalProgressObserver.
   static void InternalProgressCallbackFunction(vtkObject*, unsigned long,
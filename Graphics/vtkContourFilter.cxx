@@ -28,6 +28,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
@@ -61,6 +62,7 @@ vtkContourFilter::vtkContourFilter()
 
   this->UseScalarTree = 0;
   this->ScalarTree = NULL;
+  this->NumberOfThreads = 1;
 
   this->SynchronizedTemplates2D = vtkSynchronizedTemplates2D::New();
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
@@ -177,6 +179,7 @@ int vtkContourFilter::RequestUpdateExtent(vtkInformation* request,
       this->SynchronizedTemplates3D->SetComputeNormals(this->ComputeNormals);
       this->SynchronizedTemplates3D->SetComputeGradients(this->ComputeGradients);
       this->SynchronizedTemplates3D->SetComputeScalars(this->ComputeScalars);      
+      this->SynchronizedTemplates3D->SetNumberOfThreads(this->NumberOfThreads);
       return this->SynchronizedTemplates3D->
         ProcessRequest(request,inputVector,outputVector);
       }
@@ -296,6 +299,7 @@ int vtkContourFilter::RequestData(
       this->SynchronizedTemplates3D->SetComputeNormals(this->ComputeNormals);
       this->SynchronizedTemplates3D->SetComputeGradients(this->ComputeGradients);
       this->SynchronizedTemplates3D->SetComputeScalars(this->ComputeScalars);      
+      this->SynchronizedTemplates3D->SetNumberOfThreads(this->NumberOfThreads);
       this->SynchronizedTemplates3D->
         SetInputArrayToProcess(0,this->GetInputArrayInformation(0));
 
@@ -413,13 +417,13 @@ int vtkContourFilter::RequestData(
       estimatedSize = 1024;
       }
 
-    newPts = vtkPoints::New();
+    newPts = vtkOutputRecycler::NewPoints(output);
     newPts->Allocate(estimatedSize,estimatedSize);
-    newVerts = vtkCellArray::New();
+    newVerts = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::VERTS);
     newVerts->Allocate(estimatedSize,estimatedSize);
-    newLines = vtkCellArray::New();
+    newLines = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::LINES);
     newLines->Allocate(estimatedSize,estimatedSize);
-    newPolys = vtkCellArray::New();
+    newPolys = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::POLYS);
     newPolys->Allocate(estimatedSize,estimatedSize);
     cellScalars = inScalars->NewInstance();
     cellScalars->SetNumberOfComponents(inScalars->GetNumberOfComponents());
@@ -741,6 +745,7 @@ void vtkContourFilter::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Scalar Tree: (none)\n";
     }
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 
   if ( this->Locator )
     {
@@ -135,6 +135,13 @@ public:
   void SetArrayComponent( int );
   int  GetArrayComponent();
 
+  // Description:
+  // Set/get the number of threads used to contour. Currently this is only
+  // used if the input is a 3D vtkImageData, which is split into z-slabs
+  // by vtkSynchronizedTemplates3D. Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // see vtkAlgorithm for details
   virtual int ProcessRequest(vtkInformation*,
@@ -162,6 +169,7 @@ protected:
   vtkIncrementalPointLocator *Locator;
   int UseScalarTree;
   vtkScalarTree *ScalarTree;
+  int NumberOfThreads;
   
   vtkSynchronizedTemplates2D *SynchronizedTemplates2D;
   vtkSynchronizedTemplates3D *SynchronizedTemplates3D;
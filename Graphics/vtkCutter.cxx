@@ -28,6 +28,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -37,6 +38,7 @@
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkThreadPool.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
@@ -57,6 +59,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->CutFunction = cf;
   this->GenerateCutScalars = 0;
   this->Locator = NULL;
+  this->NumberOfThreads = 1;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -447,13 +450,13 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
     estimatedSize = 1024;
     }
 
-  newPoints = vtkPoints::New();
+  newPoints = vtkOutputRecycler::NewPoints(output);
   newPoints->Allocate(estimatedSize,estimatedSize/2);
-  newVerts = vtkCellArray::New();
+  newVerts = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::VERTS);
   newVerts->Allocate(estimatedSize,estimatedSize/2);
-  newLines = vtkCellArray::New();
+  newLines = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::LINES);
   newLines->Allocate(estimatedSize,estimatedSize/2);
-  newPolys = vtkCellArray::New();
+  newPolys = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::POLYS);
   newPolys->Allocate(estimatedSize,estimatedSize/2);
   cutScalars = vtkDoubleArray::New();
   cutScalars->SetNumberOfTuples(numPts);
@@ -644,6 +647,209 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+// A contiguous range of cells that is cut on its own, with its own locator
+// and output arrays.
+struct vtkCutterChunk
+{
+  vtkIdType BeginCell;
+  vtkIdType EndCell;
+  vtkIncrementalPointLocator *Locator;
+  vtkPoints *Points;
+  vtkCellArray *Verts;
+  vtkCellArray *Lines;
+  vtkCellArray *Polys;
+  vtkPointData *PointData;
+  vtkCellData *CellData;
+};
+
+struct vtkCutterThreadStruct
+{
+  vtkUnstructuredGrid *Grid;
+  double *CutScalars;
+  double Bounds[6];
+  vtkPointData *InPD;
+  vtkCellData *InCD;
+  vtkContourValues *ContourValues;
+  unsigned char *CellTypeDimensions;
+  vtkCutterChunk *Chunks;
+};
+
+//----------------------------------------------------------------------------
+// Cut the cells of a range of chunks.  Like the serial sort by value, each
+// chunk processes its cells in three passes of increasing dimension so
+// that the cell data of the chunk follows the verts, lines, polys order.
+static void vtkCutterCutChunks(vtkIdType begin, vtkIdType end, int,
+                               void *arg)
+{
+  vtkCutterThreadStruct *str = static_cast<vtkCutterThreadStruct *>(arg);
+  vtkUnstructuredGrid *grid = str->Grid;
+  double *scalars = str->CutScalars;
+  int numContours = str->ContourValues->GetNumberOfContours();
+  double *values = str->ContourValues->GetValues();
+  vtkGenericCell *cell = vtkGenericCell::New();
+  vtkDoubleArray *cellScalars = vtkDoubleArray::New();
+  cellScalars->Allocate(VTK_CELL_SIZE);
+  vtkIdType npts, *pts;
+  double range[2];
+  int dimensionality, cellType, iter, i;
+
+  for (vtkIdType c = begin; c < end; c++)
+    {
+    vtkCutterChunk *chunk = str->Chunks + c;
+    chunk->Locator->InitPointInsertion(chunk->Points, str->Bounds);
+    // We skip 0d cells (points), because they cannot be cut.
+    for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+      {
+      for (vtkIdType cellId = chunk->BeginCell; cellId < chunk->EndCell;
+           cellId++)
+        {
+        // Unknown cell types are skipped.
+        cellType = grid->GetCellType(cellId);
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+            str->CellTypeDimensions[cellType] != dimensionality)
+          {
+          continue;
+          }
+
+        grid->GetCellPoints(cellId, npts, pts);
+        range[0] = range[1] = scalars[pts[0]];
+        for (i = 1; i < npts; i++)
+          {
+          if (scalars[pts[i]] < range[0])
+            {
+            range[0] = scalars[pts[i]];
+            }
+          if (scalars[pts[i]] > range[1])
+            {
+            range[1] = scalars[pts[i]];
+            }
+          }
+
+        int needCell = 0;
+        for (iter = 0; iter < numContours; ++iter)
+          {
+          if (values[iter] >= range[0] && values[iter] <= range[1])
+            {
+            needCell = 1;
+            break;
+            }
+          }
+        if (!needCell)
+          {
+          continue;
+          }
+
+        // GetTuples() goes through the array's tuple buffer, which is not
+        // safe to share between threads, so the values are copied here.
+        cellScalars->SetNumberOfTuples(npts);
+        for (i = 0; i < npts; i++)
+          {
+          cellScalars->SetValue(i, scalars[pts[i]]);
+          }
+        grid->GetCell(cellId, cell);
+        for (iter = 0; iter < numContours; iter++)
+          {
+          cell->Contour(values[iter], cellScalars, chunk->Locator,
+                        chunk->Verts, chunk->Lines, chunk->Polys,
+                        str->InPD, chunk->PointData,
+                        str->InCD, cellId, chunk->CellData);
+          }
+        }
+      }
+    chunk->Locator->Initialize();
+    }
+
+  cell->Delete();
+  cellScalars->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Append the chunk outputs in chunk order.  Points go through locator so
+// that points generated by several chunks are merged as in the serial
+// algorithm.  Verts, lines and polys of all chunks are appended in this
+// order, which is also the order of the output cell data.
+static void vtkCutterMergeChunks(vtkCutterChunk *chunks, int numChunks,
+                                 vtkIncrementalPointLocator *locator,
+                                 vtkCellArray *newVerts,
+                                 vtkCellArray *newLines,
+                                 vtkCellArray *newPolys,
+                                 vtkPointData *outPD, vtkCellData *outCD)
+{
+  vtkIdType numPts = 0, numCells = 0;
+  int c;
+  for (c = 0; c < numChunks; c++)
+    {
+    numPts += chunks[c].Points->GetNumberOfPoints();
+    numCells += chunks[c].Verts->GetNumberOfCells() +
+      chunks[c].Lines->GetNumberOfCells() +
+      chunks[c].Polys->GetNumberOfCells();
+    }
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(chunks[0].PointData, numPts > 0 ? numPts : 1);
+  outCD->CopyAllOn();
+  outCD->CopyAllocate(chunks[0].CellData, numCells > 0 ? numCells : 1);
+
+  vtkIdType **maps = new vtkIdType *[numChunks];
+  vtkIdType ptId, newId;
+  double x[3];
+  for (c = 0; c < numChunks; c++)
+    {
+    vtkIdType numChunkPts = chunks[c].Points->GetNumberOfPoints();
+    maps[c] = new vtkIdType[numChunkPts > 0 ? numChunkPts : 1];
+    for (ptId = 0; ptId < numChunkPts; ptId++)
+      {
+      chunks[c].Points->GetPoint(ptId, x);
+      if (locator->InsertUniquePoint(x, newId))
+        {
+        outPD->CopyData(chunks[c].PointData, ptId, newId);
+        }
+      maps[c][ptId] = newId;
+      }
+    }
+
+  vtkIdList *cellPts = vtkIdList::New();
+  vtkIdType npts, *pts, cellId, offset;
+  vtkIdType outCellId = 0;
+  vtkCellArray *outCells[3] = { newVerts, newLines, newPolys };
+  for (int type = 0; type < 3; type++)
+    {
+    for (c = 0; c < numChunks; c++)
+      {
+      vtkCellArray *cells = (type == 0 ? chunks[c].Verts :
+                             (type == 1 ? chunks[c].Lines :
+                              chunks[c].Polys));
+      offset = 0;
+      if (type > 0)
+        {
+        offset += chunks[c].Verts->GetNumberOfCells();
+        }
+      if (type > 1)
+        {
+        offset += chunks[c].Lines->GetNumberOfCells();
+        }
+      for (cellId = 0, cells->InitTraversal();
+           cells->GetNextCell(npts, pts); cellId++)
+        {
+        cellPts->SetNumberOfIds(npts);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          cellPts->SetId(i, maps[c][pts[i]]);
+          }
+        outCells[type]->InsertNextCell(cellPts);
+        outCD->CopyData(chunks[c].CellData, offset + cellId, outCellId++);
+        }
+      }
+    }
+  cellPts->Delete();
+
+  for (c = 0; c < numChunks; c++)
+    {
+    delete [] maps[c];
+    }
+  delete [] maps;
+}
+
 //----------------------------------------------------------------------------
 void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 {
@@ -663,9 +869,23 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   vtkIdList *cellIds;
   int numContours = this->ContourValues->GetNumberOfContours();
   int abortExecute = 0;
+  vtkUnstructuredGrid *grid = static_cast<vtkUnstructuredGrid *>(input);
 
   double range[2];
 
+  // When sorting by value the cells can be cut in chunks on several
+  // threads.  Grids with polyhedra always take the serial path.
+  int numChunks = 1;
+  if ( this->NumberOfThreads > 1 && this->SortBy == VTK_SORT_BY_VALUE &&
+       grid->GetFaces() == NULL )
+    {
+    numChunks = 4*this->NumberOfThreads;
+    if ( numChunks > numCells/1024 )
+      {
+      numChunks = static_cast<int>(numCells/1024);
+      }
+    }
+
   // Create objects to hold output of contour operation
   //
   estimatedSize = static_cast<vtkIdType>(
@@ -676,13 +896,13 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
     estimatedSize = 1024;
     }
 
-  newPoints = vtkPoints::New();
+  newPoints = vtkOutputRecycler::NewPoints(output);
   newPoints->Allocate(estimatedSize,estimatedSize/2);
-  newVerts = vtkCellArray::New();
+  newVerts = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::VERTS);
   newVerts->Allocate(estimatedSize,estimatedSize/2);
-  newLines = vtkCellArray::New();
+  newLines = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::LINES);
   newLines->Allocate(estimatedSize,estimatedSize/2);
-  newPolys = vtkCellArray::New();
+  newPolys = vtkOutputRecycler::NewCellArray(output, vtkOutputRecycler::POLYS);
   newPolys->Allocate(estimatedSize,estimatedSize/2);
   cutScalars = vtkDoubleArray::New();
   cutScalars->SetNumberOfTuples(numPts);
@@ -699,8 +919,11 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
     inPD = input->GetPointData();
     }
   outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
-  outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+  if ( numChunks <= 1 )
+    {
+    outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
+    outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+    }
     
   // locator used to merge potentially duplicate points
   if ( this->Locator == NULL )
@@ -723,7 +946,6 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   vtkIdType progressInterval = numCuts/20 + 1;
   int cut=0;
 
-  vtkUnstructuredGrid *grid = static_cast<vtkUnstructuredGrid *>(input);
   vtkIdType *cellArrayPtr = grid->GetCells()->GetPointer();
   double *scalarArrayPtr = cutScalars->GetPointer(0);
   double tempScalar;
@@ -805,6 +1027,73 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
       } // for all contour values
     } // sort by cell
 
+  else if ( numChunks > 1 ) // SORT_BY_VALUE on several threads
+    {
+    vtkCutterChunk *chunks = new vtkCutterChunk[numChunks];
+    vtkIdType chunkSize = estimatedSize/numChunks + 1;
+    int c;
+    for (c = 0; c < numChunks; c++)
+      {
+      vtkCutterChunk *chunk = chunks + c;
+      chunk->BeginCell = c*numCells/numChunks;
+      chunk->EndCell = (c+1)*numCells/numChunks;
+      chunk->Locator = this->Locator->NewInstance();
+      chunk->Locator->SetTolerance(this->Locator->GetTolerance());
+      chunk->Points = vtkPoints::New();
+      chunk->Points->Allocate(chunkSize,chunkSize/2);
+      chunk->Verts = vtkCellArray::New();
+      chunk->Lines = vtkCellArray::New();
+      chunk->Polys = vtkCellArray::New();
+      chunk->Polys->Allocate(chunkSize,chunkSize/2);
+      chunk->PointData = vtkPointData::New();
+      chunk->PointData->InterpolateAllocate(inPD,chunkSize,chunkSize/2);
+      chunk->CellData = vtkCellData::New();
+      chunk->CellData->CopyAllocate(inCD,chunkSize,chunkSize/2);
+      }
+
+    unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+    vtkCutterThreadStruct str;
+    str.Grid = grid;
+    str.CutScalars = scalarArrayPtr;
+    input->GetBounds(str.Bounds);
+    str.InPD = inPD;
+    str.InCD = inCD;
+    str.ContourValues = this->ContourValues;
+    str.CellTypeDimensions = cellTypeDimensions;
+    str.Chunks = chunks;
+    // Chunks are processed in groups of one per thread to report progress
+    // and check for abort.  After an abort the output holds the chunks
+    // that were done, as the serial loop keeps the cells done so far.
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    int groupSize = pool->GetNumberOfThreads();
+    int numDone = 0;
+    while ( numDone < numChunks && !this->GetAbortExecute() )
+      {
+      this->UpdateProgress(0.9*numDone/numChunks);
+      int lastChunk = numDone + groupSize;
+      lastChunk = (lastChunk < numChunks ? lastChunk : numChunks);
+      pool->ParallelFor(numDone, lastChunk, 1, vtkCutterCutChunks, &str);
+      numDone = lastChunk;
+      }
+    this->UpdateProgress(0.9);
+
+    vtkCutterMergeChunks(chunks, numDone, this->Locator,
+                         newVerts, newLines, newPolys, outPD, outCD);
+
+    for (c = 0; c < numChunks; c++)
+      {
+      chunks[c].Locator->Delete();
+      chunks[c].Points->Delete();
+      chunks[c].Verts->Delete();
+      chunks[c].Lines->Delete();
+      chunks[c].Polys->Delete();
+      chunks[c].PointData->Delete();
+      chunks[c].CellData->Delete();
+      }
+    delete [] chunks;
+    } // sort by value on several threads
+
   else // SORT_BY_VALUE:
     {
     // Three passes over the cells to process lower dimensional cells first.
@@ -993,6 +1282,7 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Generate Cut Scalars: "
      << (this->GenerateCutScalars ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
 //-----------------------------------------------------------------------
@@ -35,6 +35,12 @@
 // with the dataset or 2) an implicit function associated with this class.
 // By default, if an implicit function is set it is used to clip the data
 // set, otherwise the dataset scalars are used to perform the clipping.
+//
+// Unstructured grids can be cut on several threads (see
+// SetNumberOfThreads()).  The cells are then split into contiguous ranges
+// that are cut concurrently on the vtkThreadPool, each with its own point
+// locator and output arrays, and the pieces are merged through the
+// locator of the filter.
 
 // .SECTION See Also
 // vtkImplicitFunction vtkClipPolyData
@@ -161,6 +167,14 @@ public:
     {this->SetSortBy(VTK_SORT_BY_CELL);}
   const char *GetSortByAsString();
 
+  // Description:
+  // Set/get the number of threads used to cut unstructured grids.  The
+  // threaded path is only taken when sorting by value and the grid has no
+  // polyhedral cells; the cut function is still evaluated serially.
+  // Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Create default locator. Used to create one when none is specified. The 
   // locator is used to merge coincident points.
@@ -203,6 +217,7 @@ protected:
   int SortBy;
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
+  int NumberOfThreads;
 private:
   vtkCutter(const vtkCutter&);  // Not implemented.
   void operator=(const vtkCutter&);  // Not implemented.
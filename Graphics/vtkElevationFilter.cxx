@@ -23,6 +23,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkSmartPointer.h"
+#include "vtkThreadedStreamingPipeline.h"
 
 vtkStandardNewMacro(vtkElevationFilter);
 
@@ -39,6 +40,10 @@ vtkElevationFilter::vtkElevationFilter()
 
   this->ScalarRange[0] = 0.0;
   this->ScalarRange[1] = 1.0;
+
+  // The input is only read with the thread safe vtkDataSet methods.
+  this->GetInformation()->Set(
+    vtkThreadedStreamingPipeline::CONCURRENT_INPUT_READS(), 1);
 }
 
 //----------------------------------------------------------------------------
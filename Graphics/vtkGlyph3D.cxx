@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSet.h"
@@ -23,17 +24,583 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 #include "vtkTransform.h"
 #include "vtkUnsignedCharArray.h"
 
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
+#define VTK_GLYPH_3D_BLOCK_SIZE 1024
+
+//----------------------------------------------------------------------------
+struct vtkGlyph3DThreadStruct
+{
+  vtkGlyph3D *Filter;
+  vtkDataSet *Input;
+  vtkDataArray *InSScalars;
+  vtkDataArray *InVectors;
+  vtkDataArray *InNormals;
+  vtkDataArray *InCScalars;
+  int HaveVectors;
+  double Den;
+  int NumberOfSources;
+  vtkIdType *GlyphIds;
+
+  // The source, with the source transform applied to its points, and the
+  // outputs of the glyphs.
+  double *SourcePoints;
+  vtkDataArray *SourceNormals;
+  vtkDataArray *SourceTCoords;
+  vtkIdType NumberOfSourcePoints;
+  vtkIdType NumberOfSourceCells;
+  vtkCellArray *SourceCells[4];
+  vtkIdType *Cells[4];
+  float *Points;
+  float *Normals;
+  vtkDataArray *Vectors;
+  vtkDataArray *TCoords;
+  vtkDataArray *Scalars;
+  vtkIdType *PointIds;
+
+  // The arrays of the input point data and the output arrays their tuples
+  // are copied to.  vtkDataSetAttributes::CopyData() iterates over the
+  // arrays with state kept in the attributes, so the threads copy the
+  // tuples of each pair of arrays instead.
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+  int NumberOfPointArrays;
+  vtkDataArray **FromPointArrays;
+  vtkDataArray **ToPointArrays;
+  int NumberOfCellArrays;
+  vtkDataArray **FromCellArrays;
+  vtkDataArray **ToCellArrays;
+
+  // The outputs of the instances.
+  double SourceMatrix[16];
+  float *Transforms;
+  float *ScaleFactors;
+  int *SourceIndices;
+};
+
+//----------------------------------------------------------------------------
+class vtkGlyph3DThreads
+{
+public:
+  static void Initialize(vtkGlyph3DThreadStruct *str, vtkGlyph3D *self,
+                         vtkDataSet *input, vtkDataArray *inSScalars,
+                         vtkDataArray *inVectors, vtkDataArray *inNormals,
+                         vtkDataArray *inCScalars);
+  static void Free(vtkGlyph3DThreadStruct *str);
+  static int MatchArrays(vtkPointData *inPD, vtkDataSetAttributes *outDSA,
+                         vtkDataArray *skip, int &numArrays,
+                         vtkDataArray **&fromArrays,
+                         vtkDataArray **&toArrays);
+  static void CopyTuples(int numArrays, vtkDataArray **fromArrays,
+                         vtkDataArray **toArrays, vtkIdType fromId,
+                         vtkIdType toId);
+  static void ComputeTransform(vtkGlyph3DThreadStruct *str,
+                               vtkIdType inPtId, vtkTransform *trans,
+                               double x[3], double v[3], double &vMag,
+                               double &colorScale, double scale[3],
+                               int &index);
+  static int ComputeIndex(vtkGlyph3DThreadStruct *str, double s,
+                          double vMag);
+  static vtkIdType SkipEmptySources(vtkGlyph3DThreadStruct *str,
+                                    vtkInformationVector *sourceInfo);
+  static void GlyphPoints(vtkIdType begin, vtkIdType end, int, void *arg);
+  static void InstancePoints(vtkIdType begin, vtkIdType end, int,
+                             void *arg);
+};
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DThreads::Initialize(vtkGlyph3DThreadStruct *str,
+                                   vtkGlyph3D *self, vtkDataSet *input,
+                                   vtkDataArray *inSScalars,
+                                   vtkDataArray *inVectors,
+                                   vtkDataArray *inNormals,
+                                   vtkDataArray *inCScalars)
+{
+  memset(str, 0, sizeof(vtkGlyph3DThreadStruct));
+  str->Filter = self;
+  str->Input = input;
+  str->InSScalars = inSScalars;
+  str->InVectors = inVectors;
+  str->InNormals = inNormals;
+  str->InCScalars = inCScalars;
+  if ( (str->Den = self->Range[1] - self->Range[0]) == 0.0 )
+    {
+    str->Den = 1.0;
+    }
+  str->HaveVectors = ( self->VectorMode != VTK_VECTOR_ROTATION_OFF &&
+                       ((self->VectorMode == VTK_USE_VECTOR && inVectors) ||
+                        (self->VectorMode == VTK_USE_NORMAL && inNormals)) );
+  str->NumberOfSources = self->GetNumberOfInputConnections(1);
+  vtkMatrix4x4::Identity(str->SourceMatrix);
+}
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DThreads::Free(vtkGlyph3DThreadStruct *str)
+{
+  delete [] str->GlyphIds;
+  delete [] str->FromPointArrays;
+  delete [] str->ToPointArrays;
+  delete [] str->FromCellArrays;
+  delete [] str->ToCellArrays;
+}
+
+//----------------------------------------------------------------------------
+// Find the input array each array of outDSA but skip was allocated from by
+// CopyAllocate().  The output tuples are written in place by several
+// threads, which only works for arrays that store whole values per tuple,
+// so return 0 and no arrays if an array cannot be matched or is a bit
+// array.
+int vtkGlyph3DThreads::MatchArrays(vtkPointData *inPD,
+                                   vtkDataSetAttributes *outDSA,
+                                   vtkDataArray *skip, int &numArrays,
+                                   vtkDataArray **&fromArrays,
+                                   vtkDataArray **&toArrays)
+{
+  int num = outDSA->GetNumberOfArrays();
+  fromArrays = new vtkDataArray *[num];
+  toArrays = new vtkDataArray *[num];
+  numArrays = 0;
+  for (int i = 0; i < num; i++)
+    {
+    vtkDataArray *to = outDSA->GetArray(i);
+    if ( skip && to == skip )
+      {
+      continue;
+      }
+    const char *name = outDSA->GetArrayName(i);
+    vtkDataArray *from = (name ? inPD->GetArray(name) : NULL);
+    if ( !to || !from || to->GetDataType() == VTK_BIT ||
+         to->GetDataType() != from->GetDataType() ||
+         to->GetNumberOfComponents() != from->GetNumberOfComponents() )
+      {
+      delete [] fromArrays;
+      delete [] toArrays;
+      fromArrays = toArrays = NULL;
+      return 0;
+      }
+    fromArrays[numArrays] = from;
+    toArrays[numArrays++] = to;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DThreads::CopyTuples(int numArrays, vtkDataArray **fromArrays,
+                                   vtkDataArray **toArrays, vtkIdType fromId,
+                                   vtkIdType toId)
+{
+  for (int i = 0; i < numArrays; i++)
+    {
+    toArrays[i]->InsertTuple(toId, fromId, fromArrays[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Set trans to the transformation of the glyph of an input point, the
+// same way the loop of vtkGlyph3D::RequestData() does, and return the
+// point, the vector, its magnitude, the scale the glyph is colored by,
+// the final scale factors and the index of the source.
+void vtkGlyph3DThreads::ComputeTransform(vtkGlyph3DThreadStruct *str,
+                                         vtkIdType inPtId,
+                                         vtkTransform *trans, double x[3],
+                                         double v[3], double &vMag,
+                                         double &colorScale,
+                                         double scale[3], int &index)
+{
+  vtkGlyph3D *self = str->Filter;
+  double s = 0.0, vNew[3];
+  double scalex, scaley, scalez;
+  double *range = self->Range;
+
+  scalex = scaley = scalez = 1.0;
+  vMag = 0.0;
+  if ( str->InSScalars )
+    {
+    s = str->InSScalars->GetComponent(inPtId, 0);
+    if ( self->ScaleMode == VTK_SCALE_BY_SCALAR ||
+         self->ScaleMode == VTK_DATA_SCALING_OFF )
+      {
+      scalex = scaley = scalez = s;
+      }
+    }
+
+  if ( str->HaveVectors )
+    {
+    if ( self->VectorMode == VTK_USE_NORMAL )
+      {
+      str->InNormals->GetTuple(inPtId, v);
+      }
+    else
+      {
+      str->InVectors->GetTuple(inPtId, v);
+      }
+    vMag = vtkMath::Norm(v);
+    if ( self->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+      {
+      scalex = v[0];
+      scaley = v[1];
+      scalez = v[2];
+      }
+    else if ( self->ScaleMode == VTK_SCALE_BY_VECTOR )
+      {
+      scalex = scaley = scalez = vMag;
+      }
+    }
+
+  if ( self->Clamping )
+    {
+    scalex = (scalex < range[0] ? range[0] :
+              (scalex > range[1] ? range[1] : scalex));
+    scalex = (scalex - range[0]) / str->Den;
+    scaley = (scaley < range[0] ? range[0] :
+              (scaley > range[1] ? range[1] : scaley));
+    scaley = (scaley - range[0]) / str->Den;
+    scalez = (scalez < range[0] ? range[0] :
+              (scalez > range[1] ? range[1] : scalez));
+    scalez = (scalez - range[0]) / str->Den;
+    }
+
+  index = vtkGlyph3DThreads::ComputeIndex(str, s, vMag);
+
+  trans->Identity();
+  str->Input->GetPoint(inPtId, x);
+  trans->Translate(x[0], x[1], x[2]);
+
+  if ( str->HaveVectors && self->Orient && (vMag > 0.0) )
+    {
+    if ( v[1] == 0.0 && v[2] == 0.0 )
+      {
+      if (v[0] < 0) //just flip x if we need to
+        {
+        trans->RotateWXYZ(180.0,0,1,0);
+        }
+      }
+    else
+      {
+      vNew[0] = (v[0]+vMag) / 2.0;
+      vNew[1] = v[1] / 2.0;
+      vNew[2] = v[2] / 2.0;
+      trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+      }
+    }
+
+  colorScale = scalex;
+  scale[0] = scale[1] = scale[2] = 1.0;
+  if ( self->Scaling )
+    {
+    if ( self->ScaleMode == VTK_DATA_SCALING_OFF )
+      {
+      scalex = scaley = scalez = self->ScaleFactor;
+      }
+    else
+      {
+      scalex *= self->ScaleFactor;
+      scaley *= self->ScaleFactor;
+      scalez *= self->ScaleFactor;
+      }
+
+    if ( scalex == 0.0 )
+      {
+      scalex = 1.0e-10;
+      }
+    if ( scaley == 0.0 )
+      {
+      scaley = 1.0e-10;
+      }
+    if ( scalez == 0.0 )
+      {
+      scalez = 1.0e-10;
+      }
+    trans->Scale(scalex,scaley,scalez);
+    scale[0] = scalex;
+    scale[1] = scaley;
+    scale[2] = scalez;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the index into the table of glyphs from the scalar and the
+// vector magnitude of a point.
+int vtkGlyph3DThreads::ComputeIndex(vtkGlyph3DThreadStruct *str, double s,
+                                    double vMag)
+{
+  vtkGlyph3D *self = str->Filter;
+  if ( self->IndexMode == VTK_INDEXING_OFF )
+    {
+    return 0;
+    }
+  double value = (self->IndexMode == VTK_INDEXING_BY_SCALAR ? s : vMag);
+  int index = static_cast<int>((value - self->Range[0])*str->NumberOfSources /
+                               str->Den);
+  return (index < 0 ? 0 :
+          (index >= str->NumberOfSources ? (str->NumberOfSources-1) :
+           index));
+}
+
+//----------------------------------------------------------------------------
+// Drop the glyphed points whose indexed source is NULL, as the loop of
+// vtkGlyph3D::RequestData() does, renumber the others and return their
+// number.
+vtkIdType vtkGlyph3DThreads::SkipEmptySources(
+  vtkGlyph3DThreadStruct *str, vtkInformationVector *sourceInfo)
+{
+  vtkGlyph3D *self = str->Filter;
+  char *haveSource = new char[str->NumberOfSources];
+  int i;
+  for (i = 0; i < str->NumberOfSources; i++)
+    {
+    haveSource[i] = (self->GetSource(i, sourceInfo) != NULL);
+    }
+  vtkIdType numPts = str->Input->GetNumberOfPoints();
+  vtkIdType numGlyphs = 0;
+  double s = 0.0, v[3], vMag = 0.0;
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+    {
+    if ( str->GlyphIds[inPtId] < 0 )
+      {
+      continue;
+      }
+    if ( str->InSScalars )
+      {
+      s = str->InSScalars->GetComponent(inPtId, 0);
+      }
+    if ( str->HaveVectors )
+      {
+      if ( self->VectorMode == VTK_USE_NORMAL )
+        {
+        str->InNormals->GetTuple(inPtId, v);
+        }
+      else
+        {
+        str->InVectors->GetTuple(inPtId, v);
+        }
+      vMag = vtkMath::Norm(v);
+      }
+    str->GlyphIds[inPtId] =
+      (haveSource[vtkGlyph3DThreads::ComputeIndex(str, s, vMag)] ?
+       numGlyphs++ : -1);
+    }
+  delete [] haveSource;
+  return numGlyphs;
+}
+
+//----------------------------------------------------------------------------
+// Write the glyphs of a range of input points at their offsets in the
+// output.  The points and normals are transformed in plain loops over
+// contiguous arrays, which the compiler can vectorize.
+void vtkGlyph3DThreads::GlyphPoints(vtkIdType begin, vtkIdType end, int,
+                                    void *arg)
+{
+  vtkGlyph3DThreadStruct *str = static_cast<vtkGlyph3DThreadStruct *>(arg);
+  vtkGlyph3D *self = str->Filter;
+  vtkTransform *trans = vtkTransform::New();
+  vtkIdType numSourcePts = str->NumberOfSourcePoints;
+  vtkIdType numSourceCells = str->NumberOfSourceCells;
+  double x[3], v[3], vMag, colorScale, scale[3], n[3];
+  double matrix[4][4], normalMatrix[4][4];
+  int index;
+  vtkIdType i, k;
+
+  for (vtkIdType inPtId = begin; inPtId < end; inPtId++)
+    {
+    vtkIdType glyphId = str->GlyphIds[inPtId];
+    if ( glyphId < 0 )
+      {
+      continue;
+      }
+    vtkGlyph3DThreads::ComputeTransform(str, inPtId, trans, x, v, vMag,
+                                        colorScale, scale, index);
+    vtkIdType ptIncr = glyphId*numSourcePts;
+    vtkIdType cellIncr = glyphId*numSourceCells;
+
+    // Copy all topology, shifted to the points of this glyph
+    for (int type = 0; type < 4; type++)
+      {
+      if ( !str->SourceCells[type] )
+        {
+        continue;
+        }
+      vtkIdType size = str->SourceCells[type]->GetNumberOfConnectivityEntries();
+      vtkIdType *inCells = str->SourceCells[type]->GetPointer();
+      vtkIdType *outCells = str->Cells[type] + glyphId*size;
+      for (k = 0; k < size; k += inCells[k] + 1)
+        {
+        outCells[k] = inCells[k];
+        for (i = 1; i <= inCells[k]; i++)
+          {
+          outCells[k+i] = inCells[k+i] + ptIncr;
+          }
+        }
+      }
+
+    // multiply points and normals by resulting matrix
+    vtkMatrix4x4::DeepCopy(*matrix, trans->GetMatrix());
+    double *inPts = str->SourcePoints;
+    float *outPts = str->Points + 3*ptIncr;
+    for (i = 0; i < numSourcePts; i++)
+      {
+      double px = inPts[3*i], py = inPts[3*i+1], pz = inPts[3*i+2];
+      outPts[3*i] = static_cast<float>(
+        matrix[0][0]*px+matrix[0][1]*py+matrix[0][2]*pz+matrix[0][3]);
+      outPts[3*i+1] = static_cast<float>(
+        matrix[1][0]*px+matrix[1][1]*py+matrix[1][2]*pz+matrix[1][3]);
+      outPts[3*i+2] = static_cast<float>(
+        matrix[2][0]*px+matrix[2][1]*py+matrix[2][2]*pz+matrix[2][3]);
+      }
+
+    if ( str->Normals )
+      {
+      // to transform the normals, multiply by the transposed inverse
+      vtkMatrix4x4::Invert(*matrix, *normalMatrix);
+      vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+      float *outNormals = str->Normals + 3*ptIncr;
+      for (i = 0; i < numSourcePts; i++)
+        {
+        str->SourceNormals->GetTuple(i, n);
+        double nx = normalMatrix[0][0]*n[0] + normalMatrix[0][1]*n[1] +
+          normalMatrix[0][2]*n[2];
+        double ny = normalMatrix[1][0]*n[0] + normalMatrix[1][1]*n[1] +
+          normalMatrix[1][2]*n[2];
+        double nz = normalMatrix[2][0]*n[0] + normalMatrix[2][1]*n[1] +
+          normalMatrix[2][2]*n[2];
+        n[0] = nx;
+        n[1] = ny;
+        n[2] = nz;
+        vtkMath::Normalize(n);
+        outNormals[3*i] = static_cast<float>(n[0]);
+        outNormals[3*i+1] = static_cast<float>(n[1]);
+        outNormals[3*i+2] = static_cast<float>(n[2]);
+        }
+      }
+
+    for (i = 0; i < numSourcePts; i++)
+      {
+      if ( str->Vectors )
+        {
+        str->Vectors->SetTuple(ptIncr+i, v);
+        }
+      if ( str->TCoords )
+        {
+        double tc[3];
+        str->SourceTCoords->GetTuple(i, tc);
+        str->TCoords->SetTuple(ptIncr+i, tc);
+        }
+      if ( str->InSScalars && self->ColorMode == VTK_COLOR_BY_SCALE )
+        {
+        str->Scalars->SetTuple(ptIncr+i, &colorScale);
+        }
+      else if ( str->InCScalars && self->ColorMode == VTK_COLOR_BY_SCALAR )
+        {
+        str->Scalars->InsertTuple(ptIncr+i, inPtId, str->InCScalars);
+        }
+      if ( str->HaveVectors && self->ColorMode == VTK_COLOR_BY_VECTOR )
+        {
+        str->Scalars->SetTuple(ptIncr+i, &vMag);
+        }
+      vtkGlyph3DThreads::CopyTuples(str->NumberOfPointArrays,
+                                    str->FromPointArrays, str->ToPointArrays,
+                                    inPtId, ptIncr+i);
+      if ( str->PointIds )
+        {
+        str->PointIds[ptIncr+i] = inPtId;
+        }
+      }
+    if ( self->FillCellData )
+      {
+      for (i = 0; i < numSourceCells; i++)
+        {
+        vtkGlyph3DThreads::CopyTuples(str->NumberOfCellArrays,
+                                      str->FromCellArrays, str->ToCellArrays,
+                                      inPtId, cellIncr+i);
+        }
+      }
+    }
+
+  trans->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Write the instances of a range of input points.
+void vtkGlyph3DThreads::InstancePoints(vtkIdType begin, vtkIdType end, int,
+                                       void *arg)
+{
+  vtkGlyph3DThreadStruct *str = static_cast<vtkGlyph3DThreadStruct *>(arg);
+  vtkGlyph3D *self = str->Filter;
+  vtkTransform *trans = vtkTransform::New();
+  double x[3], v[3], vMag, colorScale, scale[3], matrix[16];
+  int index, i;
+
+  for (vtkIdType inPtId = begin; inPtId < end; inPtId++)
+    {
+    vtkIdType glyphId = str->GlyphIds[inPtId];
+    if ( glyphId < 0 )
+      {
+      continue;
+      }
+    vtkGlyph3DThreads::ComputeTransform(str, inPtId, trans, x, v, vMag,
+                                        colorScale, scale, index);
+    vtkMatrix4x4::Multiply4x4(*trans->GetMatrix()->Element,
+                              str->SourceMatrix, matrix);
+    for (i = 0; i < 16; i++)
+      {
+      str->Transforms[16*glyphId+i] = static_cast<float>(matrix[i]);
+      }
+    for (i = 0; i < 3; i++)
+      {
+      str->Points[3*glyphId+i] = static_cast<float>(x[i]);
+      str->ScaleFactors[3*glyphId+i] = static_cast<float>(scale[i]);
+      }
+    if ( str->Vectors )
+      {
+      str->Vectors->SetTuple(glyphId, v);
+      }
+    if ( str->SourceIndices )
+      {
+      str->SourceIndices[glyphId] = index;
+      }
+    if ( str->InSScalars && self->ColorMode == VTK_COLOR_BY_SCALE )
+      {
+      str->Scalars->SetTuple(glyphId, &colorScale);
+      }
+    else if ( str->InCScalars && self->ColorMode == VTK_COLOR_BY_SCALAR )
+      {
+      str->Scalars->InsertTuple(glyphId, inPtId, str->InCScalars);
+      }
+    if ( str->HaveVectors && self->ColorMode == VTK_COLOR_BY_VECTOR )
+      {
+      str->Scalars->SetTuple(glyphId, &vMag);
+      }
+    if ( str->ToPointArrays )
+      {
+      vtkGlyph3DThreads::CopyTuples(str->NumberOfPointArrays,
+                                    str->FromPointArrays, str->ToPointArrays,
+                                    inPtId, glyphId);
+      }
+    else
+      {
+      str->OutPD->CopyData(str->InPD, inPtId, glyphId);
+      }
+    if ( str->PointIds )
+      {
+      str->PointIds[glyphId] = inPtId;
+      }
+    }
+
+  trans->Delete();
+}
+
 //----------------------------------------------------------------------------
 // Construct object with scaling on, scaling mode is by scalar value,
 // scale factor = 1.0, the range is (0,1), orient geometry is on, and
@@ -57,6 +624,8 @@ vtkGlyph3D::vtkGlyph3D()
   this->SetNumberOfInputPorts(2);
   this->FillCellData = 0;
   this->SourceTransform = 0;
+  this->NumberOfThreads = 1;
+  this->GenerateInstances = 0;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -128,7 +697,7 @@ int vtkGlyph3D::RequestData(
   vtkDataArray *newVectors=NULL;
   vtkDataArray *newNormals=NULL;
   vtkDataArray *newTCoords = NULL;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
+  double x[3], v[3], vMag = 0.0, colorScale, scale[3], tc[3];
   vtkTransform *trans = vtkTransform::New();
   vtkCell *cell;
   vtkIdList *cellPts;
@@ -136,7 +705,6 @@ int vtkGlyph3D::RequestData(
   vtkIdList *pts;
   vtkIdType ptIncr, cellIncr, cellId;
   int haveVectors, haveNormals, haveTCoords = 0;
-  double scalex,scaley,scalez, den;
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   int numberOfSources = this->GetNumberOfInputConnections(1);
@@ -188,10 +756,6 @@ int vtkGlyph3D::RequestData(
 
   // Check input for consistency
   //
-  if ( (den = this->Range[1] - this->Range[0]) == 0.0 )
-    {
-    den = 1.0;
-    }
   if ( this->VectorMode != VTK_VECTOR_ROTATION_OFF &&
        ((this->VectorMode == VTK_USE_VECTOR && inVectors != NULL) ||
         (this->VectorMode == VTK_USE_NORMAL && inNormals != NULL)) )
@@ -222,6 +786,16 @@ int vtkGlyph3D::RequestData(
       }
     }
 
+  if ( this->GenerateInstances )
+    {
+    pts->Delete();
+    trans->Delete();
+    return this->RequestInstances(input, output, inputVector[1],
+                                  inSScalars, inVectors,
+                                  inNormals, inCScalars, inGhostLevels,
+                                  requestedGhostLevel);
+    }
+
   // Allocate storage for output PolyData
   //
   outputPD->CopyVectorsOff();
@@ -309,11 +883,12 @@ int vtkGlyph3D::RequestData(
       }
     }
 
-  newPts = vtkPoints::New();
+  newPts = vtkOutputRecycler::NewPoints(output);
   newPts->Allocate(numPts*numSourcePts);
   if ( this->GeneratePointIds )
     {
-    pointIds = vtkIdTypeArray::New();
+    pointIds = static_cast<vtkIdTypeArray*>(
+      vtkOutputRecycler::NewArray(output, VTK_ID_TYPE));
     pointIds->SetName(this->PointIdsName);
     pointIds->Allocate(numPts*numSourcePts);
     outputPD->AddArray(pointIds);
@@ -328,7 +903,7 @@ int vtkGlyph3D::RequestData(
     }
   else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
     {
-    newScalars = vtkFloatArray::New();
+    newScalars = vtkOutputRecycler::NewArray(output, VTK_FLOAT);
     newScalars->Allocate(numPts*numSourcePts);
     newScalars->SetName("GlyphScale");
     if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
@@ -338,320 +913,330 @@ int vtkGlyph3D::RequestData(
     }
   else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
     {
-    newScalars = vtkFloatArray::New();
+    newScalars = vtkOutputRecycler::NewArray(output, VTK_FLOAT);
     newScalars->Allocate(numPts*numSourcePts);
     newScalars->SetName("VectorMagnitude");
     }
   if ( haveVectors )
     {
-    newVectors = vtkFloatArray::New();
-    newVectors->SetNumberOfComponents(3);
+    newVectors = vtkOutputRecycler::NewArray(output, VTK_FLOAT, 3);
     newVectors->Allocate(3*numPts*numSourcePts);
     newVectors->SetName("GlyphVector");
     }
   if ( haveNormals )
     {
-    newNormals = vtkFloatArray::New();
-    newNormals->SetNumberOfComponents(3);
+    newNormals = vtkOutputRecycler::NewArray(output, VTK_FLOAT, 3);
     newNormals->Allocate(3*numPts*numSourcePts);
     newNormals->SetName("Normals");
     }
   if (haveTCoords)
     {
-    newTCoords = vtkFloatArray::New();
     int numComps = sourceTCoords->GetNumberOfComponents();
-    newTCoords->SetNumberOfComponents(numComps);
+    newTCoords = vtkOutputRecycler::NewArray(output, VTK_FLOAT, numComps);
     newTCoords->Allocate(numComps*numPts*numSourcePts);
     newTCoords->SetName("TCoords");
     }
     
-  // Setting up for calls to PolyData::InsertNextCell()
+  // The glyphs of a single source can be written concurrently at their
+  // offsets in the output.
+  vtkGlyph3DThreadStruct str;
+  vtkGlyph3DThreads::Initialize(&str, this, input, inSScalars, inVectors,
+                                inNormals, inCScalars);
+  int threaded = ( this->NumberOfThreads > 1 &&
+                   this->IndexMode == VTK_INDEXING_OFF &&
+                   (!newScalars || newScalars->GetDataType() != VTK_BIT) &&
+                   vtkGlyph3DThreads::MatchArrays(
+                     pd, outputPD, pointIds, str.NumberOfPointArrays,
+                     str.FromPointArrays, str.ToPointArrays) &&
+                   (!this->FillCellData ||
+                    vtkGlyph3DThreads::MatchArrays(
+                      pd, outputCD, NULL, str.NumberOfCellArrays,
+                      str.FromCellArrays, str.ToCellArrays)) );
+
+  // Setting up for calls to PolyData::InsertNextCell().  The threaded
+  // path writes the cell arrays directly.
   if (this->IndexMode != VTK_INDEXING_OFF )
     {
     output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
     }
-  else
+  else if ( !threaded )
     {
     output->Allocate(this->GetSource(0, inputVector[1]),
                      3*numPts*numSourceCells, numPts*numSourceCells);
     }
 
+  // The source transform is applied in double precision on both paths.
   transformedSourcePts->SetDataTypeToDouble();
   transformedSourcePts->Allocate(numSourcePts);
 
   // Traverse all Input points, transforming Source points and copying
   // point attributes.
   //
-  ptIncr=0;
-  cellIncr=0;
-  for (inPtId=0; inPtId < numPts; inPtId++)
+  if ( threaded )
     {
-    scalex = scaley = scalez = 1.0;
-    if ( ! (inPtId % 10000) )
+    str.GlyphIds = new vtkIdType[numPts];
+    vtkIdType numGlyphs = this->FindGlyphedPoints(input, str.GlyphIds,
+                                                  inGhostLevels,
+                                                  requestedGhostLevel);
+    vtkIdType numNewPts = numGlyphs*numSourcePts;
+
+    // Apply the source transform once.
+    if (this->SourceTransform)
       {
-      this->UpdateProgress(static_cast<double>(inPtId)/numPts);
-      if (this->GetAbortExecute())
+      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
+      }
+    else
+      {
+      for (i = 0; i < numSourcePts; i++)
         {
-        break;
+        transformedSourcePts->InsertNextPoint(sourcePts->GetPoint(i));
         }
       }
+    str.SourcePoints = static_cast<double *>(
+      transformedSourcePts->GetData()->GetVoidPointer(0));
+    str.NumberOfSourcePoints = numSourcePts;
+    str.NumberOfSourceCells = numSourceCells;
+    str.SourceNormals = sourceNormals;
+    str.SourceTCoords = sourceTCoords;
 
-    // Get the scalar and vector data
-    if ( inSScalars )
+    // Allocate the output at its final size.
+    vtkCellArray *sourceCells[4] = { source->GetVerts(), source->GetLines(),
+                                     source->GetPolys(), source->GetStrips() };
+    vtkCellArray *outCells[4];
+    for (i = 0; i < 4; i++)
       {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if ( this->ScaleMode == VTK_SCALE_BY_SCALAR ||
-           this->ScaleMode == VTK_DATA_SCALING_OFF )
+      outCells[i] = NULL;
+      if ( sourceCells[i]->GetNumberOfCells() > 0 )
         {
-        scalex = scaley = scalez = s;
+        str.SourceCells[i] = sourceCells[i];
+        outCells[i] = vtkOutputRecycler::NewCellArray(output, i);
+        str.Cells[i] = outCells[i]->WritePointer(
+          numGlyphs*sourceCells[i]->GetNumberOfCells(),
+          numGlyphs*sourceCells[i]->GetNumberOfConnectivityEntries());
         }
       }
-    
-    if ( haveVectors )
+    newPts->SetDataTypeToFloat();
+    newPts->SetNumberOfPoints(numNewPts);
+    str.Points = static_cast<float *>(newPts->GetData()->GetVoidPointer(0));
+    for (i = 0; i < outputPD->GetNumberOfArrays(); i++)
       {
-      if ( this->VectorMode == VTK_USE_NORMAL )
-        {
-        inNormals->GetTuple(inPtId, v);
-        }
-      else
-        {
-        inVectors->GetTuple(inPtId, v);
-        }
-      vMag = vtkMath::Norm(v);
-      if ( this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
-        {
-        scalex = v[0];
-        scaley = v[1];
-        scalez = v[2];
-        }
-      else if ( this->ScaleMode == VTK_SCALE_BY_VECTOR )
+      outputPD->GetAbstractArray(i)->SetNumberOfTuples(numNewPts);
+      }
+    if (this->FillCellData)
+      {
+      for (i = 0; i < outputCD->GetNumberOfArrays(); i++)
         {
-        scalex = scaley = scalez = vMag;
+        outputCD->GetAbstractArray(i)->SetNumberOfTuples(
+          numGlyphs*numSourceCells);
         }
       }
-    
-    // Clamp data scale if enabled
-    if ( this->Clamping )
-      {
-      scalex = (scalex < this->Range[0] ? this->Range[0] :
-                (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0] :
-                (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0] :
-                (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
+    if ( newScalars )
+      {
+      newScalars->SetNumberOfTuples(numNewPts);
       }
-    
-    // Compute index into table of glyphs
-    if ( this->IndexMode == VTK_INDEXING_OFF )
+    if ( newVectors )
       {
-      index = 0;
+      newVectors->SetNumberOfTuples(numNewPts);
       }
-    else 
+    if ( newNormals )
       {
-      if ( this->IndexMode == VTK_INDEXING_BY_SCALAR )
-        {
-        value = s;
-        }
-      else
-        {
-        value = vMag;
-        }
-      
-      index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
-      index = (index < 0 ? 0 :
-              (index >= numberOfSources ? (numberOfSources-1) : index));
-      
-      source = this->GetSource(index, inputVector[1]);
-      if ( source != NULL )
-        {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-        }
+      newNormals->SetNumberOfTuples(numNewPts);
+      str.Normals = static_cast<float *>(newNormals->GetVoidPointer(0));
       }
-
-    // Make sure we're not indexing into empty glyph
-    if ( this->GetSource(index, inputVector[1]) == NULL )
+    if ( newTCoords )
       {
-      continue;
+      newTCoords->SetNumberOfTuples(numNewPts);
       }
+    str.Vectors = newVectors;
+    str.TCoords = newTCoords;
+    str.Scalars = newScalars;
+    str.PointIds = (pointIds ? pointIds->GetPointer(0) : NULL);
+
+    input->PrepareForThreadedAccess();
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, numPts, VTK_GLYPH_3D_BLOCK_SIZE, vtkGlyph3DThreads::GlyphPoints,
+      &str);
 
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate 
-    // glyphs on the borders.  The corrct check here is:
-    // ghostLevel > 0.  I am leaving this over glyphing here because
-    // it make a nice example (sphereGhost.tcl) to show the 
-    // point ghost levels with the glyph filter.  I am not certain 
-    // of the usefulness of point ghost levels over 1, but I will have
-    // to think about it.
-    if (inGhostLevels && inGhostLevels[inPtId] > requestedGhostLevel)
+    if ( outCells[0] )
       {
-      continue;
+      output->SetVerts(outCells[0]);
       }
-
-    if (!this->IsPointVisible(input, inPtId))
+    if ( outCells[1] )
       {
-      continue;
+      output->SetLines(outCells[1]);
       }
-    
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
-    // Copy all topology (transformation independent)
-    for (cellId=0; cellId < numSourceCells; cellId++)
+    if ( outCells[2] )
       {
-      cell = this->GetSource(index, inputVector[1])->GetCell(cellId);
-      cellPts = cell->GetPointIds();
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i=0; i < npts; i++) 
-        {
-        pts->InsertId(i,cellPts->GetId(i) + ptIncr);
-        }
-      output->InsertNextCell(cell->GetCellType(),pts);
+      output->SetPolys(outCells[2]);
       }
-    
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-    
-    if ( haveVectors )
+    if ( outCells[3] )
+      {
+      output->SetStrips(outCells[3]);
+      }
+    for (i = 0; i < 4; i++)
       {
-      // Copy Input vector
-      for (i=0; i < numSourcePts; i++) 
+      if ( outCells[i] )
         {
-        newVectors->InsertTuple(i+ptIncr, v);
+        outCells[i]->Delete();
         }
-      if (this->Orient && (vMag > 0.0))
+      }
+    }
+  else
+    {
+    ptIncr=0;
+    cellIncr=0;
+    for (inPtId=0; inPtId < numPts; inPtId++)
+      {
+      if ( ! (inPtId % 10000) )
         {
-        // if there is no y or z component
-        if ( v[1] == 0.0 && v[2] == 0.0 )
+        this->UpdateProgress(static_cast<double>(inPtId)/numPts);
+        if (this->GetAbortExecute())
           {
-          if (v[0] < 0) //just flip x if we need to
-            {
-            trans->RotateWXYZ(180.0,0,1,0);
-            }
+          break;
           }
-        else
+        }
+
+      // Get the scalar and vector data, the index into the table of
+      // glyphs and the transformation of the glyph.
+      vtkGlyph3DThreads::ComputeTransform(&str, inPtId, trans, x, v, vMag,
+                                          colorScale, scale, index);
+      if ( this->IndexMode != VTK_INDEXING_OFF )
+        {
+        source = this->GetSource(index, inputVector[1]);
+        if ( source != NULL )
           {
-          vNew[0] = (v[0]+vMag) / 2.0;
-          vNew[1] = v[1] / 2.0;
-          vNew[2] = v[2] / 2.0;
-          trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          sourcePts = source->GetPoints();
+          sourceNormals = source->GetPointData()->GetNormals();
+          numSourcePts = sourcePts->GetNumberOfPoints();
+          numSourceCells = source->GetNumberOfCells();
           }
         }
-      }
-    
-    if (haveTCoords)
-      {
-      for (i = 0; i < numSourcePts; i++)
+
+      // Make sure we're not indexing into empty glyph
+      if ( this->GetSource(index, inputVector[1]) == NULL )
         {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i+ptIncr, tc);
+        continue;
         }
-      }
-    
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-      {
-      for (i=0; i < numSourcePts; i++)
+
+      // Check ghost points.
+      // If we are processing a piece, we do not want to duplicate 
+      // glyphs on the borders.  The corrct check here is:
+      // ghostLevel > 0.  I am leaving this over glyphing here because
+      // it make a nice example (sphereGhost.tcl) to show the 
+      // point ghost levels with the glyph filter.  I am not certain 
+      // of the usefulness of point ghost levels over 1, but I will have
+      // to think about it.
+      if (inGhostLevels && inGhostLevels[inPtId] > requestedGhostLevel)
         {
-        newScalars->InsertTuple(i+ptIncr, &scalex); // = scaley = scalez
+        continue;
         }
-      }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-      {
-      for (i=0; i < numSourcePts; i++)
+
+      if (!this->IsPointVisible(input, inPtId))
         {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
+        continue;
         }
-      }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-      {
-      for (i=0; i < numSourcePts; i++) 
+    
+      // Copy all topology (transformation independent)
+      for (cellId=0; cellId < numSourceCells; cellId++)
         {
-        newScalars->InsertTuple(i+ptIncr, &vMag);
+        cell = this->GetSource(index, inputVector[1])->GetCell(cellId);
+        cellPts = cell->GetPointIds();
+        npts = cellPts->GetNumberOfIds();
+        for (pts->Reset(), i=0; i < npts; i++) 
+          {
+          pts->InsertId(i,cellPts->GetId(i) + ptIncr);
+          }
+        output->InsertNextCell(cell->GetCellType(),pts);
         }
-      }
     
-    // scale data if appropriate
-    if ( this->Scaling )
-      {
-      if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
+      if ( haveVectors )
         {
-        scalex = scaley = scalez = this->ScaleFactor;
+        // Copy Input vector
+        for (i=0; i < numSourcePts; i++) 
+          {
+          newVectors->InsertTuple(i+ptIncr, v);
+          }
         }
-      else
+    
+      if (haveTCoords)
         {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
+        for (i = 0; i < numSourcePts; i++)
+          {
+          sourceTCoords->GetTuple(i, tc);
+          newTCoords->InsertTuple(i+ptIncr, tc);
+          }
         }
-      
-      if ( scalex == 0.0 )
+    
+      // Copy scalar value
+      if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
         {
-        scalex = 1.0e-10;
+        for (i=0; i < numSourcePts; i++)
+          {
+          newScalars->InsertTuple(i+ptIncr, &colorScale);
+          }
         }
-      if ( scaley == 0.0 )
+      else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
         {
-        scaley = 1.0e-10;
+        for (i=0; i < numSourcePts; i++)
+          {
+          outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
+          }
         }
-      if ( scalez == 0.0 )
+      if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
         {
-        scalez = 1.0e-10;
+        for (i=0; i < numSourcePts; i++) 
+          {
+          newScalars->InsertTuple(i+ptIncr, &vMag);
+          }
         }
-      trans->Scale(scalex,scaley,scalez);
-      }
-
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-      {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-      }
-    else
-      {
-      trans->TransformPoints(sourcePts,newPts);
-      }
     
-    if ( haveNormals )
-      {
-      trans->TransformNormals(sourceNormals,newNormals);
-      }
+      // multiply points and normals by resulting matrix
+      if (this->SourceTransform)
+        {
+        transformedSourcePts->Reset();
+        this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
+        trans->TransformPoints(transformedSourcePts, newPts);
+        }
+      else
+        {
+        trans->TransformPoints(sourcePts,newPts);
+        }
     
-    // Copy point data from source (if possible)
-    if ( pd ) 
-      {
-      for (i=0; i < numSourcePts; i++)
+      if ( haveNormals )
         {
-        outputPD->CopyData(pd,inPtId,ptIncr+i);
+        trans->TransformNormals(sourceNormals,newNormals);
         }
-      if (this->FillCellData)
+    
+      // Copy point data from source (if possible)
+      if ( pd ) 
         {
-        for (i=0; i < numSourceCells; i++)
+        for (i=0; i < numSourcePts; i++)
+          {
+          outputPD->CopyData(pd,inPtId,ptIncr+i);
+          }
+        if (this->FillCellData)
           {
-          outputCD->CopyData(pd,inPtId,cellIncr+i);
+          for (i=0; i < numSourceCells; i++)
+            {
+            outputCD->CopyData(pd,inPtId,cellIncr+i);
+            }
           }
         }
-      }
 
-    // If point ids are to be generated, do it here
-    if ( this->GeneratePointIds )
-      {
-      for (i=0; i < numSourcePts; i++)
+      // If point ids are to be generated, do it here
+      if ( this->GeneratePointIds )
         {
-        pointIds->InsertNextValue(inPtId);
+        for (i=0; i < numSourcePts; i++)
+          {
+          pointIds->InsertNextValue(inPtId);
+          }
         }
-      }
 
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
-    } 
+      ptIncr += numSourcePts;
+      cellIncr += numSourceCells;
+      } 
+    }
+  vtkGlyph3DThreads::Free(&str);
   
   // Update ourselves and release memory
   //
@@ -690,6 +1275,185 @@ int vtkGlyph3D::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkGlyph3D::FindGlyphedPoints(vtkDataSet *input,
+                                        vtkIdType *glyphIds,
+                                        unsigned char *inGhostLevels,
+                                        int requestedGhostLevel)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numGlyphs = 0;
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+    {
+    if ( (inGhostLevels && inGhostLevels[inPtId] > requestedGhostLevel) ||
+         !this->IsPointVisible(input, inPtId) )
+      {
+      glyphIds[inPtId] = -1;
+      }
+    else
+      {
+      glyphIds[inPtId] = numGlyphs++;
+      }
+    }
+  return numGlyphs;
+}
+
+//----------------------------------------------------------------------------
+int vtkGlyph3D::RequestInstances(vtkDataSet *input, vtkPolyData *output,
+                                 vtkInformationVector *sourceInfo,
+                                 vtkDataArray *inSScalars,
+                                 vtkDataArray *inVectors,
+                                 vtkDataArray *inNormals,
+                                 vtkDataArray *inCScalars,
+                                 unsigned char *inGhostLevels,
+                                 int requestedGhostLevel)
+{
+  vtkPointData *pd = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkDataArray *newScalars = NULL;
+  vtkDataArray *newVectors = NULL;
+  vtkDataArray *sourceIndices = NULL;
+  vtkIdTypeArray *pointIds = NULL;
+  vtkGlyph3DThreadStruct str;
+  int i;
+
+  vtkDebugMacro(<<"Generating glyph instances");
+
+  vtkGlyph3DThreads::Initialize(&str, this, input, inSScalars, inVectors,
+                                inNormals, inCScalars);
+  str.GlyphIds = new vtkIdType[numPts];
+  vtkIdType numGlyphs = this->FindGlyphedPoints(input, str.GlyphIds,
+                                                inGhostLevels,
+                                                requestedGhostLevel);
+  if ( this->IndexMode != VTK_INDEXING_OFF )
+    {
+    numGlyphs = vtkGlyph3DThreads::SkipEmptySources(&str, sourceInfo);
+    }
+  if ( this->SourceTransform )
+    {
+    vtkMatrix4x4::DeepCopy(str.SourceMatrix,
+                           this->SourceTransform->GetMatrix());
+    }
+
+  // Allocate the output at its final size.
+  outputPD->CopyVectorsOff();
+  outputPD->CopyNormalsOff();
+  outputPD->CopyTCoordsOff();
+  outputPD->CopyAllocate(pd,numGlyphs);
+  if ( this->GeneratePointIds )
+    {
+    pointIds = static_cast<vtkIdTypeArray*>(
+      vtkOutputRecycler::NewArray(output, VTK_ID_TYPE));
+    pointIds->SetName(this->PointIdsName);
+    outputPD->AddArray(pointIds);
+    pointIds->Delete();
+    }
+  for (i = 0; i < outputPD->GetNumberOfArrays(); i++)
+    {
+    outputPD->GetAbstractArray(i)->SetNumberOfTuples(numGlyphs);
+    }
+  str.InPD = pd;
+  str.OutPD = outputPD;
+  str.PointIds = (pointIds ? pointIds->GetPointer(0) : NULL);
+
+  vtkPoints *newPts = vtkOutputRecycler::NewPoints(output);
+  newPts->SetNumberOfPoints(numGlyphs);
+  str.Points = static_cast<float *>(newPts->GetData()->GetVoidPointer(0));
+  vtkDataArray *transforms = vtkOutputRecycler::NewArray(output, VTK_FLOAT,
+                                                         16);
+  transforms->SetName("GlyphTransform");
+  transforms->SetNumberOfTuples(numGlyphs);
+  str.Transforms = static_cast<float *>(transforms->GetVoidPointer(0));
+  vtkDataArray *scaleFactors = vtkOutputRecycler::NewArray(output, VTK_FLOAT,
+                                                           3);
+  scaleFactors->SetName("GlyphScaleFactors");
+  scaleFactors->SetNumberOfTuples(numGlyphs);
+  str.ScaleFactors = static_cast<float *>(scaleFactors->GetVoidPointer(0));
+  if ( str.HaveVectors )
+    {
+    newVectors = vtkOutputRecycler::NewArray(output, VTK_FLOAT, 3);
+    newVectors->SetName("GlyphVector");
+    newVectors->SetNumberOfTuples(numGlyphs);
+    str.Vectors = newVectors;
+    }
+  if ( this->IndexMode != VTK_INDEXING_OFF )
+    {
+    sourceIndices = vtkOutputRecycler::NewArray(output, VTK_INT);
+    sourceIndices->SetName("GlyphSourceIndex");
+    sourceIndices->SetNumberOfTuples(numGlyphs);
+    str.SourceIndices = static_cast<int *>(sourceIndices->GetVoidPointer(0));
+    }
+  if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
+    {
+    newScalars = inCScalars->NewInstance();
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetName(inCScalars->GetName());
+    }
+  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
+    {
+    newScalars = vtkOutputRecycler::NewArray(output, VTK_FLOAT);
+    newScalars->SetName("GlyphScale");
+    if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
+      {
+      newScalars->SetName(inSScalars->GetName());
+      }
+    }
+  else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && str.HaveVectors)
+    {
+    newScalars = vtkOutputRecycler::NewArray(output, VTK_FLOAT);
+    newScalars->SetName("VectorMagnitude");
+    }
+  if ( newScalars )
+    {
+    newScalars->SetNumberOfTuples(numGlyphs);
+    str.Scalars = newScalars;
+    }
+
+  if ( this->NumberOfThreads > 1 &&
+       (!newScalars || newScalars->GetDataType() != VTK_BIT) &&
+       vtkGlyph3DThreads::MatchArrays(pd, outputPD, pointIds,
+                                      str.NumberOfPointArrays,
+                                      str.FromPointArrays,
+                                      str.ToPointArrays) )
+    {
+    input->PrepareForThreadedAccess();
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, numPts, VTK_GLYPH_3D_BLOCK_SIZE, vtkGlyph3DThreads::InstancePoints,
+      &str);
+    }
+  else
+    {
+    vtkGlyph3DThreads::InstancePoints(0, numPts, 0, &str);
+    }
+  vtkGlyph3DThreads::Free(&str);
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  outputPD->AddArray(transforms);
+  transforms->Delete();
+  outputPD->AddArray(scaleFactors);
+  scaleFactors->Delete();
+  if (newVectors)
+    {
+    outputPD->SetVectors(newVectors);
+    newVectors->Delete();
+    }
+  if (sourceIndices)
+    {
+    outputPD->AddArray(sourceIndices);
+    sourceIndices->Delete();
+    }
+  if (newScalars)
+    {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+    }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -831,6 +1595,9 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Generate Instances: "
+     << (this->GenerateInstances ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -65,9 +65,20 @@
 // color scalars by using the SetInputArrayToProcess methods in
 // vtkAlgorithm. The first array is scalars, the next vectors, the next
 // normals and finally color scalars.
+//
+// When a single glyph is used, the glyphs can be generated on several
+// threads (see SetNumberOfThreads()).  The output is then allocated once
+// and each input point writes its glyph at its own offset, which gives
+// the same output as the serial algorithm.
+//
+// Large numbers of glyphs use a lot of memory.  When GenerateInstances is
+// on, the output only has one point per glyph, at the input point, with
+// the transformation of the glyph and its scalars in the point data, for
+// a mapper that draws the source itself for each point (see
+// SetGenerateInstances()).
 
 // .SECTION See Also
-// vtkTensorGlyph
+// vtkTensorGlyph vtkGlyph3DMapper
 
 #ifndef __vtkGlyph3D_h
 #define __vtkGlyph3D_h
@@ -242,6 +253,31 @@ public:
   void SetSourceTransform(vtkTransform*);
   vtkGetObjectMacro(SourceTransform, vtkTransform);
 
+  // Description:
+  // Set/get the number of threads used to generate the glyphs.  Threads
+  // are only used when indexing is off and the output attributes can be
+  // written concurrently (there are no bit arrays).  Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // Turn on/off the generation of glyph instances instead of glyph
+  // geometry.  When on, the output has one point, and no cell, for each
+  // glyph.  The point is the input point and the point data has the input
+  // point data, the scalars the glyph would have been colored with, and:
+  // \li "GlyphTransform", 16 components: the matrix, in row major order,
+  // transforming the source (SourceTransform included) into the glyph,
+  // \li "GlyphScaleFactors", 3 components: the scale factors of the glyph,
+  // \li "GlyphVector", 3 components, the active vectors: the vector or
+  // normal the glyph is oriented with, when there is one,
+  // \li "GlyphSourceIndex", when indexing is on: the index of the source.
+  // The glyph scale factors and vectors can be used by vtkGlyph3DMapper
+  // with SetScaleModeToScaleByVectorComponents(), a scale factor of 1 and
+  // clamping off.  Defaults to off.
+  vtkSetMacro(GenerateInstances,int);
+  vtkGetMacro(GenerateInstances,int);
+  vtkBooleanMacro(GenerateInstances,int);
+
   // Description:
   // Overridden to include SourceTransform's MTime.
   virtual unsigned long GetMTime();
@@ -256,6 +292,20 @@ protected:
 
   vtkPolyData* GetSource(int idx, vtkInformationVector *sourceInfo);
 
+  // Find the input points that get a glyph, and number them.  glyphIds
+  // receives the number of each point, or -1.  Returns the number of
+  // glyphs.
+  vtkIdType FindGlyphedPoints(vtkDataSet *input, vtkIdType *glyphIds,
+                              unsigned char *inGhostLevels,
+                              int requestedGhostLevel);
+
+  // Generate the glyph instances of RequestData().
+  int RequestInstances(vtkDataSet *input, vtkPolyData *output,
+                       vtkInformationVector *sourceInfo,
+                       vtkDataArray *inSScalars, vtkDataArray *inVectors,
+                       vtkDataArray *inNormals, vtkDataArray *inCScalars,
+                       unsigned char *inGhostLevels, int requestedGhostLevel);
+
   vtkPolyData **Source; // Geometry to copy to each point
   int Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
@@ -270,8 +320,14 @@ protected:
   int FillCellData; // whether to fill output cell data
   char *PointIdsName;
   vtkTransform* SourceTransform;
+  int NumberOfThreads;
+  int GenerateInstances;
 
 private:
+//BTX
+  friend class vtkGlyph3DThreads;
+//ETX
+
   vtkGlyph3D(const vtkGlyph3D&);  // Not implemented.
   void operator=(const vtkGlyph3D&);  // Not implemented.
 };
@@ -18,6 +18,7 @@
 #include "vtkPolyData.h"
 #include "vtkGenericCell.h"
 #include "vtkIdListCollection.h"
+#include "vtkThreadPool.h"
 
 #include <stack>
 #include <vector>
@@ -135,6 +136,37 @@ extern "C" int __compareMax(const void *pA, const void *B )
     }
 }
 
+//---------------------------------------------------------------------------
+// Fill and sort one of the 6 sorted lists: task 2*axis sorts the minima
+// along axis, task 2*axis+1 sorts the maxima.
+struct vtkModifiedBSPTreeSortStruct
+{
+  Sorted_cell_extents_Lists *Lists;
+  double (*CellBounds)[6];
+  vtkIdType NumberOfCells;
+};
+
+static void vtkModifiedBSPTreeSortList(vtkIdType begin, vtkIdType end, int,
+                                       void *arg)
+{
+  vtkModifiedBSPTreeSortStruct *str =
+    static_cast<vtkModifiedBSPTreeSortStruct *>(arg);
+  for (vtkIdType task=begin; task<end; task++)
+    {
+    int i = static_cast<int>(task/2);
+    cell_extents *list = (task%2) ? str->Lists->Maxs[i] : str->Lists->Mins[i];
+    for (vtkIdType j=0; j<str->NumberOfCells; j++)
+      { // loop over each cell
+      list[j].min     = str->CellBounds[j][i*2];   // i=0 xmin, i=1 ymin, i=2 zmin
+      list[j].max     = str->CellBounds[j][i*2+1]; // i=0 xmax, i=1 ymax, i=2 zmax
+      list[j].cell_ID = j;
+      }
+    // Sort
+    qsort( list, str->NumberOfCells, sizeof(cell_extents),
+           (task%2) ? __compareMax : __compareMin );
+    }
+}
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
@@ -212,21 +244,18 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
   //
   // sort the cells into 6 lists using structure for subdividing tests
   Sorted_cell_extents_Lists *lists = new Sorted_cell_extents_Lists(numCells);
-  for (int i=0; i<3; i++)
-    { // loop over each axis
-    for (vtkIdType j=0; j<numCells; j++)
-      { // loop over each cell
-      lists->Mins[i][j].min   = CellBounds[j][i*2];   // i=0 xmin, i=1 ymin, i=2 zmin
-      lists->Mins[i][j].max   = CellBounds[j][i*2+1]; // i=0 xmax, i=1 ymax, i=2 zmax
-      lists->Mins[i][j].cell_ID = j;
-      //
-      lists->Maxs[i][j].min   = CellBounds[j][i*2];
-      lists->Maxs[i][j].max   = CellBounds[j][i*2+1];
-      lists->Maxs[i][j].cell_ID = j;
-      }
-    // Sort
-    qsort( lists->Mins[i], numCells, sizeof(cell_extents), __compareMin) ;
-    qsort( lists->Maxs[i], numCells, sizeof(cell_extents), __compareMax) ;
+  vtkModifiedBSPTreeSortStruct str;
+  str.Lists = lists;
+  str.CellBounds = this->CellBounds;
+  str.NumberOfCells = numCells;
+  if (this->NumberOfThreads > 1)
+    {
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, 6, 1, vtkModifiedBSPTreeSortList, &str);
+    }
+  else
+    {
+    vtkModifiedBSPTreeSortList(0, 6, 0, &str);
     }
   //
   // call the recursive subdivision routine
@@ -92,6 +92,8 @@
 // Cells are only sorted into 6 lists once - before tree creation, each node
 // segments the lists and passes them down to the new child nodes whilst
 // maintaining sorted order. This makes for an efficient subdivision strategy.
+// With NumberOfThreads above one, the cell bounds are computed and the 6
+// lists are sorted concurrently; the subdivision itself remains serial.
 //
 // NB. The following reference has been sent to me
 //   @Article{formella-1995-ray,
@@ -24,9 +24,12 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkThreadPool.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on, 
@@ -41,6 +44,7 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->ComputeCellNormals = 0;
   this->NonManifoldTraversal = 1;
   this->AutoOrientNormals = 0;
+  this->NumberOfThreads = 1;
   // some internal data
   this->NumFlips = 0;
 }
@@ -48,6 +52,324 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+#define VTK_POLY_DATA_NORMALS_BLOCK_SIZE 4096
+
+//----------------------------------------------------------------------------
+// The new points created by splitting a contiguous range of points.  Each
+// new point is recorded with the point it duplicates, and each use of a
+// split point with its position in the connectivity array and the index
+// of its new point in the range.
+struct vtkPolyDataNormalsChunk
+{
+  vtkstd::vector<vtkIdType> OldIds;
+  vtkstd::vector<vtkIdType> Replacements;
+  vtkIdType Offset;
+};
+
+struct vtkPolyDataNormalsThreadStruct
+{
+  vtkPoints *Points;
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  vtkIdType *Connectivity;
+  float *PolyNormals;
+  float *Normals;
+  vtkIdType *Map;
+  vtkIdType NumberOfPoints;
+  double CosAngle;
+  double FlipDirection;
+  vtkPolyDataNormalsChunk *Chunks;
+};
+
+//----------------------------------------------------------------------------
+// Compute the normals of a range of polygons.
+static void vtkPolyDataNormalsComputePolyNormals(vtkIdType begin,
+                                                 vtkIdType end, int,
+                                                 void *arg)
+{
+  vtkPolyDataNormalsThreadStruct *str =
+    static_cast<vtkPolyDataNormalsThreadStruct *>(arg);
+  vtkIdType npts, *pts;
+  double n[3];
+  float *normal = str->PolyNormals + 3*begin;
+
+  for (vtkIdType cellId = begin; cellId < end; cellId++, normal += 3)
+    {
+    str->NewMesh->GetCellPoints(cellId, npts, pts);
+    vtkPolygon::ComputeNormal(str->Points, npts, pts, n);
+    normal[0] = static_cast<float>(n[0]);
+    normal[1] = static_cast<float>(n[1]);
+    normal[2] = static_cast<float>(n[2]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the two points sharing an edge with ptId in a polygon, in the
+// order used by vtkPolyDataNormals::MarkAndSplit().
+static inline void vtkPolyDataNormalsEdgePoints(vtkIdType npts,
+                                                vtkIdType *pts,
+                                                vtkIdType ptId,
+                                                vtkIdType neiPt[2])
+{
+  vtkIdType spot;
+  for (spot=0; spot < npts; spot++)
+    {
+    if ( pts[spot] == ptId )
+      {
+      break;
+      }
+    }
+  if ( spot == 0 )
+    {
+    neiPt[0] = pts[spot+1];
+    neiPt[1] = pts[npts-1];
+    }
+  else if ( spot == (npts-1) )
+    {
+    neiPt[0] = pts[spot-1];
+    neiPt[1] = pts[0];
+    }
+  else
+    {
+    neiPt[0] = pts[spot+1];
+    neiPt[1] = pts[spot-1];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the first position of a cell in the list of cells using a point.
+static inline int vtkPolyDataNormalsFindCell(vtkIdType *cells,
+                                             vtkIdType cellId)
+{
+  int i;
+  for (i=0; cells[i] != cellId; i++)
+    {
+    }
+  return i;
+}
+
+//----------------------------------------------------------------------------
+// Same as vtkPolyDataNormals::MarkAndSplit() for a range of chunks of
+// points, except that the regions of the cells around a point are kept
+// in a local array, indexed by the first position of the cells in the
+// list of cells using the point, and that the new points are recorded in
+// the chunks instead of being written in the mesh.
+static void vtkPolyDataNormalsMarkPoints(vtkIdType begin, vtkIdType end,
+                                         int, void *arg)
+{
+  vtkPolyDataNormalsThreadStruct *str =
+    static_cast<vtkPolyDataNormalsThreadStruct *>(arg);
+  vtkPolyData *oldMesh = str->OldMesh;
+  vtkIdList *cellIds = vtkIdList::New();
+  cellIds->Allocate(VTK_CELL_SIZE);
+  vtkstd::vector<int> regions;
+  unsigned short ncells;
+  vtkIdType *cells, numPts, *pts, neiPt[2], nei, cellId, neiCellId, ptId;
+  float *thisNormal, *neiNormal;
+  int i, j, neiIdx, numRegions;
+
+  for (vtkIdType c = begin; c < end; c++)
+    {
+    vtkPolyDataNormalsChunk *chunk = str->Chunks + c;
+    vtkIdType lastPt = (c+1)*VTK_POLY_DATA_NORMALS_BLOCK_SIZE;
+    if (lastPt > str->NumberOfPoints)
+      {
+      lastPt = str->NumberOfPoints;
+      }
+    for (ptId = c*VTK_POLY_DATA_NORMALS_BLOCK_SIZE; ptId < lastPt; ptId++)
+      {
+      oldMesh->GetPointCells(ptId,ncells,cells);
+      if ( ncells <= 1 )
+        {
+        continue; //point does not need to be further disconnected
+        }
+
+      regions.assign(ncells, -1);
+      numRegions = 0;
+      for (j=0; j<ncells; j++) //for all cells connected to point
+        {
+        if ( regions[vtkPolyDataNormalsFindCell(cells, cells[j])] >= 0 )
+          {
+          continue;
+          }
+        regions[vtkPolyDataNormalsFindCell(cells, cells[j])] = numRegions;
+        oldMesh->GetCellPoints(cells[j],numPts,pts);
+        vtkPolyDataNormalsEdgePoints(numPts, pts, ptId, neiPt);
+
+        for (i=0; i<2; i++) //for each of the two edges of the seed cell
+          {
+          cellId = cells[j];
+          nei = neiPt[i];
+          while ( cellId >= 0 ) //while we can grow this region
+            {
+            oldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+            if ( cellIds->GetNumberOfIds() == 1 &&
+                 regions[(neiIdx=vtkPolyDataNormalsFindCell(
+                            cells, neiCellId=cellIds->GetId(0)))] < 0 )
+              {
+              thisNormal = str->PolyNormals + 3*cellId;
+              neiNormal = str->PolyNormals + 3*neiCellId;
+              if ( (static_cast<double>(thisNormal[0])*neiNormal[0] +
+                    static_cast<double>(thisNormal[1])*neiNormal[1] +
+                    static_cast<double>(thisNormal[2])*neiNormal[2])
+                   > str->CosAngle )
+                {
+                //visit and arrange to visit next edge neighbor
+                regions[neiIdx] = numRegions;
+                cellId = neiCellId;
+                oldMesh->GetCellPoints(cellId,numPts,pts);
+                vtkIdType next[2];
+                vtkPolyDataNormalsEdgePoints(numPts, pts, ptId, next);
+                nei = (next[0] != nei ? next[0] : next[1]);
+                }
+              else
+                {
+                cellId = -1; //separated by edge angle
+                }
+              }
+            else
+              {
+              cellId = -1;//separated by previous visit, boundary, or non-manifold
+              }
+            }
+          }
+        numRegions++;
+        }
+
+      if ( numRegions <= 1 )
+        {
+        continue; //a single region, no splitting ever required
+        }
+
+      // Record a new point for each region but the first one, and the
+      // uses of ptId by the cells of these regions.  A degenerate cell
+      // listed twice has each of its uses of ptId replaced.
+      vtkIdType firstNewPoint =
+        static_cast<vtkIdType>(chunk->OldIds.size()) - 1;
+      for (i=1; i < numRegions; i++)
+        {
+        chunk->OldIds.push_back(ptId);
+        }
+      vtkIdType spot = -1;
+      for (j=0; j<ncells; j++)
+        {
+        int region = regions[vtkPolyDataNormalsFindCell(cells, cells[j])];
+        if ( j == 0 || cells[j] != cells[j-1] )
+          {
+          spot = -1;
+          }
+        if ( region > 0 )
+          {
+          str->NewMesh->GetCellPoints(cells[j],numPts,pts);
+          for (spot++; spot < numPts && pts[spot] != ptId; spot++)
+            {
+            }
+          if ( spot < numPts )
+            {
+            chunk->Replacements.push_back(pts + spot - str->Connectivity);
+            chunk->Replacements.push_back(firstNewPoint + region);
+            }
+          }
+        }
+      }
+    }
+
+  cellIds->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Write the new points of a range of chunks in the point map and in the
+// connectivity array.
+static void vtkPolyDataNormalsSplitPoints(vtkIdType begin, vtkIdType end,
+                                          int, void *arg)
+{
+  vtkPolyDataNormalsThreadStruct *str =
+    static_cast<vtkPolyDataNormalsThreadStruct *>(arg);
+  vtkIdType i;
+
+  for (vtkIdType c = begin; c < end; c++)
+    {
+    vtkPolyDataNormalsChunk *chunk = str->Chunks + c;
+    vtkIdType lastPt = (c+1)*VTK_POLY_DATA_NORMALS_BLOCK_SIZE;
+    if (lastPt > str->NumberOfPoints)
+      {
+      lastPt = str->NumberOfPoints;
+      }
+    for (i = c*VTK_POLY_DATA_NORMALS_BLOCK_SIZE; i < lastPt; i++)
+      {
+      str->Map[i] = i;
+      }
+    vtkIdType numNewPts = static_cast<vtkIdType>(chunk->OldIds.size());
+    for (i = 0; i < numNewPts; i++)
+      {
+      str->Map[chunk->Offset + i] = chunk->OldIds[i];
+      }
+    vtkIdType numReplacements =
+      static_cast<vtkIdType>(chunk->Replacements.size());
+    for (i = 0; i < numReplacements; i += 2)
+      {
+      str->Connectivity[chunk->Replacements[i]] =
+        chunk->Offset + chunk->Replacements[i+1];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the normals of a range of output points by adding the normals
+// of the polygons that use them, in the order of the polygons like the
+// serial algorithm does.
+static void vtkPolyDataNormalsGatherNormals(vtkIdType begin, vtkIdType end,
+                                            int, void *arg)
+{
+  vtkPolyDataNormalsThreadStruct *str =
+    static_cast<vtkPolyDataNormalsThreadStruct *>(arg);
+  unsigned short ncells;
+  vtkIdType *cells, npts, *pts, oldId;
+  float *normal = str->Normals + 3*begin;
+  float *polyNormal;
+  double length;
+  int i, j;
+
+  for (vtkIdType ptId = begin; ptId < end; ptId++, normal += 3)
+    {
+    normal[0] = normal[1] = normal[2] = 0.0f;
+    oldId = (str->Map ? str->Map[ptId] : ptId);
+    str->OldMesh->GetPointCells(oldId,ncells,cells);
+    for (j=0; j < ncells; j++)
+      {
+      if ( j > 0 && cells[j] == cells[j-1] )
+        {
+        continue;
+        }
+      str->NewMesh->GetCellPoints(cells[j],npts,pts);
+      polyNormal = str->PolyNormals + 3*cells[j];
+      for (i=0; i < npts; i++)
+        {
+        if ( pts[i] == ptId )
+          {
+          normal[0] = static_cast<float>(
+            static_cast<double>(normal[0]) + polyNormal[0]);
+          normal[1] = static_cast<float>(
+            static_cast<double>(normal[1]) + polyNormal[1]);
+          normal[2] = static_cast<float>(
+            static_cast<double>(normal[2]) + polyNormal[2]);
+          }
+        }
+      }
+    length = sqrt(static_cast<double>(normal[0])*normal[0] +
+                  static_cast<double>(normal[1])*normal[1] +
+                  static_cast<double>(normal[2])*normal[2]);
+    if ( length != 0.0 )
+      {
+      for (i=0; i < 3; i++)
+        {
+        normal[i] = static_cast<float>(
+          normal[i] / length * str->FlipDirection);
+        }
+      }
+    }
+}
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -83,6 +405,7 @@ int vtkPolyDataNormals::RequestData(
   double n[3];
   vtkCellArray *newPolys;
   vtkIdType ptId, oldId;
+  vtkPolyDataNormalsThreadStruct str;
 
   vtkDebugMacro(<<"Generating surface normals");
 
@@ -158,9 +481,25 @@ int vtkPolyDataNormals::RequestData(
   this->NewMesh->SetPolys(newPolys);
   this->NewMesh->BuildCells(); //builds connectivity
 
+  // Without reordering of the polygons, the normals can be computed on
+  // several threads.
+  int threaded = ( this->NumberOfThreads > 1 && ! this->Consistency &&
+                   ! this->AutoOrientNormals );
+  if ( threaded )
+    {
+    str.Points = inPts;
+    str.OldMesh = this->OldMesh;
+    str.NewMesh = this->NewMesh;
+    str.Connectivity = newPolys->GetPointer();
+    str.Map = NULL;
+    str.NumberOfPoints = numPts;
+    str.Chunks = NULL;
+    }
+
   // The visited array keeps track of which polygons have been visited.
   //
-  if ( this->Consistency || this->Splitting || this->AutoOrientNormals ) 
+  if ( ! threaded &&
+       (this->Consistency || this->Splitting || this->AutoOrientNormals) ) 
     {
     this->Visited = new int[numPolys];
     memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys*sizeof(int));
@@ -316,19 +655,46 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
-       cellId++ )
+  if ( threaded )
     {
-    if ((cellId % 1000) == 0)
+    // The polygons are processed in groups of one block per thread, to
+    // report progress and check for an abort like the serial loop.
+    str.PolyNormals = this->PolyNormals->GetPointer(0);
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    vtkIdType groupSize =
+      VTK_POLY_DATA_NORMALS_BLOCK_SIZE * pool->GetNumberOfThreads();
+    for (cellId=0; cellId < numPolys; cellId += groupSize)
       {
       this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
       if (this->GetAbortExecute())
         {
-        break; 
+        break;
         }
+      vtkIdType lastCell = cellId + groupSize;
+      if (lastCell > numPolys)
+        {
+        lastCell = numPolys;
+        }
+      pool->ParallelFor(cellId, lastCell, VTK_POLY_DATA_NORMALS_BLOCK_SIZE,
+                        vtkPolyDataNormalsComputePolyNormals, &str);
+      }
+    }
+  else
+    {
+    for (cellId=0, newPolys->InitTraversal(); 
+         newPolys->GetNextCell(npts,pts); cellId++ )
+      {
+      if ((cellId % 1000) == 0)
+        {
+        this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
+        if (this->GetAbortExecute())
+          {
+          break; 
+          }
+        }
+      vtkPolygon::ComputeNormal(inPts, npts, pts, n);
+      this->PolyNormals->SetTuple(cellId,n);
       }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
     }
 
   // Split mesh if sharp features
@@ -343,16 +709,42 @@ int vtkPolyDataNormals::RequestData(
     // to map new points into old points.
     //
     this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (i=0; i < numPts; i++)
+    if ( threaded )
       {
-      this->Map->SetId(i,i);
+      // Each chunk of points records its new points in its own buffers.
+      // The new points are then numbered in the order of the chunks, as
+      // the serial traversal of the points would number them.
+      vtkIdType numChunks = (numPts + VTK_POLY_DATA_NORMALS_BLOCK_SIZE - 1) /
+        VTK_POLY_DATA_NORMALS_BLOCK_SIZE;
+      str.CosAngle = this->CosAngle;
+      str.Chunks = new vtkPolyDataNormalsChunk[numChunks];
+      vtkThreadPool::GetGlobalPool()->ParallelFor(
+        0, numChunks, 1, vtkPolyDataNormalsMarkPoints, &str);
+      numNewPts = numPts;
+      for (i=0; i < numChunks; i++)
+        {
+        str.Chunks[i].Offset = numNewPts;
+        numNewPts += static_cast<vtkIdType>(str.Chunks[i].OldIds.size());
+        }
+      this->Map->SetNumberOfIds(numNewPts);
+      str.Map = this->Map->GetPointer(0);
+      vtkThreadPool::GetGlobalPool()->ParallelFor(
+        0, numChunks, 1, vtkPolyDataNormalsSplitPoints, &str);
+      delete [] str.Chunks;
       }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    else
       {
-      this->MarkAndSplit(ptId);
-      }//for all input points
+      this->Map->SetNumberOfIds(numPts);
+      for (i=0; i < numPts; i++)
+        {
+        this->Map->SetId(i,i);
+        }
+
+      for (ptId=0; ptId < numPts; ptId++)
+        {
+        this->MarkAndSplit(ptId);
+        }//for all input points
+      }
 
     numNewPts = this->Map->GetNumberOfIds();
 
@@ -370,7 +762,15 @@ int vtkPolyDataNormals::RequestData(
       newPts->SetPoint(ptId,inPts->GetPoint(oldId));
       outPD->CopyData(pd,oldId,ptId);
       }
-    this->Map->Delete();
+    if ( threaded && this->ComputePointNormals )
+      {
+      // keep the map to gather the point normals
+      str.Map = this->Map->GetPointer(0);
+      }
+    else
+      {
+      this->Map->Delete();
+      }
     } //splitting
 
   else //no splitting, so no new points
@@ -380,7 +780,7 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
     }
 
-  if ( this->Consistency || this->Splitting )
+  if ( ! threaded && (this->Consistency || this->Splitting) )
     {
     delete [] this->Visited;
     this->CellIds->Delete();
@@ -400,14 +800,27 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfComponents(3);
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
-  n[0] = n[1] = n[2] = 0.0;
-  for (i=0; i < numNewPts; i++)
+
+  if ( threaded && this->ComputePointNormals )
     {
-    newNormals->SetTuple(i,n);
+    str.Normals = newNormals->GetPointer(0);
+    str.FlipDirection = flipDirection;
+    vtkThreadPool::GetGlobalPool()->ParallelFor(
+      0, numNewPts, VTK_POLY_DATA_NORMALS_BLOCK_SIZE,
+      vtkPolyDataNormalsGatherNormals, &str);
+    if ( this->Splitting )
+      {
+      this->Map->Delete();
+      }
     }
-
-  if (this->ComputePointNormals)
+  else if (this->ComputePointNormals)
     {
+    n[0] = n[1] = n[2] = 0.0;
+    for (i=0; i < numNewPts; i++)
+      {
+      newNormals->SetTuple(i,n);
+      }
+
     for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
           cellId++ )
       {
@@ -428,12 +841,12 @@ int vtkPolyDataNormals::RequestData(
       {
       newNormals->GetTuple(i, vertNormal);
       length = vtkMath::Norm(vertNormal);
-      if (length != 0.0) 
+      for (j=0; j < 3; j++)
         {
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] / length * flipDirection;
-          }
+        // a point without polygons, or with degenerate ones only, keeps
+        // its zero sum, as in the threaded path
+        n[j] = (length != 0.0 ? vertNormal[j] / length * flipDirection :
+                vertNormal[j]);
         }
       newNormals->SetTuple(i,n);
       }
@@ -729,5 +1142,6 @@ void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ComputeCellNormals ? "On\n" : "Off\n");
   os << indent << "Non-manifold Traversal: " 
      << (this->NonManifoldTraversal ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
@@ -24,6 +24,17 @@
 // averaging them at shared points. When sharp edges are present, the edges
 // are split and new points generated to prevent blurry edges (due to 
 // Gouraud shading).
+//
+// When Consistency and AutoOrientNormals are off, the normals can be
+// computed on several threads (see SetNumberOfThreads()).  The polygon
+// normals are then computed concurrently, the points on feature edges
+// are split in contiguous ranges that record their new points in their
+// own buffers, and the normal of each output point is gathered from the
+// polygons using it.  The output is the same as the one of the serial
+// algorithm.
+//
+// Points that are used by no polygon, or only by degenerate ones, get a
+// zero normal.
 
 // .SECTION Caveats
 // Normals are computed only for polygons and triangle strips. Normals are
@@ -114,6 +125,13 @@ public:
   vtkSetMacro(NonManifoldTraversal,int);
   vtkGetMacro(NonManifoldTraversal,int);
   vtkBooleanMacro(NonManifoldTraversal,int);
+
+  // Description:
+  // Set/get the number of threads used to compute the normals.  Threads
+  // are only used when Consistency and AutoOrientNormals are off.
+  // Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
   
 protected:
   vtkPolyDataNormals();
@@ -131,6 +149,7 @@ protected:
   int ComputePointNormals;
   int ComputeCellNormals;
   int NumFlips;
+  int NumberOfThreads;
 
 private:
   vtkIdList *Wave;
@@ -17,6 +17,7 @@
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkCharArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -24,6 +25,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 
 #include <vtkstd/vector>
 
@@ -38,6 +40,7 @@ class vtkProbeFilter::vtkVectorOfArrays :
 vtkProbeFilter::vtkProbeFilter()
 {
   this->SpatialMatch = 0;
+  this->NumberOfThreads = 1;
   this->ValidPoints = vtkIdTypeArray::New();
   this->MaskPoints = vtkCharArray::New();
   this->MaskPoints->SetNumberOfComponents(1);
@@ -211,6 +214,121 @@ void vtkProbeFilter::Probe(vtkDataSet *input, vtkDataSet *source,
   this->ProbeEmptyPoints(input, 0, source, output);
 }
 
+//----------------------------------------------------------------------------
+// Points are probed on threads in blocks of this many consecutive points.
+// The search of a point starts from the cell of the previous point of its
+// block, so the blocks, not the threads, determine the output.
+#define VTK_PROBE_FILTER_BLOCK_SIZE 1024
+
+struct vtkProbeFilterThreadStruct
+{
+  vtkDataSet *Input;
+  vtkDataSet *Source;
+  vtkPointData *SourcePD;
+  vtkPointData *OutPD;
+  vtkDataSetAttributes::FieldList *PointList;
+  int SourceIndex;
+  vtkstd::vector<vtkDataArray *> InCellArrays;
+  vtkstd::vector<vtkDataArray *> OutCellArrays;
+  vtkstd::vector<vtkDataArray *> OutArrays;
+  char *Mask;
+  double Tol2;
+  int MaxCellSize;
+  bool UseNullPoint;
+  vtkIdType NumberOfPoints;
+};
+
+//----------------------------------------------------------------------------
+// Output tuples are written in place by several threads, which only works
+// for arrays that store whole values per tuple.
+static int vtkProbeFilterCanWriteConcurrently(vtkPointData *outPD)
+{
+  for (int i = 0; i < outPD->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray *array = outPD->GetArray(i);
+    if ( !array || array->GetDataType() == VTK_BIT )
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static void vtkProbeFilterProbeBlocks(vtkIdType begin, vtkIdType end, int,
+                                      void *arg)
+{
+  vtkProbeFilterThreadStruct *str =
+    static_cast<vtkProbeFilterThreadStruct *>(arg);
+  vtkGenericCell *cell = vtkGenericCell::New();
+  double *weights = new double[str->MaxCellSize > 0 ? str->MaxCellSize : 1];
+  double x[3], pcoords[3];
+  int subId;
+  size_t numCellArrays = str->InCellArrays.size();
+
+  for (vtkIdType block = begin; block < end; block++)
+    {
+    vtkIdType ptId = block*VTK_PROBE_FILTER_BLOCK_SIZE;
+    vtkIdType lastId = ptId + VTK_PROBE_FILTER_BLOCK_SIZE;
+    if ( lastId > str->NumberOfPoints )
+      {
+      lastId = str->NumberOfPoints;
+      }
+    // cell holds the cell with id hint while hint >= 0
+    vtkIdType hint = -1;
+    for ( ; ptId < lastId; ptId++)
+      {
+      if ( str->Mask[ptId] == static_cast<char>(1) )
+        {
+        continue;
+        }
+
+      str->Input->GetPoint(ptId, x);
+      vtkIdType cellId = str->Source->FindCell(
+        x, (hint >= 0 ? cell : NULL), cell, hint, str->Tol2, subId, pcoords,
+        weights);
+      if ( cellId >= 0 )
+        {
+        str->Source->GetCell(cellId, cell);
+        str->OutPD->InterpolatePoint((*str->PointList), str->SourcePD,
+                                     str->SourceIndex, ptId,
+                                     cell->PointIds, weights);
+        for (size_t i = 0; i < numCellArrays; i++)
+          {
+          if ( str->InCellArrays[i] )
+            {
+            str->OutPD->CopyTuple(str->InCellArrays[i],
+                                  str->OutCellArrays[i], cellId, ptId);
+            }
+          }
+        // marked as newly probed until the serial pass that follows
+        str->Mask[ptId] = static_cast<char>(2);
+        hint = cellId;
+        }
+      else
+        {
+        hint = -1;
+        if ( str->UseNullPoint )
+          {
+          // vtkPointData::NullPoint() registers the point data through
+          // its iterator and allocates, so null the arrays here.
+          for (size_t i = 0; i < str->OutArrays.size(); i++)
+            {
+            vtkDataArray *array = str->OutArrays[i];
+            for (int j = 0; j < array->GetNumberOfComponents(); j++)
+              {
+              array->SetComponent(ptId, j, 0.0);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  delete [] weights;
+  cell->Delete();
+}
+
 //----------------------------------------------------------------------------
 void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input, 
   int srcIdx,
@@ -268,62 +386,138 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   double minRes2 = minRes * minRes;
   tol2 = tol2 > minRes2 ? minRes2 : tol2;
 
-  // Loop over all input points, interpolating source data
-  //
-  int abort=0;
-  vtkIdType progressInterval=numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abort; ptId++)
+  vtkIdType numBlocks = (numPts + VTK_PROBE_FILTER_BLOCK_SIZE - 1) /
+    VTK_PROBE_FILTER_BLOCK_SIZE;
+  if ( this->NumberOfThreads > 1 && numBlocks > 1 &&
+       vtkProbeFilterCanWriteConcurrently(outPD) )
     {
-    if ( !(ptId % progressInterval) )
+    // The arrays are written in place, so they get their final size first.
+    int i;
+    for (i = 0; i < outPD->GetNumberOfArrays(); i++)
       {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
+      vtkDataArray *array = outPD->GetArray(i);
+      if ( array->GetNumberOfTuples() < numPts )
+        {
+        array->Resize(numPts);
+        array->SetNumberOfTuples(numPts);
+        }
       }
 
-    if (maskArray[ptId] == static_cast<char>(1))
+    vtkProbeFilterThreadStruct str;
+    str.Input = input;
+    str.Source = source;
+    str.SourcePD = pd;
+    str.OutPD = outPD;
+    str.PointList = this->PointList;
+    str.SourceIndex = srcIdx;
+    vtkVectorOfArrays::iterator iter;
+    for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
+      ++iter)
       {
-      // skip points which have already been probed with success.
-      // This is helpful for multiblock dataset probing.
-      continue;
+      str.InCellArrays.push_back(cd->GetArray((*iter)->GetName()));
+      str.OutCellArrays.push_back(*iter);
       }
-
-    // Get the xyz coordinate of the point in the input dataset
-    input->GetPoint(ptId, x);
-
-    // Find the cell that contains xyz and get it
-    vtkIdType cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
-    if (cellId >= 0)
+    str.Mask = maskArray;
+    str.Tol2 = tol2;
+    str.MaxCellSize = mcs;
+    str.UseNullPoint = this->UseNullPoint;
+    for (i = 0; i < outPD->GetNumberOfArrays(); i++)
       {
-      cell = source->GetCell(cellId);
+      str.OutArrays.push_back(outPD->GetArray(i));
       }
-    else
+    str.NumberOfPoints = numPts;
+
+    // Build what the searches share: the bounds and cell types of both
+    // datasets, and the point locator and cell links of point sets, which
+    // a first FindCell() inside the source creates.
+    input->PrepareForThreadedAccess();
+    source->PrepareForThreadedAccess();
+    vtkGenericCell *genCell = vtkGenericCell::New();
+    source->GetCenter(x);
+    source->FindCell(x, NULL, genCell, -1, tol2, subId, pcoords, weights);
+    genCell->Delete();
+
+    // Blocks are probed in groups to report progress.
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    vtkIdType groupSize = numBlocks/10 + 1;
+    for (vtkIdType block = 0; block < numBlocks && !this->GetAbortExecute();
+         block += groupSize)
       {
-      cell = 0;
+      this->UpdateProgress(static_cast<double>(block)/numBlocks);
+      vtkIdType lastBlock = block + groupSize;
+      pool->ParallelFor(block, (lastBlock < numBlocks ? lastBlock : numBlocks),
+                        1, vtkProbeFilterProbeBlocks, &str);
       }
-    if (cell)
+
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      // Interpolate the point data
-      outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
-        cell->PointIds, weights);
-      this->ValidPoints->InsertNextValue(ptId);
-      this->NumberOfValidPoints++;
-      vtkVectorOfArrays::iterator iter;
-      for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
-        ++iter)
+      if (maskArray[ptId] == static_cast<char>(2))
         {
-        vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
-        if (inArray)
-          {
-          outPD->CopyTuple(inArray, *iter, cellId, ptId);
-          }
+        maskArray[ptId] = static_cast<char>(1);
+        this->ValidPoints->InsertNextValue(ptId);
+        this->NumberOfValidPoints++;
         }
-      maskArray[ptId] = static_cast<char>(1);
       }
-    else
+    }
+  else
+    {
+    // Loop over all input points, interpolating source data
+    //
+    int abort=0;
+    vtkIdType progressInterval=numPts/20 + 1;
+    for (ptId=0; ptId < numPts && !abort; ptId++)
       {
-      if (this->UseNullPoint)
+      if ( !(ptId % progressInterval) )
         {
-        outPD->NullPoint(ptId);
+        this->UpdateProgress(static_cast<double>(ptId)/numPts);
+        abort = GetAbortExecute();
+        }
+
+      if (maskArray[ptId] == static_cast<char>(1))
+        {
+        // skip points which have already been probed with success.
+        // This is helpful for multiblock dataset probing.
+        continue;
+        }
+
+      // Get the xyz coordinate of the point in the input dataset
+      input->GetPoint(ptId, x);
+
+      // Find the cell that contains xyz and get it
+      vtkIdType cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
+      if (cellId >= 0)
+        {
+        cell = source->GetCell(cellId);
+        }
+      else
+        {
+        cell = 0;
+        }
+      if (cell)
+        {
+        // Interpolate the point data
+        outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
+          cell->PointIds, weights);
+        this->ValidPoints->InsertNextValue(ptId);
+        this->NumberOfValidPoints++;
+        vtkVectorOfArrays::iterator iter;
+        for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
+          ++iter)
+          {
+          vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
+          if (inArray)
+            {
+            outPD->CopyTuple(inArray, *iter, cellId, ptId);
+            }
+          }
+        maskArray[ptId] = static_cast<char>(1);
+        }
+      else
+        {
+        if (this->UseNullPoint)
+          {
+          outPD->NullPoint(ptId);
+          }
         }
       }
     }
@@ -510,4 +704,5 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ValidPointMaskArrayName: " << (this->ValidPointMaskArrayName?
     this->ValidPointMaskArrayName : "vtkValidPointMask") << "\n";
   os << indent << "ValidPoints: " << this->ValidPoints << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
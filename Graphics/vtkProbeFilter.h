@@ -31,6 +31,12 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// The points can be probed on several threads (see SetNumberOfThreads()).
+// They are then split into blocks of consecutive points that are probed
+// concurrently on the vtkThreadPool.  Within a block the search for each
+// point starts from the cell found for the previous point, since
+// neighbouring probe points usually fall in nearby cells.
 
 #ifndef __vtkProbeFilter_h
 #define __vtkProbeFilter_h
@@ -85,12 +91,21 @@ public:
   vtkSetStringMacro(ValidPointMaskArrayName)
   vtkGetStringMacro(ValidPointMaskArrayName)
 
+  // Description:
+  // Set/get the number of threads used to probe the points.  The source
+  // locator is built once and shared by all threads.  Output arrays that
+  // cannot be written concurrently, such as bit or string arrays, cause
+  // the points to be probed serially.  Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 //BTX 
 protected:
   vtkProbeFilter();
   ~vtkProbeFilter();
 
   int SpatialMatch;
+  int NumberOfThreads;
 
   virtual int RequestData(vtkInformation *, vtkInformationVector **, 
     vtkInformationVector *);
@@ -31,12 +31,14 @@
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredPoints.h"
+#include "vtkThreadPool.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
 
 #include <math.h>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkSynchronizedTemplates3D);
 
@@ -56,6 +58,7 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
     = this->ExecuteExtent[4] = this->ExecuteExtent[5] = 0;
 
   this->ArrayComponent = 0;
+  this->NumberOfThreads = 1;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -250,11 +253,18 @@ if (ComputeScalars) \
 //
 // Contouring filter specialized for images
 //
+// When firstPlane/lastPlane are given, the (edge key, point id) pairs of
+// the x and y edges crossed in the first/last z plane of exExt, and of the
+// samples of these planes that lie on the contour, are appended to them,
+// so that slabs contoured separately can be stitched together.
 template <class T>
 void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
                   vtkInformation *inInfo,
                   vtkImageData *data, vtkPolyData *output, T *ptr, 
-                  vtkDataArray *inScalars)
+                  vtkDataArray *inScalars,
+                  vtkstd::vector<vtkIdType> *firstPlane = NULL,
+                  vtkstd::vector<vtkIdType> *lastPlane = NULL,
+                  int reportProgress = 1)
 {
   int *inExt = data->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
@@ -366,16 +376,23 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
     }
 
   // for each contour
-  for (vidx = 0; vidx < numContours; vidx++)
+  int abortExecute = 0;
+  for (vidx = 0; vidx < numContours && !abortExecute; vidx++)
     {
     value = values[vidx];
     inPtrZ = ptr;
 
     //==================================================================
-    for (k = zMin; k <= zMax; k++)
+    for (k = zMin; k <= zMax && !abortExecute; k++)
       {
-      self->UpdateProgress((double)vidx/numContours + 
-                           (k-zMin)/((zMax - zMin+1.0)*numContours));
+      if (reportProgress)
+        {
+        self->UpdateProgress((double)vidx/numContours + 
+                             (k-zMin)/((zMax - zMin+1.0)*numContours));
+        abortExecute = self->GetAbortExecute();
+        }
+      vtkstd::vector<vtkIdType> *planeEdges =
+        (k == zMin ? firstPlane : (k == zMax ? lastPlane : NULL));
       z = origin[2] + spacing[2]*k;
       x[2] = z;
 
@@ -552,6 +569,34 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
                 }
               }
             }
+          // Remember the edges shared with a neighboring slab.
+          if (planeEdges)
+            {
+            vtkIdType edgeKey = 
+              ((static_cast<vtkIdType>(vidx)*ydim + (j-yMin))*xdim + (i-xMin))*3;
+            if (*isect2Ptr > -1)
+              {
+              planeEdges->push_back(edgeKey);
+              planeEdges->push_back(*isect2Ptr);
+              }
+            if (*(isect2Ptr + 1) > -1)
+              {
+              planeEdges->push_back(edgeKey + 1);
+              planeEdges->push_back(*(isect2Ptr + 1));
+              }
+            // A sample on the contour may only get a point from the z edges
+            // that end on it: the edge below in the last plane, the edge
+            // above in the first plane.
+            if (*s0 == value)
+              {
+              int zEdge = (k == zMax ? *(isect1Ptr + 2) : *(isect2Ptr + 2));
+              if (zEdge > -1)
+                {
+                planeEdges->push_back(edgeKey + 2);
+                planeEdges->push_back(zEdge);
+                }
+              }
+            }
           // To keep track of ids for interpolating attributes.
           ++edgePtId;
           
@@ -636,6 +681,153 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
 
 
 
+//----------------------------------------------------------------------------
+// A z-slab of the execute extent contoured on its own.  Consecutive slabs
+// share one z plane.
+struct vtkSynchronizedTemplates3DSlab
+{
+  int Extent[6];
+  vtkPolyData *Output;
+  vtkstd::vector<vtkIdType> FirstPlane;
+  vtkstd::vector<vtkIdType> LastPlane;
+};
+
+struct vtkSynchronizedTemplates3DThreadStruct
+{
+  vtkSynchronizedTemplates3D *Filter;
+  vtkImageData *Data;
+  vtkInformation *InInfo;
+  vtkDataArray *InScalars;
+  vtkSynchronizedTemplates3DSlab *Slabs;
+};
+
+//----------------------------------------------------------------------------
+static void vtkSynchronizedTemplates3DContourSlabs(vtkIdType begin,
+                                                   vtkIdType end, int,
+                                                   void *arg)
+{
+  vtkSynchronizedTemplates3DThreadStruct *str =
+    static_cast<vtkSynchronizedTemplates3DThreadStruct *>(arg);
+  for (vtkIdType s = begin; s < end; ++s)
+    {
+    vtkSynchronizedTemplates3DSlab *slab = str->Slabs + s;
+    void *ptr = str->Data->GetArrayPointerForExtent(str->InScalars,
+                                                    slab->Extent);
+    switch (str->InScalars->GetDataType())
+      {
+      vtkTemplateMacro(
+        ContourImage(str->Filter, slab->Extent, str->InInfo, str->Data,
+                     slab->Output, (VTK_TT *)ptr, str->InScalars,
+                     &slab->FirstPlane, &slab->LastPlane, 0));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Append the slab outputs to output.  Points that a slab generated on the
+// plane it shares with the previous slab are replaced by the points the
+// previous slab generated on the same edges.
+static void vtkSynchronizedTemplates3DMergeSlabs(
+  vtkSynchronizedTemplates3DSlab *slabs, int numSlabs, vtkPolyData *output)
+{
+  vtkIdType numPts = 0;
+  vtkIdType numCells = 0;
+  int s;
+  for (s = 0; s < numSlabs; s++)
+    {
+    numPts += slabs[s].Output->GetNumberOfPoints();
+    numCells += slabs[s].Output->GetNumberOfCells();
+    }
+
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->Allocate(numPts > 0 ? numPts : 1);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(newPolys->EstimateSize(numCells > 0 ? numCells : 1, 3));
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(slabs[0].Output->GetPointData(), numPts);
+  outCD->CopyAllOn();
+  outCD->CopyAllocate(slabs[0].Output->GetCellData(), numCells);
+
+  vtkIdType *prevMap = NULL;
+  for (s = 0; s < numSlabs; s++)
+    {
+    vtkPolyData *slabOutput = slabs[s].Output;
+    vtkPoints *slabPts = slabOutput->GetPoints();
+    vtkPointData *slabPD = slabOutput->GetPointData();
+    vtkCellData *slabCD = slabOutput->GetCellData();
+    vtkIdType numSlabPts = slabOutput->GetNumberOfPoints();
+    vtkIdType *map = new vtkIdType[numSlabPts > 0 ? numSlabPts : 1];
+    vtkIdType ptId;
+    for (ptId = 0; ptId < numSlabPts; ptId++)
+      {
+      map[ptId] = -1;
+      }
+
+    // Both edge lists are sorted by edge key.
+    if (s > 0)
+      {
+      vtkstd::vector<vtkIdType> &first = slabs[s].FirstPlane;
+      vtkstd::vector<vtkIdType> &last = slabs[s-1].LastPlane;
+      size_t a = 0, b = 0;
+      while (a < first.size() && b < last.size())
+        {
+        if (first[a] < last[b])
+          {
+          a += 2;
+          }
+        else if (last[b] < first[a])
+          {
+          b += 2;
+          }
+        else
+          {
+          map[first[a+1]] = prevMap[last[b+1]];
+          a += 2;
+          b += 2;
+          }
+        }
+      }
+
+    for (ptId = 0; ptId < numSlabPts; ptId++)
+      {
+      if (map[ptId] < 0)
+        {
+        map[ptId] = newPts->InsertNextPoint(slabPts->GetPoint(ptId));
+        outPD->CopyData(slabPD, ptId, map[ptId]);
+        }
+      }
+
+    vtkCellArray *slabPolys = slabOutput->GetPolys();
+    vtkIdType npts, *pts, ptIds[3];
+    vtkIdType cellId = 0, outCellId;
+    for (slabPolys->InitTraversal(); slabPolys->GetNextCell(npts, pts);
+         cellId++)
+      {
+      ptIds[0] = map[pts[0]];
+      ptIds[1] = map[pts[1]];
+      ptIds[2] = map[pts[2]];
+      if (ptIds[0] != ptIds[1] &&
+          ptIds[0] != ptIds[2] &&
+          ptIds[1] != ptIds[2])
+        {
+        outCellId = newPolys->InsertNextCell(3, ptIds);
+        outCD->CopyData(slabCD, cellId, outCellId);
+        }
+      }
+
+    delete [] prevMap;
+    prevMap = map;
+    }
+  delete [] prevMap;
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+}
+
 //----------------------------------------------------------------------------
 void vtkSynchronizedTemplates3D::SetInputMemoryLimit(
   unsigned long vtkNotUsed(limit) )
@@ -697,13 +889,75 @@ void vtkSynchronizedTemplates3D::ThreadedExecute(vtkImageData *data,
     return;
     }
   
-  ptr = data->GetArrayPointerForExtent(inScalars, exExt);
-  switch (inScalars->GetDataType())
+  // Split the extent into z-slabs of at least one cell layer, a couple
+  // per thread so that the pool can balance uneven slabs.
+  int numSlabs = 2*this->NumberOfThreads;
+  if (this->NumberOfThreads <= 1)
+    {
+    numSlabs = 1;
+    }
+  if (numSlabs > exExt[5] - exExt[4])
+    {
+    numSlabs = exExt[5] - exExt[4];
+    }
+
+  if (numSlabs <= 1)
+    {
+    ptr = data->GetArrayPointerForExtent(inScalars, exExt);
+    switch (inScalars->GetDataType())
+      {
+      vtkTemplateMacro(
+        ContourImage(this, exExt, inInfo, data, output, 
+                     (VTK_TT *)ptr, inScalars));
+      }
+    return;
+    }
+
+  vtkSynchronizedTemplates3DSlab *slabs =
+    new vtkSynchronizedTemplates3DSlab[numSlabs];
+  int numLayers = exExt[5] - exExt[4];
+  int s;
+  for (s = 0; s < numSlabs; s++)
+    {
+    vtkSynchronizedTemplates3DSlab *slab = slabs + s;
+    slab->Extent[0] = exExt[0];
+    slab->Extent[1] = exExt[1];
+    slab->Extent[2] = exExt[2];
+    slab->Extent[3] = exExt[3];
+    slab->Extent[4] = exExt[4] + s*numLayers/numSlabs;
+    slab->Extent[5] = exExt[4] + (s+1)*numLayers/numSlabs;
+    slab->Output = vtkPolyData::New();
+    }
+
+  vtkSynchronizedTemplates3DThreadStruct str;
+  str.Filter = this;
+  str.Data = data;
+  str.InInfo = inInfo;
+  str.InScalars = inScalars;
+  str.Slabs = slabs;
+
+  // Slabs are contoured in groups to report progress.
+  vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+  int groupSize = pool->GetNumberOfThreads();
+  for (s = 0; s < numSlabs && !this->GetAbortExecute(); s += groupSize)
+    {
+    this->UpdateProgress(0.9*s/numSlabs);
+    int lastSlab = s + groupSize;
+    pool->ParallelFor(s, (lastSlab < numSlabs ? lastSlab : numSlabs), 1,
+                      vtkSynchronizedTemplates3DContourSlabs, &str);
+    }
+  this->UpdateProgress(0.9);
+
+  if (!this->GetAbortExecute())
+    {
+    vtkSynchronizedTemplates3DMergeSlabs(slabs, numSlabs, output);
+    }
+
+  for (s = 0; s < numSlabs; s++)
     {
-    vtkTemplateMacro(
-      ContourImage(this, exExt, inInfo, data, output, 
-                   (VTK_TT *)ptr, inScalars));
+    slabs[s].Output->Delete();
     }
+  delete [] slabs;
 }
 
 //----------------------------------------------------------------------------
@@ -856,6 +1110,7 @@ void vtkSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 
@@ -19,6 +19,12 @@
 // template algorithm. Note that vtkContourFilter will automatically
 // use this class when appropriate.
 
+// When NumberOfThreads is larger than one, the execute extent is split
+// into z-slabs that are contoured concurrently on the vtkThreadPool and
+// stitched back together, so points on the planes shared by two slabs are
+// not duplicated.  The output then has the same geometry as the serial
+// result but points and triangles come out in slab order.
+
 // .SECTION Caveats
 // This filter is specialized to 3D images (aka volumes).
 
@@ -135,6 +141,12 @@ public:
   vtkSetMacro(ArrayComponent, int);
   vtkGetMacro(ArrayComponent, int);
 
+  // Description:
+  // Set/get the number of threads used to contour the volume.  The
+  // default of 1 keeps the serial algorithm.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkSynchronizedTemplates3D();
   ~vtkSynchronizedTemplates3D();
@@ -151,6 +163,7 @@ protected:
   int ExecuteExtent[6];
 
   int ArrayComponent;
+  int NumberOfThreads;
 
 private:
   vtkSynchronizedTemplates3D(const vtkSynchronizedTemplates3D&);  // Not implemented.
@@ -20,6 +20,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkOutputRecycler.h"
 #include "vtkPointData.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -139,8 +140,7 @@ int vtkThreshold::RequestData(
   numPts = input->GetNumberOfPoints();
   output->Allocate(input->GetNumberOfCells());
 
-  newPoints = vtkPoints::New();
-  newPoints->SetDataType( this->PointsDataType );
+  newPoints = vtkOutputRecycler::NewPoints(output, this->PointsDataType);
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
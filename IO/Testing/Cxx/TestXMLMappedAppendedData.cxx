@@ -0,0 +1,204 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMappedAppendedData.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Write image data with raw appended data, read it back with
+// MapAppendedData on, and compare with the arrays that were written.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <vtkstd/string>
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare the arrays of the given attributes over the extent of the
+// output, which may be a part of the extent of the input.
+static int CompareAttributes(vtkImageData* input, vtkImageData* output,
+                             int cells)
+{
+  vtkDataSetAttributes* inAttributes = input->GetPointData();
+  vtkDataSetAttributes* outAttributes = output->GetPointData();
+  if(cells)
+    {
+    inAttributes = input->GetCellData();
+    outAttributes = output->GetCellData();
+    }
+  int inExt[6], outExt[6];
+  input->GetExtent(inExt);
+  output->GetExtent(outExt);
+  int c = (cells ? 1 : 0);
+  for(int a = 0; a < inAttributes->GetNumberOfArrays(); a++)
+    {
+    vtkDataArray* inArray = inAttributes->GetArray(a);
+    vtkDataArray* outArray = outAttributes->GetArray(inArray->GetName());
+    if(!outArray || outArray->GetDataType() != inArray->GetDataType())
+      {
+      cerr << "Array " << inArray->GetName() << " was not read" << endl;
+      return 1;
+      }
+    vtkIdType outId = 0;
+    for(int k = outExt[4]; k <= outExt[5] - c; k++)
+      {
+      for(int j = outExt[2]; j <= outExt[3] - c; j++)
+        {
+        for(int i = outExt[0]; i <= outExt[1] - c; i++, outId++)
+          {
+          vtkIdType inId = ((k - inExt[4])*(inExt[3] - inExt[2] + 1 - c) +
+                            (j - inExt[2]))*(inExt[1] - inExt[0] + 1 - c) +
+            (i - inExt[0]);
+          for(int comp = 0; comp < inArray->GetNumberOfComponents(); comp++)
+            {
+            if(inArray->GetComponent(inId, comp) !=
+               outArray->GetComponent(outId, comp))
+              {
+              cerr << "Array " << inArray->GetName() << " differs at "
+                   << i << " " << j << " " << k << endl;
+              return 1;
+              }
+            }
+          }
+        }
+      }
+    }
+  return 0;
+}
+
+static int CompareImages(vtkImageData* input, vtkImageData* output)
+{
+  return (CompareAttributes(input, output, 0) +
+          CompareAttributes(input, output, 1));
+}
+
+// Check that the last update of the reader mapped the given number of
+// arrays.
+static int CheckMapped(vtkXMLImageDataReader* reader, int expected)
+{
+  if(reader->GetNumberOfMappedArrays() != expected)
+    {
+    cerr << "Mapped " << reader->GetNumberOfMappedArrays()
+         << " arrays of " << reader->GetFileName() << " instead of "
+         << expected << endl;
+    return 1;
+    }
+  return 0;
+}
+
+int TestXMLMappedAppendedData(int argc, char* argv[])
+{
+  // Arrays of several word sizes so that some of them are aligned in the
+  // file whatever the size of the XML header.
+  VTK_CREATE(vtkImageData, image);
+  image->SetExtent(-3, 16, 2, 19, 0, 15);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  vtkIdType numCells = image->GetNumberOfCells();
+  VTK_CREATE(vtkUnsignedCharArray, bytes);
+  bytes->SetName("Bytes");
+  VTK_CREATE(vtkFloatArray, vectors);
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  VTK_CREATE(vtkDoubleArray, doubles);
+  doubles->SetName("Doubles");
+  for(vtkIdType i = 0; i < numPoints; i++)
+    {
+    bytes->InsertNextValue(static_cast<unsigned char>(i*7 % 251));
+    vectors->InsertNextTuple3(sin(0.1*i), cos(0.1*i), 0.5*i);
+    doubles->InsertNextValue(sqrt(static_cast<double>(i)) + 1e-9*i);
+    }
+  VTK_CREATE(vtkShortArray, shorts);
+  shorts->SetName("Shorts");
+  for(vtkIdType i = 0; i < numCells; i++)
+    {
+    shorts->InsertNextValue(static_cast<short>(i*13 - 20000));
+    }
+  image->GetPointData()->SetScalars(bytes);
+  image->GetPointData()->AddArray(vectors);
+  image->GetPointData()->AddArray(doubles);
+  image->GetCellData()->AddArray(shorts);
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string rawFile = tempDir;
+  rawFile += "/TestXMLMappedAppendedData.vti";
+  vtkstd::string compressedFile = tempDir;
+  compressedFile += "/TestXMLMappedAppendedDataZ.vti";
+  delete [] tempDir;
+  const char* rawName = rawFile.c_str();
+  const char* compressedName = compressedFile.c_str();
+  VTK_CREATE(vtkXMLImageDataWriter, writer);
+  writer->SetInput(image);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressor(0);
+  writer->SetFileName(rawName);
+  writer->Write();
+  VTK_CREATE(vtkZLibDataCompressor, compressor);
+  writer->SetCompressor(compressor);
+  writer->SetFileName(compressedName);
+  writer->Write();
+
+  int errors = 0;
+
+  // Mapped arrays remain valid after the reader is gone, and changes to
+  // them do not reach the file.
+  vtkSmartPointer<vtkImageData> mapped;
+  {
+  VTK_CREATE(vtkXMLImageDataReader, reader);
+  reader->SetFileName(rawName);
+  reader->MapAppendedDataOn();
+  reader->Update();
+  errors += CheckMapped(reader, 4);
+  mapped = reader->GetOutput();
+  }
+  errors += CompareImages(image, mapped);
+  vtkDataArray* mappedBytes = mapped->GetPointData()->GetArray("Bytes");
+  mappedBytes->SetComponent(5, 0, 255 - mappedBytes->GetComponent(5, 0));
+  mapped->GetPointData()->GetArray("Doubles")->SetComponent(0, 0, -1.0);
+  mapped = 0;
+
+  for(int f = 0; f < 2; f++)
+    {
+    VTK_CREATE(vtkXMLImageDataReader, reader);
+    reader->SetFileName(f ? compressedName : rawName);
+    reader->MapAppendedDataOn();
+    reader->Update();
+    errors += CheckMapped(reader, f ? 0 : 4);
+    errors += CompareImages(image, reader->GetOutput());
+
+    // A part of the image is read, not mapped.  A new reader is used so
+    // that the whole output of the first one is not kept.
+    VTK_CREATE(vtkXMLImageDataReader, partReader);
+    partReader->SetFileName(f ? compressedName : rawName);
+    partReader->MapAppendedDataOn();
+    partReader->UpdateInformation();
+    partReader->GetOutput()->SetUpdateExtent(0, 9, 4, 12, 3, 8);
+    partReader->Update();
+    errors += CheckMapped(partReader, 0);
+    errors += CompareImages(image, partReader->GetOutput());
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLWriterCompression.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check vtkLZ4DataCompressor on buffers that exercise the corner cases of
+// the format, and check that vtkXMLWriter writes the same file with any
+// number of compression threads.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadPool.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include "vtksys/SystemTools.hxx"
+
+#include <stdlib.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compress and uncompress a buffer and check that it comes back.
+static int TestRoundTrip(vtkDataCompressor* compressor,
+                         const unsigned char* data, unsigned long size,
+                         const char* name)
+{
+  vtkUnsignedCharArray* compressed = compressor->Compress(data, size);
+  if(!compressed)
+    {
+    cerr << name << ": compression failed" << endl;
+    return 1;
+    }
+  vtkUnsignedCharArray* uncompressed =
+    compressor->Uncompress(compressed->GetPointer(0),
+                           compressed->GetNumberOfTuples(), size);
+  int errors = 0;
+  if(!uncompressed ||
+     static_cast<unsigned long>(uncompressed->GetNumberOfTuples()) != size ||
+     (size && memcmp(uncompressed->GetPointer(0), data, size) != 0))
+    {
+    cerr << name << ": uncompressed data differ" << endl;
+    errors++;
+    }
+  compressed->Delete();
+  if(uncompressed)
+    {
+    uncompressed->Delete();
+    }
+  return errors;
+}
+
+static int TestLZ4()
+{
+  VTK_CREATE(vtkLZ4DataCompressor, compressor);
+  const unsigned long size = 300000;
+  unsigned char* data = new unsigned char[size];
+  int errors = 0;
+
+  // Small sizes around the limits of the format.
+  srand(3);
+  for(unsigned long i = 0; i < size; i++)
+    {
+    data[i] = static_cast<unsigned char>(rand() % 4);
+    }
+  for(unsigned long n = 1; n < 40; n++)
+    {
+    errors += TestRoundTrip(compressor, data, n, "small");
+    }
+
+  // Random data, which do not compress, and data with long runs and
+  // repeats closer and farther than the largest match distance.
+  for(unsigned long i = 0; i < size; i++)
+    {
+    data[i] = static_cast<unsigned char>(rand());
+    }
+  errors += TestRoundTrip(compressor, data, size, "random");
+  for(unsigned long i = 0; i < size; i++)
+    {
+    data[i] = static_cast<unsigned char>((i / 1000) % 3 ? 7 : i % 251);
+    }
+  errors += TestRoundTrip(compressor, data, size, "runs");
+  for(unsigned long i = 70000; i < size; i++)
+    {
+    data[i] = data[i % 70000];
+    }
+  errors += TestRoundTrip(compressor, data, size, "far repeats");
+
+  // Compressible data must shrink, and acceleration must not break them.
+  vtkUnsignedCharArray* compressed = compressor->Compress(data, size);
+  if(!compressed ||
+     static_cast<unsigned long>(compressed->GetNumberOfTuples()) > size/4)
+    {
+    cerr << "Compressible data were not compressed" << endl;
+    errors++;
+    }
+  if(compressed)
+    {
+    compressed->Delete();
+    }
+  compressor->SetAcceleration(8);
+  errors += TestRoundTrip(compressor, data, size, "accelerated");
+
+  delete [] data;
+  return errors;
+}
+
+// A grid of hexahedra with a smooth point array.
+static void BuildGrid(vtkUnstructuredGrid* grid, int dim)
+{
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkDoubleArray, field);
+  field->SetName("Field");
+  for(int k = 0; k < dim; k++)
+    {
+    for(int j = 0; j < dim; j++)
+      {
+      for(int i = 0; i < dim; i++)
+        {
+        points->InsertNextPoint(i, j + 0.01*i*k, k);
+        field->InsertNextValue(0.001*i*j - k);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(field);
+  grid->Allocate((dim-1)*(dim-1)*(dim-1));
+  vtkIdType pts[8];
+  for(int k = 0; k < dim-1; k++)
+    {
+    for(int j = 0; j < dim-1; j++)
+      {
+      for(int i = 0; i < dim-1; i++)
+        {
+        pts[0] = (k*dim + j)*dim + i;
+        pts[1] = pts[0] + 1;
+        pts[2] = pts[1] + dim;
+        pts[3] = pts[0] + dim;
+        for(int p = 0; p < 4; p++)
+          {
+          pts[p+4] = pts[p] + dim*dim;
+          }
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, pts);
+        }
+      }
+    }
+}
+
+int TestXMLWriterCompression(int, char*[])
+{
+  int errors = TestLZ4();
+
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+  VTK_CREATE(vtkUnstructuredGrid, grid);
+  BuildGrid(grid, 30);
+
+  // Small blocks, byte swapping and 32-bit ids exercise all the
+  // conversions done before compression.
+  const char* names[2] = { "TestXMLWriterCompression1.vtu",
+                           "TestXMLWriterCompression2.vtu" };
+  for(int c = 0; c < 2; c++)
+    {
+    for(int t = 0; t < 2; t++)
+      {
+      VTK_CREATE(vtkXMLUnstructuredGridWriter, writer);
+      writer->SetInput(grid);
+      writer->SetFileName(names[t]);
+      if(c)
+        {
+        writer->SetCompressorTypeToLZ4();
+        }
+      writer->SetBlockSize(1024);
+      writer->SetByteOrderToBigEndian();
+      writer->SetIdTypeToInt32();
+      writer->SetNumberOfThreads(t ? 4 : 1);
+      writer->Write();
+      }
+    if(vtksys::SystemTools::FilesDiffer(names[0], names[1]))
+      {
+      cerr << "Compressor " << c << ": the threaded writer wrote another file"
+           << endl;
+      errors++;
+      }
+
+    VTK_CREATE(vtkXMLUnstructuredGridReader, reader);
+    reader->SetFileName(names[1]);
+    reader->Update();
+    vtkUnstructuredGrid* output = reader->GetOutput();
+    vtkDataArray* field = output->GetPointData()->GetArray("Field");
+    if(output->GetNumberOfPoints() != grid->GetNumberOfPoints() ||
+       output->GetNumberOfCells() != grid->GetNumberOfCells() || !field)
+      {
+      cerr << "Compressor " << c << ": the file was not read back" << endl;
+      errors++;
+      continue;
+      }
+    vtkIdType npts1, npts2, *pts1, *pts2;
+    for(vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); cellId++)
+      {
+      grid->GetCellPoints(cellId, npts1, pts1);
+      output->GetCellPoints(cellId, npts2, pts2);
+      if(npts1 != npts2 || memcmp(pts1, pts2, npts1*sizeof(vtkIdType)) != 0)
+        {
+        cerr << "Compressor " << c << ": cell " << cellId << " differs"
+             << endl;
+        errors++;
+        break;
+        }
+      }
+    vtkDataArray* expected = grid->GetPointData()->GetArray("Field");
+    for(vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ptId++)
+      {
+      if(field->GetTuple1(ptId) != expected->GetTuple1(ptId))
+        {
+        cerr << "Compressor " << c << ": point " << ptId << " differs"
+             << endl;
+        errors++;
+        break;
+        }
+      }
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
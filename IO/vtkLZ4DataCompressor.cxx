@@ -0,0 +1,299 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4DataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4DataCompressor.h"
+#include "vtkObjectFactory.h"
+
+#include <string.h>
+
+vtkStandardNewMacro(vtkLZ4DataCompressor);
+
+// An LZ4 block is a sequence of (literals, match) pairs.  Each starts
+// with a token holding the literal length in its high 4 bits and the
+// match length minus 4 in its low 4 bits; a value of 15 continues in the
+// following bytes, 255 at a time.  The literals come next, then the
+// distance of the match as 2 bytes, little-endian.  The last sequence has
+// only literals: the last 5 bytes of the data are always literals, and no
+// match starts in the last 12 bytes.
+#define VTK_LZ4_MIN_MATCH 4
+#define VTK_LZ4_LAST_LITERALS 5
+#define VTK_LZ4_MATCH_FIND_LIMIT 12
+#define VTK_LZ4_MAX_DISTANCE 65535
+#define VTK_LZ4_HASH_LOG 12
+
+//----------------------------------------------------------------------------
+static inline vtkTypeUInt32 vtkLZ4Read32(const unsigned char* p)
+{
+  vtkTypeUInt32 value;
+  memcpy(&value, p, 4);
+  return value;
+}
+
+//----------------------------------------------------------------------------
+static inline unsigned int vtkLZ4Hash(vtkTypeUInt32 sequence)
+{
+  return (sequence*2654435761U) >> (32 - VTK_LZ4_HASH_LOG);
+}
+
+//----------------------------------------------------------------------------
+static inline unsigned char* vtkLZ4WriteLength(unsigned char* op,
+                                               unsigned long length)
+{
+  for(; length >= 255; length -= 255)
+    {
+    *op++ = 255;
+    }
+  *op++ = static_cast<unsigned char>(length);
+  return op;
+}
+
+//----------------------------------------------------------------------------
+// Write a sequence and return the new output position.
+static inline unsigned char* vtkLZ4WriteSequence(unsigned char* op,
+                                                 const unsigned char* literals,
+                                                 unsigned long numLiterals,
+                                                 unsigned long distance,
+                                                 unsigned long matchLength)
+{
+  unsigned char* token = op++;
+  *token = static_cast<unsigned char>(
+    (numLiterals < 15 ? numLiterals : 15) << 4);
+  if(numLiterals >= 15)
+    {
+    op = vtkLZ4WriteLength(op, numLiterals - 15);
+    }
+  memcpy(op, literals, numLiterals);
+  op += numLiterals;
+  if(distance)
+    {
+    *op++ = static_cast<unsigned char>(distance & 0xff);
+    *op++ = static_cast<unsigned char>(distance >> 8);
+    matchLength -= VTK_LZ4_MIN_MATCH;
+    *token |= static_cast<unsigned char>(matchLength < 15 ? matchLength : 15);
+    if(matchLength >= 15)
+      {
+      op = vtkLZ4WriteLength(op, matchLength - 15);
+      }
+    }
+  return op;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::vtkLZ4DataCompressor()
+{
+  this->Acceleration = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::~vtkLZ4DataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4DataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Acceleration: " << this->Acceleration << endl;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::CompressBuffer(const unsigned char* uncompressedData,
+                                     unsigned long uncompressedSize,
+                                     unsigned char* compressedData,
+                                     unsigned long compressionSpace)
+{
+  if(compressionSpace < this->GetMaximumCompressionSpace(uncompressedSize))
+    {
+    vtkErrorMacro("Not enough space for LZ4 compression.");
+    return 0;
+    }
+
+  const unsigned char* base = uncompressedData;
+  const unsigned char* end = base + uncompressedSize;
+  const unsigned char* anchor = base;
+  unsigned char* op = compressedData;
+
+  if(uncompressedSize > VTK_LZ4_MATCH_FIND_LIMIT)
+    {
+    // Positions of the last sequences of 4 bytes with each hash.  The
+    // table starts at the first position, which is never a match for
+    // itself.
+    vtkTypeUInt32 table[1 << VTK_LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
+    const unsigned char* matchFindLimit = end - VTK_LZ4_MATCH_FIND_LIMIT;
+    const unsigned char* matchLimit = end - VTK_LZ4_LAST_LITERALS;
+    const unsigned char* ip = base + 1;
+    unsigned int searches = this->Acceleration << 6;
+    while(ip < matchFindLimit)
+      {
+      vtkTypeUInt32 sequence = vtkLZ4Read32(ip);
+      unsigned int h = vtkLZ4Hash(sequence);
+      const unsigned char* ref = base + table[h];
+      table[h] = static_cast<vtkTypeUInt32>(ip - base);
+      if(ip - ref > VTK_LZ4_MAX_DISTANCE || vtkLZ4Read32(ref) != sequence)
+        {
+        // Skip faster and faster over data that do not compress.
+        ip += searches++ >> 6;
+        continue;
+        }
+
+      // Extend the match backward over the pending literals, then
+      // forward up to the last literals.
+      while(ip > anchor && ref > base && ip[-1] == ref[-1])
+        {
+        --ip;
+        --ref;
+        }
+      const unsigned char* matchEnd = ip + VTK_LZ4_MIN_MATCH;
+      const unsigned char* refEnd = ref + VTK_LZ4_MIN_MATCH;
+      while(matchEnd < matchLimit && *matchEnd == *refEnd)
+        {
+        ++matchEnd;
+        ++refEnd;
+        }
+
+      op = vtkLZ4WriteSequence(op, anchor, ip - anchor, ip - ref,
+                               matchEnd - ip);
+      if(matchEnd - 2 > base)
+        {
+        table[vtkLZ4Hash(vtkLZ4Read32(matchEnd - 2))] =
+          static_cast<vtkTypeUInt32>(matchEnd - 2 - base);
+        }
+      ip = anchor = matchEnd;
+      searches = this->Acceleration << 6;
+      }
+    }
+
+  // The remaining bytes are literals.
+  op = vtkLZ4WriteSequence(op, anchor, end - anchor, 0, 0);
+  return op - compressedData;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::UncompressBuffer(const unsigned char* compressedData,
+                                       unsigned long compressedSize,
+                                       unsigned char* uncompressedData,
+                                       unsigned long uncompressedSize)
+{
+  const unsigned char* ip = compressedData;
+  const unsigned char* inEnd = ip + compressedSize;
+  unsigned char* op = uncompressedData;
+  unsigned char* outEnd = op + uncompressedSize;
+
+  while(ip < inEnd)
+    {
+    // Copy the literals.
+    unsigned int token = *ip++;
+    unsigned long length = token >> 4;
+    if(length == 15)
+      {
+      unsigned char b;
+      do
+        {
+        if(ip >= inEnd)
+          {
+          vtkErrorMacro("LZ4 data is truncated.");
+          return 0;
+          }
+        b = *ip++;
+        length += b;
+        }
+      while(b == 255);
+      }
+    if(length > static_cast<unsigned long>(inEnd - ip) ||
+       length > static_cast<unsigned long>(outEnd - op))
+      {
+      vtkErrorMacro("LZ4 data is corrupted.");
+      return 0;
+      }
+    memcpy(op, ip, length);
+    op += length;
+    ip += length;
+
+    // The last sequence has no match.
+    if(ip == inEnd)
+      {
+      break;
+      }
+
+    // Copy the match, which may overlap the output.
+    if(inEnd - ip < 2)
+      {
+      vtkErrorMacro("LZ4 data is truncated.");
+      return 0;
+      }
+    unsigned long distance = ip[0] | (ip[1] << 8);
+    ip += 2;
+    length = token & 15;
+    if(length == 15)
+      {
+      unsigned char b;
+      do
+        {
+        if(ip >= inEnd)
+          {
+          vtkErrorMacro("LZ4 data is truncated.");
+          return 0;
+          }
+        b = *ip++;
+        length += b;
+        }
+      while(b == 255);
+      }
+    length += VTK_LZ4_MIN_MATCH;
+    if(distance == 0 ||
+       distance > static_cast<unsigned long>(op - uncompressedData) ||
+       length > static_cast<unsigned long>(outEnd - op))
+      {
+      vtkErrorMacro("LZ4 data is corrupted.");
+      return 0;
+      }
+    const unsigned char* ref = op - distance;
+    if(distance >= length)
+      {
+      memcpy(op, ref, length);
+      op += length;
+      }
+    else
+      {
+      for(unsigned char* matchEnd = op + length; op < matchEnd;)
+        {
+        *op++ = *ref++;
+        }
+      }
+    }
+
+  // Make sure the output size matched that expected.
+  unsigned long decSize = op - uncompressedData;
+  if(decSize != uncompressedSize)
+    {
+    vtkErrorMacro("Decompression produced incorrect size.\n"
+                  "Expected " << uncompressedSize << " and got " << decSize);
+    return 0;
+    }
+
+  return decSize;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::GetMaximumCompressionSpace(unsigned long size)
+{
+  // Data that do not compress take one extra byte per 255 literals, plus
+  // the token.
+  return size + size/255 + 16;
+}
@@ -911,6 +911,44 @@ vtkXMLDataParser::ReadAppendedData(OffsetType offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::FindRawAppendedData(OffsetType offset, int wordType,
+                                          OffsetType& position,
+                                          OffsetType& numWords)
+{
+  // The words must be stored as they are in memory.
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(this->Compressor || this->ByteOrder != nativeByteOrder ||
+     !this->AppendedDataPosition ||
+     this->AppendedDataStream->IsA("vtkBase64InputStream"))
+    {
+    return 0;
+    }
+
+  // Read the length of the data.
+  HeaderType rsize;
+  const unsigned long len = sizeof(HeaderType);
+  unsigned char* p = reinterpret_cast<unsigned char*>(&rsize);
+  this->DataStream = this->AppendedDataStream;
+  this->SeekG(this->AppendedDataPosition+offset);
+  this->DataStream->SetStream(this->Stream);
+  this->DataStream->StartReading();
+  int result = (this->DataStream->Read(p, len) == len);
+  this->DataStream->EndReading();
+  if(!result)
+    {
+    return 0;
+    }
+
+  position = this->AppendedDataPosition + offset + len;
+  numWords = rsize/this->GetWordTypeSize(wordType);
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
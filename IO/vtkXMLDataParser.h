@@ -79,6 +79,16 @@ public:
     { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  // Description:
+  // Find an appended data block that is stored raw, uncompressed and in
+  // the byte order of this machine, so that it can be used in place.
+  // On success, position is set to the offset in the input stream of the
+  // first word of the block, numWords to the number of words in the
+  // block, and 1 is returned.  Returns 0 when the block has to be read
+  // with ReadAppendedData.
+  int FindRawAppendedData(OffsetType offset, int wordType,
+                          OffsetType& position, OffsetType& numWords);
+
   // Description:
   // Read from an ascii data section starting at the current position in
   // the stream.  Returns the number of words read.
@@ -19,6 +19,7 @@
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
 #include "vtkDataArraySelection.h"
+#include "vtkDataArrayTemplate.h"
 #include "vtkDataSet.h"
 #include "vtkPointData.h"
 #include "vtkXMLDataElement.h"
@@ -29,6 +30,14 @@
 
 #include "assert.h"
 
+#ifdef _WIN32
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 //----------------------------------------------------------------------------
 vtkXMLDataReader::vtkXMLDataReader()
@@ -40,6 +49,8 @@ vtkXMLDataReader::vtkXMLDataReader()
   this->NumberOfPointArrays = 0;
   this->NumberOfCellArrays = 0;
   this->InReadData = 0;
+  this->MapAppendedData = 0;
+  this->NumberOfMappedArrays = 0;
   
   // Setup a callback for when the XMLParser's data reading routines
   // report progress.
@@ -81,6 +92,9 @@ vtkXMLDataReader::~vtkXMLDataReader()
 void vtkXMLDataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MapAppendedData: " << this->MapAppendedData << "\n";
+  os << indent << "NumberOfMappedArrays: " << this->NumberOfMappedArrays
+     << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -315,6 +329,7 @@ void vtkXMLDataReader::DestroyPieces()
 void vtkXMLDataReader::SetupOutputData()
 {
   this->Superclass::SetupOutputData();
+  this->NumberOfMappedArrays = 0;
   
   vtkDataSet* output = vtkDataSet::SafeDownCast(this->GetCurrentOutput());
   vtkPointData* pointData = output->GetPointData();
@@ -760,6 +775,16 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     }
   this->InReadData = 1;
   int result;
+
+  // Whole arrays may be mapped from the file instead of read.
+  if(this->MapAppendedData && arrayIndex == 0 && startIndex == 0 &&
+     numValues == array->GetNumberOfTuples()*array->GetNumberOfComponents() &&
+     this->MapArrayValues(da, array, numValues))
+    {
+    this->InReadData = 0;
+    return 1;
+    }
+
   // All arrays types except vtkBitArray.
   vtkArrayIterator* iter = array->NewIterator();
   switch (array->GetDataType())
@@ -778,6 +803,155 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
   return result;
 }
 
+//----------------------------------------------------------------------------
+// A region of a file mapped in memory.
+struct vtkXMLDataReaderMapping
+{
+  void* Base;
+  size_t Length;
+};
+
+//----------------------------------------------------------------------------
+static void vtkXMLDataReaderUnmap(void* clientData)
+{
+  vtkXMLDataReaderMapping* mapping =
+    static_cast<vtkXMLDataReaderMapping*>(clientData);
+#ifdef _WIN32
+  UnmapViewOfFile(mapping->Base);
+#else
+  munmap(mapping->Base, mapping->Length);
+#endif
+  delete mapping;
+}
+
+//----------------------------------------------------------------------------
+// Map length bytes of the file starting at position.  The pages are copied
+// on write so that changes never reach the file.  Returns a pointer to the
+// first byte, or 0 on failure.
+static void* vtkXMLDataReaderMap(const char* fileName,
+                                 vtkTypeUInt64 position, size_t length,
+                                 vtkXMLDataReaderMapping** mapping)
+{
+  void* base;
+  vtkTypeUInt64 start;
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if(file == INVALID_HANDLE_VALUE)
+    {
+    return 0;
+    }
+  HANDLE fileMapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+  CloseHandle(file);
+  if(!fileMapping)
+    {
+    return 0;
+    }
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  start = position - position % info.dwAllocationGranularity;
+  size_t mapLength = static_cast<size_t>(position - start) + length;
+  base = MapViewOfFile(fileMapping, FILE_MAP_COPY,
+                       static_cast<DWORD>(start >> 32),
+                       static_cast<DWORD>(start & 0xffffffff), mapLength);
+  CloseHandle(fileMapping);
+  if(!base)
+    {
+    return 0;
+    }
+#else
+  int fd = open(fileName, O_RDONLY);
+  if(fd < 0)
+    {
+    return 0;
+    }
+  // Touching pages past the end of the file would raise SIGBUS.
+  struct stat fs;
+  if(fstat(fd, &fs) != 0 ||
+     static_cast<vtkTypeUInt64>(fs.st_size) < position + length)
+    {
+    close(fd);
+    return 0;
+    }
+  start = position - position % sysconf(_SC_PAGESIZE);
+  size_t mapLength = static_cast<size_t>(position - start) + length;
+  base = mmap(0, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+              static_cast<off_t>(start));
+  close(fd);
+  if(base == MAP_FAILED)
+    {
+    return 0;
+    }
+#endif
+  *mapping = new vtkXMLDataReaderMapping;
+  (*mapping)->Base = base;
+  (*mapping)->Length = mapLength;
+  return static_cast<char*>(base) + (position - start);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkXMLDataReaderSetMappedArray(vtkDataArray* array, T* data,
+                                    vtkIdType numValues,
+                                    vtkXMLDataReaderMapping* mapping)
+{
+  vtkDataArrayTemplate<T>* a = static_cast<vtkDataArrayTemplate<T>*>(array);
+  a->SetArray(data, numValues, 0,
+              vtkDataArrayTemplate<T>::VTK_DATA_ARRAY_USER_DEFINED);
+  a->SetArrayFreeFunction(&vtkXMLDataReaderUnmap, mapping);
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataReader::MapArrayValues(vtkXMLDataElement* da,
+                                     vtkAbstractArray* array,
+                                     vtkIdType numValues)
+{
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  if(!dataArray || dataArray->GetDataType() == VTK_BIT || numValues <= 0 ||
+     !da->GetAttribute("offset") || !this->IsReadingFile())
+    {
+    return 0;
+    }
+
+  // The block must hold all the values, each at an address aligned for
+  // its type.
+  unsigned long offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  vtkXMLDataParser::OffsetType position;
+  vtkXMLDataParser::OffsetType numWords;
+  int wordSize = dataArray->GetDataTypeSize();
+  if(!this->XMLParser->FindRawAppendedData(offset, dataArray->GetDataType(),
+                                           position, numWords) ||
+     numWords < numValues || position % wordSize != 0)
+    {
+    return 0;
+    }
+
+  vtkXMLDataReaderMapping* mapping = 0;
+  void* data = vtkXMLDataReaderMap(this->FileName, position,
+                                   static_cast<size_t>(numValues)*wordSize,
+                                   &mapping);
+  if(!data)
+    {
+    return 0;
+    }
+  vtkDebugMacro("Mapped " << numValues << " values of array "
+                << (dataArray->GetName()? dataArray->GetName() : "")
+                << " from offset " << position);
+
+  switch(dataArray->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkXMLDataReaderSetMappedArray(dataArray, static_cast<VTK_TT*>(data),
+                                     numValues, mapping));
+    default:
+      vtkXMLDataReaderUnmap(mapping);
+      return 0;
+    }
+  ++this->NumberOfMappedArrays;
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLDataReader::DataProgressCallbackFunction(vtkObject*, unsigned long,
                                                     void* clientdata, void*)
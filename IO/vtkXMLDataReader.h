@@ -44,6 +44,25 @@ public:
   // SetupOutputInformation to outInfo
   virtual void CopyOutputInformation(vtkInformation *outInfo, int port);
 
+  // Description:
+  // Get/Set whether arrays stored raw and uncompressed in the appended
+  // data section of a file are memory mapped instead of read.  A mapped
+  // array uses the pages of the file in place: reading is immediate, the
+  // operating system loads the data when it is first accessed, and
+  // processes that map the same file share the memory.  Changes to a
+  // mapped array are private to it, but the file must not be modified or
+  // truncated while the array exists.  Arrays that are encoded, swapped,
+  // compressed, not aligned in the file, or only partly read, are always
+  // read.  The default is off.
+  vtkSetMacro(MapAppendedData, int);
+  vtkGetMacro(MapAppendedData, int);
+  vtkBooleanMacro(MapAppendedData, int);
+
+  // Description:
+  // Get the number of arrays that the last update mapped from the file
+  // instead of reading them.
+  vtkGetMacro(NumberOfMappedArrays, int);
+
 protected:
   vtkXMLDataReader();
   ~vtkXMLDataReader();  
@@ -87,6 +106,11 @@ protected:
   // values will be put in the array.
   int ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues);
+
+  // Try to replace the storage of the array with a memory mapping of its
+  // appended data.  Returns 0 if the array has to be read.
+  int MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array,
+                     vtkIdType numValues);
     
 
   
@@ -114,6 +138,12 @@ protected:
   // Flag for whether DataProgressCallback should actually update
   // progress.
   int InReadData;
+
+  // Whether raw appended data are memory mapped.
+  int MapAppendedData;
+
+  // The number of arrays mapped by the current update.
+  int NumberOfMappedArrays;
   
   // The observer to report progress from reading data from XMLParser.
   vtkCallbackCommand* DataProgressObserver;  
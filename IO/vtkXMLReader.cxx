@@ -24,6 +24,7 @@
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
 #include "vtkXMLFileReadTester.h"
+#include "vtkLZ4DataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -296,12 +297,16 @@ void vtkXMLReader::SetupCompressor(const char* type)
   vtkObject* object = vtkInstantiator::CreateInstance(type);
   vtkDataCompressor* compressor = vtkDataCompressor::SafeDownCast(object);
   
-  // In static builds, the vtkZLibDataCompressor may not have been
-  // registered with the vtkInstantiator.  Check for it here.
+  // In static builds, the compressors may not have been registered
+  // with the vtkInstantiator.  Check for them here.
   if(!compressor && (strcmp(type, "vtkZLibDataCompressor") == 0))
     {
     compressor = vtkZLibDataCompressor::New();
     }
+  if(!compressor && (strcmp(type, "vtkLZ4DataCompressor") == 0))
+    {
+    compressor = vtkLZ4DataCompressor::New();
+    }
   
   if(!compressor)
     {
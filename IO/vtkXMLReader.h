@@ -201,6 +201,11 @@ protected:
   
   // The stream used to read the input.
   istream* Stream;
+
+  // Whether Stream is the file named by FileName, as opposed to a
+  // stream given by the user.
+  int IsReadingFile()
+    { return this->FileStream && this->Stream == this->FileStream; }
   
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
@@ -24,11 +24,13 @@
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkLZ4DataCompressor.h"
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZLibDataCompressor.h"
 #define vtkOffsetsManager_DoNotInclude
@@ -42,6 +44,7 @@
 
 #include <assert.h>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 # include <unistd.h> /* unlink */
@@ -79,6 +82,19 @@ public:
    {
    return writer->ByteSwapBuffer;
    }
+ static inline int WriteBinaryDataBlocksThreaded(vtkXMLWriter* writer,
+   unsigned char* in_data, vtkXMLWriter::OffsetType numWords,
+   vtkXMLWriter::OffsetType blockWords, vtkXMLWriter::OffsetType memWordSize,
+   int wordType)
+   {
+   return writer->WriteBinaryDataBlocksThreaded(in_data, numWords,
+     blockWords, memWordSize, wordType);
+   }
+ static inline void PerformByteSwap(vtkXMLWriter* writer, void* data,
+   vtkXMLWriter::OffsetType numWords, int wordSize)
+   {
+   writer->PerformByteSwap(data, numWords, wordSize);
+   }
 };
 
 //----------------------------------------------------------------------------
@@ -96,6 +112,14 @@ int vtkXMLWriterWriteBinaryDataBlocks(vtkXMLWriter* writer,
   unsigned char* ptr = reinterpret_cast<unsigned char*>(iter->GetTuple(0));
   vtkXMLWriter::OffsetType wordsLeft = numWords;
 
+  // Compress several blocks at a time if there are several.
+  if(writer->GetCompressor() && writer->GetNumberOfThreads() > 1 &&
+     numWords > blockWords)
+    {
+    return vtkXMLWriterHelper::WriteBinaryDataBlocksThreaded(writer, ptr,
+      numWords, blockWords, memWordSize, wordType);
+    }
+
   // Do the complete blocks.
   vtkXMLWriterHelper::SetProgressPartial(writer, 0);
   int result = 1;
@@ -244,6 +268,7 @@ vtkXMLWriter::vtkXMLWriter()
   this->CompressionHeader = 0;
   this->Int32IdTypeBuffer = 0;
   this->ByteSwapBuffer = 0;
+  this->NumberOfThreads = 1;
 
   this->EncodeAppendedData = 1;
   this->AppendedDataPosition = 0;
@@ -304,6 +329,18 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     this->Modified();
     return;
     }
+
+  if (compressorType == LZ4)
+    {
+    if (this->Compressor && this->Compressor->IsA("vtkLZ4DataCompressor"))
+      {
+      return;
+      }
+    vtkLZ4DataCompressor* compressor = vtkLZ4DataCompressor::New();
+    this->SetCompressor(compressor);
+    compressor->Delete();
+    return;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -350,6 +387,7 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
   if(this->Stream)
     {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -1095,11 +1133,13 @@ int vtkXMLWriter::WriteBinaryDataInternal(vtkAbstractArray* a,
     }
 
 #ifdef VTK_USE_64BIT_IDS
-  // Free the id-type conversion buffer if it was allocated.
+  // Free the id-type conversion buffer if it was allocated.  The byte
+  // swap buffer may point into it.
   if(this->Int32IdTypeBuffer)
     {
     delete [] this->Int32IdTypeBuffer;
     this->Int32IdTypeBuffer = 0;
+    this->ByteSwapBuffer = 0;
     }
 #endif
   return ret;
@@ -1279,13 +1319,25 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data,
 {
   // Compress the data.
   vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
+  if(!outputArray)
+    {
+    return 0;
+    }
+
+  // Write the compressed data.
+  int result = this->WriteCompressedBlock(outputArray->GetPointer(0),
+                                          outputArray->GetNumberOfTuples());
+
+  outputArray->Delete();
 
-  // Find the compressed size.
-  HeaderType outputSize = outputArray->GetNumberOfTuples();
-  unsigned char* outputPointer = outputArray->GetPointer(0);
+  return result;
+}
 
+//----------------------------------------------------------------------------
+int vtkXMLWriter::WriteCompressedBlock(unsigned char* data, HeaderType size)
+{
   // Write the compressed data.
-  int result = this->DataStream->Write(outputPointer, outputSize);
+  int result = this->DataStream->Write(data, size);
   this->Stream->flush();
   if (this->Stream->fail())
     {
@@ -1293,10 +1345,125 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data,
     }
 
   // Store the resulting compressed size in the compression header.
-  this->CompressionHeader[3+this->CompressionBlockNumber++] = outputSize;
+  this->CompressionHeader[3+this->CompressionBlockNumber++] = size;
 
-  outputArray->Delete();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+// The blocks of a batch compressed on several threads.
+struct vtkXMLWriterCompressBlocksData
+{
+  vtkXMLWriter* Writer;
+  vtkDataCompressor* Compressor;
+  unsigned char* Input;
+  vtkXMLWriter::OffsetType NumberOfWords;
+  vtkXMLWriter::OffsetType BlockWords;
+  vtkXMLWriter::OffsetType MemBlockSize;
+  vtkXMLWriter::OffsetType OutWordSize;
+  int ConvertIds;
+  int Swap;
+  vtkIdType FirstBlock;
+  vtkstd::vector<vtkstd::vector<unsigned char> > Outputs;
+  vtkstd::vector<unsigned long> OutputSizes;
+};
 
+//----------------------------------------------------------------------------
+// Convert, swap and compress the blocks in [begin, end).
+static void vtkXMLWriterCompressBlocks(vtkIdType begin, vtkIdType end, int,
+                                       void* arg)
+{
+  vtkXMLWriterCompressBlocksData* data =
+    static_cast<vtkXMLWriterCompressBlocksData*>(arg);
+  vtkstd::vector<unsigned char> buffer;
+  for(vtkIdType block = begin; block < end; ++block)
+    {
+    vtkXMLWriter::OffsetType firstWord = block*data->BlockWords;
+    vtkXMLWriter::OffsetType numWords =
+      data->NumberOfWords - firstWord < data->BlockWords ?
+      data->NumberOfWords - firstWord : data->BlockWords;
+    unsigned long size =
+      static_cast<unsigned long>(numWords*data->OutWordSize);
+    unsigned char* in = data->Input + block*data->MemBlockSize;
+    if(data->ConvertIds || data->Swap)
+      {
+      buffer.resize(size);
+      if(data->ConvertIds)
+        {
+        vtkIdType* ids = reinterpret_cast<vtkIdType*>(in);
+        vtkTypeInt32* out = reinterpret_cast<vtkTypeInt32*>(&buffer[0]);
+        for(vtkXMLWriter::OffsetType i = 0; i < numWords; ++i)
+          {
+          out[i] = static_cast<vtkTypeInt32>(ids[i]);
+          }
+        }
+      else
+        {
+        memcpy(&buffer[0], in, size);
+        }
+      if(data->Swap)
+        {
+        vtkXMLWriterHelper::PerformByteSwap(data->Writer, &buffer[0],
+          numWords, static_cast<int>(data->OutWordSize));
+        }
+      in = &buffer[0];
+      }
+
+    vtkstd::vector<unsigned char>& output =
+      data->Outputs[block - data->FirstBlock];
+    output.resize(data->Compressor->GetMaximumCompressionSpace(size));
+    data->OutputSizes[block - data->FirstBlock] =
+      data->Compressor->Compress(in, size, &output[0],
+                                 static_cast<unsigned long>(output.size()));
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLWriter::WriteBinaryDataBlocksThreaded(unsigned char* in_data,
+                                                OffsetType numWords,
+                                                OffsetType blockWords,
+                                                OffsetType memWordSize,
+                                                int wordType)
+{
+  vtkXMLWriterCompressBlocksData data;
+  data.Writer = this;
+  data.Compressor = this->Compressor;
+  data.Input = in_data;
+  data.NumberOfWords = numWords;
+  data.BlockWords = blockWords;
+  data.MemBlockSize = blockWords*memWordSize;
+  data.OutWordSize = this->GetOutputWordTypeSize(wordType);
+  data.ConvertIds = (data.OutWordSize != memWordSize);
+  data.Swap = (this->ByteSwapBuffer != 0);
+
+  // Compress a few blocks per thread at a time to bound the memory used
+  // by the compressed data waiting to be written.
+  vtkIdType numBlocks = (numWords + blockWords - 1)/blockWords;
+  vtkIdType batchSize = 4*this->NumberOfThreads;
+  data.Outputs.resize(batchSize);
+  data.OutputSizes.resize(batchSize);
+
+  int result = 1;
+  this->SetProgressPartial(0);
+  for(vtkIdType first = 0; result && first < numBlocks; first += batchSize)
+    {
+    vtkIdType last = first + batchSize < numBlocks ?
+      first + batchSize : numBlocks;
+    data.FirstBlock = first;
+    vtkThreadPool::GetGlobalPool()->ParallelFor(first, last, 1,
+      vtkXMLWriterCompressBlocks, &data);
+    for(vtkIdType block = first; result && block < last; ++block)
+      {
+      unsigned long size = data.OutputSizes[block - first];
+      if(!size ||
+         !this->WriteCompressedBlock(&data.Outputs[block - first][0], size))
+        {
+        result = 0;
+        }
+      }
+    this->SetProgressPartial(float(last)/numBlocks);
+    }
+  this->SetProgressPartial(1);
   return result;
 }
 
@@ -1763,6 +1930,19 @@ void vtkXMLWriter::WriteArrayAppended(
 void vtkXMLWriter::WriteArrayAppendedData(vtkAbstractArray* a,
   OffsetType pos, OffsetType& lastoffset)
 {
+  // Pad raw data so that the words of the array are aligned in the file
+  // and readers can map them in place.
+  int wordSize = a->GetDataTypeSize();
+  if(!this->EncodeAppendedData && !this->Compressor && wordSize > 1)
+    {
+    ostream& os = *(this->Stream);
+    OffsetType start = static_cast<OffsetType>(os.tellp()) +
+      static_cast<OffsetType>(sizeof(HeaderType));
+    for(; start % wordSize != 0; ++start)
+      {
+      os.put('\0');
+      }
+    }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a); 
 }
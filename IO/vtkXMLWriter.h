@@ -114,7 +114,8 @@ public:
   enum CompressorType
     {
     NONE,
-    ZLIB
+    ZLIB,
+    LZ4
     };
 //ETX
 
@@ -129,6 +130,10 @@ public:
     {
     this->SetCompressorType(ZLIB);
     }
+  void SetCompressorTypeToLZ4()
+    {
+    this->SetCompressorType(LZ4);
+    }
 
   // Description:
   // Get/Set the block size used in compression.  When reading, this
@@ -137,6 +142,14 @@ public:
   // be a multiple of the largest scalar data type.
   virtual void SetBlockSize(unsigned int blockSize);
   vtkGetMacro(BlockSize, unsigned int);
+
+  // Description:
+  // Get/Set the number of threads used to compress the blocks of an
+  // array.  Blocks are compressed in batches on the threads of the
+  // global vtkThreadPool and written in order, so the file does not
+  // depend on the number of threads.  The default is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
   
   // Description:
   // Get/Set the data mode used for the file's data.  The options are
@@ -280,6 +293,7 @@ protected:
   HeaderType*    CompressionHeader;
   unsigned int   CompressionHeaderLength;
   OffsetType  CompressionHeaderPosition;
+  int NumberOfThreads;
   
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
@@ -416,6 +430,11 @@ protected:
   void PerformByteSwap(void* data, OffsetType numWords, int wordSize);
   int CreateCompressionHeader(OffsetType size);
   int WriteCompressionBlock(unsigned char* data, OffsetType size);
+  int WriteCompressedBlock(unsigned char* data, HeaderType size);
+  int WriteBinaryDataBlocksThreaded(unsigned char* in_data,
+                                    OffsetType numWords,
+                                    OffsetType blockWords,
+                                    OffsetType memWordSize, int wordType);
   int WriteCompressionHeader();
   OffsetType GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
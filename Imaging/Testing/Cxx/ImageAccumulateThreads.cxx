@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    ImageAccumulateThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that accumulating an image on several threads gives the same bins
+// and statistics as a single thread, with one and three components, with
+// and without a stencil, and with zeros ignored.
+
+#include "vtkDataArray.h"
+#include "vtkImageAccumulate.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkROIStencilSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadPool.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int Same(double a, double b)
+{
+  return (fabs(a - b) <= 1.0e-9 * (1.0 + fabs(a)));
+}
+
+// Compare the outputs and statistics of the two filters.
+static int CompareFilters(vtkImageAccumulate *serial,
+                          vtkImageAccumulate *threaded)
+{
+  int *bins1 = static_cast<int *>(serial->GetOutput()->GetScalarPointer());
+  int *bins2 = static_cast<int *>(threaded->GetOutput()->GetScalarPointer());
+  vtkIdType numBins = serial->GetOutput()->GetNumberOfPoints();
+  vtkIdType total = 0;
+  for (vtkIdType i = 0; i < numBins; i++)
+    {
+    if (bins1[i] != bins2[i])
+      {
+      cerr << "Bin " << i << " holds " << bins2[i] << " instead of "
+           << bins1[i] << endl;
+      return 0;
+      }
+    total += bins1[i];
+    }
+  if (total == 0 || serial->GetVoxelCount() != threaded->GetVoxelCount())
+    {
+    cerr << "Counted " << threaded->GetVoxelCount() << " voxels instead of "
+         << serial->GetVoxelCount() << endl;
+    return 0;
+    }
+  for (int i = 0; i < 3; i++)
+    {
+    if (serial->GetMin()[i] != threaded->GetMin()[i] ||
+        serial->GetMax()[i] != threaded->GetMax()[i] ||
+        !Same(serial->GetMean()[i], threaded->GetMean()[i]) ||
+        !Same(serial->GetStandardDeviation()[i],
+              threaded->GetStandardDeviation()[i]))
+      {
+      cerr << "The statistics of component " << i << " differ." << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int ImageAccumulateThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+  vtkMath::RandomSeed(5678);
+
+  // An ellipsoid in the middle of the images.
+  VTK_CREATE(vtkROIStencilSource, stencil);
+  stencil->SetOutputWholeExtent(0, 99, 0, 79, 0, 29);
+  stencil->SetShapeToEllipsoid();
+  stencil->SetBounds(20, 80, 10, 70, 5, 25);
+
+  for (int components = 1; components <= 3; components += 2)
+    {
+    VTK_CREATE(vtkImageData, image);
+    image->SetExtent(0, 99, 0, 79, 0, 29);
+    image->SetScalarTypeToShort();
+    image->SetNumberOfScalarComponents(components);
+    image->AllocateScalars();
+    vtkDataArray *scalars = image->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+      {
+      for (int j = 0; j < components; j++)
+        {
+        scalars->SetComponent(i, j, floor(vtkMath::Random(-20.0, 300.0)));
+        }
+      }
+
+    for (int mode = 0; mode < 4; mode++)
+      {
+      VTK_CREATE(vtkImageAccumulate, serial);
+      VTK_CREATE(vtkImageAccumulate, threaded);
+      vtkImageAccumulate *filters[2] = { serial, threaded };
+      for (int f = 0; f < 2; f++)
+        {
+        filters[f]->SetInput(image);
+        if (components == 1)
+          {
+          filters[f]->SetComponentExtent(0, 99, 0, 0, 0, 0);
+          filters[f]->SetComponentSpacing(2.5, 1.0, 1.0);
+          }
+        else
+          {
+          filters[f]->SetComponentExtent(0, 29, 0, 19, 0, 9);
+          filters[f]->SetComponentSpacing(10.0, 15.0, 30.0);
+          }
+        if (mode > 0)
+          {
+          filters[f]->SetStencil(stencil->GetOutput());
+          filters[f]->SetReverseStencil(mode == 2);
+          }
+        filters[f]->SetIgnoreZero(mode == 3);
+        }
+      threaded->SetNumberOfThreads(4);
+      serial->Update();
+      threaded->Update();
+      if (!CompareFilters(serial, threaded))
+        {
+        cerr << "With " << components << " components in mode " << mode
+             << "." << endl;
+        return 1;
+        }
+      }
+    }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    ImageEuclideanDistance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the distances computed by the Felzenszwalb algorithm of
+// vtkImageEuclideanDistance with distances to the nearest zero voxel
+// computed by brute force, with anisotropic spacing, a maximum distance
+// and signed distances.
+
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMath.h"
+#include "vtkSmartPointer.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// The squared distance of a voxel to the nearest voxel whose value is or
+// is not zero.
+static double BruteForce(vtkImageData *image, int x, int y, int z,
+                         int zero, double maxDist)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  double *spacing = image->GetSpacing();
+  double best = maxDist;
+  unsigned char *ptr =
+    static_cast<unsigned char *>(image->GetScalarPointer());
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++, ptr++)
+        {
+        if ((*ptr == 0) == zero)
+          {
+          double dx = (i - x) * spacing[0];
+          double dy = (j - y) * spacing[1];
+          double dz = (k - z) * spacing[2];
+          double d = dx * dx + dy * dy + dz * dz;
+          best = (d < best ? d : best);
+          }
+        }
+      }
+    }
+  return best;
+}
+
+static int CheckDistances(vtkImageData *image, vtkImageData *output,
+                          double maxDist, int sign)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  unsigned char *in = static_cast<unsigned char *>(image->GetScalarPointer());
+  float *out = static_cast<float *>(output->GetScalarPointer());
+  for (int z = 0; z < dims[2]; z++)
+    {
+    for (int y = 0; y < dims[1]; y++)
+      {
+      for (int x = 0; x < dims[0]; x++, in++, out++)
+        {
+        double expected = 0.0;
+        if (*in != 0)
+          {
+          expected = BruteForce(image, x, y, z, 1, maxDist);
+          }
+        else if (sign)
+          {
+          expected = -BruteForce(image, x, y, z, 0, maxDist);
+          }
+        if (fabs(*out - expected) > 1.0e-4 * (1.0 + fabs(expected)))
+          {
+          cerr << "The distance at " << x << " " << y << " " << z << " is "
+               << *out << " instead of " << expected << endl;
+          return 0;
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+int ImageEuclideanDistance(int, char *[])
+{
+  // A few random spheres.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(23, 17, 11);
+  image->SetSpacing(1.0, 1.5, 2.25);
+  image->SetScalarTypeToUnsignedChar();
+  image->AllocateScalars();
+  vtkMath::RandomSeed(3456);
+  double centers[4][3];
+  int i, j, k, c;
+  for (c = 0; c < 4; c++)
+    {
+    centers[c][0] = vtkMath::Random(0.0, 22.0);
+    centers[c][1] = vtkMath::Random(0.0, 24.0);
+    centers[c][2] = vtkMath::Random(0.0, 22.5);
+    }
+  unsigned char *ptr = static_cast<unsigned char *>(image->GetScalarPointer());
+  for (k = 0; k < 11; k++)
+    {
+    for (j = 0; j < 17; j++)
+      {
+      for (i = 0; i < 23; i++)
+        {
+        double x[3] = { i * 1.0, j * 1.5, k * 2.25 };
+        *ptr = 0;
+        for (c = 0; c < 4; c++)
+          {
+          if (vtkMath::Distance2BetweenPoints(x, centers[c]) < 20.0)
+            {
+            *ptr = 1;
+            }
+          }
+        ptr++;
+        }
+      }
+    }
+
+  double maxDists[2] = { VTK_INT_MAX, 10.0 };
+  for (int m = 0; m < 2; m++)
+    {
+    for (int sign = 0; sign < 2; sign++)
+      {
+      VTK_CREATE(vtkImageEuclideanDistance, distance);
+      distance->SetInput(image);
+      distance->SetAlgorithmToFelzenszwalb();
+      distance->SetMaximumDistance(maxDists[m]);
+      distance->SetSignedDistance(sign);
+      distance->SetNumberOfThreads(4);
+      distance->Update();
+      if (!CheckDistances(image, distance->GetOutput(), maxDists[m], sign))
+        {
+        cerr << "With maximum distance " << maxDists[m] << " and signed "
+             << "distance " << sign << endl;
+        return 1;
+        }
+      }
+    }
+
+  return 0;
+}
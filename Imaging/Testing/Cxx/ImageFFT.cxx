@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    ImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the transforms of vtkImageFFT with discrete Fourier transforms
+// computed term by term, for real and complex images whose dimensions use
+// each radix and Bluestein's algorithm, and check that vtkImageRFFT
+// gives back the images.
+
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkSmartPointer.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// An image of random values with one or two components.
+static void MakeImage(vtkImageData *image, int dims[3], int components)
+{
+  image->SetDimensions(dims);
+  image->SetScalarTypeToFloat();
+  image->SetNumberOfScalarComponents(components);
+  image->AllocateScalars();
+  float *ptr = static_cast<float *>(image->GetScalarPointer());
+  vtkIdType size =
+    static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2] * components;
+  for (vtkIdType i = 0; i < size; i++)
+    {
+    ptr[i] = static_cast<float>(vtkMath::Random(-1.0, 1.0));
+    }
+}
+
+// Compare the transform of an image with its discrete Fourier transform.
+static int CheckTransform(vtkImageData *image, vtkImageData *transform)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  int components = image->GetNumberOfScalarComponents();
+  float *in = static_cast<float *>(image->GetScalarPointer());
+  double *out = static_cast<double *>(transform->GetScalarPointer());
+  double maxError = 0.0;
+
+  for (int k2 = 0; k2 < dims[2]; k2++)
+    {
+    for (int k1 = 0; k1 < dims[1]; k1++)
+      {
+      for (int k0 = 0; k0 < dims[0]; k0++)
+        {
+        double real = 0.0;
+        double imag = 0.0;
+        float *value = in;
+        for (int j2 = 0; j2 < dims[2]; j2++)
+          {
+          for (int j1 = 0; j1 < dims[1]; j1++)
+            {
+            for (int j0 = 0; j0 < dims[0]; j0++)
+              {
+              double angle = -2.0 * vtkMath::DoublePi() *
+                (static_cast<double>((j0 * k0) % dims[0]) / dims[0] +
+                 static_cast<double>((j1 * k1) % dims[1]) / dims[1] +
+                 static_cast<double>((j2 * k2) % dims[2]) / dims[2]);
+              double c = cos(angle);
+              double s = sin(angle);
+              double im = (components > 1 ? value[1] : 0.0);
+              real += value[0] * c - im * s;
+              imag += value[0] * s + im * c;
+              value += components;
+              }
+            }
+          }
+        double error = fabs(out[0] - real) + fabs(out[1] - imag);
+        maxError = (error > maxError ? error : maxError);
+        out += 2;
+        }
+      }
+    }
+  if (maxError > 1.0e-9)
+    {
+    cerr << "The transform of a " << dims[0] << "x" << dims[1] << "x"
+         << dims[2] << " image with " << components
+         << " components is off by " << maxError << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Compare the reverse transform with the image.
+static int CheckReverse(vtkImageData *image, vtkImageData *reverse)
+{
+  int components = image->GetNumberOfScalarComponents();
+  float *in = static_cast<float *>(image->GetScalarPointer());
+  double *out = static_cast<double *>(reverse->GetScalarPointer());
+  double maxError = 0.0;
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    double im = (components > 1 ? in[1] : 0.0);
+    double error = fabs(out[0] - in[0]) + fabs(out[1] - im);
+    maxError = (error > maxError ? error : maxError);
+    in += components;
+    out += 2;
+    }
+  if (maxError > 1.0e-9)
+    {
+    cerr << "The reverse transform is off by " << maxError << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int ImageFFT(int, char *[])
+{
+  // 12 = 4*3, 7 and 10 = 2*5 use the radices, 13 and 31 Bluestein's
+  // algorithm.  The long rows fill several blocks of lines.
+  int dims[][3] = { {12, 7, 13}, {10, 31, 1}, {1000, 3, 1} };
+  vtkMath::RandomSeed(1234);
+
+  for (int i = 0; i < 3; i++)
+    {
+    for (int components = 1; components <= 2; components++)
+      {
+      VTK_CREATE(vtkImageData, image);
+      MakeImage(image, dims[i], components);
+
+      VTK_CREATE(vtkImageFFT, fft);
+      fft->SetNumberOfThreads(4);
+      fft->SetInput(image);
+      fft->Update();
+      if (!CheckTransform(image, fft->GetOutput()))
+        {
+        return 1;
+        }
+
+      VTK_CREATE(vtkImageRFFT, rfft);
+      rfft->SetNumberOfThreads(4);
+      rfft->SetInputConnection(fft->GetOutputPort());
+      rfft->Update();
+      if (!CheckReverse(image, rfft->GetOutput()))
+        {
+        return 1;
+        }
+
+      // The plans are reused when the filters execute again.
+      image->Modified();
+      rfft->Update();
+      if (!CheckReverse(image, rfft->GetOutput()))
+        {
+        return 1;
+        }
+      }
+    }
+
+  return 0;
+}
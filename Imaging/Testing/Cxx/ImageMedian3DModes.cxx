@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    ImageMedian3DModes.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the medians that vtkImageMedian3D computes with histograms and
+// sorting networks with medians computed by sorting each neighborhood,
+// near the boundaries as well as inside the image.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// An image of random values.  The values of the integer images are drawn
+// from a small range so that the neighborhoods hold equal values.
+static void MakeImage(vtkImageData *image, int type, int components)
+{
+  image->SetExtent(-3, 36, 2, 21, 0, 10);
+  image->SetScalarType(type);
+  image->SetNumberOfScalarComponents(components);
+  image->AllocateScalars();
+  double range = (type == VTK_FLOAT || type == VTK_DOUBLE ? 1000.0 : 50.0);
+  double offset = (type == VTK_SHORT ? -25.0 : 0.0);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < components; j++)
+      {
+      scalars->SetComponent(i, j, offset +
+                            floor(vtkMath::Random(0.0, range)));
+      }
+    }
+}
+
+// Compare the output with the values of rank n/2 of the neighborhoods.
+static int CheckMedians(vtkImageData *image, vtkImageData *output,
+                        int kernel[3])
+{
+  int ext[6];
+  image->GetExtent(ext);
+  int components = image->GetNumberOfScalarComponents();
+  vtkstd::vector<double> values;
+  for (int z = ext[4]; z <= ext[5]; z++)
+    {
+    for (int y = ext[2]; y <= ext[3]; y++)
+      {
+      for (int x = ext[0]; x <= ext[1]; x++)
+        {
+        int pos[3] = { x, y, z };
+        int hood[6];
+        for (int k = 0; k < 3; k++)
+          {
+          hood[2*k] = pos[k] - kernel[k]/2;
+          hood[2*k+1] = hood[2*k] + kernel[k] - 1;
+          hood[2*k] = (hood[2*k] > ext[2*k] ? hood[2*k] : ext[2*k]);
+          hood[2*k+1] = (hood[2*k+1] < ext[2*k+1] ? hood[2*k+1] :
+                         ext[2*k+1]);
+          }
+        for (int c = 0; c < components; c++)
+          {
+          values.clear();
+          for (int k = hood[4]; k <= hood[5]; k++)
+            {
+            for (int j = hood[2]; j <= hood[3]; j++)
+              {
+              for (int i = hood[0]; i <= hood[1]; i++)
+                {
+                values.push_back(image->GetScalarComponentAsDouble(i, j, k, c));
+                }
+              }
+            }
+          vtkstd::sort(values.begin(), values.end());
+          double median = values[values.size()/2];
+          double result = output->GetScalarComponentAsDouble(x, y, z, c);
+          if (result != median)
+            {
+            cerr << "The median at " << x << " " << y << " " << z
+                 << " is " << result << " instead of " << median << endl;
+            return 0;
+            }
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+int ImageMedian3DModes(int, char *[])
+{
+  int types[] = { VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_UNSIGNED_SHORT,
+                  VTK_FLOAT, VTK_DOUBLE };
+  // The last kernel is too large for the sorting networks.
+  int kernels[][3] = { {3, 3, 3}, {5, 5, 5}, {5, 3, 1}, {4, 2, 1},
+                       {7, 7, 7} };
+  vtkMath::RandomSeed(2345);
+
+  for (int t = 0; t < 5; t++)
+    {
+    for (int components = 1; components <= 2; components++)
+      {
+      VTK_CREATE(vtkImageData, image);
+      MakeImage(image, types[t], components);
+      for (int k = 0; k < 5; k++)
+        {
+        if (k == 4 && types[t] != VTK_SHORT && types[t] != VTK_FLOAT)
+          {
+          continue;
+          }
+        VTK_CREATE(vtkImageMedian3D, median);
+        median->SetInput(image);
+        median->SetKernelSize(kernels[k][0], kernels[k][1], kernels[k][2]);
+        median->SetMedianModeToFast();
+        median->SetNumberOfThreads(4);
+        median->Update();
+        if (!CheckMedians(image, median->GetOutput(), kernels[k]))
+          {
+          cerr << "With type " << image->GetScalarTypeAsString() << ", "
+               << components << " components and kernel " << kernels[k][0]
+               << "x" << kernels[k][1] << "x" << kernels[k][2] << endl;
+          return 1;
+          }
+        }
+      }
+    }
+
+  return 0;
+}
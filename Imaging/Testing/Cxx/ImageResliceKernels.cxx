@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    ImageResliceKernels.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// vtkImageReslice has vectorized kernels for short, unsigned short and
+// float data.  Reslice the same values stored as int or double, which
+// always use the scalar kernels, and check that the results are identical.
+
+#include "vtkImageCast.h"
+#include "vtkImageData.h"
+#include "vtkImageReslice.h"
+#include "vtkMatrix4x4.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+#include <math.h>
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static vtkImageData *Reslice(vtkImageData *input, vtkMatrix4x4 *axes,
+                             int interpolation, int mode, int extent[6],
+                             vtkImageReslice *reslice)
+{
+  reslice->SetInput(input);
+  reslice->SetResliceAxes(axes);
+  reslice->SetInterpolationMode(interpolation);
+  reslice->SetWrap(mode == 1);
+  reslice->SetMirror(mode == 2);
+  reslice->SetBorder(mode == 3);
+  reslice->SetBackgroundLevel(7.0);
+  reslice->SetOutputExtent(extent);
+  reslice->SetOutputSpacing(0.83, 0.91, 1.0);
+  reslice->SetOutputOrigin(-3.1, -2.7, 0.0);
+  reslice->Update();
+  return reslice->GetOutput();
+}
+
+int ImageResliceKernels(int, char *[])
+{
+  // A 16-bit volume with values that need rounding when interpolated.
+  VTK_CREATE(vtkImageData, image);
+  image->SetDimensions(37, 29, 23);
+  image->SetSpacing(0.9, 1.1, 1.3);
+  image->SetOrigin(-1.0, 2.0, 0.5);
+  image->SetScalarTypeToUnsignedShort();
+  image->AllocateScalars();
+  unsigned short *ptr =
+    static_cast<unsigned short *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    ptr[i] = static_cast<unsigned short>(
+      20000 + 15000*sin(0.37*i) + 17*(i % 101));
+    }
+
+  // Pairs of types: the first has vectorized kernels, the second not.
+  int types[3][2] = { { VTK_UNSIGNED_SHORT, VTK_INT },
+                      { VTK_SHORT, VTK_INT },
+                      { VTK_FLOAT, VTK_DOUBLE } };
+  const char *modes[4] = { "background", "wrap", "mirror", "border" };
+
+  // An oblique and an axis-aligned orientation, the latter with a
+  // translation so that the permuted code has to interpolate.
+  VTK_CREATE(vtkTransform, oblique);
+  oblique->Translate(14.0, 12.0, 12.0);
+  oblique->RotateWXYZ(23.0, 0.3, 0.9, 0.2);
+  VTK_CREATE(vtkMatrix4x4, aligned);
+  aligned->SetElement(0, 3, 0.37);
+  aligned->SetElement(1, 3, 0.41);
+  aligned->SetElement(2, 3, 3.73);
+  vtkMatrix4x4 *matrices[2] = { oblique->GetMatrix(), aligned };
+
+  // Odd widths and an extent that sticks out of the input.
+  int extent[6] = { 0, 44, 0, 40, 0, 3 };
+
+  int errors = 0;
+  for (int t = 0; t < 3; t++)
+    {
+    vtkSmartPointer<vtkImageData> inputs[2];
+    for (int k = 0; k < 2; k++)
+      {
+      // The second input is cast from the first to get the same values.
+      VTK_CREATE(vtkImageCast, cast);
+      cast->SetInput(k ? inputs[0].GetPointer() : image.GetPointer());
+      cast->SetOutputScalarType(types[t][k]);
+      cast->ClampOverflowOn();
+      cast->Update();
+      inputs[k] = cast->GetOutput();
+      }
+    for (int m = 0; m < 2; m++)
+      {
+      for (int interp = VTK_RESLICE_NEAREST; interp <= VTK_RESLICE_LINEAR;
+           interp++)
+        {
+        for (int mode = 0; mode < 4; mode++)
+          {
+          VTK_CREATE(vtkImageReslice, reslice1);
+          VTK_CREATE(vtkImageReslice, reslice2);
+          vtkImageData *out1 = Reslice(inputs[0], matrices[m], interp, mode,
+                                       extent, reslice1);
+          vtkImageData *out2 = Reslice(inputs[1], matrices[m], interp, mode,
+                                       extent, reslice2);
+          vtkDataArray *a1 = out1->GetPointData()->GetScalars();
+          vtkDataArray *a2 = out2->GetPointData()->GetScalars();
+          for (vtkIdType i = 0; i < a1->GetNumberOfTuples(); i++)
+            {
+            double v2 = a2->GetTuple1(i);
+            if (types[t][0] == VTK_FLOAT)
+              {
+              v2 = static_cast<float>(v2);
+              }
+            if (a1->GetTuple1(i) != v2)
+              {
+              cerr << out1->GetScalarTypeAsString() << ", "
+                   << (m ? "aligned" : "oblique") << ", "
+                   << (interp ? "linear" : "nearest") << ", " << modes[mode]
+                   << ": voxel " << i << " is " << a1->GetTuple1(i)
+                   << " instead of " << v2 << endl;
+              errors++;
+              break;
+              }
+            }
+          }
+        }
+      }
+    }
+
+  return (errors == 0) ? 0 : 1;
+}
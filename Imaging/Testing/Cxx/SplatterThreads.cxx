@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    SplatterThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkGaussianSplatter and vtkShepardMethod give the same volumes
+// on several threads as on one, for each accumulation mode, with and
+// without normals and scalars, and with points outside of the volume.
+
+#include "vtkDoubleArray.h"
+#include "vtkGaussianSplatter.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkShepardMethod.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadPool.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+// Compare the scalars of two volumes value by value.
+static int CompareVolumes(vtkImageData *serial, vtkImageData *threaded)
+{
+  vtkDataArray *scalars1 = serial->GetPointData()->GetScalars();
+  vtkDataArray *scalars2 = threaded->GetPointData()->GetScalars();
+  if (scalars1->GetNumberOfTuples() != scalars2->GetNumberOfTuples())
+    {
+    cerr << "The volumes have different sizes." << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < scalars1->GetNumberOfTuples(); i++)
+    {
+    if (scalars1->GetComponent(i, 0) != scalars2->GetComponent(i, 0))
+      {
+      cerr << "Voxel " << i << " holds " << scalars2->GetComponent(i, 0)
+           << " instead of " << scalars1->GetComponent(i, 0) << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int SplatterThreads(int, char *[])
+{
+  vtkThreadPool::GetGlobalPool()->SetNumberOfThreads(4);
+  vtkMath::RandomSeed(4321);
+
+  // Random points with normals and scalars, some of them outside of the
+  // model bounds of the filters.
+  VTK_CREATE(vtkPoints, points);
+  VTK_CREATE(vtkDoubleArray, normals);
+  VTK_CREATE(vtkDoubleArray, scalars);
+  normals->SetNumberOfComponents(3);
+  for (int i = 0; i < 500; i++)
+    {
+    points->InsertNextPoint(vtkMath::Random(-0.2, 1.2),
+                            vtkMath::Random(-0.2, 1.2),
+                            vtkMath::Random(-0.2, 1.2));
+    normals->InsertNextTuple3(vtkMath::Random(-1.0, 1.0),
+                              vtkMath::Random(-1.0, 1.0),
+                              vtkMath::Random(-1.0, 1.0));
+    scalars->InsertNextValue(vtkMath::Random(0.0, 2.0));
+    }
+  // Two points on voxels of the volume of vtkShepardMethod.
+  points->InsertNextPoint(0.5, 0.5, 0.5);
+  normals->InsertNextTuple3(0.0, 0.0, 1.0);
+  scalars->InsertNextValue(3.0);
+  points->InsertNextPoint(0.5, 0.5, 0.5);
+  normals->InsertNextTuple3(0.0, 0.0, 0.0);
+  scalars->InsertNextValue(1.0);
+  VTK_CREATE(vtkPolyData, input);
+  input->SetPoints(points);
+  input->GetPointData()->SetNormals(normals);
+  input->GetPointData()->SetScalars(scalars);
+
+  for (int mode = VTK_ACCUMULATION_MODE_MIN;
+       mode <= VTK_ACCUMULATION_MODE_SUM; mode++)
+    {
+    for (int warping = 0; warping < 4; warping++)
+      {
+      VTK_CREATE(vtkGaussianSplatter, serial);
+      VTK_CREATE(vtkGaussianSplatter, threaded);
+      vtkGaussianSplatter *filters[2] = { serial, threaded };
+      for (int f = 0; f < 2; f++)
+        {
+        filters[f]->SetInput(input);
+        filters[f]->SetSampleDimensions(31, 27, 35);
+        filters[f]->SetModelBounds(0.0, 1.0, 0.0, 1.0, 0.0, 1.0);
+        filters[f]->SetRadius(0.08);
+        filters[f]->SetAccumulationMode(mode);
+        filters[f]->SetNormalWarping(warping & 1);
+        filters[f]->SetScalarWarping((warping >> 1) & 1);
+        }
+      threaded->SetNumberOfThreads(4);
+      serial->Update();
+      threaded->Update();
+      if (!CompareVolumes(serial->GetOutput(), threaded->GetOutput()))
+        {
+        cerr << "vtkGaussianSplatter in " << serial->GetAccumulationModeAsString()
+             << " mode with warping " << warping << "." << endl;
+        return 1;
+        }
+      }
+    }
+
+  VTK_CREATE(vtkShepardMethod, serial);
+  VTK_CREATE(vtkShepardMethod, threaded);
+  vtkShepardMethod *filters[2] = { serial, threaded };
+  for (int f = 0; f < 2; f++)
+    {
+    filters[f]->SetInput(input);
+    filters[f]->SetSampleDimensions(21, 25, 41);
+    filters[f]->SetModelBounds(0.0, 1.0, 0.0, 1.0, 0.0, 1.0);
+    filters[f]->SetMaximumDistance(0.1);
+    }
+  threaded->SetNumberOfThreads(4);
+  serial->Update();
+  threaded->Update();
+  if (!CompareVolumes(serial->GetOutput(), threaded->GetOutput()))
+    {
+    cerr << "vtkShepardMethod." << endl;
+    return 1;
+    }
+
+  return 0;
+}
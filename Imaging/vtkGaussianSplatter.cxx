@@ -21,11 +21,16 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkSplatTiles.h"
+#include "vtkThreadPool.h"
 
 #include <math.h>
 
 vtkStandardNewMacro(vtkGaussianSplatter);
 
+// The number of slabs of the volume per thread of the pool.
+#define VTK_GAUSSIAN_SPLATTER_TILES_PER_THREAD 4
+
 // Construct object with dimensions=(50,50,50); automatic computation of 
 // bounds; a splat radius of 0.1; an exponent factor of -5; and normal and 
 // scalar warping turned on.
@@ -56,6 +61,197 @@ vtkGaussianSplatter::vtkGaussianSplatter()
 
   this->AccumulationMode = VTK_ACCUMULATION_MODE_MAX;
   this->NullValue = 0.0;
+
+  this->NumberOfThreads = 1;
+
+  this->Visited = 0;
+  this->P = 0;
+  this->N = 0;
+  this->S = 0.0;
+}
+
+//----------------------------------------------------------------------------
+// The state shared by the threads that splat the slabs of the volume.  Self
+// is set only when the volume is a single slab splatted by the calling
+// thread, which then reports progress and checks for abort.
+struct vtkGaussianSplatterTiles
+{
+  vtkGaussianSplatter *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Normals;
+  vtkDataArray *Scalars;
+  double Origin[3];
+  double Spacing[3];
+  double SplatDistance[3];
+  int Dimensions[3];
+  double Radius2;
+  double Eccentricity2;
+  double ExponentFactor;
+  double ScaleFactor;
+  int AccumulationMode;
+  double *Values;
+  char *Visited;
+  vtkSplatTiles Tiles;
+};
+
+//----------------------------------------------------------------------------
+// The voxels that the splat of a point may reach.
+static void vtkGaussianSplatterFootprint(vtkGaussianSplatterTiles *str,
+                                         double p[3], int min[3], int max[3])
+{
+  for (int i=0; i<3; i++)
+    {
+    double loc = (p[i] - str->Origin[i]) / str->Spacing[i];
+    min[i] = static_cast<int>(floor(loc-str->SplatDistance[i]));
+    max[i] = static_cast<int>(ceil(loc+str->SplatDistance[i]));
+    if ( min[i] < 0 )
+      {
+      min[i] = 0;
+      }
+    if ( max[i] >= str->Dimensions[i] )
+      {
+      max[i] = str->Dimensions[i] - 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The slices that the splat of a point may reach, for vtkSplatTiles.
+static void vtkGaussianSplatterSlices(vtkIdType ptId, int &firstSlice,
+                                      int &lastSlice, void *data)
+{
+  vtkGaussianSplatterTiles *str = static_cast<vtkGaussianSplatterTiles *>(data);
+  double p[3];
+  int min[3], max[3];
+  str->Input->GetPoint(ptId, p);
+  vtkGaussianSplatterFootprint(str, p, min, max);
+  firstSlice = min[2];
+  lastSlice = max[2];
+}
+
+//----------------------------------------------------------------------------
+// Splat the points of a range of slabs, within the slabs.  Each voxel
+// gets the contributions of the points in increasing order, whatever the
+// number of slabs.
+static void vtkGaussianSplatterSplatTiles(vtkIdType begin, vtkIdType end,
+                                          int vtkNotUsed(threadIndex),
+                                          void *data)
+{
+  vtkGaussianSplatterTiles *str = static_cast<vtkGaussianSplatterTiles *>(data);
+  vtkSplatTiles *tiles = &str->Tiles;
+  int sliceSize = str->Dimensions[0]*str->Dimensions[1];
+  double p[3], n[3], cx[3], v[3];
+  double factor, dist2, mag=1.0, r2, z2;
+  int min[3], max[3], i, j, k;
+
+  for (vtkIdType tile = begin; tile < end; tile++)
+    {
+    vtkIdType first = tiles->GetTileBegin(tile);
+    vtkIdType last = tiles->GetTileBegin(tile+1);
+    vtkIdType progressInterval = (last - first)/20 + 1;
+    for (vtkIdType t = first; t < last; t++)
+      {
+      if ( str->Self && ! ((t - first) % progressInterval) )
+        {
+        str->Self->UpdateProgress(static_cast<double>(t - first)/
+                                  (last - first));
+        if ( str->Self->GetAbortExecute() )
+          {
+          break;
+          }
+        }
+
+      vtkIdType ptId = tiles->GetPointId(t);
+      str->Input->GetPoint(ptId, p);
+      if ( str->Normals )
+        {
+        str->Normals->GetTuple(ptId, n);
+        mag = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+        if ( mag != 1.0 )
+          {
+          mag = (mag == 0.0 ? 1.0 : sqrt(mag));
+          }
+        }
+      factor = str->ScaleFactor;
+      if ( str->Scalars )
+        {
+        factor = str->ScaleFactor * str->Scalars->GetComponent(ptId,0);
+        }
+
+      // Determine the splat footprint within the slab.
+      vtkGaussianSplatterFootprint(str, p, min, max);
+      if ( min[2] < tiles->GetTileBound(tile) )
+        {
+        min[2] = tiles->GetTileBound(tile);
+        }
+      if ( max[2] >= tiles->GetTileBound(tile+1) )
+        {
+        max[2] = tiles->GetTileBound(tile+1) - 1;
+        }
+
+      // Loop over all sample points in volume within footprint and
+      // evaluate the splat
+      for (k=min[2]; k<=max[2]; k++)
+        {
+        cx[2] = str->Origin[2] + str->Spacing[2]*k;
+        for (j=min[1]; j<=max[1]; j++)
+          {
+          cx[1] = str->Origin[1] + str->Spacing[1]*j;
+          for (i=min[0]; i<=max[0]; i++)
+            {
+            cx[0] = str->Origin[0] + str->Spacing[0]*i;
+            if ( str->Normals )
+              {
+              // Ellipsoidal Gaussian sampling
+              v[0] = cx[0] - p[0];
+              v[1] = cx[1] - p[1];
+              v[2] = cx[2] - p[2];
+              r2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+              z2 = (v[0]*n[0] + v[1]*n[1] + v[2]*n[2])/mag;
+              z2 = z2*z2;
+              dist2 = (r2 - z2)/str->Eccentricity2 + z2;
+              }
+            else
+              {
+              // Gaussian sampling
+              dist2 = ((cx[0]-p[0])*(cx[0]-p[0]) + (cx[1]-p[1])*(cx[1]-p[1]) +
+                       (cx[2]-p[2])*(cx[2]-p[2]) );
+              }
+            if ( dist2 > str->Radius2 )
+              {
+              continue;
+              }
+
+            vtkIdType idx = i + j*str->Dimensions[0] + k*sliceSize;
+            double value = factor * exp(
+              static_cast<double>
+              (str->ExponentFactor*(dist2)/(str->Radius2)));
+            if ( ! str->Visited[idx] )
+              {
+              str->Visited[idx] = 1;
+              str->Values[idx] = value;
+              }
+            else
+              {
+              double s = str->Values[idx];
+              switch (str->AccumulationMode)
+                {
+                case VTK_ACCUMULATION_MODE_MIN:
+                  str->Values[idx] = (s < value ? s : value);
+                  break;
+                case VTK_ACCUMULATION_MODE_MAX:
+                  str->Values[idx] = (s > value ? s : value);
+                  break;
+                case VTK_ACCUMULATION_MODE_SUM:
+                  str->Values[idx] = s + value;
+                  break;
+                }
+              }//not first visit
+            }
+          }
+        }//within splat footprint
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -117,13 +313,10 @@ int vtkGaussianSplatter::RequestData(
     outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
   output->AllocateScalars();
   
-  vtkIdType numPts, numNewPts, ptId, idx, i;
-  int j, k;
-  int min[3], max[3];
+  vtkIdType numPts, numNewPts, i;
   vtkPointData *pd;
   vtkDataArray *inNormals=NULL;
   vtkDataArray *inScalars=NULL;
-  double loc[3], dist2, cx[3];
   vtkDoubleArray *newScalars = 
     vtkDoubleArray::SafeDownCast(output->GetPointData()->GetScalars());
   newScalars->SetName("SplatterValues");
@@ -131,7 +324,6 @@ int vtkGaussianSplatter::RequestData(
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  int sliceSize=this->SampleDimensions[0]*this->SampleDimensions[1];
   
   vtkDebugMacro(<< "Splatting data");
 
@@ -155,104 +347,81 @@ int vtkGaussianSplatter::RequestData(
     {
     newScalars->SetTuple(i,&this->NullValue);
     }
-  this->Visited = new char[numNewPts];
+  char *visited = new char[numNewPts];
   for (i=0; i < numNewPts; i++)
     {
-    this->Visited[i] = 0;
+    visited[i] = 0;
     }
 
   output->SetDimensions(this->GetSampleDimensions());
   this->ComputeModelBounds(input,output, outInfo);
 
-  //  Set up function pointers to sample functions
+  //  Pick the sample functions
   //
   pd = input->GetPointData();
-  if ( this->NormalWarping && (inNormals=pd->GetNormals()) != NULL )
+  if ( this->NormalWarping )
     {
-    this->Sample = &vtkGaussianSplatter::EccentricGaussian;
+    inNormals = pd->GetNormals();
     }
-  else
+  if ( this->ScalarWarping )
     {
-    this->Sample = &vtkGaussianSplatter::Gaussian;
+    inScalars = pd->GetScalars();
     }
 
-  if ( this->ScalarWarping && (inScalars=pd->GetScalars()) != NULL )
+  vtkGaussianSplatterTiles str;
+  str.Self = this;
+  str.Input = input;
+  str.Normals = inNormals;
+  str.Scalars = inScalars;
+  for (i=0; i<3; i++)
     {
-    this->SampleFactor = &vtkGaussianSplatter::ScalarSampling;
+    str.Origin[i] = this->Origin[i];
+    str.Spacing[i] = this->Spacing[i];
+    str.SplatDistance[i] = this->SplatDistance[i];
+    str.Dimensions[i] = this->SampleDimensions[i];
     }
-  else
+  str.Radius2 = this->Radius2;
+  str.Eccentricity2 = this->Eccentricity2;
+  str.ExponentFactor = this->ExponentFactor;
+  str.ScaleFactor = this->ScaleFactor;
+  str.AccumulationMode = this->AccumulationMode;
+  str.Values = newScalars->GetPointer(0);
+  str.Visited = visited;
+
+  // Traverse all points - splatting each into the volume.  With several
+  // threads, the volume is cut into slabs along z, the points are sorted
+  // into the slabs that their footprint overlaps, and each slab is
+  // splatted by one thread at a time.  The serial case is a single slab.
+  //
+  vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+  int numTiles = 1;
+  if ( this->NumberOfThreads > 1 )
     {
-    this->SampleFactor = &vtkGaussianSplatter::PositionSampling;
-    this->S = 0.0; //position sampling does not require S to be defined
-                   //but this makes purify happy.
+    numTiles = VTK_GAUSSIAN_SPLATTER_TILES_PER_THREAD *
+      pool->GetNumberOfThreads();
+    input->PrepareForThreadedAccess();
     }
-
-  // Traverse all points - splatting each into the volume.
-  // For each point, determine which voxel it is in.  Then determine
-  // the subvolume that the splat is contained in, and process that.
-  //
-  int abortExecute=0;
-  vtkIdType progressInterval = numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abortExecute; ptId++)
+  str.Tiles.Initialize(this->SampleDimensions[2], numTiles, numPts,
+                       vtkGaussianSplatterSlices, &str);
+  numTiles = str.Tiles.GetNumberOfTiles();
+  if ( numTiles == 1 )
     {
-    if ( ! (ptId % progressInterval) )
-      {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (static_cast<double>(ptId)/numPts);
-      abortExecute = this->GetAbortExecute();
-      }
-
-    this->P = input->GetPoint(ptId);
-    if ( inNormals != NULL )
-      {
-      this->N = inNormals->GetTuple(ptId);
-      }
-    if ( inScalars != NULL )
-      {
-      this->S = inScalars->GetComponent(ptId,0);
-      }
-
-    // Determine the voxel that the point is in
-    for (i=0; i<3; i++)  
-      {
-      loc[i] = (this->P[i] - this->Origin[i]) / this->Spacing[i];
-      }
-
-    // Determine splat footprint
-    for (i=0; i<3; i++)
+    vtkGaussianSplatterSplatTiles(0, 1, 0, &str);
+    }
+  else
+    {
+    // Slabs are splatted in groups to report progress.
+    str.Self = NULL;
+    int groupSize = numTiles/10 + 1;
+    for (int tile=0; tile < numTiles && !this->GetAbortExecute();
+         tile+=groupSize)
       {
-      min[i] = static_cast<int>(floor(static_cast<double>(loc[i])-this->SplatDistance[i]));
-      max[i] = static_cast<int>(ceil(static_cast<double>(loc[i])+this->SplatDistance[i]));
-      if ( min[i] < 0 )
-        {
-        min[i] = 0;
-        }
-      if ( max[i] >= this->SampleDimensions[i] )
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
+      this->UpdateProgress(static_cast<double>(tile)/numTiles);
+      int lastTile = tile + groupSize;
+      pool->ParallelFor(tile, (lastTile < numTiles ? lastTile : numTiles), 1,
+                        vtkGaussianSplatterSplatTiles, &str);
       }
-    
-    // Loop over all sample points in volume within footprint and
-    // evaluate the splat
-    for (k=min[2]; k<=max[2]; k++)
-      {
-      cx[2] = this->Origin[2] + this->Spacing[2]*k;
-      for (j=min[1]; j<=max[1]; j++)
-        {
-        cx[1] = this->Origin[1] + this->Spacing[1]*j;
-        for (i=min[0]; i<=max[0]; i++)
-          {
-          cx[0] = this->Origin[0] + this->Spacing[0]*i;
-          if ( (dist2=(this->*Sample)(cx)) <= this->Radius2 ) 
-            {
-            idx = i + j*this->SampleDimensions[0] + k*sliceSize;
-            this->SetScalar(idx,dist2, newScalars);
-            }//if within splat radius
-          }
-        }
-      }//within splat footprint
-    }//for all input points
+    }
 
   // If capping is turned on, set the distances of the outside of the volume
   // to the CapValue.
@@ -266,7 +435,7 @@ int vtkGaussianSplatter::RequestData(
 
   // Update self and release memeory
   //
-  delete [] this->Visited;
+  delete [] visited;
 
   return 1;
 }
@@ -455,14 +624,17 @@ void vtkGaussianSplatter::Cap(vtkDoubleArray *s)
     }
 }
 
+#ifndef VTK_LEGACY_REMOVE
 //----------------------------------------------------------------------------
 //
 //  Gaussian sampling
 //
 double vtkGaussianSplatter::Gaussian (double cx[3])
 {
-  return ((cx[0]-P[0])*(cx[0]-P[0]) + (cx[1]-P[1])*(cx[1]-P[1]) +
-          (cx[2]-P[2])*(cx[2]-P[2]) );
+  VTK_LEGACY_BODY(vtkGaussianSplatter::Gaussian, "VTK 5.8");
+  return ((cx[0]-this->P[0])*(cx[0]-this->P[0]) +
+          (cx[1]-this->P[1])*(cx[1]-this->P[1]) +
+          (cx[2]-this->P[2])*(cx[2]-this->P[2]) );
 }
     
 //----------------------------------------------------------------------------
@@ -471,6 +643,7 @@ double vtkGaussianSplatter::Gaussian (double cx[3])
 //
 double vtkGaussianSplatter::EccentricGaussian (double cx[3])
 {
+  VTK_LEGACY_BODY(vtkGaussianSplatter::EccentricGaussian, "VTK 5.8");
   double   v[3], r2, z2, rxy2, mag;
 
   v[0] = cx[0] - this->P[0];
@@ -501,11 +674,26 @@ double vtkGaussianSplatter::EccentricGaussian (double cx[3])
   return (rxy2/this->Eccentricity2 + z2);
 }
     
+//----------------------------------------------------------------------------
+double vtkGaussianSplatter::ScalarSampling(double s)
+{
+  VTK_LEGACY_BODY(vtkGaussianSplatter::ScalarSampling, "VTK 5.8");
+  return this->ScaleFactor * s;
+}
+
+//----------------------------------------------------------------------------
+double vtkGaussianSplatter::PositionSampling(double)
+{
+  VTK_LEGACY_BODY(vtkGaussianSplatter::PositionSampling, "VTK 5.8");
+  return this->ScaleFactor;
+}
+
 //----------------------------------------------------------------------------
 void vtkGaussianSplatter::SetScalar(int idx, double dist2, 
                                     vtkDoubleArray *newScalars)
 {
-  double v = (this->*SampleFactor)(this->S) * exp(
+  VTK_LEGACY_BODY(vtkGaussianSplatter::SetScalar, "VTK 5.8");
+  double v = this->ScaleFactor * (this->ScalarWarping ? this->S : 1.0) * exp(
     static_cast<double>
     (this->ExponentFactor*(dist2)/(this->Radius2)));
 
@@ -532,6 +720,7 @@ void vtkGaussianSplatter::SetScalar(int idx, double dist2,
       }
     }//not first visit
 }
+#endif
 
 //----------------------------------------------------------------------------
 const char *vtkGaussianSplatter::GetAccumulationModeAsString()
@@ -586,6 +775,8 @@ void vtkGaussianSplatter::PrintSelf(ostream& os, vtkIndent indent)
      << this->GetAccumulationModeAsString() << "\n";
 
   os << indent << "Null Value: " << this->NullValue << "\n";
+
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
 //----------------------------------------------------------------------------
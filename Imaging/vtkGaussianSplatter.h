@@ -57,6 +57,12 @@
 // Some voxels may never receive a contribution during the splatting process.
 // The final value of these points can be specified with the "NullValue" 
 // instance variable.
+//
+// The points can be splatted on several threads (see
+// SetNumberOfThreads()).  The volume is then cut into slabs, and each
+// point is splatted by the slabs that its footprint overlaps, so the
+// threads never write to the same voxels and the result does not depend
+// on the number of threads.
 
 // .SECTION See Also
 // vtkShepardMethod
@@ -179,6 +185,12 @@ public:
   vtkSetMacro(NullValue,double);
   vtkGetMacro(NullValue,double);
 
+  // Description:
+  // Set/Get the number of threads used to splat the points.  Initial
+  // value is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Compute the size of the sample bounding box automatically from the
   // input data. This is an internal helper function.
@@ -209,22 +221,25 @@ protected:
   int Capping; // Cap side of volume to close surfaces
   double CapValue; // value to use for capping
   int AccumulationMode; // how to combine scalar values
+  int NumberOfThreads; // threads used to splat the points
 
-  double Gaussian(double x[3]);  
-  double EccentricGaussian(double x[3]);  
-  double ScalarSampling(double s) 
-    {return this->ScaleFactor * s;}
-  double PositionSampling(double) 
-    {return this->ScaleFactor;}
-  void SetScalar(int idx, double dist2, vtkDoubleArray *newScalars);
+  // Description:
+  // The sampling functions of the old serial splat loop.  They work on the
+  // point of that loop, which the filter no longer sets.
+  // @deprecated as of VTK 5.8. The filter evaluates the splats in its
+  // slab worker and does not call them.
+  VTK_LEGACY(double Gaussian(double x[3]));
+  VTK_LEGACY(double EccentricGaussian(double x[3]));
+  VTK_LEGACY(double ScalarSampling(double s));
+  VTK_LEGACY(double PositionSampling(double));
+  VTK_LEGACY(void SetScalar(int idx, double dist2,
+                            vtkDoubleArray *newScalars));
 
 //BTX
 private:
   double Radius2;
-  double (vtkGaussianSplatter::*Sample)(double x[3]);
-  double (vtkGaussianSplatter::*SampleFactor)(double s);
-  char *Visited;
   double Eccentricity2;
+  char *Visited; // state of the legacy sampling functions
   double *P;
   double *N;
   double S;
@@ -22,11 +22,15 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 
 #include <math.h>
 
 vtkStandardNewMacro(vtkImageAccumulate);
 
+// The number of voxels accumulated by a thread at a time.
+#define VTK_IMAGE_ACCUMULATE_CHUNK_SIZE 65536
+
 //----------------------------------------------------------------------------
 // Constructor sets default values
 vtkImageAccumulate::vtkImageAccumulate()
@@ -49,6 +53,7 @@ vtkImageAccumulate::vtkImageAccumulate()
     this->StandardDeviation[2] = 0.0;
   this->VoxelCount = 0;
   this->IgnoreZero = 0;
+  this->NumberOfThreads = 1;
 
   // we have the image input and the optional stencil input
   this->SetNumberOfInputPorts(2);
@@ -124,55 +129,148 @@ vtkImageStencilData *vtkImageAccumulate::GetStencil()
 
 
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
-template <class T>
-void vtkImageAccumulateExecute(vtkImageAccumulate *self,
-                               vtkImageData *inData, T *,
-                               vtkImageData *outData, int *outPtr,
-                               double min[3], double max[3],
-                               double mean[3],
-                               double standardDeviation[3],
-                               vtkIdType *voxelCount,
-                               int* updateExtent)
+// What the pieces of the input share: where the bins are and which
+// voxels are accumulated.
+struct vtkImageAccumulateInfo
 {
-  // variables used to compute statistics (filter handles max 3 components)
-  double sum[3];
-  sum[0] = sum[1] = sum[2] = 0.0;
-  double sumSqr[3];
-  sumSqr[0] = sumSqr[1] = sumSqr[2] = 0.0;
-  min[0] = min[1] = min[2] = VTK_DOUBLE_MAX;
-  max[0] = max[1] = max[2] = VTK_DOUBLE_MIN;
-  standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-  *voxelCount = 0;
+  vtkImageData *InData;
+  vtkImageStencilData *Stencil;
+  bool ReverseStencil;
+  bool IgnoreZero;
+  int NumberOfComponents;
+  int OutExtent[6];
+  vtkIdType OutIncrements[3];
+  double Origin[3];
+  double Spacing[3];
+};
 
-  // input's number of components is used as output dimensionality
-  int numC = inData->GetNumberOfScalarComponents();
+//----------------------------------------------------------------------------
+// The statistics of a piece of the input.
+struct vtkImageAccumulateStatistics
+{
+  double Sum[3];
+  double SumSqr[3];
+  double Min[3];
+  double Max[3];
+  vtkIdType Count;
+};
 
-  // get information for output data
-  int outExtent[6];
-  outData->GetExtent(outExtent);
-  vtkIdType outIncs[3];
-  outData->GetIncrements(outIncs);
-  double origin[3];
-  outData->GetOrigin(origin);
-  double spacing[3];
-  outData->GetSpacing(spacing);
+//----------------------------------------------------------------------------
+static void vtkImageAccumulateInitializeStatistics(
+  vtkImageAccumulateStatistics *stats)
+{
+  for (int idxC = 0; idxC < 3; ++idxC)
+    {
+    stats->Sum[idxC] = 0.0;
+    stats->SumSqr[idxC] = 0.0;
+    stats->Min[idxC] = VTK_DOUBLE_MAX;
+    stats->Max[idxC] = VTK_DOUBLE_MIN;
+    }
+  stats->Count = 0;
+}
 
-  // zero count in every bin
-  vtkIdType size = 1;
-  size *= (outExtent[1] - outExtent[0] + 1);
-  size *= (outExtent[3] - outExtent[2] + 1);
-  size *= (outExtent[5] - outExtent[4] + 1);
-  for (vtkIdType j = 0; j < size; j++)
+//----------------------------------------------------------------------------
+// Add the statistics of a piece to those of the pieces before it.
+static void vtkImageAccumulateMergeStatistics(
+  vtkImageAccumulateStatistics *stats,
+  const vtkImageAccumulateStatistics *piece)
+{
+  for (int idxC = 0; idxC < 3; ++idxC)
     {
-    outPtr[j] = 0;
+    stats->Sum[idxC] += piece->Sum[idxC];
+    stats->SumSqr[idxC] += piece->SumSqr[idxC];
+    if (piece->Min[idxC] < stats->Min[idxC])
+      {
+      stats->Min[idxC] = piece->Min[idxC];
+      }
+    if (piece->Max[idxC] > stats->Max[idxC])
+      {
+      stats->Max[idxC] = piece->Max[idxC];
+      }
     }
+  stats->Count += piece->Count;
+}
 
-  vtkImageStencilData *stencil = self->GetStencil();
-  bool reverseStencil = (self->GetReverseStencil() != 0);
-  bool ignoreZero = (self->GetIgnoreZero() != 0);
+//----------------------------------------------------------------------------
+// Gather the statistics of a span of single component voxels.  The span
+// is read in groups of four values that are accumulated in four separate
+// lanes, which the compiler can keep in vector registers.  The ignored
+// zeros add nothing to the sums and are left out of the minimum, the
+// maximum and the count.
+template <class T>
+void vtkImageAccumulateSpanStatistics(T *inPtr, T *spanEndPtr,
+                                      bool ignoreZero,
+                                      vtkImageAccumulateStatistics *stats)
+{
+  double sum[4], sumSqr[4], min[4], max[4], v[4];
+  vtkIdType count[4];
+  int lane;
+  for (lane = 0; lane < 4; ++lane)
+    {
+    sum[lane] = 0.0;
+    sumSqr[lane] = 0.0;
+    min[lane] = stats->Min[0];
+    max[lane] = stats->Max[0];
+    count[lane] = 0;
+    }
 
-  vtkImageStencilIterator<T> inIter(inData, stencil, updateExtent, self);
+  vtkIdType n = static_cast<vtkIdType>(spanEndPtr - inPtr);
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+    for (lane = 0; lane < 4; ++lane)
+      {
+      v[lane] = static_cast<double>(inPtr[i + lane]);
+      }
+    for (lane = 0; lane < 4; ++lane)
+      {
+      bool used = (!ignoreZero || v[lane] != 0);
+      sum[lane] += v[lane];
+      sumSqr[lane] += v[lane] * v[lane];
+      min[lane] = (used && v[lane] < min[lane] ? v[lane] : min[lane]);
+      max[lane] = (used && v[lane] > max[lane] ? v[lane] : max[lane]);
+      count[lane] += (used ? 1 : 0);
+      }
+    }
+  for (lane = 0; i < n; ++i, ++lane)
+    {
+    double w = static_cast<double>(inPtr[i]);
+    bool used = (!ignoreZero || w != 0);
+    sum[lane] += w;
+    sumSqr[lane] += w * w;
+    min[lane] = (used && w < min[lane] ? w : min[lane]);
+    max[lane] = (used && w > max[lane] ? w : max[lane]);
+    count[lane] += (used ? 1 : 0);
+    }
+
+  for (lane = 0; lane < 4; ++lane)
+    {
+    stats->Sum[0] += sum[lane];
+    stats->SumSqr[0] += sumSqr[lane];
+    stats->Min[0] = (min[lane] < stats->Min[0] ? min[lane] : stats->Min[0]);
+    stats->Max[0] = (max[lane] > stats->Max[0] ? max[lane] : stats->Max[0]);
+    stats->Count += count[lane];
+    }
+}
+
+//----------------------------------------------------------------------------
+// This templated function accumulates an extent of the input for any type
+// of data into bins laid out like the output.
+template <class T>
+void vtkImageAccumulateExtent(vtkImageAccumulateInfo *info, int extent[6],
+                              vtkAlgorithm *progress, int *outPtr,
+                              vtkImageAccumulateStatistics *stats)
+{
+  int numC = info->NumberOfComponents;
+  int *outExtent = info->OutExtent;
+  vtkIdType *outIncs = info->OutIncrements;
+  double *origin = info->Origin;
+  double *spacing = info->Spacing;
+  bool reverseStencil = info->ReverseStencil;
+  bool ignoreZero = info->IgnoreZero;
+
+  vtkImageStencilIterator<T> inIter(info->InData, info->Stencil, extent,
+                                    progress);
 
   while (!inIter.IsAtEnd())
     {
@@ -181,6 +279,21 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
       T *inPtr = inIter.BeginSpan();
       T *spanEndPtr = inIter.EndSpan();
 
+      if (numC == 1)
+        {
+        vtkImageAccumulateSpanStatistics(inPtr, spanEndPtr, ignoreZero,
+                                         stats);
+        while (inPtr != spanEndPtr)
+          {
+          double v = static_cast<double>(*inPtr++);
+          int outIdx = vtkMath::Floor((v - origin[0]) / spacing[0]);
+          if (outIdx >= outExtent[0] && outIdx <= outExtent[1])
+            {
+            ++outPtr[(outIdx - outExtent[0]) * outIncs[0]];
+            }
+          }
+        }
+
       while (inPtr != spanEndPtr)
         {
         // find the bin for this pixel.
@@ -192,17 +305,17 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
           if (!ignoreZero || v != 0)
             {
             // gather statistics
-            sum[idxC] += v;
-            sumSqr[idxC] += v*v;
-            if (v > max[idxC])
+            stats->Sum[idxC] += v;
+            stats->SumSqr[idxC] += v*v;
+            if (v > stats->Max[idxC])
               {
-              max[idxC] = v;
+              stats->Max[idxC] = v;
               }
-            if (v < min[idxC])
+            if (v < stats->Min[idxC])
               {
-              min[idxC] = v;
+              stats->Min[idxC] = v;
               }
-            (*voxelCount)++;
+            stats->Count++;
             }
 
           // compute the index
@@ -229,32 +342,194 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
 
     inIter.NextSpan();
     }
+}
 
-  // initialize the statistics
-  mean[0] = 0;
-  mean[1] = 0;
-  mean[2] = 0;
+//----------------------------------------------------------------------------
+// The state shared by the threads.  The rows of the update extent are
+// split in chunks; each thread has its own bins, the first one counting
+// into the output, and each chunk its own statistics so that they are
+// added in the same order on every run.
+struct vtkImageAccumulateThreadStruct
+{
+  vtkImageAccumulateInfo *Info;
+  int *UpdateExtent;
+  vtkIdType RowsPerChunk;
+  vtkIdType NumberOfRows;
+  vtkIdType NumberOfBins;
+  int **Bins;
+  vtkImageAccumulateStatistics *ChunkStatistics;
+};
 
-  standardDeviation[0] = 0;
-  standardDeviation[1] = 0;
-  standardDeviation[2] = 0;
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageAccumulateChunks(vtkIdType begin, vtkIdType end,
+                              int threadIndex, void *data)
+{
+  vtkImageAccumulateThreadStruct *str =
+    static_cast<vtkImageAccumulateThreadStruct *>(data);
+  int *uExt = str->UpdateExtent;
+  vtkIdType numY = uExt[3] - uExt[2] + 1;
+
+  int *bins = str->Bins[threadIndex];
+  if (!bins)
+    {
+    bins = new int[str->NumberOfBins];
+    memset(bins, 0, str->NumberOfBins * sizeof(int));
+    str->Bins[threadIndex] = bins;
+    }
+
+  for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+    vtkImageAccumulateStatistics *stats = str->ChunkStatistics + chunk;
+    vtkImageAccumulateInitializeStatistics(stats);
+    vtkIdType row = chunk * str->RowsPerChunk;
+    vtkIdType lastRow = row + str->RowsPerChunk;
+    lastRow = (lastRow < str->NumberOfRows ? lastRow : str->NumberOfRows);
+
+    // The rows of each slice make a sub-extent.
+    while (row < lastRow)
+      {
+      vtkIdType sliceEnd = (row / numY + 1) * numY;
+      vtkIdType last = (sliceEnd < lastRow ? sliceEnd : lastRow) - 1;
+      int extent[6];
+      extent[0] = uExt[0];
+      extent[1] = uExt[1];
+      extent[2] = uExt[2] + static_cast<int>(row % numY);
+      extent[3] = uExt[2] + static_cast<int>(last % numY);
+      extent[4] = extent[5] = uExt[4] + static_cast<int>(row / numY);
+      vtkImageAccumulateExtent<T>(str->Info, extent, 0, bins, stats);
+      row = last + 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// This templated function executes the filter for any type of data.
+template <class T>
+void vtkImageAccumulateExecute(vtkImageAccumulate *self,
+                               vtkImageData *inData, T *,
+                               vtkImageData *outData, int *outPtr,
+                               double min[3], double max[3],
+                               double mean[3],
+                               double standardDeviation[3],
+                               vtkIdType *voxelCount,
+                               int* updateExtent)
+{
+  vtkImageAccumulateInfo info;
+  info.InData = inData;
+  info.Stencil = self->GetStencil();
+  info.ReverseStencil = (self->GetReverseStencil() != 0);
+  info.IgnoreZero = (self->GetIgnoreZero() != 0);
+
+  // input's number of components is used as output dimensionality
+  info.NumberOfComponents = inData->GetNumberOfScalarComponents();
+
+  // get information for output data
+  outData->GetExtent(info.OutExtent);
+  outData->GetIncrements(info.OutIncrements);
+  outData->GetOrigin(info.Origin);
+  outData->GetSpacing(info.Spacing);
+
+  // zero count in every bin
+  int *outExtent = info.OutExtent;
+  vtkIdType size = 1;
+  size *= (outExtent[1] - outExtent[0] + 1);
+  size *= (outExtent[3] - outExtent[2] + 1);
+  size *= (outExtent[5] - outExtent[4] + 1);
+  for (vtkIdType j = 0; j < size; j++)
+    {
+    outPtr[j] = 0;
+    }
+
+  // variables used to compute statistics (filter handles max 3 components)
+  vtkImageAccumulateStatistics stats;
+  vtkImageAccumulateInitializeStatistics(&stats);
+
+  vtkIdType numRows =
+    static_cast<vtkIdType>(updateExtent[3] - updateExtent[2] + 1) *
+    (updateExtent[5] - updateExtent[4] + 1);
+  if (self->GetNumberOfThreads() > 1 && numRows > 1 &&
+      updateExtent[1] >= updateExtent[0])
+    {
+    vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+    int numSlots = pool->GetNumberOfThreads();
+    vtkImageAccumulateThreadStruct str;
+    str.Info = &info;
+    str.UpdateExtent = updateExtent;
+    str.RowsPerChunk = VTK_IMAGE_ACCUMULATE_CHUNK_SIZE /
+      (updateExtent[1] - updateExtent[0] + 1) + 1;
+    str.NumberOfRows = numRows;
+    str.NumberOfBins = size;
+    str.Bins = new int *[numSlots];
+    memset(str.Bins, 0, numSlots * sizeof(int *));
+    // The first thread counts into the output.
+    str.Bins[0] = outPtr;
+    vtkIdType numChunks = (numRows - 1) / str.RowsPerChunk + 1;
+    str.ChunkStatistics = new vtkImageAccumulateStatistics[numChunks];
+
+    // Chunks are accumulated in groups to report progress.
+    vtkIdType groupSize = numChunks/10 + 1;
+    vtkIdType chunk;
+    for (chunk = 0; chunk < numChunks && !self->GetAbortExecute();
+         chunk += groupSize)
+      {
+      self->UpdateProgress(static_cast<double>(chunk)/numChunks);
+      vtkIdType lastChunk = chunk + groupSize;
+      pool->ParallelFor(chunk, (lastChunk < numChunks ? lastChunk : numChunks),
+                        1, vtkImageAccumulateChunks<T>, &str);
+      }
+    vtkIdType numDone = (chunk < numChunks ? chunk : numChunks);
+
+    // Add the bins of the other threads and the statistics of the chunks.
+    for (int slot = 1; slot < numSlots; ++slot)
+      {
+      int *bins = str.Bins[slot];
+      if (bins)
+        {
+        for (vtkIdType j = 0; j < size; j++)
+          {
+          outPtr[j] += bins[j];
+          }
+        delete [] bins;
+        }
+      }
+    for (chunk = 0; chunk < numDone; ++chunk)
+      {
+      vtkImageAccumulateMergeStatistics(&stats, str.ChunkStatistics + chunk);
+      }
+    delete [] str.Bins;
+    delete [] str.ChunkStatistics;
+    }
+  else
+    {
+    vtkImageAccumulateExtent<T>(&info, updateExtent, self, outPtr, &stats);
+    }
+
+  // initialize the statistics
+  *voxelCount = stats.Count;
+  for (int idxC = 0; idxC < 3; ++idxC)
+    {
+    min[idxC] = stats.Min[idxC];
+    max[idxC] = stats.Max[idxC];
+    mean[idxC] = 0;
+    standardDeviation[idxC] = 0;
+    }
 
   if (*voxelCount != 0) // avoid the div0
     {
     double n = static_cast<double>(*voxelCount);
-    mean[0] = sum[0]/n;
-    mean[1] = sum[1]/n;
-    mean[2] = sum[2]/n;
+    mean[0] = stats.Sum[0]/n;
+    mean[1] = stats.Sum[1]/n;
+    mean[2] = stats.Sum[2]/n;
 
     if (*voxelCount - 1 != 0) // avoid the div0
       {
       double m = static_cast<double>(*voxelCount - 1);
-      standardDeviation[0] = sqrt((sumSqr[0] - mean[0]*mean[0]*n)/m);
-      standardDeviation[1] = sqrt((sumSqr[1] - mean[1]*mean[1]*n)/m);
-      standardDeviation[2] = sqrt((sumSqr[2] - mean[2]*mean[2]*n)/m);
+      standardDeviation[0] = sqrt((stats.SumSqr[0] - mean[0]*mean[0]*n)/m);
+      standardDeviation[1] = sqrt((stats.SumSqr[1] - mean[1]*mean[1]*n)/m);
+      standardDeviation[2] = sqrt((stats.SumSqr[2] - mean[2]*mean[2]*n)/m);
       }
     }
-
 }
 
 
@@ -419,6 +694,7 @@ void vtkImageAccumulate::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ReverseStencil: " << (this->ReverseStencil ?
                                          "On\n" : "Off\n");
   os << indent << "IgnoreZero: " << (this->IgnoreZero ? "On" : "Off") << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 
   os << indent << "ComponentOrigin: ( "
      << this->ComponentOrigin[0] << ", "
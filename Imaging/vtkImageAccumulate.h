@@ -31,6 +31,10 @@
 // option with vtkImageMask may result in results being slightly off since 0
 // could be a valid value from your input.
 //
+// The voxels can be accumulated on several threads (see
+// SetNumberOfThreads()).  Each thread then counts into its own bins, and
+// the bins and statistics of the threads are added at the end.
+//
 // .SECTION see also vtkImageMask
 
 #ifndef __vtkImageAccumulate_h
@@ -113,6 +117,13 @@ public:
   vtkGetMacro(IgnoreZero, int);
   vtkBooleanMacro(IgnoreZero, int);
 
+  // Description:
+  // Set/Get the number of threads used to accumulate the voxels.  The
+  // first thread counts into the output, and each of the others
+  // allocates a copy of the bins.  Initial value is 1.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkImageAccumulate();
   ~vtkImageAccumulate();
@@ -139,6 +150,7 @@ protected:
   vtkIdType VoxelCount;
 
   int ReverseStencil;
+  int NumberOfThreads;
 
   virtual int FillInputPortInformation(int port, vtkInformation* info);
 
@@ -75,7 +75,13 @@ int vtkImageCacheFilter::GetCacheSize()
 
 //----------------------------------------------------------------------------
 // This method simply copies by reference the input data to the output.
-void vtkImageCacheFilter::ExecuteData(vtkDataObject *)
+void vtkImageCacheFilter::ExecuteData(vtkDataObject *out)
 {
-  // do nothing just override superclass to prevent warning
+  vtkImageData *output = vtkImageData::SafeDownCast(out);
+  vtkImageData *input = this->GetImageDataInput(0);
+  if (output && input)
+    {
+    output->SetExtent(input->GetExtent());
+    output->GetPointData()->PassData(input->GetPointData());
+    }
 }
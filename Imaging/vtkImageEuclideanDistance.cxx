@@ -19,6 +19,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadPool.h"
 
 #include <math.h>
 
@@ -32,6 +33,27 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
   this->Algorithm = VTK_EDT_SAITO;
+  this->SignedDistance = 0;
+}
+
+//----------------------------------------------------------------------------
+// The Felzenszwalb algorithm produces floats.
+int vtkImageEuclideanDistance::RequestInformation(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestInformation(request, inputVector,
+                                            outputVector))
+    {
+    return 0;
+    }
+  if (this->Algorithm == VTK_EDT_FELZENSZWALB)
+    {
+    vtkDataObject::SetPointDataActiveScalarInfo(
+      outputVector->GetInformationObject(0), VTK_FLOAT, 1);
+    }
+  return 1;
 }
 
 //----------------------------------------------------------------------------
@@ -661,6 +683,298 @@ int vtkImageEuclideanDistance::IterativeRequestData(
 }
 
 
+//----------------------------------------------------------------------------
+// The state shared by the threads of the Felzenszwalb algorithm.  The rows
+// of an axis are numbered with the lower of the two other axes varying
+// fastest, so that consecutive rows are next to each other in memory.
+struct vtkImageEuclideanDistanceRows
+{
+  vtkImageData *InData;
+  void *InPtr;
+  float *OutPtr;
+  float *Inside;
+  int Initialize;
+  float MaximumDistance;
+  int Axis;
+  int Dims[3];
+  vtkIdType Increments[3];
+  double Spacing2;
+};
+
+//----------------------------------------------------------------------------
+// The start of a row of the float buffers along the current axis.
+static vtkIdType vtkImageEuclideanDistanceRowStart(
+  vtkImageEuclideanDistanceRows *rows, vtkIdType row)
+{
+  int axis1 = (rows->Axis == 0 ? 1 : 0);
+  int axis2 = (rows->Axis == 2 ? 1 : 2);
+  return (row % rows->Dims[axis1]) * rows->Increments[axis1] +
+    (row / rows->Dims[axis1]) * rows->Increments[axis2];
+}
+
+//----------------------------------------------------------------------------
+// Copy rows along x of the input into the float buffers.  With Initialize,
+// the non-zero voxels are set to the maximum distance, and the zero voxels
+// of the inside buffer of the signed distance are set to it.
+template <class T>
+void vtkImageEuclideanDistanceInitializeRows(vtkIdType begin, vtkIdType end,
+                                             int vtkNotUsed(threadIndex),
+                                             void *data)
+{
+  vtkImageEuclideanDistanceRows *rows =
+    static_cast<vtkImageEuclideanDistanceRows *>(data);
+  vtkIdType inInc0, inInc1, inInc2;
+  rows->InData->GetIncrements(inInc0, inInc1, inInc2);
+  float maxDist = rows->MaximumDistance;
+  int size = rows->Dims[0];
+
+  for (vtkIdType row = begin; row < end; ++row)
+    {
+    T *inPtr = static_cast<T *>(rows->InPtr) +
+      (row % rows->Dims[1]) * inInc1 + (row / rows->Dims[1]) * inInc2;
+    float *outPtr = rows->OutPtr + row * rows->Increments[1];
+    int idx;
+    if (!rows->Initialize)
+      {
+      for (idx = 0; idx < size; ++idx)
+        {
+        outPtr[idx] = static_cast<float>(inPtr[idx * inInc0]);
+        }
+      }
+    else if (!rows->Inside)
+      {
+      for (idx = 0; idx < size; ++idx)
+        {
+        outPtr[idx] = (inPtr[idx * inInc0] == 0 ? 0.0f : maxDist);
+        }
+      }
+    else
+      {
+      float *inside = rows->Inside + row * rows->Increments[1];
+      for (idx = 0; idx < size; ++idx)
+        {
+        int zero = (inPtr[idx * inInc0] == 0);
+        outPtr[idx] = (zero ? 0.0f : maxDist);
+        inside[idx] = (zero ? maxDist : 0.0f);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the distances along the current axis in rows of a float buffer.
+// Each voxel is the apex of a parabola whose height is its value, and the
+// lower envelope of the parabolas of a row gives its new values.  The
+// voxels at the maximum distance are left out of the envelope, and rows
+// without any other voxel are only clamped.
+static void vtkImageEuclideanDistanceTransformRows(float *buffer,
+                                                   vtkIdType begin,
+                                                   vtkIdType end,
+                                                   vtkImageEuclideanDistanceRows
+                                                   *rows)
+{
+  int size = rows->Dims[rows->Axis];
+  vtkIdType inc = rows->Increments[rows->Axis];
+  double w = rows->Spacing2;
+  float maxDist = rows->MaximumDistance;
+  float *f = new float[size];
+  int *v = new int[size];
+  double *z = new double[size + 1];
+  int q, k, j;
+
+  for (vtkIdType row = begin; row < end; ++row)
+    {
+    float *ptr = buffer + vtkImageEuclideanDistanceRowStart(rows, row);
+
+    // Build the lower envelope.  v holds the apexes of its parabolas,
+    // and z the boundaries between them.
+    k = -1;
+    for (q = 0; q < size; ++q)
+      {
+      f[q] = ptr[q * inc];
+      if (f[q] >= maxDist)
+        {
+        continue;
+        }
+      while (k >= 0)
+        {
+        int p = v[k];
+        double s = ((f[q] + w * q * q) - (f[p] + w * p * p)) /
+          (2.0 * w * (q - p));
+        if (s > z[k])
+          {
+          ++k;
+          v[k] = q;
+          z[k] = s;
+          z[k + 1] = VTK_DOUBLE_MAX;
+          break;
+          }
+        --k;
+        }
+      if (k < 0)
+        {
+        k = 0;
+        v[0] = q;
+        z[0] = -VTK_DOUBLE_MAX;
+        z[1] = VTK_DOUBLE_MAX;
+        }
+      }
+
+    if (k < 0)
+      {
+      for (q = 0; q < size; ++q)
+        {
+        ptr[q * inc] = maxDist;
+        }
+      continue;
+      }
+
+    // Read the envelope.
+    j = 0;
+    for (q = 0; q < size; ++q)
+      {
+      while (z[j + 1] < q)
+        {
+        ++j;
+        }
+      double d = w * (q - v[j]) * (q - v[j]) + f[v[j]];
+      ptr[q * inc] = (d < maxDist ? static_cast<float>(d) : maxDist);
+      }
+    }
+
+  delete [] f;
+  delete [] v;
+  delete [] z;
+}
+
+//----------------------------------------------------------------------------
+static void vtkImageEuclideanDistanceTransform(vtkIdType begin, vtkIdType end,
+                                               int vtkNotUsed(threadIndex),
+                                               void *data)
+{
+  vtkImageEuclideanDistanceRows *rows =
+    static_cast<vtkImageEuclideanDistanceRows *>(data);
+  vtkImageEuclideanDistanceTransformRows(rows->OutPtr, begin, end, rows);
+  if (rows->Inside)
+    {
+    vtkImageEuclideanDistanceTransformRows(rows->Inside, begin, end, rows);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Execute the Felzenszwalb algorithm on all the axes.
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of Sampled
+// Functions. Cornell Computing and Information Science Technical Report
+// TR2004-1963, 2004.
+//
+int vtkImageEuclideanDistance::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (this->Algorithm != VTK_EDT_FELZENSZWALB)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkImageData *inData = vtkImageData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *outData = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  this->AllocateOutputScalars(outData);
+
+  vtkDebugMacro(<<"Executing image euclidean distance");
+
+  int outExt[6];
+  outData->GetExtent(outExt);
+  void *inPtr = inData->GetScalarPointerForExtent(outExt);
+  if (!inPtr)
+    {
+    vtkErrorMacro(<< "Execute: No scalars for update extent.")
+    return 1;
+    }
+  if (outData->GetScalarType() != VTK_FLOAT)
+    {
+    vtkErrorMacro(<< "Execute: Output must be be type float.");
+    return 1;
+    }
+
+  vtkImageEuclideanDistanceRows rows;
+  rows.InData = inData;
+  rows.InPtr = inPtr;
+  rows.OutPtr = static_cast<float *>(outData->GetScalarPointer());
+  rows.Inside = 0;
+  rows.Initialize = this->Initialize;
+  rows.MaximumDistance = static_cast<float>(this->MaximumDistance);
+  outData->GetDimensions(rows.Dims);
+  rows.Increments[0] = 1;
+  rows.Increments[1] = rows.Dims[0];
+  rows.Increments[2] = static_cast<vtkIdType>(rows.Dims[0]) * rows.Dims[1];
+  vtkIdType numVoxels = rows.Increments[2] * rows.Dims[2];
+  if (this->SignedDistance && this->Initialize)
+    {
+    rows.Inside = new float[numVoxels];
+    }
+
+  vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+  int threaded = (this->NumberOfThreads > 1);
+  vtkIdType numRows = numVoxels / rows.Dims[0];
+  switch (inData->GetScalarType())
+    {
+    vtkTemplateMacro(
+      if (threaded)
+        {
+        pool->ParallelFor(0, numRows, 0,
+                          vtkImageEuclideanDistanceInitializeRows<VTK_TT>,
+                          &rows);
+        }
+      else
+        {
+        vtkImageEuclideanDistanceInitializeRows<VTK_TT>(0, numRows, 0,
+                                                        &rows);
+        });
+    default:
+      vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      delete [] rows.Inside;
+      return 1;
+    }
+
+  double *spacing = outData->GetSpacing();
+  for (rows.Axis = 0; rows.Axis < 3 && !this->AbortExecute; ++rows.Axis)
+    {
+    rows.Spacing2 = (this->ConsiderAnisotropy ?
+                     spacing[rows.Axis] * spacing[rows.Axis] : 1.0);
+    numRows = numVoxels / rows.Dims[rows.Axis];
+    if (threaded)
+      {
+      pool->ParallelFor(0, numRows, 0, vtkImageEuclideanDistanceTransform,
+                        &rows);
+      }
+    else
+      {
+      vtkImageEuclideanDistanceTransform(0, numRows, 0, &rows);
+      }
+    this->UpdateProgress((rows.Axis + 1.0) / 3.0);
+    }
+
+  // The voxels are zero in one of the two buffers.
+  if (rows.Inside)
+    {
+    float *outPtr = rows.OutPtr;
+    for (vtkIdType i = 0; i < numVoxels; ++i)
+      {
+      outPtr[i] -= rows.Inside[i];
+      }
+    delete [] rows.Inside;
+    }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // For streaming and threads.  Splits output update extent into num pieces.
 // This method needs to be called num times.  Results must not overlap for
@@ -746,10 +1060,17 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "Saito\n";
     }
+  else if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+    {
+    os << "Felzenszwalb\n";
+    }
   else 
     {
     os << "Saito Cached\n";
     }
+
+  os << indent << "Signed Distance: " 
+     << (this->SignedDistance ? "On\n" : "Off\n");
 }
   
 
@@ -29,6 +29,13 @@
 // slow it very significantly. In that case, one should use 
 // ::SetAlgorithmToSaitoCached() instead for better performance. 
 //
+// ::SetAlgorithmToFelzenszwalb() selects a linear time algorithm that
+// computes the lower envelope of the parabolas centered on the voxels of
+// each row.  It does not go through the intermediate images of the
+// decomposition: all the axes are processed in place in a float output,
+// the rows of each axis on several threads (see SetNumberOfThreads()).
+// It can also compute signed distances (see SetSignedDistance()).
+//
 // References:
 //
 // T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance 
@@ -38,6 +45,10 @@
 // O. Cuisenaire. Distance Transformation: fast algorithms and applications
 // to medical image processing. PhD Thesis, Universite catholique de Louvain,
 // October 1999. http://ltswww.epfl.ch/~cuisenai/papers/oc_thesis.pdf 
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of Sampled
+// Functions. Cornell Computing and Information Science Technical Report
+// TR2004-1963, 2004.
  
 
 #ifndef __vtkImageEuclideanDistance_h
@@ -47,6 +58,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1 
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTK_IMAGING_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -84,7 +96,9 @@ public:
   
   // Description:
   // Any distance bigger than this->MaximumDistance will not ne computed but
-  // set to this->MaximumDistance instead. 
+  // set to this->MaximumDistance instead. The Felzenszwalb algorithm skips
+  // the voxels at this distance and the rows that only contain such voxels,
+  // so a small maximum distance makes it faster.
   vtkSetMacro(MaximumDistance, double);
   vtkGetMacro(MaximumDistance, double);
 
@@ -92,13 +106,24 @@ public:
   // Selects a Euclidean DT algorithm. 
   // 1. Saito
   // 2. Saito-cached 
-  // More algorithms will be added later on. 
+  // 3. Felzenszwalb, whose output is float instead of double.
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
   void SetAlgorithmToSaito () 
     { this->SetAlgorithm(VTK_EDT_SAITO); } 
   void SetAlgorithmToSaitoCached () 
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }   
+  void SetAlgorithmToFelzenszwalb () 
+    { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }   
+
+  // Description:
+  // Used with the Felzenszwalb algorithm and Initialize on to also compute
+  // the distances of the zero voxels to the non-zero ones, and store them
+  // as negative values.  The output then holds the square of the distance
+  // to the boundary of the mask, with a minus sign outside of it.
+  vtkSetMacro(SignedDistance, int);
+  vtkGetMacro(SignedDistance, int);
+  vtkBooleanMacro(SignedDistance, int);
 
   virtual int IterativeRequestData(vtkInformation*,
                                    vtkInformationVector**,
@@ -112,10 +137,19 @@ protected:
   int Initialize;
   int ConsiderAnisotropy;
   int Algorithm;
+  int SignedDistance;
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData *outData);
   
+  // The Felzenszwalb algorithm processes all the axes in RequestData().
+  virtual int RequestInformation(vtkInformation*,
+                                 vtkInformationVector**,
+                                 vtkInformationVector*);
+  virtual int RequestData(vtkInformation*,
+                          vtkInformationVector**,
+                          vtkInformationVector*);
+
   virtual int IterativeRequestInformation(vtkInformation* in,
                                           vtkInformation* out);
   virtual int IterativeRequestUpdateExtent(vtkInformation* in,
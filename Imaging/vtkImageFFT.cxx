@@ -58,7 +58,10 @@ int vtkImageFFT::IterativeRequestUpdateExtent(
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
+// is always doubles.  The lines are transformed in blocks of interleaved
+// lines.  Real input lines are transformed two at a time, as the real and
+// imaginary parts of one complex line, and separated using the symmetry
+// of the transforms of real lines.
 template <class T>
 void vtkImageFFTExecute(vtkImageFFT *self,
                         vtkImageData *inData, int inExt[6], T *inPtr,
@@ -78,6 +81,7 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int idxL, numberOfLines, blockSize, numberOfComplexLines;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -101,9 +105,16 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     return;
     }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the blocks of complex numbers
+  numberOfComplexLines = vtkImageFourierFilter::GetNumberOfLinesPerBlock(
+    inSize0);
+  blockSize = numberOfComplexLines;
+  if (numberOfComponents == 1)
+    {
+    blockSize *= 2;
+    }
+  inComplex = new vtkImageComplex[inSize0 * numberOfComplexLines];
+  outComplex = new vtkImageComplex[inSize0 * numberOfComplexLines];
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -116,46 +127,106 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += numberOfLines)
       {
       if (!id) 
         {
-        if (!(count%target))
-          {
-          self->UpdateProgress(count/(50.0*target) + startProgress);
-          }
-        count++;
+        self->UpdateProgress(count/(50.0*target) + startProgress);
         }
+      numberOfLines = outMax1 - idx1 + 1;
+      if (numberOfLines > blockSize)
+        {
+        numberOfLines = blockSize;
+        }
+      count += numberOfLines;
+
       // copy into complex numbers
+      if (numberOfComponents == 1)
+        {
+        numberOfComplexLines = (numberOfLines + 1) / 2;
+        }
+      else
+        {
+        numberOfComplexLines = numberOfLines;
+        }
       inPtr0 = inPtr1;
       pComplex = inComplex;
       for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
         {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
+        if (numberOfComponents == 1)
+          {
+          pComplex[numberOfComplexLines - 1].Imag = 0.0;
+          for (idxL = 0; idxL < numberOfLines; ++idxL)
+            {
+            double value = static_cast<double>(inPtr0[idxL*inInc1]);
+            if (idxL % 2)
+              {
+              pComplex[idxL / 2].Imag = value;
+              }
+            else
+              {
+              pComplex[idxL / 2].Real = value;
+              }
+            }
+          }
+        else
           { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+          for (idxL = 0; idxL < numberOfLines; ++idxL)
+            {
+            pComplex[idxL].Real = static_cast<double>(inPtr0[idxL*inInc1]);
+            pComplex[idxL].Imag = static_cast<double>(inPtr0[idxL*inInc1+1]);
+            }
           }
         inPtr0 += inInc0;
-        ++pComplex;
+        pComplex += numberOfComplexLines;
         }
       
       // Call the method that performs the fft
-      self->ExecuteFft(inComplex, outComplex, inSize0);
+      self->ExecuteFftLines(inComplex, outComplex, inSize0,
+                            numberOfComplexLines, 1);
 
       // copy into output
       outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
         {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
+        int k = idx0 - inMin0;
+        pComplex = outComplex + k * numberOfComplexLines;
+        if (numberOfComponents == 1)
+          {
+          // X(k) = (Z(k) + conj(Z(N-k))) / 2 and
+          // Y(k) = (Z(k) - conj(Z(N-k))) / 2i
+          vtkImageComplex *pMirror =
+            outComplex + ((inSize0 - k) % inSize0) * numberOfComplexLines;
+          for (idxL = 0; idxL < numberOfLines; ++idxL)
+            {
+            vtkImageComplex &z = pComplex[idxL / 2];
+            vtkImageComplex &zMirror = pMirror[idxL / 2];
+            double *outValue = outPtr0 + idxL*outInc1;
+            if (idxL % 2)
+              {
+              outValue[0] = 0.5 * (z.Imag + zMirror.Imag);
+              outValue[1] = 0.5 * (zMirror.Real - z.Real);
+              }
+            else
+              {
+              outValue[0] = 0.5 * (z.Real + zMirror.Real);
+              outValue[1] = 0.5 * (z.Imag - zMirror.Imag);
+              }
+            }
+          }
+        else
+          {
+          for (idxL = 0; idxL < numberOfLines; ++idxL)
+            {
+            outPtr0[idxL*outInc1] = pComplex[idxL].Real;
+            outPtr0[idxL*outInc1+1] = pComplex[idxL].Imag;
+            }
+          }
         outPtr0 += outInc0;
-        ++pComplex;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += numberOfLines*inInc1;
+      outPtr1 += numberOfLines*outInc1;
       }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
@@ -14,14 +14,444 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
+#include "vtkCriticalSection.h"
+
+#include <vtkstd/map>
+
 #include <math.h>
 
+// The number of complex numbers in a block of interleaved lines.
+#define VTK_IMAGE_FOURIER_BLOCK_SIZE 8192
+
+// The largest number of mixed radix stages.
+#define VTK_IMAGE_FOURIER_MAX_STAGES 32
+
+static const double vtkImageFourierPi = 3.14159265358979323846;
+
+/*=========================================================================
+        Plans of transforms.
+=========================================================================*/
+
+//----------------------------------------------------------------------------
+// The forward transform of a length.  A length whose prime factors are 2,
+// 3, 5 and 7 is computed with Stockham autosort stages of radix 4, 2, 3,
+// 5 and 7, which read and write the lines in natural order.  Any other
+// length N uses Bluestein's algorithm: the transform is the product of a
+// chirp with the circular convolution of the chirped input and the
+// conjugate chirp, computed with a power of two transform of length
+// M >= 2N-1.  A plan is not modified after it is built, so several
+// threads can use it at once.
+class vtkImageFourierFilterPlan
+{
+public:
+  vtkImageFourierFilterPlan(int n);
+  ~vtkImageFourierFilterPlan();
+
+  // Transform numberOfLines interleaved lines of data, using work, of the
+  // same size, as scratch.  Returns the array that holds the result.
+  vtkImageComplex *Execute(vtkImageComplex *data, vtkImageComplex *work,
+                           int numberOfLines);
+
+protected:
+  void ExecuteStage(int stage, int n, int stride, vtkImageComplex *x,
+                    vtkImageComplex *y);
+  void ExecuteBluestein(vtkImageComplex *data, int numberOfLines);
+
+  int N;
+
+  // The radix of each stage, with the twiddle factors w(n)^(j*k) of the
+  // stage, for j < n/radix and 0 < k < radix, where n is the length left
+  // to transform before the stage.
+  int NumberOfStages;
+  int Radix[VTK_IMAGE_FOURIER_MAX_STAGES];
+  vtkImageComplex *Twiddles[VTK_IMAGE_FOURIER_MAX_STAGES];
+
+  // The roots of unity of the radix 5 and 7 butterflies.
+  vtkImageComplex Roots5[5];
+  vtkImageComplex Roots7[7];
+
+  // Bluestein's algorithm: the plan of length M, the chirp
+  // exp(-i*pi*k*k/N) and the transform of the conjugate chirp, divided
+  // by M.
+  vtkImageFourierFilterPlan *Convolution;
+  vtkImageComplex *Chirp;
+  vtkImageComplex *Kernel;
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan::vtkImageFourierFilterPlan(int n)
+{
+  int i, j, k;
+
+  this->N = n;
+  this->NumberOfStages = 0;
+  this->Convolution = NULL;
+  this->Chirp = NULL;
+  this->Kernel = NULL;
+  for (k = 0; k < 5; ++k)
+    {
+    vtkImageComplexPolarSet(this->Roots5[k], 1.0,
+                            -2.0 * vtkImageFourierPi * k / 5.0);
+    }
+  for (k = 0; k < 7; ++k)
+    {
+    vtkImageComplexPolarSet(this->Roots7[k], 1.0,
+                            -2.0 * vtkImageFourierPi * k / 7.0);
+    }
+
+  // Factor the length, radix 4 first.
+  static const int radices[] = { 4, 2, 3, 5, 7 };
+  int rest = n;
+  for (i = 0; i < 5; ++i)
+    {
+    while (rest % radices[i] == 0 && rest > 1)
+      {
+      this->Radix[this->NumberOfStages++] = radices[i];
+      rest /= radices[i];
+      }
+    }
+
+  if (rest == 1)
+    {
+    int length = n;
+    for (i = 0; i < this->NumberOfStages; ++i)
+      {
+      int p = this->Radix[i];
+      int m = length / p;
+      vtkImageComplex *twiddle = new vtkImageComplex[m * (p - 1)];
+      this->Twiddles[i] = twiddle;
+      for (j = 0; j < m; ++j)
+        {
+        for (k = 1; k < p; ++k)
+          {
+          vtkImageComplexPolarSet(*twiddle, 1.0,
+            -2.0 * vtkImageFourierPi * ((j * k) % length) / length);
+          ++twiddle;
+          }
+        }
+      length = m;
+      }
+    return;
+    }
+
+  // Bluestein's algorithm.
+  this->NumberOfStages = 0;
+  int m = 1;
+  while (m < 2 * n - 1)
+    {
+    m *= 2;
+    }
+  this->Convolution = new vtkImageFourierFilterPlan(m);
+  this->Chirp = new vtkImageComplex[n];
+  // k*k modulo 2N keeps the angle accurate for long transforms.
+  int k2 = 0;
+  for (k = 0; k < n; ++k)
+    {
+    vtkImageComplexPolarSet(this->Chirp[k], 1.0,
+                            -vtkImageFourierPi * k2 / n);
+    k2 += 2 * k + 1;
+    while (k2 >= 2 * n)
+      {
+      k2 -= 2 * n;
+      }
+    }
+  this->Kernel = new vtkImageComplex[m];
+  vtkImageComplex *work = new vtkImageComplex[m];
+  for (k = 0; k < m; ++k)
+    {
+    vtkImageComplexEuclidSet(this->Kernel[k], 0.0, 0.0);
+    }
+  for (k = 0; k < n; ++k)
+    {
+    vtkImageComplexConjugate(this->Chirp[k], this->Kernel[k]);
+    if (k > 0)
+      {
+      vtkImageComplexConjugate(this->Chirp[k], this->Kernel[m - k]);
+      }
+    }
+  vtkImageComplex *result = this->Convolution->Execute(this->Kernel, work, 1);
+  for (k = 0; k < m; ++k)
+    {
+    vtkImageComplexScale(this->Kernel[k], 1.0 / m, result[k]);
+    }
+  delete [] work;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan::~vtkImageFourierFilterPlan()
+{
+  for (int i = 0; i < this->NumberOfStages; ++i)
+    {
+    delete [] this->Twiddles[i];
+    }
+  delete this->Convolution;
+  delete [] this->Chirp;
+  delete [] this->Kernel;
+}
+
+//----------------------------------------------------------------------------
+// One Stockham stage: the length left to transform, n, is split into
+// radix sub-sequences.  Each group of stride consecutive numbers (the
+// interleaved lines and the transforms of the earlier stages) goes
+// through the same butterfly, which the compiler can vectorize.
+void vtkImageFourierFilterPlan::ExecuteStage(int stage, int n, int stride,
+                                             vtkImageComplex *x,
+                                             vtkImageComplex *y)
+{
+  static const double sin60 = 0.86602540378443864676;
+  int p = this->Radix[stage];
+  int m = n / p;
+  vtkImageComplex *twiddle = this->Twiddles[stage];
+  vtkImageComplex a[7], c[7];
+  int j, q, k, r;
+
+  for (j = 0; j < m; ++j, twiddle += p - 1)
+    {
+    vtkImageComplex *in = x + j * stride;
+    vtkImageComplex *out = y + j * p * stride;
+    for (q = 0; q < stride; ++q)
+      {
+      for (r = 0; r < p; ++r)
+        {
+        a[r] = in[q + r * m * stride];
+        }
+      switch (p)
+        {
+        case 2:
+          vtkImageComplexAdd(a[0], a[1], c[0]);
+          vtkImageComplexSubtract(a[0], a[1], c[1]);
+          break;
+        case 3:
+          {
+          vtkImageComplex t1, t2, t3;
+          vtkImageComplexAdd(a[1], a[2], t1);
+          vtkImageComplexSubtract(a[1], a[2], t2);
+          vtkImageComplexAdd(a[0], t1, c[0]);
+          t1.Real = a[0].Real - 0.5 * t1.Real;
+          t1.Imag = a[0].Imag - 0.5 * t1.Imag;
+          // -i*sin(60)*(a1-a2)
+          vtkImageComplexEuclidSet(t3, sin60 * t2.Imag, -sin60 * t2.Real);
+          vtkImageComplexAdd(t1, t3, c[1]);
+          vtkImageComplexSubtract(t1, t3, c[2]);
+          }
+          break;
+        case 4:
+          {
+          vtkImageComplex t0, t1, t2, t3;
+          vtkImageComplexAdd(a[0], a[2], t0);
+          vtkImageComplexSubtract(a[0], a[2], t1);
+          vtkImageComplexAdd(a[1], a[3], t2);
+          // -i*(a1-a3)
+          vtkImageComplexEuclidSet(t3, a[1].Imag - a[3].Imag,
+                                   a[3].Real - a[1].Real);
+          vtkImageComplexAdd(t0, t2, c[0]);
+          vtkImageComplexAdd(t1, t3, c[1]);
+          vtkImageComplexSubtract(t0, t2, c[2]);
+          vtkImageComplexSubtract(t1, t3, c[3]);
+          }
+          break;
+        default:
+          {
+          vtkImageComplex *roots = (p == 5 ? this->Roots5 : this->Roots7);
+          for (k = 0; k < p; ++k)
+            {
+            c[k] = a[0];
+            for (r = 1; r < p; ++r)
+              {
+              const vtkImageComplex &w = roots[(r * k) % p];
+              c[k].Real += a[r].Real * w.Real - a[r].Imag * w.Imag;
+              c[k].Imag += a[r].Real * w.Imag + a[r].Imag * w.Real;
+              }
+            }
+          }
+          break;
+        }
+      out[q] = c[0];
+      for (k = 1; k < p; ++k)
+        {
+        vtkImageComplexMultiply(c[k], twiddle[k - 1], out[q + k * stride]);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkImageComplex *vtkImageFourierFilterPlan::Execute(vtkImageComplex *data,
+                                                    vtkImageComplex *work,
+                                                    int numberOfLines)
+{
+  if (this->Convolution)
+    {
+    this->ExecuteBluestein(data, numberOfLines);
+    return data;
+    }
+
+  vtkImageComplex *x = data;
+  vtkImageComplex *y = work;
+  int n = this->N;
+  int stride = numberOfLines;
+  for (int i = 0; i < this->NumberOfStages; ++i)
+    {
+    this->ExecuteStage(i, n, stride, x, y);
+    n /= this->Radix[i];
+    stride *= this->Radix[i];
+    vtkImageComplex *tmp = x;
+    x = y;
+    y = tmp;
+    }
+  return x;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilterPlan::ExecuteBluestein(vtkImageComplex *data,
+                                                 int numberOfLines)
+{
+  int n = this->N;
+  int m = this->Convolution->N;
+  vtkIdType size = static_cast<vtkIdType>(m) * numberOfLines;
+  vtkImageComplex *a = new vtkImageComplex[size];
+  vtkImageComplex *work = new vtkImageComplex[size];
+  vtkImageComplex *p, *result;
+  int k, l;
+
+  // Chirp the input and pad it with zeros.
+  p = a;
+  for (k = 0; k < n; ++k)
+    {
+    for (l = 0; l < numberOfLines; ++l, ++p)
+      {
+      vtkImageComplexMultiply(data[k * numberOfLines + l], this->Chirp[k], *p);
+      }
+    }
+  for (; p < a + size; ++p)
+    {
+    vtkImageComplexEuclidSet(*p, 0.0, 0.0);
+    }
+
+  // Convolve with the conjugate chirp: multiply the transforms, and
+  // compute the inverse transform as the conjugate of the forward
+  // transform of the conjugate.
+  result = this->Convolution->Execute(a, work, numberOfLines);
+  p = result;
+  for (k = 0; k < m; ++k)
+    {
+    for (l = 0; l < numberOfLines; ++l, ++p)
+      {
+      vtkImageComplexMultiply(*p, this->Kernel[k], *p);
+      p->Imag = -p->Imag;
+      }
+    }
+  result = this->Convolution->Execute(result, result == a ? work : a,
+                                      numberOfLines);
+
+  p = data;
+  for (k = 0; k < n; ++k)
+    {
+    for (l = 0; l < numberOfLines; ++l, ++p)
+      {
+      vtkImageComplex c;
+      vtkImageComplexConjugate(result[k * numberOfLines + l], c);
+      vtkImageComplexMultiply(c, this->Chirp[k], *p);
+      }
+    }
+
+  delete [] a;
+  delete [] work;
+}
+
+//----------------------------------------------------------------------------
+class vtkImageFourierFilterPlans
+{
+public:
+  ~vtkImageFourierFilterPlans()
+    {
+    vtkstd::map<int, vtkImageFourierFilterPlan *>::iterator it;
+    for (it = this->Plans.begin(); it != this->Plans.end(); ++it)
+      {
+      delete it->second;
+      }
+    }
+
+  // Find the plan of a length, or build it.
+  vtkImageFourierFilterPlan *GetPlan(int n)
+    {
+    this->Lock.Lock();
+    vtkImageFourierFilterPlan *&plan = this->Plans[n];
+    if (!plan)
+      {
+      plan = new vtkImageFourierFilterPlan(n);
+      }
+    vtkImageFourierFilterPlan *result = plan;
+    this->Lock.Unlock();
+    return result;
+    }
+
+  vtkstd::map<int, vtkImageFourierFilterPlan *> Plans;
+  vtkSimpleCriticalSection Lock;
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::vtkImageFourierFilter()
+{
+  this->Plans = new vtkImageFourierFilterPlans;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::~vtkImageFourierFilter()
+{
+  delete this->Plans;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFourierFilter::GetNumberOfLinesPerBlock(int N)
+{
+  int lines = VTK_IMAGE_FOURIER_BLOCK_SIZE / (N > 0 ? N : 1);
+  return (lines > 1 ? lines : 1);
+}
+
+//----------------------------------------------------------------------------
+// The backward transform is the conjugate of the forward transform of the
+// conjugate, divided by N.
+void vtkImageFourierFilter::ExecuteFftLines(vtkImageComplex *in,
+                                            vtkImageComplex *out, int N,
+                                            int numberOfLines, int fb)
+{
+  vtkIdType size = static_cast<vtkIdType>(N) * numberOfLines;
+  vtkIdType idx;
+
+  if (fb == -1)
+    {
+    for (idx = 0; idx < size; ++idx)
+      {
+      in[idx].Real = in[idx].Real / N;
+      in[idx].Imag = -in[idx].Imag / N;
+      }
+    }
+  vtkImageComplex *result =
+    this->Plans->GetPlan(N)->Execute(in, out, numberOfLines);
+  if (result != out)
+    {
+    for (idx = 0; idx < size; ++idx)
+      {
+      out[idx] = result[idx];
+      }
+    }
+  if (fb == -1)
+    {
+    for (idx = 0; idx < size; ++idx)
+      {
+      out[idx].Imag = -out[idx].Imag;
+      }
+    }
+}
+
 
 
 /*=========================================================================
         Vectors of complex numbers.
 =========================================================================*/
 
+#ifndef VTK_LEGACY_REMOVE
 //----------------------------------------------------------------------------
 // This function calculates one step of a FFT.
 // It is specialized for a factor of 2. 
@@ -31,6 +461,7 @@ void vtkImageFourierFilter::ExecuteFftStep2(vtkImageComplex *p_in,
                                             vtkImageComplex *p_out, 
                                             int N, int bsize, int fb)
 {
+  VTK_LEGACY_BODY(vtkImageFourierFilter::ExecuteFftStep2, "VTK 5.8");
   int i1, i2;
   vtkImageComplex *p1, *p2, *p3;
   vtkImageComplex q, fact1, fact, temp;
@@ -101,6 +532,7 @@ void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
                                             vtkImageComplex *p_out,
                                             int N, int bsize, int n, int fb)
 {
+  VTK_LEGACY_BODY(vtkImageFourierFilter::ExecuteFftStepN, "VTK 5.8");
   int i0, i1, i2, i3;
   vtkImageComplex *p1, *p2, *p3;
   vtkImageComplex q, fact, temp;
@@ -142,8 +574,7 @@ void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
       }
     }
 }
-
-
+#endif
 
 //----------------------------------------------------------------------------
 // This function calculates the whole fft (or rfft) of an array.
@@ -154,59 +585,7 @@ void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
                                                       vtkImageComplex *out, 
                                                       int N, int fb)
 {
-  vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
-  int idx;
-
-  // If this is a reverse transform (scale accordingly).
-  if(fb == -1)
-    {  
-    p1 = in;
-    for(idx = 0; idx < N; ++idx)
-      {
-      p1->Real = p1->Real / static_cast<float>(N);
-      p1->Imag = p1->Imag / static_cast<float>(N);
-      ++p1;
-      }
-    }
-  p1 = in;
-  p2 = out;
-  while(block_size < N && n <= N)
-    {
-    if((rest_size % n) == 0)
-      {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
-        {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
-        }
-      else
-        {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
-        }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
-      }
-    else
-      {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
-      }
-    }
-  // If the results ended up in the input, copy to output.
-  if(p1 != out)
-    {
-    for(n = 0; n < N; ++n)
-      {
-      *out++ = *p1++;
-      }
-    }
+  this->ExecuteFftLines(in, out, N, 1, fb);
 }
 
 
@@ -18,6 +18,14 @@
 // this superclass is a container for methods that manipulate these structure
 // including fast Fourier transforms.  Complex numbers may become a class.
 // This should really be a helper class.
+//
+// The transforms are computed with plans that the filter builds once for
+// each length and reuses across executions.  Lengths whose prime factors
+// are 2, 3, 5 and 7 are transformed with mixed radix butterflies, other
+// lengths with Bluestein's algorithm, which turns them into a convolution
+// computed with a power of two transform.  Several lines are transformed
+// together, stored interleaved, so that an axis pass works on blocks that
+// fit in the cache.
 #ifndef __vtkImageFourierFilter_h
 #define __vtkImageFourierFilter_h
 
@@ -81,6 +89,7 @@ typedef struct{
 }
 
 /******************* End of COMPLEX number stuff ********************/
+class vtkImageFourierFilterPlans;
 //ETX
 
 class VTK_IMAGING_EXPORT vtkImageFourierFilter : public vtkImageDecomposeFilter
@@ -105,19 +114,41 @@ public:
   // (It is engineered for no decimation)
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
+  // Description:
+  // This function calculates the fft (fb = 1) or rfft (fb = -1) of
+  // numberOfLines lines of length N stored interleaved: value i of line l
+  // is at in[i*numberOfLines + l].  The results are stored the same way
+  // in out.  The contents of the input array are changed.  It can be
+  // called from several threads at once.
+  void ExecuteFftLines(vtkImageComplex *in, vtkImageComplex *out, int N,
+                       int numberOfLines, int fb);
+
+  // Description:
+  // The number of lines to transform together so that a block of lines
+  // of length N fits in the cache.
+  static int GetNumberOfLinesPerBlock(int N);
+
   //ETX
   
 protected:
-  vtkImageFourierFilter() {};
-  ~vtkImageFourierFilter() {};
+  vtkImageFourierFilter();
+  ~vtkImageFourierFilter();
 
   //BTX
-  void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out, 
-                       int N, int bsize, int fb);
-  void ExecuteFftStepN(vtkImageComplex *p_in, vtkImageComplex *p_out,
-                       int N, int bsize, int n, int fb);
+  // Description:
+  // One step of an FFT of factor 2, or of any factor n.
+  // @deprecated as of VTK 5.8. The transforms use ExecuteFftLines.
+  VTK_LEGACY(void ExecuteFftStep2(vtkImageComplex *p_in,
+                                  vtkImageComplex *p_out,
+                                  int N, int bsize, int fb));
+  VTK_LEGACY(void ExecuteFftStepN(vtkImageComplex *p_in,
+                                  vtkImageComplex *p_out,
+                                  int N, int bsize, int n, int fb));
   void ExecuteFftForwardBackward(vtkImageComplex *in, vtkImageComplex *out, 
                                  int N, int fb);
+
+  // The plans of the lengths transformed so far.
+  vtkImageFourierFilterPlans *Plans;
   //ETX
 private:
   vtkImageFourierFilter(const vtkImageFourierFilter&);  // Not implemented.
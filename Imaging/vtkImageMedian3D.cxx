@@ -22,9 +22,19 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTypeTraits.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/map>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkImageMedian3D);
 
+// The number of pixels whose neighborhoods go through a sorting network
+// together, and the largest neighborhood sorted with a network.
+#define VTK_IMAGE_MEDIAN_LANES 8
+#define VTK_IMAGE_MEDIAN_MAX_NETWORK 125
+
 //-----------------------------------------------------------------------------
 // Construct an instance of vtkImageMedian3D fitler.
 vtkImageMedian3D::vtkImageMedian3D()
@@ -32,6 +42,7 @@ vtkImageMedian3D::vtkImageMedian3D()
   this->NumberOfElements = 0;
   this->SetKernelSize(1,1,1);
   this->HandleBoundaries = 1;
+  this->MedianMode = VTK_IMAGE_MEDIAN_SORT;
 }
 
 //-----------------------------------------------------------------------------
@@ -45,6 +56,20 @@ void vtkImageMedian3D::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "NumberOfElements: " << this->NumberOfElements << endl;
+  os << indent << "MedianMode: " << this->GetMedianModeAsString() << endl;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkImageMedian3D::GetMedianModeAsString()
+{
+  switch (this->MedianMode)
+    {
+    case VTK_IMAGE_MEDIAN_SORT:
+      return "Sort";
+    case VTK_IMAGE_MEDIAN_FAST:
+      return "Fast";
+    }
+  return "";
 }
 
 //-----------------------------------------------------------------------------
@@ -365,6 +390,418 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
   delete [] Sort;
 }
 
+//-----------------------------------------------------------------------------
+// The range of the neighborhood of an output index along an axis, clipped
+// by the input extent.
+static void vtkImageMedian3DHood(int idx, int middle, int size,
+                                 int inMin, int inMax, int &min, int &max)
+{
+  min = idx - middle;
+  max = min + size - 1;
+  min = (min > inMin) ? min : inMin;
+  max = (max < inMax) ? max : inMax;
+}
+
+//-----------------------------------------------------------------------------
+// Compute the medians of 8 and 16 bit integers with a histogram of the
+// neighborhood.  Along each row, the columns of the neighborhood that
+// leave it are removed from the histogram and those that enter it are
+// added.  The median bin moves from its previous position, and the
+// histogram is emptied at the end of each row so that it never has to be
+// cleared.
+template <class T>
+void vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                      vtkImageData *inData, T *inPtr,
+                                      vtkImageData *outData, T *outPtr,
+                                      int outExt[6], int id, int numComp)
+{
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int *inExt = inData->GetExtent();
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int outIdx0, outIdx1, outIdx2, outIdxC;
+  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
+  int hoodIdx1, hoodIdx2, min0, max0;
+  unsigned long count = 0;
+  unsigned long target;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+
+  // The bins of all the values of the type.
+  int offset = -static_cast<int>(vtkTypeTraits<T>::Min());
+  int numBins = static_cast<int>(vtkTypeTraits<T>::Max()) + offset + 1;
+  int *hist = new int[numBins];
+  memset(hist, 0, numBins * sizeof(int));
+  int median = 0;
+  int below = 0;
+  int num = 0;
+
+  target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1)*
+                                      (outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+    {
+    vtkImageMedian3DHood(outIdx2, kernelMiddle[2], kernelSize[2],
+                         inExt[4], inExt[5], hoodMin2, hoodMax2);
+    for (outIdx1 = outExt[2];
+         !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      vtkImageMedian3DHood(outIdx1, kernelMiddle[1], kernelSize[1],
+                           inExt[2], inExt[3], hoodMin1, hoodMax1);
+      T *outPtr1 = outPtr + (outIdx1 - outExt[2]) * outInc1 +
+        (outIdx2 - outExt[4]) * outInc2;
+      for (outIdxC = 0; outIdxC < numComp; ++outIdxC)
+        {
+        T *inPtr1 = inPtr + (hoodMin1 - inExt[2]) * inInc1 +
+          (hoodMin2 - inExt[4]) * inInc2 + outIdxC;
+        hoodMin0 = hoodMax0 = outExt[0] - kernelMiddle[0];
+        for (outIdx0 = outExt[0]; outIdx0 <= outExt[1] + 1; ++outIdx0)
+          {
+          // Past the end of the row, remove all the columns.
+          if (outIdx0 <= outExt[1])
+            {
+            vtkImageMedian3DHood(outIdx0, kernelMiddle[0], kernelSize[0],
+                                 inExt[0], inExt[1], min0, max0);
+            }
+          else
+            {
+            min0 = max0 + 1;
+            }
+
+          // Update the histogram with the columns that leave and enter
+          // the neighborhood.
+          for (int step = 0; step < 2; ++step)
+            {
+            int first = (step ? hoodMax0 + 1 : hoodMin0);
+            int last = (step ? max0 : min0 - 1);
+            int sign = (step ? 1 : -1);
+            if (outIdx0 == outExt[0])
+              {
+              first = (step ? min0 : 1);
+              last = (step ? max0 : 0);
+              }
+            for (int hoodIdx0 = first; hoodIdx0 <= last; ++hoodIdx0)
+              {
+              T *inPtr2 = inPtr1 + (hoodIdx0 - inExt[0]) * inInc0;
+              for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+                {
+                T *inPtr0 = inPtr2;
+                for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                  {
+                  int bin = static_cast<int>(*inPtr0) + offset;
+                  hist[bin] += sign;
+                  if (bin < median)
+                    {
+                    below += sign;
+                    }
+                  inPtr0 += inInc1;
+                  }
+                inPtr2 += inInc2;
+                }
+              num += sign * (hoodMax1 - hoodMin1 + 1) *
+                (hoodMax2 - hoodMin2 + 1);
+              }
+            }
+          hoodMin0 = min0;
+          hoodMax0 = max0;
+          if (outIdx0 > outExt[1])
+            {
+            break;
+            }
+
+          // Move the median bin until it holds the value of rank num/2.
+          int rank = num / 2;
+          while (below > rank)
+            {
+            --median;
+            below -= hist[median];
+            }
+          while (below + hist[median] <= rank)
+            {
+            below += hist[median];
+            ++median;
+            }
+          outPtr1[(outIdx0 - outExt[0]) * outInc0 + outIdxC] =
+            static_cast<T>(median - offset);
+          }
+        }
+      }
+    }
+
+  delete [] hist;
+}
+
+//-----------------------------------------------------------------------------
+// A network of comparators that moves the value of a rank of a set of
+// values to its place in the sorted set: Batcher's odd-even merge sort of
+// a power of two number of values, without the comparators that do not
+// lead to that rank.
+static void vtkImageMedian3DBuildNetwork(int size, int rank,
+                                         vtkstd::vector<int> &network)
+{
+  vtkstd::vector<int> all;
+  int p, k, j, i;
+  for (p = 1; p < size; p *= 2)
+    {
+    for (k = p; k >= 1; k /= 2)
+      {
+      for (j = k % p; j + k < size; j += 2 * k)
+        {
+        for (i = 0; i < k && i < size - j - k; ++i)
+          {
+          if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+            {
+            all.push_back(i + j);
+            all.push_back(i + j + k);
+            }
+          }
+        }
+      }
+    }
+
+  // Keep the comparators that the rank depends on, in their order.
+  vtkstd::vector<char> needed(size, 0);
+  needed[rank] = 1;
+  vtkstd::vector<int> kept;
+  for (i = static_cast<int>(all.size()) - 2; i >= 0; i -= 2)
+    {
+    if (needed[all[i]] || needed[all[i + 1]])
+      {
+      needed[all[i]] = needed[all[i + 1]] = 1;
+      kept.push_back(all[i + 1]);
+      kept.push_back(all[i]);
+      }
+    }
+  network.assign(kept.rbegin(), kept.rend());
+}
+
+//-----------------------------------------------------------------------------
+// Compute the medians of other scalar types.  Where VTK_IMAGE_MEDIAN_LANES
+// consecutive pixels of a row have whole neighborhoods along the row, the
+// neighborhoods are stored side by side and go through a sorting network
+// together: each comparator is a minimum and a maximum of arrays of
+// values, which the compiler can vectorize.  Each neighborhood is padded
+// with copies of its smallest and largest values up to a power of two.
+// The other pixels, and all of them when the neighborhoods have more than
+// VTK_IMAGE_MEDIAN_MAX_NETWORK values, use a partial sort of their
+// neighborhood.
+template <class T>
+void vtkImageMedian3DNetworkExecute(vtkImageMedian3D *self,
+                                    vtkImageData *inData, T *inPtr,
+                                    vtkImageData *outData, T *outPtr,
+                                    int outExt[6], int id, int numComp)
+{
+  const int lanes = VTK_IMAGE_MEDIAN_LANES;
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int *inExt = inData->GetExtent();
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int outIdx0, outIdx1, outIdx2, outIdxC;
+  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
+  int hoodIdx0, hoodIdx1, hoodIdx2, lane, i;
+  unsigned long count = 0;
+  unsigned long target;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+
+  // Larger neighborhoods are only partially sorted.
+  int numElements = self->GetNumberOfElements();
+  int network = (numElements <= VTK_IMAGE_MEDIAN_MAX_NETWORK);
+  int size = 1;
+  while (size < numElements)
+    {
+    size *= 2;
+    }
+  T *values = new T[network ? size * lanes : 1];
+  T *sort = new T[numElements];
+
+  // The networks of the neighborhood sizes found so far.
+  vtkstd::map<int, vtkstd::vector<int> > networks;
+
+  target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1)*
+                                      (outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+    {
+    vtkImageMedian3DHood(outIdx2, kernelMiddle[2], kernelSize[2],
+                         inExt[4], inExt[5], hoodMin2, hoodMax2);
+    for (outIdx1 = outExt[2];
+         !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      vtkImageMedian3DHood(outIdx1, kernelMiddle[1], kernelSize[1],
+                           inExt[2], inExt[3], hoodMin1, hoodMax1);
+      T *outPtr1 = outPtr + (outIdx1 - outExt[2]) * outInc1 +
+        (outIdx2 - outExt[4]) * outInc2;
+      for (outIdxC = 0; outIdxC < numComp; ++outIdxC)
+        {
+        T *inPtr1 = inPtr + (hoodMin1 - inExt[2]) * inInc1 +
+          (hoodMin2 - inExt[4]) * inInc2 + outIdxC;
+        outIdx0 = outExt[0];
+        while (outIdx0 <= outExt[1])
+          {
+          hoodMin0 = outIdx0 - kernelMiddle[0];
+          hoodMax0 = hoodMin0 + kernelSize[0] - 1 + lanes - 1;
+          if (network && outIdx0 + lanes - 1 <= outExt[1] &&
+              hoodMin0 >= inExt[0] && hoodMax0 <= inExt[1])
+            {
+            // Store the neighborhoods side by side.
+            int num = 0;
+            T *inPtr2 = inPtr1 + (hoodMin0 - inExt[0]) * inInc0;
+            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+              {
+              T *inPtr0 = inPtr2;
+              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                for (hoodIdx0 = 0; hoodIdx0 < kernelSize[0]; ++hoodIdx0)
+                  {
+                  T *ptr = inPtr0 + hoodIdx0 * inInc0;
+                  T *value = values + num * lanes;
+                  for (lane = 0; lane < lanes; ++lane)
+                    {
+                    value[lane] = ptr[lane * inInc0];
+                    }
+                  ++num;
+                  }
+                inPtr0 += inInc1;
+                }
+              inPtr2 += inInc2;
+              }
+
+            // Pad them with their smallest and largest values.
+            int padded = 1;
+            while (padded < num)
+              {
+              padded *= 2;
+              }
+            int numLow = (padded - num) / 2;
+            if (padded > num)
+              {
+              T low[VTK_IMAGE_MEDIAN_LANES];
+              T high[VTK_IMAGE_MEDIAN_LANES];
+              for (lane = 0; lane < lanes; ++lane)
+                {
+                low[lane] = high[lane] = values[lane];
+                }
+              for (i = 1; i < num; ++i)
+                {
+                T *value = values + i * lanes;
+                for (lane = 0; lane < lanes; ++lane)
+                  {
+                  low[lane] = (value[lane] < low[lane] ? value[lane] :
+                               low[lane]);
+                  high[lane] = (high[lane] < value[lane] ? value[lane] :
+                                high[lane]);
+                  }
+                }
+              for (i = num; i < padded; ++i)
+                {
+                T *value = values + i * lanes;
+                T *pad = (i < num + numLow ? low : high);
+                for (lane = 0; lane < lanes; ++lane)
+                  {
+                  value[lane] = pad[lane];
+                  }
+                }
+              }
+
+            // Sort them.
+            int rank = numLow + num / 2;
+            vtkstd::vector<int> &comparators = networks[num];
+            if (comparators.empty() && padded > 1)
+              {
+              vtkImageMedian3DBuildNetwork(padded, rank, comparators);
+              }
+            int numComparators = static_cast<int>(comparators.size());
+            for (i = 0; i < numComparators; i += 2)
+              {
+              // Load both rows before storing either, since the compiler
+              // cannot tell that they do not overlap, and write the minimum
+              // and the maximum as separate loops so that they become
+              // vector instructions instead of branches.
+              T *a = values + comparators[i] * lanes;
+              T *b = values + comparators[i + 1] * lanes;
+              T x[VTK_IMAGE_MEDIAN_LANES];
+              T y[VTK_IMAGE_MEDIAN_LANES];
+              for (lane = 0; lane < lanes; ++lane)
+                {
+                x[lane] = a[lane];
+                }
+              for (lane = 0; lane < lanes; ++lane)
+                {
+                y[lane] = b[lane];
+                }
+              for (lane = 0; lane < lanes; ++lane)
+                {
+                a[lane] = (y[lane] < x[lane] ? y[lane] : x[lane]);
+                }
+              for (lane = 0; lane < lanes; ++lane)
+                {
+                b[lane] = (x[lane] < y[lane] ? y[lane] : x[lane]);
+                }
+              }
+            T *median = values + rank * lanes;
+            for (lane = 0; lane < lanes; ++lane)
+              {
+              outPtr1[(outIdx0 + lane - outExt[0]) * outInc0 + outIdxC] =
+                median[lane];
+              }
+            outIdx0 += lanes;
+            }
+          else
+            {
+            vtkImageMedian3DHood(outIdx0, kernelMiddle[0], kernelSize[0],
+                                 inExt[0], inExt[1], hoodMin0, hoodMax0);
+            int num = 0;
+            T *inPtr2 = inPtr1 + (hoodMin0 - inExt[0]) * inInc0;
+            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+              {
+              T *inPtr0 = inPtr2;
+              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
+                  {
+                  sort[num++] = inPtr0[(hoodIdx0 - hoodMin0) * inInc0];
+                  }
+                inPtr0 += inInc1;
+                }
+              inPtr2 += inInc2;
+              }
+            vtkstd::nth_element(sort, sort + num / 2, sort + num);
+            outPtr1[(outIdx0 - outExt[0]) * outInc0 + outIdxC] =
+              sort[num / 2];
+            ++outIdx0;
+            }
+          }
+        }
+      }
+    }
+
+  delete [] values;
+  delete [] sort;
+}
+
 //-----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output region types.
@@ -396,6 +833,61 @@ void vtkImageMedian3D::ThreadedRequestData(
     return;
     }
   
+  int numComp = inArray->GetNumberOfComponents();
+  if (this->MedianMode == VTK_IMAGE_MEDIAN_FAST)
+    {
+    switch (inArray->GetDataType())
+      {
+      case VTK_CHAR:
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<char *>(inPtr),
+                                         outData[0],
+                                         static_cast<char *>(outPtr),
+                                         outExt, id, numComp);
+        return;
+      case VTK_SIGNED_CHAR:
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<signed char *>(inPtr),
+                                         outData[0],
+                                         static_cast<signed char *>(outPtr),
+                                         outExt, id, numComp);
+        return;
+      case VTK_UNSIGNED_CHAR:
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<unsigned char *>(inPtr),
+                                         outData[0],
+                                         static_cast<unsigned char *>(outPtr),
+                                         outExt, id, numComp);
+        return;
+      case VTK_SHORT:
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<short *>(inPtr),
+                                         outData[0],
+                                         static_cast<short *>(outPtr),
+                                         outExt, id, numComp);
+        return;
+      case VTK_UNSIGNED_SHORT:
+        vtkImageMedian3DHistogramExecute(this, inData[0][0],
+                                         static_cast<unsigned short *>(inPtr),
+                                         outData[0],
+                                         static_cast<unsigned short *>(outPtr),
+                                         outExt, id, numComp);
+        return;
+      }
+    switch (inArray->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkImageMedian3DNetworkExecute(this, inData[0][0],
+                                       static_cast<VTK_TT *>(inPtr),
+                                       outData[0],
+                                       static_cast<VTK_TT *>(outPtr),
+                                       outExt, id, numComp));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+      }
+    return;
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
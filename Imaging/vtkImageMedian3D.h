@@ -19,6 +19,9 @@
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
 // into a 2D median.  
+//
+// The fast median mode computes the same medians with algorithms whose
+// cost grows more slowly with the kernel size (see SetMedianMode()).
 
 
 #ifndef __vtkImageMedian3D_h
@@ -27,6 +30,9 @@
 
 #include "vtkImageSpatialAlgorithm.h"
 
+#define VTK_IMAGE_MEDIAN_SORT 0
+#define VTK_IMAGE_MEDIAN_FAST 1
+
 class VTK_IMAGING_EXPORT vtkImageMedian3D : public vtkImageSpatialAlgorithm
 {
 public:
@@ -43,11 +49,33 @@ public:
   // Return the number of elements in the median mask
   vtkGetMacro(NumberOfElements,int);
 
+  // Description:
+  // Set/Get how the medians are computed.  Sort, the default, inserts the
+  // values of each neighborhood in a sorted array.  Fast keeps a
+  // histogram of the neighborhood of 8 and 16 bit integer scalars and
+  // updates it as the neighborhood slides along a row, so the cost grows
+  // with the square of the kernel size instead of its cube.  For other
+  // scalar types, it sorts the neighborhoods of several pixels at once
+  // with a sorting network when they have at most 125 values (i.e.
+  // 5x5x5), and otherwise partially sorts each neighborhood.  Neighborhoods
+  // with an even number of values, such as those clipped by the image
+  // boundary, have two middle values: the fast mode always takes the
+  // upper one, while the sort mode takes either one depending on the
+  // order of the values.
+  vtkSetClampMacro(MedianMode,int,VTK_IMAGE_MEDIAN_SORT,VTK_IMAGE_MEDIAN_FAST);
+  vtkGetMacro(MedianMode,int);
+  void SetMedianModeToSort() {
+    this->SetMedianMode(VTK_IMAGE_MEDIAN_SORT); };
+  void SetMedianModeToFast() {
+    this->SetMedianMode(VTK_IMAGE_MEDIAN_FAST); };
+  const char *GetMedianModeAsString();
+
 protected:
   vtkImageMedian3D();
   ~vtkImageMedian3D();
 
   int NumberOfElements;
+  int MedianMode;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -58,7 +58,8 @@ int vtkImageRFFT::IterativeRequestUpdateExtent(
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
+// is always doubles.  The lines are transformed in blocks of interleaved
+// lines.
 template <class T>
 void vtkImageRFFTExecute(vtkImageRFFT *self,
                          vtkImageData *inData, int inExt[6], T *inPtr,
@@ -78,6 +79,7 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int idxL, numberOfLines, blockSize;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -101,9 +103,10 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     return;
     }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the blocks of complex numbers
+  blockSize = vtkImageFourierFilter::GetNumberOfLinesPerBlock(inSize0);
+  inComplex = new vtkImageComplex[inSize0 * blockSize];
+  outComplex = new vtkImageComplex[inSize0 * blockSize];
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -116,46 +119,56 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += numberOfLines)
       {
       if (!id) 
         {
-        if (!(count%target))
-          {
-          self->UpdateProgress(count/(50.0*target) + startProgress);
-          }
-        count++;
+        self->UpdateProgress(count/(50.0*target) + startProgress);
+        }
+      numberOfLines = outMax1 - idx1 + 1;
+      if (numberOfLines > blockSize)
+        {
+        numberOfLines = blockSize;
         }
+      count += numberOfLines;
+
       // copy into complex numbers
       inPtr0 = inPtr1;
       pComplex = inComplex;
       for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
         {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
-          { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+        for (idxL = 0; idxL < numberOfLines; ++idxL)
+          {
+          pComplex->Real = static_cast<double>(inPtr0[idxL*inInc1]);
+          pComplex->Imag = 0.0;
+          if (numberOfComponents > 1)
+            { // yes we have an imaginary input
+            pComplex->Imag = static_cast<double>(inPtr0[idxL*inInc1+1]);
+            }
+          ++pComplex;
           }
         inPtr0 += inInc0;
-        ++pComplex;
         }
       
       // Call the method that performs the RFFT
-      self->ExecuteRfft(inComplex, outComplex, inSize0);
+      self->ExecuteFftLines(inComplex, outComplex, inSize0, numberOfLines, -1);
 
       // copy into output
       outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
+      pComplex = outComplex + (outMin0 - inMin0) * numberOfLines;
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
         {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
+        for (idxL = 0; idxL < numberOfLines; ++idxL)
+          {
+          outPtr0[idxL*outInc1] = pComplex->Real;
+          outPtr0[idxL*outInc1+1] = pComplex->Imag;
+          ++pComplex;
+          }
         outPtr0 += outInc0;
-        ++pComplex;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += numberOfLines*inInc1;
+      outPtr1 += numberOfLines*outInc1;
       }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
@@ -17,10 +17,11 @@
 // vtkImageRFFT implements the reverse fast Fourier transform.  The input
 // can have real or complex data in any components and data types, but
 // the output is always complex doubles with real values in component0, and
-// imaginary values in component1.  The filter is fastest for images that
-// have power of two sizes.  The filter uses a butterfly fitlers for each
-// prime factor of the dimension.  This makes images with prime number dimensions 
-// (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes) 
+// imaginary values in component1.  The filter is fastest for images whose
+// sizes only have the prime factors 2, 3, 5 and 7, which are computed
+// with a butterfly for each factor.  Other sizes (i.e. 17x17) are computed
+// with a power of two transform at least twice as long (see
+// vtkImageFourierFilter).  Multi dimensional (i.e volumes) 
 // FFT's are decomposed so that each axis executes in series.
 // In most cases the RFFT will produce an image whose imaginary values are all
 // zero's. In this case vtkImageExtractComponents can be used to remove
@@ -70,6 +70,20 @@ vtkCxxSetObjectMacro(vtkImageReslice,ResliceTransform,vtkAbstractTransform);
 
 #define VTK_RESLICE_FLOOR_TOL 7.62939453125e-06
 
+// SSE2 is part of every x86-64 processor, so kernels that interpolate two
+// output voxels at a time are compiled in whenever the compiler targets
+// it.  They reproduce the floor and rounding of the 64-bit scalar code
+// exactly, so the output does not depend on which kernel was used.  The
+// i386 floor adds no tolerance and keeps only 16 bits of fraction, so
+// the kernels are not used there.
+
+#if defined __SSE2__ || defined _M_X64
+#if defined VTK_RESLICE_64BIT_FLOOR
+#define VTK_RESLICE_USE_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
 
 template<class F>
 inline int vtkResliceFloor(double x, F &f)
@@ -2233,6 +2247,313 @@ void vtkResliceApplyTransform(vtkAbstractTransform *newtrans,
   inPoint[2] *= inInvSpacing[2];
 }
 
+#ifdef VTK_RESLICE_USE_SSE2
+//----------------------------------------------------------------------------
+// SSE2 versions of the floor and round functions above, for two values.
+// The value is first shifted by the same large constant as in the scalar
+// code, which leaves 16 bits of fraction, and the shift is then removed
+// exactly so that the integer part fits a 32-bit conversion.
+inline __m128d vtkResliceShiftFloorSSE2(__m128d x, double shift, __m128d &f)
+{
+  __m128d t = _mm_sub_pd(_mm_add_pd(x, _mm_set1_pd(shift)),
+                         _mm_set1_pd(103079215104.0));
+  __m128d i = _mm_cvtepi32_pd(_mm_cvttpd_epi32(t));
+  // truncation rounds negative values up
+  i = _mm_sub_pd(i, _mm_and_pd(_mm_cmplt_pd(t, i), _mm_set1_pd(1.0)));
+  f = _mm_sub_pd(t, i);
+  return i;
+}
+
+inline __m128d vtkResliceFloorSSE2(__m128d x, __m128d &f)
+{
+  return vtkResliceShiftFloorSSE2(
+    x, 103079215104.0 + VTK_RESLICE_FLOOR_TOL, f);
+}
+
+inline __m128d vtkResliceRoundSSE2(__m128d x)
+{
+  __m128d f;
+  return vtkResliceShiftFloorSSE2(
+    x, 103079215104.5 + VTK_RESLICE_FLOOR_TOL, f);
+}
+
+//----------------------------------------------------------------------------
+// Interpolate a row of single-component output voxels for an affine
+// transformation.  The input position of voxel idX is point + idX*xAxis.
+// Pairs of voxels that are both inside the input extent are interpolated
+// together; the others go through the scalar functions.
+template <class T>
+struct vtkImageResliceRowSSE2
+{
+  static void NearestNeighbor(
+    void *&outPtr, const void *inPtr, const int inExt[6],
+    const vtkIdType inInc[3], const double point[3], const double xAxis[3],
+    int idXmin, int idXmax, int mode, const void *background);
+
+  static void Trilinear(
+    void *&outPtr, const void *inPtr, const int inExt[6],
+    const vtkIdType inInc[3], const double point[3], const double xAxis[3],
+    int idXmin, int idXmax, int mode, const void *background);
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageResliceRowSSE2<T>::NearestNeighbor(
+  void *&outVoidPtr, const void *inVoidPtr, const int inExt[6],
+  const vtkIdType inInc[3], const double point[3], const double xAxis[3],
+  int idXmin, int idXmax, int, const void *voidBackground)
+{
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  const T *background = static_cast<const T *>(voidBackground);
+  T *outPtr = static_cast<T *>(outVoidPtr);
+
+  int inExtX = inExt[1] - inExt[0] + 1;
+  int inExtY = inExt[3] - inExt[2] + 1;
+  int inExtZ = inExt[5] - inExt[4] + 1;
+
+  __m128d px = _mm_set1_pd(point[0]);
+  __m128d py = _mm_set1_pd(point[1]);
+  __m128d pz = _mm_set1_pd(point[2]);
+  __m128d ax = _mm_set1_pd(xAxis[0]);
+  __m128d ay = _mm_set1_pd(xAxis[1]);
+  __m128d az = _mm_set1_pd(xAxis[2]);
+
+  double id[3][2];
+  for (int idX = idXmin; idX <= idXmax; idX += 2)
+    {
+    __m128d ix = _mm_set_pd(idX + 1, idX);
+    _mm_storeu_pd(id[0], vtkResliceRoundSSE2(
+                    _mm_add_pd(px, _mm_mul_pd(ix, ax))));
+    _mm_storeu_pd(id[1], vtkResliceRoundSSE2(
+                    _mm_add_pd(py, _mm_mul_pd(ix, ay))));
+    _mm_storeu_pd(id[2], vtkResliceRoundSSE2(
+                    _mm_add_pd(pz, _mm_mul_pd(ix, az))));
+
+    int m = (idX < idXmax ? 2 : 1);
+    for (int k = 0; k < m; k++)
+      {
+      int inIdX = static_cast<int>(id[0][k]) - inExt[0];
+      int inIdY = static_cast<int>(id[1][k]) - inExt[2];
+      int inIdZ = static_cast<int>(id[2][k]) - inExt[4];
+
+      if (inIdX >= 0 && inIdX < inExtX &&
+          inIdY >= 0 && inIdY < inExtY &&
+          inIdZ >= 0 && inIdZ < inExtZ)
+        {
+        *outPtr++ = inPtr[inIdX*inInc[0] + inIdY*inInc[1] + inIdZ*inInc[2]];
+        }
+      else
+        {
+        *outPtr++ = *background;
+        }
+      }
+    }
+
+  outVoidPtr = outPtr;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageResliceRowSSE2<T>::Trilinear(
+  void *&outVoidPtr, const void *inVoidPtr, const int inExt[6],
+  const vtkIdType inInc[3], const double point[3], const double xAxis[3],
+  int idXmin, int idXmax, int mode, const void *background)
+{
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+
+  int inExtX = inExt[1] - inExt[0] + 1;
+  int inExtY = inExt[3] - inExt[2] + 1;
+  int inExtZ = inExt[5] - inExt[4] + 1;
+
+  __m128d px = _mm_set1_pd(point[0]);
+  __m128d py = _mm_set1_pd(point[1]);
+  __m128d pz = _mm_set1_pd(point[2]);
+  __m128d ax = _mm_set1_pd(xAxis[0]);
+  __m128d ay = _mm_set1_pd(xAxis[1]);
+  __m128d az = _mm_set1_pd(xAxis[2]);
+  __m128d one = _mm_set1_pd(1.0);
+
+  double pos[3][2], id[3][2], frac[3][2];
+  int idX = idXmin;
+  for (; idX < idXmax; idX += 2)
+    {
+    __m128d ix = _mm_set_pd(idX + 1, idX);
+    __m128d x = _mm_add_pd(px, _mm_mul_pd(ix, ax));
+    __m128d y = _mm_add_pd(py, _mm_mul_pd(ix, ay));
+    __m128d z = _mm_add_pd(pz, _mm_mul_pd(ix, az));
+    __m128d fx, fy, fz;
+    _mm_storeu_pd(id[0], vtkResliceFloorSSE2(x, fx));
+    _mm_storeu_pd(id[1], vtkResliceFloorSSE2(y, fy));
+    _mm_storeu_pd(id[2], vtkResliceFloorSSE2(z, fz));
+    _mm_storeu_pd(frac[0], fx);
+    _mm_storeu_pd(frac[1], fy);
+    _mm_storeu_pd(frac[2], fz);
+
+    // compute the lookup offsets of both voxels
+    const T *inPtr0[2], *inPtr1[2];
+    vtkIdType i00[2], i01[2], i10[2], i11[2];
+    int inside = 1;
+    for (int k = 0; k < 2 && inside; k++)
+      {
+      int inIdX0 = static_cast<int>(id[0][k]) - inExt[0];
+      int inIdY0 = static_cast<int>(id[1][k]) - inExt[2];
+      int inIdZ0 = static_cast<int>(id[2][k]) - inExt[4];
+
+      int inIdX1 = inIdX0 + (frac[0][k] != 0);
+      int inIdY1 = inIdY0 + (frac[1][k] != 0);
+      int inIdZ1 = inIdZ0 + (frac[2][k] != 0);
+
+      inside = (inIdX0 >= 0 && inIdX1 < inExtX &&
+                inIdY0 >= 0 && inIdY1 < inExtY &&
+                inIdZ0 >= 0 && inIdZ1 < inExtZ);
+
+      vtkIdType factY0 = inIdY0*inInc[1];
+      vtkIdType factY1 = inIdY1*inInc[1];
+      vtkIdType factZ0 = inIdZ0*inInc[2];
+      vtkIdType factZ1 = inIdZ1*inInc[2];
+
+      i00[k] = factY0 + factZ0;
+      i01[k] = factY0 + factZ1;
+      i10[k] = factY1 + factZ0;
+      i11[k] = factY1 + factZ1;
+
+      inPtr0[k] = inPtr + inIdX0*inInc[0];
+      inPtr1[k] = inPtr + inIdX1*inInc[0];
+      }
+
+    if (!inside)
+      { // let the scalar code handle the boundary conditions
+      _mm_storeu_pd(pos[0], x);
+      _mm_storeu_pd(pos[1], y);
+      _mm_storeu_pd(pos[2], z);
+      for (int k = 0; k < 2; k++)
+        {
+        double inPoint[3] = { pos[0][k], pos[1][k], pos[2][k] };
+        vtkImageResliceInterpolate<double, T>::Trilinear(
+          outVoidPtr, inVoidPtr, inExt, inInc, 1, inPoint, mode, background);
+        }
+      continue;
+      }
+
+    __m128d rx = _mm_sub_pd(one, fx);
+    __m128d ry = _mm_sub_pd(one, fy);
+    __m128d rz = _mm_sub_pd(one, fz);
+
+    __m128d ryrz = _mm_mul_pd(ry, rz);
+    __m128d fyrz = _mm_mul_pd(fy, rz);
+    __m128d ryfz = _mm_mul_pd(ry, fz);
+    __m128d fyfz = _mm_mul_pd(fy, fz);
+
+#define VTK_RESLICE_GATHER(p, i) \
+    _mm_set_pd(p[1][i[1]], p[0][i[0]])
+
+    __m128d r0 = _mm_add_pd(
+      _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(ryrz, VTK_RESLICE_GATHER(inPtr0, i00)),
+                   _mm_mul_pd(ryfz, VTK_RESLICE_GATHER(inPtr0, i01))),
+        _mm_mul_pd(fyrz, VTK_RESLICE_GATHER(inPtr0, i10))),
+      _mm_mul_pd(fyfz, VTK_RESLICE_GATHER(inPtr0, i11)));
+    __m128d r1 = _mm_add_pd(
+      _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(ryrz, VTK_RESLICE_GATHER(inPtr1, i00)),
+                   _mm_mul_pd(ryfz, VTK_RESLICE_GATHER(inPtr1, i01))),
+        _mm_mul_pd(fyrz, VTK_RESLICE_GATHER(inPtr1, i10))),
+      _mm_mul_pd(fyfz, VTK_RESLICE_GATHER(inPtr1, i11)));
+
+#undef VTK_RESLICE_GATHER
+
+    double result[2];
+    _mm_storeu_pd(result, _mm_add_pd(_mm_mul_pd(rx, r0),
+                                     _mm_mul_pd(fx, r1)));
+
+    T *outPtr = static_cast<T *>(outVoidPtr);
+    vtkResliceRound(result[0], outPtr[0]);
+    vtkResliceRound(result[1], outPtr[1]);
+    outVoidPtr = outPtr + 2;
+    }
+
+  if (idX == idXmax)
+    { // odd number of voxels
+    double inPoint[3];
+    inPoint[0] = point[0] + idX*xAxis[0];
+    inPoint[1] = point[1] + idX*xAxis[1];
+    inPoint[2] = point[2] + idX*xAxis[2];
+    vtkImageResliceInterpolate<double, T>::Trilinear(
+      outVoidPtr, inVoidPtr, inExt, inInc, 1, inPoint, mode, background);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Get a row function for the affine case, or NULL if the scalar code must
+// be used.  Only single-component short, unsigned short and float data
+// with nearest or linear interpolation have vectorized row functions.
+template <class F>
+void vtkGetResliceRowFunc(vtkImageReslice *,
+                          void (**rowfunc)(void *&outPtr, const void *inPtr,
+                                           const int inExt[6],
+                                           const vtkIdType inInc[3],
+                                           const F point[3],
+                                           const F xAxis[3],
+                                           int idXmin, int idXmax, int mode,
+                                           const void *background))
+{
+  *rowfunc = 0;
+}
+
+#ifdef VTK_RESLICE_USE_SSE2
+void vtkGetResliceRowFunc(vtkImageReslice *self,
+                          void (**rowfunc)(void *&outPtr, const void *inPtr,
+                                           const int inExt[6],
+                                           const vtkIdType inInc[3],
+                                           const double point[3],
+                                           const double xAxis[3],
+                                           int idXmin, int idXmax, int mode,
+                                           const void *background))
+{
+  *rowfunc = 0;
+  if (self->GetOutput()->GetNumberOfScalarComponents() != 1)
+    {
+    return;
+    }
+
+  int dataType = self->GetOutput()->GetScalarType();
+  switch (self->GetInterpolationMode())
+    {
+    case VTK_RESLICE_NEAREST:
+      switch (dataType)
+        {
+        case VTK_SHORT:
+          *rowfunc = &(vtkImageResliceRowSSE2<short>::NearestNeighbor);
+          break;
+        case VTK_UNSIGNED_SHORT:
+          *rowfunc =
+            &(vtkImageResliceRowSSE2<unsigned short>::NearestNeighbor);
+          break;
+        case VTK_FLOAT:
+          *rowfunc = &(vtkImageResliceRowSSE2<float>::NearestNeighbor);
+          break;
+        }
+      break;
+    case VTK_RESLICE_LINEAR:
+    case VTK_RESLICE_RESERVED_2:
+      switch (dataType)
+        {
+        case VTK_SHORT:
+          *rowfunc = &(vtkImageResliceRowSSE2<short>::Trilinear);
+          break;
+        case VTK_UNSIGNED_SHORT:
+          *rowfunc = &(vtkImageResliceRowSSE2<unsigned short>::Trilinear);
+          break;
+        case VTK_FLOAT:
+          *rowfunc = &(vtkImageResliceRowSSE2<float>::Trilinear);
+          break;
+        }
+      break;
+    }
+}
+#endif
+
 // The vtkOptimizedExecute() is like vtkImageResliceExecute, except that
 // it provides a few optimizations:
 // 1) the ResliceAxes and ResliceTransform are joined to create a 
@@ -2269,6 +2590,10 @@ void vtkOptimizedExecute(vtkImageReslice *self,
                      int numscalars, const F point[3],
                      int mode, const void *background);
   void (*setpixels)(void *&out, const void *in, int numscalars, int n);
+  void (*rowfunc)(void *&outPtr, const void *inPtr,
+                  const int inExt[6], const vtkIdType inInc[3],
+                  const F point[3], const F xAxis[3],
+                  int idXmin, int idXmax, int mode, const void *background);
 
   int mode = VTK_RESLICE_BACKGROUND;
   int wrap = 0;
@@ -2343,6 +2668,16 @@ void vtkOptimizedExecute(vtkImageReslice *self,
   vtkGetResliceInterpFunc(self, &interpolate);
   vtkGetSetPixelsFunc(self, &setpixels);
 
+  // vectorized rows are only possible for affine transformations,
+  // and nearest-neighbor rows do not wrap
+  rowfunc = 0;
+  if (!(newtrans || perspective) &&
+      (optimizeNearest ||
+       self->GetInterpolationMode() != VTK_RESLICE_NEAREST))
+    {
+    vtkGetResliceRowFunc(self, &rowfunc);
+    }
+
   // get the stencil
   vtkImageStencilData *stencil = self->GetStencil();
 
@@ -2376,7 +2711,12 @@ void vtkOptimizedExecute(vtkImageReslice *self,
                                      outPtr, background, numscalars, 
                                      setpixels, iter))
         {
-        if (!optimizeNearest)
+        if (rowfunc)
+          {
+          rowfunc(outPtr, inPtr, inExt, inInc, inPoint1, xAxis,
+                  idXmin, idXmax, mode, background);
+          }
+        else if (!optimizeNearest)
           {
           for (idX = idXmin; idX <= idXmax; idX++)
             {
@@ -2790,6 +3130,177 @@ void vtkImageResliceSummation<F, T>::Tricubic(
   outVoidPtr = outPtr;
 }
 
+#ifdef VTK_RESLICE_USE_SSE2
+//----------------------------------------------------------------------------
+// SSE2 version of the trilinear summation for single-component data, which
+// interpolates two output voxels at a time.  The cases that only copy or
+// interpolate along z are left to the scalar code.
+template<class T>
+struct vtkImageResliceSummationSSE2
+{
+  static void Trilinear(
+    void *&outPtr, const void *inPtr, int numscalars, int n,
+    const vtkIdType *iX, const double *fX, const vtkIdType *iY,
+    const double *fY, const vtkIdType *iZ, const double *fZ,
+    const int useNearestNeighbor[3]);
+};
+
+template<class T>
+void vtkImageResliceSummationSSE2<T>::Trilinear(
+                                  void *&outVoidPtr, const void *inVoidPtr,
+                                  int numscalars, int n,
+                                  const vtkIdType *iX, const double *fX,
+                                  const vtkIdType *iY, const double *fY,
+                                  const vtkIdType *iZ, const double *fZ,
+                                  const int useNearestNeighbor[3])
+{
+  double ry = fY[0];
+  double fy = fY[1];
+  double rz = fZ[0];
+  double fz = fZ[1];
+
+  if (useNearestNeighbor[0] && fy == 0)
+    {
+    vtkImageResliceSummation<double, T>::Trilinear(
+      outVoidPtr, inVoidPtr, numscalars, n, iX, fX, iY, fY, iZ, fZ,
+      useNearestNeighbor);
+    return;
+    }
+
+  const T *inPtr = static_cast<const T *>(inVoidPtr);
+  T *outPtr = static_cast<T *>(outVoidPtr);
+
+  vtkIdType i00 = iY[0] + iZ[0];
+  vtkIdType i01 = iY[0] + iZ[1];
+  vtkIdType i10 = iY[1] + iZ[0];
+  vtkIdType i11 = iY[1] + iZ[1];
+
+  // with fz == 0 the scalar code does bilinear interpolation in x,y
+  int bilinear = (fz == 0);
+  __m128d wy0 = _mm_set1_pd(bilinear ? ry : ry*rz);
+  __m128d wy1 = _mm_set1_pd(bilinear ? fy : fy*rz);
+  __m128d wz0 = _mm_set1_pd(ry*fz);
+  __m128d wz1 = _mm_set1_pd(fy*fz);
+
+#define VTK_RESLICE_GATHER(p0, p1, i) \
+  _mm_set_pd(p1[i], p0[i])
+
+  int i = 0;
+  for (; i + 1 < n; i += 2)
+    {
+    __m128d w0 = _mm_loadu_pd(fX);
+    __m128d w1 = _mm_loadu_pd(fX + 2);
+    fX += 4;
+    __m128d rx = _mm_unpacklo_pd(w0, w1);
+    __m128d fx = _mm_unpackhi_pd(w0, w1);
+
+    const T *inPtr0a = inPtr + iX[0];
+    const T *inPtr1a = inPtr + iX[1];
+    const T *inPtr0b = inPtr + iX[2];
+    const T *inPtr1b = inPtr + iX[3];
+    iX += 4;
+
+    __m128d r0, r1;
+    if (bilinear)
+      {
+      r0 = _mm_add_pd(
+        _mm_mul_pd(wy0, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i00)),
+        _mm_mul_pd(wy1, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i10)));
+      r1 = _mm_add_pd(
+        _mm_mul_pd(wy0, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i00)),
+        _mm_mul_pd(wy1, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i10)));
+      }
+    else
+      {
+      // same order of operations as the scalar code
+      r0 = _mm_add_pd(
+        _mm_add_pd(
+          _mm_add_pd(
+            _mm_mul_pd(wy0, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i00)),
+            _mm_mul_pd(wz0, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i01))),
+          _mm_mul_pd(wy1, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i10))),
+        _mm_mul_pd(wz1, VTK_RESLICE_GATHER(inPtr0a, inPtr0b, i11)));
+      r1 = _mm_add_pd(
+        _mm_add_pd(
+          _mm_add_pd(
+            _mm_mul_pd(wy0, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i00)),
+            _mm_mul_pd(wz0, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i01))),
+          _mm_mul_pd(wy1, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i10))),
+        _mm_mul_pd(wz1, VTK_RESLICE_GATHER(inPtr1a, inPtr1b, i11)));
+      }
+
+    double result[2];
+    _mm_storeu_pd(result, _mm_add_pd(_mm_mul_pd(rx, r0),
+                                     _mm_mul_pd(fx, r1)));
+    vtkResliceRound(result[0], *outPtr++);
+    vtkResliceRound(result[1], *outPtr++);
+    }
+
+#undef VTK_RESLICE_GATHER
+
+  outVoidPtr = outPtr;
+  if (i < n)
+    { // odd number of voxels
+    vtkImageResliceSummation<double, T>::Trilinear(
+      outVoidPtr, inVoidPtr, numscalars, 1, iX, fX, iY, fY, iZ, fZ,
+      useNearestNeighbor);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Replace the summation function with a vectorized one when possible.
+template<class F>
+void vtkGetResliceSummationFuncSSE2(vtkImageReslice *,
+                                    void (**)(void *&out, const void *in,
+                                              int numscalars, int n,
+                                              const vtkIdType *iX,
+                                              const F *fX,
+                                              const vtkIdType *iY,
+                                              const F *fY,
+                                              const vtkIdType *iZ,
+                                              const F *fZ,
+                                              const int useNearest[3]),
+                                    int)
+{
+}
+
+#ifdef VTK_RESLICE_USE_SSE2
+void vtkGetResliceSummationFuncSSE2(vtkImageReslice *self,
+                                    void (**summation)(void *&out,
+                                                       const void *in,
+                                                       int numscalars, int n,
+                                                       const vtkIdType *iX,
+                                                       const double *fX,
+                                                       const vtkIdType *iY,
+                                                       const double *fY,
+                                                       const vtkIdType *iZ,
+                                                       const double *fZ,
+                                                       const int useNearest[3]),
+                                    int interpolationMode)
+{
+  if (self->GetOutput()->GetNumberOfScalarComponents() != 1 ||
+      (interpolationMode != VTK_RESLICE_LINEAR &&
+       interpolationMode != VTK_RESLICE_RESERVED_2))
+    {
+    return;
+    }
+
+  switch (self->GetOutput()->GetScalarType())
+    {
+    case VTK_SHORT:
+      *summation = &(vtkImageResliceSummationSSE2<short>::Trilinear);
+      break;
+    case VTK_UNSIGNED_SHORT:
+      *summation = &(vtkImageResliceSummationSSE2<unsigned short>::Trilinear);
+      break;
+    case VTK_FLOAT:
+      *summation = &(vtkImageResliceSummationSSE2<float>::Trilinear);
+      break;
+    }
+}
+#endif
+
 //----------------------------------------------------------------------------
 // get approprate summation function for different interpolation modes
 // and different scalar types
@@ -3305,6 +3816,7 @@ void vtkReslicePermuteExecute(vtkImageReslice *self,
                     const int useNearestNeighbor[3]);
   void (*setpixels)(void *&out, const void *in, int numscalars, int n);
   vtkGetResliceSummationFunc(self, &summation, interpolationMode);
+  vtkGetResliceSummationFuncSSE2(self, &summation, interpolationMode);
   vtkGetSetPixelsFunc(self, &setpixels);
 
   // set color for area outside of input volume extent
@@ -22,9 +22,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkSplatTiles.h"
+#include "vtkThreadPool.h"
 
 vtkStandardNewMacro(vtkShepardMethod);
 
+// The number of slabs of the volume per thread of the pool.
+#define VTK_SHEPARD_METHOD_TILES_PER_THREAD 4
+
 // Construct with sample dimensions=(50,50,50) and so that model bounds are
 // automatically computed from input. Null value for each unvisited output 
 // point is 0.0. Maximum distance is 0.25.
@@ -44,6 +49,138 @@ vtkShepardMethod::vtkShepardMethod()
   this->SampleDimensions[2] = 50;
 
   this->NullValue = 0.0;
+
+  this->NumberOfThreads = 1;
+}
+
+//----------------------------------------------------------------------------
+// The state shared by the threads that sample the slabs of the volume.  Self
+// is set only when the volume is a single slab sampled by the calling
+// thread, which then reports progress and checks for abort.
+struct vtkShepardMethodTiles
+{
+  vtkShepardMethod *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  double MaximumDistance;
+  double Origin[3];
+  double Spacing[3];
+  int Dimensions[3];
+  float *Values;
+  double *Sum;
+  vtkSplatTiles Tiles;
+};
+
+//----------------------------------------------------------------------------
+// The voxels within the maximum distance of a point, along each axis.
+static void vtkShepardMethodFootprint(vtkShepardMethodTiles *str,
+                                      double px[3], int min[3], int max[3])
+{
+  for (int i=0; i<3; i++)
+    {
+    min[i] = static_cast<int>(
+      ((px[i] - str->MaximumDistance) - str->Origin[i]) / str->Spacing[i]);
+    max[i] = static_cast<int>(
+      ((px[i] + str->MaximumDistance) - str->Origin[i]) / str->Spacing[i]);
+    if (min[i] < 0)
+      {
+      min[i] = 0;
+      }
+    if (max[i] >= str->Dimensions[i])
+      {
+      max[i] = str->Dimensions[i] - 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The slices within the maximum distance of a point, for vtkSplatTiles.
+static void vtkShepardMethodSlices(vtkIdType ptId, int &firstSlice,
+                                   int &lastSlice, void *data)
+{
+  vtkShepardMethodTiles *str = static_cast<vtkShepardMethodTiles *>(data);
+  double px[3];
+  int min[3], max[3];
+  str->Input->GetPoint(ptId, px);
+  vtkShepardMethodFootprint(str, px, min, max);
+  firstSlice = min[2];
+  lastSlice = max[2];
+}
+
+//----------------------------------------------------------------------------
+// Accumulate the weighted scalars of the points of a range of slabs, within
+// the slabs.  Each voxel sums the contributions of the points in
+// increasing order, whatever the number of slabs.
+static void vtkShepardMethodSampleTiles(vtkIdType begin, vtkIdType end,
+                                        int vtkNotUsed(threadIndex),
+                                        void *data)
+{
+  vtkShepardMethodTiles *str = static_cast<vtkShepardMethodTiles *>(data);
+  vtkSplatTiles *tiles = &str->Tiles;
+  int jkFactor = str->Dimensions[0]*str->Dimensions[1];
+  double px[3], x[3], distance2, inScalar;
+  int min[3], max[3], i, j, k;
+
+  for (vtkIdType tile = begin; tile < end; tile++)
+    {
+    vtkIdType first = tiles->GetTileBegin(tile);
+    vtkIdType last = tiles->GetTileBegin(tile+1);
+    for (vtkIdType t = first; t < last; t++)
+      {
+      if (str->Self && ! ((t - first) % 1000))
+        {
+        str->Self->UpdateProgress(static_cast<double>(t - first)/
+                                  (last - first));
+        if (str->Self->GetAbortExecute())
+          {
+          break;
+          }
+        }
+
+      vtkIdType ptId = tiles->GetPointId(t);
+      str->Input->GetPoint(ptId, px);
+      inScalar = str->Scalars->GetComponent(ptId,0);
+
+      // Each input point affects voxels within maxDistance, within the slab.
+      vtkShepardMethodFootprint(str, px, min, max);
+      if (min[2] < tiles->GetTileBound(tile))
+        {
+        min[2] = tiles->GetTileBound(tile);
+        }
+      if (max[2] >= tiles->GetTileBound(tile+1))
+        {
+        max[2] = tiles->GetTileBound(tile+1) - 1;
+        }
+
+      for (k = min[2]; k <= max[2]; k++)
+        {
+        x[2] = str->Spacing[2] * k + str->Origin[2];
+        for (j = min[1]; j <= max[1]; j++)
+          {
+          x[1] = str->Spacing[1] * j + str->Origin[1];
+          for (i = min[0]; i <= max[0]; i++)
+            {
+            x[0] = str->Spacing[0] * i + str->Origin[0];
+            vtkIdType idx = jkFactor*k + str->Dimensions[0]*j + i;
+
+            distance2 = vtkMath::Distance2BetweenPoints(x,px);
+
+            if ( distance2 == 0.0 )
+              {
+              str->Sum[idx] = VTK_DOUBLE_MAX;
+              str->Values[idx] = VTK_FLOAT_MAX;
+              }
+            else
+              {
+              str->Sum[idx] += 1.0 / distance2;
+              str->Values[idx] = static_cast<float>(
+                str->Values[idx] + (inScalar/distance2));
+              }
+            }
+          }
+        }
+      }
+    }
 }
 
 // Compute ModelBounds from input geometry.
@@ -155,14 +292,11 @@ int vtkShepardMethod::RequestData(
   output->AllocateScalars();
   
   vtkIdType ptId, i;
-  int j, k;
-  double *px, x[3], s, *sum, spacing[3], origin[3];
+  double s, *sum, spacing[3], origin[3];
   
-  double maxDistance, distance2, inScalar;
+  double maxDistance;
   vtkDataArray *inScalars;
-  vtkIdType numPts, numNewPts, idx;
-  int min[3], max[3];
-  int jkFactor;
+  vtkIdType numPts, numNewPts;
   vtkFloatArray *newScalars = 
     vtkFloatArray::SafeDownCast(output->GetPointData()->GetScalars());
 
@@ -201,97 +335,52 @@ int vtkShepardMethod::RequestData(
   outInfo->Set(vtkDataObject::SPACING(),spacing,3);
 
 
-  // Traverse all input points. 
-  // Each input point affects voxels within maxDistance.
-  //
-  int abortExecute=0;
-  for (ptId=0; ptId < numPts && !abortExecute; ptId++)
+  vtkShepardMethodTiles str;
+  str.Self = this;
+  str.Input = input;
+  str.Scalars = inScalars;
+  str.MaximumDistance = maxDistance;
+  for (i=0; i<3; i++)
     {
-    if ( ! (ptId % 1000) )
-      {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (ptId/numPts);
-      if (this->GetAbortExecute())
-        {
-        abortExecute = 1;
-        break;
-        }
-      }
-
-    px = input->GetPoint(ptId);
-    inScalar = inScalars->GetComponent(ptId,0);
-    
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
-      {
-      double amin = static_cast<double>(
-        (px[i] - maxDistance) - origin[i]) / spacing[i];
-      double amax = static_cast<double>(
-        (px[i] + maxDistance) - origin[i]) / spacing[i];
-      min[i] = static_cast<int>(amin);
-      max[i] = static_cast<int>(amax);
-      
-      if (min[i] < amin)
-        {
-        min[i]++; // round upward to nearest integer to get min[i]
-        }
-      if (max[i] > amax)
-        {
-        max[i]--; // round downward to nearest integer to get max[i]
-        }
-
-      if (min[i] < 0)
-        {
-        min[i] = 0; // valid range check
-        }
-      if (max[i] >= this->SampleDimensions[i]) 
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
-      }
+    str.Origin[i] = origin[i];
+    str.Spacing[i] = spacing[i];
+    str.Dimensions[i] = this->SampleDimensions[i];
+    }
+  str.Values = newScalars->GetPointer(0);
+  str.Sum = sum;
 
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
-      {
-      min[i] = static_cast<int>(
-        static_cast<double>((px[i] - maxDistance) - origin[i]) / spacing[i]);
-      max[i] = static_cast<int>(
-        static_cast<double>((px[i] + maxDistance) - origin[i]) / spacing[i]);
-      if (min[i] < 0)
-        {
-        min[i] = 0;
-        }
-      if (max[i] >= this->SampleDimensions[i]) 
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
-      }
-  
-    jkFactor = this->SampleDimensions[0]*this->SampleDimensions[1];
-    for (k = min[2]; k <= max[2]; k++) 
+  // Traverse all input points.  With several threads, the volume is cut
+  // into slabs along z, the points are sorted into the slabs that they
+  // influence, and each slab is sampled by one thread at a time.  The
+  // serial case is a single slab.
+  //
+  vtkThreadPool *pool = vtkThreadPool::GetGlobalPool();
+  int numTiles = 1;
+  if (this->NumberOfThreads > 1)
+    {
+    numTiles = VTK_SHEPARD_METHOD_TILES_PER_THREAD *
+      pool->GetNumberOfThreads();
+    input->PrepareForThreadedAccess();
+    }
+  str.Tiles.Initialize(this->SampleDimensions[2], numTiles, numPts,
+                       vtkShepardMethodSlices, &str);
+  numTiles = str.Tiles.GetNumberOfTiles();
+  if (numTiles == 1)
+    {
+    vtkShepardMethodSampleTiles(0, 1, 0, &str);
+    }
+  else
+    {
+    // Slabs are sampled in groups to report progress.
+    str.Self = NULL;
+    int groupSize = numTiles/10 + 1;
+    for (int tile=0; tile < numTiles && !this->GetAbortExecute();
+         tile+=groupSize)
       {
-      x[2] = spacing[2] * k + origin[2];
-      for (j = min[1]; j <= max[1]; j++)
-        {
-        x[1] = spacing[1] * j + origin[1];
-        for (i = min[0]; i <= max[0]; i++) 
-          {
-          x[0] = spacing[0] * i + origin[0];
-          idx = jkFactor*k + this->SampleDimensions[0]*j + i;
-
-          distance2 = vtkMath::Distance2BetweenPoints(x,px);
-
-          if ( distance2 == 0.0 )
-            {
-            sum[idx] = VTK_DOUBLE_MAX;
-            newScalars->SetComponent(idx,0,VTK_FLOAT_MAX);
-            }
-          else
-            {
-            s = newScalars->GetComponent(idx,0);
-            sum[idx] += 1.0 / distance2;
-            newScalars->SetComponent(idx,0,s+(inScalar/distance2));
-            }
-          }
-        }
+      this->UpdateProgress(static_cast<double>(tile)/numTiles);
+      int lastTile = tile + groupSize;
+      pool->ParallelFor(tile, (lastTile < numTiles ? lastTile : numTiles), 1,
+                        vtkShepardMethodSampleTiles, &str);
       }
     }
 
@@ -394,4 +483,6 @@ void vtkShepardMethod::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Null Value: " << this->NullValue << "\n";
 
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+
 }
@@ -31,6 +31,11 @@
 // If you use a maximum distance less than 1.0, some output points may
 // never receive a contribution. The final value of these points can be 
 // specified with the "NullValue" instance variable.
+//
+// The points can be sampled on several threads (see SetNumberOfThreads()).
+// The volume is then cut into slabs, and each point is sampled by the
+// slabs within its maximum distance, so the threads never write to the
+// same voxels and the result does not depend on the number of threads.
 
 #ifndef __vtkShepardMethod_h
 #define __vtkShepardMethod_h
@@ -85,6 +90,12 @@ public:
   vtkSetMacro(NullValue,double);
   vtkGetMacro(NullValue,double);
 
+  // Description:
+  // Set/Get the number of threads used to sample the points.  Initial
+  // value is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   vtkShepardMethod();
   ~vtkShepardMethod() {};
@@ -105,6 +116,7 @@ protected:
   double MaximumDistance;
   double ModelBounds[6];
   double NullValue;
+  int NumberOfThreads;
 private:
   vtkShepardMethod(const vtkShepardMethod&);  // Not implemented.
   void operator=(const vtkShepardMethod&);  // Not implemented.
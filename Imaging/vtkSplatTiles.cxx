@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSplatTiles.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSplatTiles.h"
+
+//----------------------------------------------------------------------------
+vtkSplatTiles::vtkSplatTiles()
+{
+  this->NumberOfTiles = 0;
+  this->TileBounds = NULL;
+  this->TileOffsets = NULL;
+  this->TilePoints = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkSplatTiles::~vtkSplatTiles()
+{
+  delete [] this->TileBounds;
+  delete [] this->TileOffsets;
+  delete [] this->TilePoints;
+}
+
+//----------------------------------------------------------------------------
+void vtkSplatTiles::Initialize(int numSlices, int numTiles, vtkIdType numPts,
+                               vtkSplatTilesFootprint footprint, void *data)
+{
+  delete [] this->TileBounds;
+  delete [] this->TileOffsets;
+  delete [] this->TilePoints;
+  this->TilePoints = NULL;
+
+  if ( numTiles > numSlices )
+    {
+    numTiles = numSlices;
+    }
+  if ( numTiles < 1 )
+    {
+    numTiles = 1;
+    }
+  this->NumberOfTiles = numTiles;
+
+  int tile, k;
+  this->TileBounds = new int[numTiles+1];
+  for (tile=0; tile<=numTiles; tile++)
+    {
+    this->TileBounds[tile] = static_cast<int>(
+      static_cast<vtkIdType>(numSlices)*tile/numTiles);
+    }
+  this->TileOffsets = new vtkIdType[numTiles+1];
+  this->TileOffsets[0] = 0;
+  if ( numTiles == 1 )
+    {
+    this->TileOffsets[1] = numPts;
+    return;
+    }
+
+  int *sliceTiles = new int[numSlices];
+  for (tile=0; tile<numTiles; tile++)
+    {
+    for (k=this->TileBounds[tile]; k<this->TileBounds[tile+1]; k++)
+      {
+      sliceTiles[k] = tile;
+      }
+    }
+
+  // Count the points of each slab, then place them.
+  for (tile=1; tile<=numTiles; tile++)
+    {
+    this->TileOffsets[tile] = 0;
+    }
+  int first, last;
+  vtkIdType ptId;
+  for (ptId=0; ptId < numPts; ptId++)
+    {
+    footprint(ptId, first, last, data);
+    if ( first <= last )
+      {
+      for (tile=sliceTiles[first]; tile<=sliceTiles[last]; tile++)
+        {
+        this->TileOffsets[tile+1]++;
+        }
+      }
+    }
+  for (tile=0; tile<numTiles; tile++)
+    {
+    this->TileOffsets[tile+1] += this->TileOffsets[tile];
+    }
+
+  this->TilePoints = new vtkIdType[this->TileOffsets[numTiles]];
+  vtkIdType *next = new vtkIdType[numTiles];
+  for (tile=0; tile<numTiles; tile++)
+    {
+    next[tile] = this->TileOffsets[tile];
+    }
+  for (ptId=0; ptId < numPts; ptId++)
+    {
+    footprint(ptId, first, last, data);
+    if ( first <= last )
+      {
+      for (tile=sliceTiles[first]; tile<=sliceTiles[last]; tile++)
+        {
+        this->TilePoints[next[tile]++] = ptId;
+        }
+      }
+    }
+  delete [] next;
+  delete [] sliceTiles;
+}
@@ -0,0 +1,89 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSplatTiles.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSplatTiles - sort points into the slabs of a volume
+// .SECTION Description
+// vtkSplatTiles cuts the slices of a volume into slabs of about the same
+// thickness, and sorts points into every slab that their footprint
+// reaches.  The points of a slab are kept in increasing order, so a
+// filter that processes each slab on its own thread visits the points of
+// every voxel in the same order as a serial loop over the points.  With a
+// single slab the points are not sorted at all.
+//
+// This is a helper for the filters that splat points into a volume.
+
+// .SECTION See also
+// vtkGaussianSplatter vtkShepardMethod
+
+#ifndef __vtkSplatTiles_h
+#define __vtkSplatTiles_h
+
+#include "vtkSystemIncludes.h"
+
+// Signature of the function that gives the slices reached by the footprint
+// of a point.  It sets lastSlice < firstSlice when the point reaches none.
+typedef void (*vtkSplatTilesFootprint)(vtkIdType ptId, int &firstSlice,
+                                       int &lastSlice, void *data);
+
+class VTK_IMAGING_EXPORT vtkSplatTiles
+{
+public:
+  vtkSplatTiles();
+  ~vtkSplatTiles();
+
+  // Description:
+  // Cut numSlices slices into numTiles slabs, and sort numPts points into
+  // the slabs with a counting sort.  The footprint function is called
+  // twice per point, once to count and once to fill the slabs, so that
+  // no footprint is stored.  It is not called when there is one slab.
+  void Initialize(int numSlices, int numTiles, vtkIdType numPts,
+                  vtkSplatTilesFootprint footprint, void *data);
+
+  // Description:
+  // Get the number of slabs.
+  int GetNumberOfTiles()
+    {
+    return this->NumberOfTiles;
+    }
+
+  // Description:
+  // The slices of a slab are GetTileBound(tile) to GetTileBound(tile+1)-1.
+  int GetTileBound(int tile)
+    {
+    return this->TileBounds[tile];
+    }
+
+  // Description:
+  // The points of a slab are GetPointId(t) for t from GetTileBegin(tile)
+  // to GetTileBegin(tile+1)-1.
+  vtkIdType GetTileBegin(int tile)
+    {
+    return this->TileOffsets[tile];
+    }
+  vtkIdType GetPointId(vtkIdType t)
+    {
+    return (this->TilePoints ? this->TilePoints[t] : t);
+    }
+
+private:
+  int NumberOfTiles;
+  int *TileBounds;
+  vtkIdType *TileOffsets;
+  vtkIdType *TilePoints;
+
+  vtkSplatTiles(const vtkSplatTiles&);  // Not implemented.
+  void operator=(const vtkSplatTiles&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDistributedDataSharedMemory.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This test redistributes a sphere with vtkDistributedDataFilter with and
+// without the shared memory exchange between processes on the same host,
+// using both the fast and the minimal memory exchanges, and checks that
+// each process gets the same cells.
+
+#include <mpi.h>
+
+#include "vtkDistributedDataFilter.h"
+#include "vtkMPIController.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcess.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type,name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+class MyProcess : public vtkProcess
+{
+public:
+  static MyProcess *New();
+  vtkTypeMacro(MyProcess, vtkProcess);
+
+  virtual void Execute();
+
+protected:
+  MyProcess() {}
+
+  // Redistribute the sphere and copy this process' output.
+  void Redistribute(vtkUnstructuredGrid *output, int useSharedMemory,
+                    int useMinimalMemory);
+};
+
+vtkStandardNewMacro(MyProcess);
+
+void MyProcess::Redistribute(vtkUnstructuredGrid *output, int useSharedMemory,
+                             int useMinimalMemory)
+{
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int me = this->Controller->GetLocalProcessId();
+
+  // Each process reads a wedge of the sphere.
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(32);
+  sphere->SetStartTheta(360.0 * me / numProcs);
+  sphere->SetEndTheta(360.0 * (me + 1) / numProcs);
+
+  VTK_CREATE(vtkDistributedDataFilter, d3);
+  d3->SetInputConnection(sphere->GetOutputPort());
+  d3->SetController(this->Controller);
+  d3->SetUseSharedMemory(useSharedMemory);
+  d3->SetUseMinimalMemory(useMinimalMemory);
+  d3->Update();
+
+  output->ShallowCopy(d3->GetOutput());
+}
+
+void MyProcess::Execute()
+{
+  VTK_CREATE(vtkUnstructuredGrid, messages);
+  this->Redistribute(messages, 0, 0);
+
+  this->ReturnValue = 1;
+  for (int minimal = 0; minimal < 2; minimal++)
+    {
+    VTK_CREATE(vtkUnstructuredGrid, shared);
+    this->Redistribute(shared, 1, minimal);
+
+    double b1[6];
+    double b2[6];
+    messages->GetBounds(b1);
+    shared->GetBounds(b2);
+    if (shared->GetNumberOfCells() != messages->GetNumberOfCells() ||
+        shared->GetNumberOfPoints() != messages->GetNumberOfPoints() ||
+        b1[0] != b2[0] || b1[1] != b2[1] || b1[2] != b2[2] ||
+        b1[3] != b2[3] || b1[4] != b2[4] || b1[5] != b2[5])
+      {
+      cout << "Process " << this->Controller->GetLocalProcessId()
+           << " got " << shared->GetNumberOfCells() << " cells instead of "
+           << messages->GetNumberOfCells() << " through shared memory"
+           << (minimal ? " with minimal memory." : ".") << endl;
+      this->ReturnValue = 0;
+      }
+    }
+
+  // All processes must succeed.
+  int ok = this->ReturnValue;
+  this->Controller->AllReduce(&ok, &this->ReturnValue, 1,
+                              vtkCommunicator::MIN_OP);
+  this->ReturnValue = this->ReturnValue ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  // This is here to avoid false leak messages from vtkDebugLeaks when
+  // using mpich. It appears that the root process which spawns all the
+  // main processes waits in MPI_Init() and calls exit() when
+  // the others are done, causing apparent memory leaks for any objects
+  // created before MPI_Init().
+  MPI_Init(&argc, &argv);
+
+  vtkMPIController *c = vtkMPIController::New();
+  c->Initialize(&argc, &argv, 1);
+
+  int retVal = 1;
+
+  vtkMultiProcessController::SetGlobalController(c);
+
+  if (c->GetNumberOfProcesses() < 2)
+    {
+    cout << "TestDistributedDataSharedMemory requires 2 or more processes"
+         << endl;
+    c->Delete();
+    return retVal;
+    }
+
+  MyProcess *p = MyProcess::New();
+
+  c->SetSingleProcessObject(p);
+  c->SingleMethodExecute();
+
+  retVal = p->GetReturnValue();
+
+  p->Delete();
+  c->Finalize();
+  c->Delete();
+
+  return retVal;
+}
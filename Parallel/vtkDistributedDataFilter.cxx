@@ -60,6 +60,18 @@
 
 #include <vtkstd/vector>
 
+// Sub grids are exchanged through POSIX shared memory between processes on
+// the same host.
+#if defined(VTK_USE_MPI) && !defined(_WIN32)
+# define VTK_D3_SHARED_MEMORY
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#define VTK_D3_HOST_NAME_SIZE 256
+
 
 vtkStandardNewMacro(vtkDistributedDataFilter)
 
@@ -81,12 +93,29 @@ public:
 class vtkDistributedDataFilter::vtkInternals
 {
 public:
+  vtkInternals() : SharedMemoryJobId(0), NumberOfExchanges(0) {}
+
   vtkstd::vector<int> UserRegionAssignments;
+
+  // Flags of the processes on the same host, from FindLocalProcesses().
+  vtkstd::vector<char> LocalProcesses;
+
+  // The shared memory segments of an exchange are named after these.
+  int SharedMemoryJobId;
+  int NumberOfExchanges;
+
+  void GetSharedMemoryName(char *name, int source, int target)
+    {
+    sprintf(name, "/vtkD3-%d-%d-%d-%d", this->SharedMemoryJobId,
+            this->NumberOfExchanges, source, target);
+    }
 };
 
 //----------------------------------------------------------------------------
 vtkDistributedDataFilter::vtkDistributedDataFilter()
 {
+  this->Internals = new vtkDistributedDataFilter::vtkInternals();
+
   this->Kdtree = NULL;
 
   this->Controller = NULL;
@@ -107,9 +136,9 @@ vtkDistributedDataFilter::vtkDistributedDataFilter()
   this->Timing = 0;
 
   this->UseMinimalMemory = 0;
+  this->UseSharedMemory = 0;
 
   this->UserCuts = 0;
-  this->Internals = new vtkDistributedDataFilter::vtkInternals();
 }
 
 //----------------------------------------------------------------------------
@@ -251,6 +280,8 @@ void vtkDistributedDataFilter::SetController(vtkMultiProcessController *c)
 
   this->Modified();
 
+  this->Internals->LocalProcesses.clear();
+
   if (this->Controller != NULL)
     {
     this->Controller->UnRegister(this);
@@ -1354,6 +1385,146 @@ void vtkDistributedDataFilter::SetUpPairWiseExchange()
     }
 }
 
+//-------------------------------------------------------------------------
+void vtkDistributedDataFilter::FindLocalProcesses()
+{
+  vtkstd::vector<char> &local = this->Internals->LocalProcesses;
+
+  if (!this->UseSharedMemory ||
+      static_cast<int>(local.size()) == this->NumProcesses)
+    {
+    return;
+    }
+
+  local.assign(this->NumProcesses, 0);
+
+#ifdef VTK_D3_SHARED_MEMORY
+  vtkMPIController *mpiContr = vtkMPIController::SafeDownCast(this->Controller);
+
+  if (!mpiContr)
+    {
+    return;
+    }
+
+  char host[VTK_D3_HOST_NAME_SIZE];
+  memset(host, 0, VTK_D3_HOST_NAME_SIZE);
+  strncpy(host, vtkMPIController::GetProcessorName(), VTK_D3_HOST_NAME_SIZE-1);
+
+  vtkstd::vector<char> hosts(this->NumProcesses * VTK_D3_HOST_NAME_SIZE);
+  mpiContr->AllGather(host, &hosts[0], VTK_D3_HOST_NAME_SIZE);
+
+  for (int proc=0; proc < this->NumProcesses; proc++)
+    {
+    local[proc] = (proc != this->MyId) &&
+      !strcmp(&hosts[proc * VTK_D3_HOST_NAME_SIZE], host);
+    }
+
+  // The process id of process 0 is unique on its host while the job runs.
+  // Segment names that collide on other hosts fall back to messages.
+
+  int jobId = static_cast<int>(getpid());
+  mpiContr->Broadcast(&jobId, 1, 0);
+  this->Internals->SharedMemoryJobId = jobId;
+#endif
+}
+
+//-------------------------------------------------------------------------
+int vtkDistributedDataFilter::PutSharedSubGrid(const char *buf, int size,
+                                               int target)
+{
+#ifdef VTK_D3_SHARED_MEMORY
+  if (!this->UseSharedMemory || !this->Internals->LocalProcesses[target])
+    {
+    return 0;
+    }
+
+  char name[64];
+  this->Internals->GetSharedMemoryName(name, this->MyId, target);
+
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+    {
+    return 0;
+    }
+
+  void *mem = MAP_FAILED;
+  if (ftruncate(fd, size) == 0)
+    {
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+  close(fd);
+
+  if (mem == MAP_FAILED)
+    {
+    shm_unlink(name);
+    return 0;
+    }
+
+  memcpy(mem, buf, size);
+  munmap(mem, size);
+
+  return 1;
+#else
+  (void)buf;
+  (void)size;
+  (void)target;
+  return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void vtkDistributedDataFilter::RemoveSharedSubGrid(int target)
+{
+#ifdef VTK_D3_SHARED_MEMORY
+  char name[64];
+  this->Internals->GetSharedMemoryName(name, this->MyId, target);
+  shm_unlink(name);
+#else
+  (void)target;
+#endif
+}
+
+//-------------------------------------------------------------------------
+vtkUnstructuredGrid *vtkDistributedDataFilter::GetSharedSubGrid(int source,
+                                                                int size)
+{
+  vtkUnstructuredGrid *grid = NULL;
+#ifdef VTK_D3_SHARED_MEMORY
+  char name[64];
+  this->Internals->GetSharedMemoryName(name, source, this->MyId);
+
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0)
+    {
+    vtkWarningMacro(<< "vtkDistributedDataFilter::GetSharedSubGrid can not open "
+                    << name << ", receiving it in a message");
+    return NULL;
+    }
+
+  // The segment disappears once it is unmapped.
+
+  shm_unlink(name);
+  void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (mem == MAP_FAILED)
+    {
+    vtkWarningMacro(<< "vtkDistributedDataFilter::GetSharedSubGrid can not map "
+                    << name << ", receiving it in a message");
+    return NULL;
+    }
+
+  grid = this->UnMarshallDataSet(static_cast<char *>(mem), size);
+  munmap(mem, size);
+#else
+  (void)source;
+  (void)size;
+  vtkErrorMacro(<< "vtkDistributedDataFilter::GetSharedSubGrid requires MPI");
+#endif
+
+  return grid;
+}
+
 //-------------------------------------------------------------------------
 void vtkDistributedDataFilter::FreeIntArrays(vtkIdTypeArray **ar)
 {
@@ -1850,6 +2021,9 @@ vtkUnstructuredGrid *
 
   vtkDataSet **grids = new vtkDataSet * [nprocs];
 
+  this->FindLocalProcesses();
+  this->Internals->NumberOfExchanges++;
+
   if (numLists[iam] > 0)
     {
     // I was extracting/packing/sending/unpacking ugrids of zero cells,
@@ -1897,6 +2071,14 @@ vtkUnstructuredGrid *
 
         packedGridSend = this->MarshallDataSet(sendGrid, packedGridSendSize);
         sendGrid->Delete();
+
+        // A negative size tells the target the grid is in shared memory.
+        // The packed grid is kept until the target has found it.
+
+        if (this->PutSharedSubGrid(packedGridSend, packedGridSendSize, target))
+          {
+          packedGridSendSize = -packedGridSendSize;
+          }
         }
       else if (deleteCellIds)
         {
@@ -1941,6 +2123,68 @@ vtkUnstructuredGrid *
       {
       req.Wait();
 
+      grids[numReceivedGrids++] = 
+        this->UnMarshallDataSet(packedGridRecv, packedGridRecvSize);
+      }
+
+    if ((packedGridSendSize >= 0) && (packedGridRecvSize >= 0))
+      {
+      continue;
+      }
+
+    // Tell the source whether its sub grid was found in shared memory.
+    // A sub grid that was not is sent in a message after all.
+
+    vtkMPICommunicator::Request ackReq;
+    int found = 1;
+    int targetFound = 1;
+    vtkUnstructuredGrid *sharedGrid = NULL;
+
+    if (packedGridRecvSize < 0)
+      {
+      packedGridRecvSize = -packedGridRecvSize;
+      sharedGrid = this->GetSharedSubGrid(source, packedGridRecvSize);
+      found = (sharedGrid != NULL);
+      }
+
+    if (packedGridSendSize < 0)
+      {
+      mpiContr->NoBlockReceive(&targetFound, 1, target, tag, ackReq);
+      }
+
+    if (sharedGrid)
+      {
+      mpiContr->Send(&found, 1, source, tag);
+      grids[numReceivedGrids++] = sharedGrid;
+      }
+    else if (!found)
+      {
+      if (packedGridRecvSize > recvBufSize)
+        {
+        delete [] packedGridRecv;
+        packedGridRecv = new char [packedGridRecvSize];
+        recvBufSize = packedGridRecvSize;
+        }
+      mpiContr->NoBlockReceive(packedGridRecv, packedGridRecvSize, source,
+                               tag, req);
+      mpiContr->Send(&found, 1, source, tag);
+      }
+
+    if (packedGridSendSize < 0)
+      {
+      ackReq.Wait();
+      if (!targetFound)
+        {
+        this->RemoveSharedSubGrid(target);
+        mpiContr->Send(packedGridSend, -packedGridSendSize, target, tag);
+        }
+      delete [] packedGridSend;
+      }
+
+    if (!found)
+      {
+      req.Wait();
+
       grids[numReceivedGrids++] = 
         this->UnMarshallDataSet(packedGridRecv, packedGridRecvSize);
       }
@@ -2419,6 +2663,9 @@ vtkUnstructuredGrid *
   vtkDataSet *tmpGrid = myGrid->NewInstance();
   tmpGrid->ShallowCopy(myGrid);
 
+  this->FindLocalProcesses();
+  this->Internals->NumberOfExchanges++;
+
   vtkModelMetadata *mmd = NULL;
 
   if (vtkDistributedDataFilter::HasMetadata(tmpGrid)  && !ghostCellFlag)
@@ -2451,6 +2698,14 @@ vtkUnstructuredGrid *
           sendBufs[proc] = this->MarshallDataSet(grids[proc], sendSize[proc]);
           grids[proc]->Delete();
           grids[proc] = NULL;
+
+          // A negative size tells the target the grid is in shared memory.
+          // The packed grid is kept until the target has found it.
+
+          if (this->PutSharedSubGrid(sendBufs[proc], sendSize[proc], proc))
+            {
+            sendSize[proc] = -sendSize[proc];
+            }
           }
         }
       else if (deleteCellIds)
@@ -2521,14 +2776,67 @@ vtkUnstructuredGrid *
       }
     }
 
-  for (proc=0; proc < nprocs; proc++)
+  // Unpack sub grids in shared memory, and tell their sources whether
+  // they were found.  A sub grid that was not is sent in a message after
+  // all.
+
+  vtkMPICommunicator::Request *ackReq = NULL;
+  int *found = NULL;
+
+  if (this->UseSharedMemory)
     {
-    if (sendSize[proc] > 0)
+    ackReq = new vtkMPICommunicator::Request [nprocs];
+    found = new int [2*nprocs];
+    int *targetFound = found + nprocs;
+
+    for (proc=0; proc < nprocs; proc++)
       {
-      delete [] sendBufs[proc];
+      if (sendSize[proc] < 0)
+        {
+        mpiContr->NoBlockReceive(targetFound + proc, 1, proc, tag,
+                                 ackReq[proc]);
+        }
       }
+
+    for (proc=0; proc < nprocs; proc++)
+      {
+      if (recvSize[proc] < 0)
+        {
+        recvSize[proc] = -recvSize[proc];
+        grids[proc] = this->GetSharedSubGrid(proc, recvSize[proc]);
+        found[proc] = (grids[proc] != NULL);
+        if (!found[proc])
+          {
+          recvBufs[proc] = new char [recvSize[proc]];
+          mpiContr->NoBlockReceive(recvBufs[proc], recvSize[proc], proc, tag,
+                                   reqBuf[proc]);
+          numReceives++;
+          }
+        mpiContr->Send(found + proc, 1, proc, tag);
+        }
+      }
+
+    for (proc=0; proc < nprocs; proc++)
+      {
+      if (sendSize[proc] < 0)
+        {
+        ackReq[proc].Wait();
+        if (!targetFound[proc])
+          {
+          this->RemoveSharedSubGrid(proc);
+          mpiContr->Send(sendBufs[proc], -sendSize[proc], proc, tag);
+          }
+        }
+      }
+    }
+
+  for (proc=0; proc < nprocs; proc++)
+    {
+    delete [] sendBufs[proc];
     }
 
+  delete [] ackReq;
+  delete [] found;
   delete [] sendSize;
   delete [] sendBufs;
 
@@ -4793,5 +5101,6 @@ void vtkDistributedDataFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Timing: " << this->Timing << endl;
   os << indent << "UseMinimalMemory: " << this->UseMinimalMemory << endl;
+  os << indent << "UseSharedMemory: " << this->UseSharedMemory << endl;
 }
 
@@ -74,6 +74,13 @@
 //   If still not found, D3 will create a temporary array of
 //   global element IDs.
 //
+// Sub grids are exchanged as packed data sets in MPI messages.  When
+// UseSharedMemory is on, processes on the same host leave the packed sub
+// grid in a POSIX shared memory segment instead; only its size goes
+// through a message and the receiver unpacks it from the segment.  A sub
+// grid that the receiver can not find there is sent in a message.
+// Processes on other hosts still exchange messages.
+//
 // .SECTION Caveats
 // The Execute() method must be called by all processes in the
 // parallel application, or it will hang.  If you are not certain
@@ -207,6 +214,21 @@ public:
   vtkGetMacro(UseMinimalMemory, int);
   vtkSetMacro(UseMinimalMemory, int);
 
+  // Description:
+  //  Exchange sub grids with processes on the same host through
+  //  shared memory rather than messages.  Processes are on the same
+  //  host when MPI reports the same processor name.  If a shared
+  //  memory segment cannot be created or opened, the sub grid is sent
+  //  in a message.  The packed sub grid is still copied into the
+  //  segment and unpacked from it, so this saves little over the on
+  //  node transport of most MPI implementations, and it costs a few
+  //  more collective calls.  It must be set the same on all processes.
+  //  Only available with MPI on POSIX systems.  Default is OFF.
+
+  vtkBooleanMacro(UseSharedMemory, int);
+  vtkGetMacro(UseSharedMemory, int);
+  vtkSetMacro(UseSharedMemory, int);
+
 
   // Description:
   //  Turn on collection of timing data
@@ -364,6 +386,23 @@ private:
   // each processor to talk to every other.
   void SetUpPairWiseExchange();
 
+  // Description:
+  // Find the processes running on the same host as this one.  Must be
+  // called by all processes; the result is kept until the controller
+  // changes.
+  void FindLocalProcesses();
+
+  // Description:
+  // Put a packed sub grid for a process on the same host in shared
+  // memory, or unpack one a process on the same host left there.
+  // PutSharedSubGrid() returns 0 if the sub grid must be sent in a
+  // message instead.
+  // RemoveSharedSubGrid() removes a sub grid that the target could not
+  // find.
+  int PutSharedSubGrid(const char *buf, int size, int target);
+  vtkUnstructuredGrid *GetSharedSubGrid(int source, int size);
+  void RemoveSharedSubGrid(int target);
+
   // Description:
   // ?
   void FreeIntArrays(vtkIdTypeArray **ar);
@@ -553,6 +592,7 @@ private:
   double ProgressIncrement;
 
   int UseMinimalMemory;
+  int UseSharedMemory;
 
   vtkBSPCuts* UserCuts;
 